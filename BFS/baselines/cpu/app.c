@@ -11,6 +11,7 @@
 #include "../../support/common.h"
 #include "../../support/graph.h"
 #include "../../support/params.h"
+#include "../../support/rapl.h"
 #include "../../support/timer.h"
 #include "../../support/utils.h"
 
@@ -21,9 +22,8 @@ int main(int argc, char** argv) {
 
     // Initialize BFS data structures
     PRINT_INFO(p.verbosity >= 1, "Reading graph %s", p.fileName);
-    struct COOGraph cooGraph = readCOOGraph(p.fileName);
-    PRINT_INFO(p.verbosity >= 1, "    Graph has %d nodes and %d edges", cooGraph.numNodes, cooGraph.numEdges);
-    struct CSRGraph csrGraph = coo2csr(cooGraph);
+    struct CSRGraph csrGraph = readGraph(p.fileName);
+    PRINT_INFO(p.verbosity >= 1, "    Graph has %d nodes and %d edges", csrGraph.numNodes, csrGraph.numEdges);
     uint32_t* nodeLevel = (uint32_t*) malloc(csrGraph.numNodes*sizeof(uint32_t));
     uint32_t* nodeLevelRef = (uint32_t*) malloc(csrGraph.numNodes*sizeof(uint32_t));
     for(uint32_t i = 0; i < csrGraph.numNodes; ++i) {
@@ -40,8 +40,10 @@ int main(int argc, char** argv) {
 
     // Calculating result on CPU
     PRINT_INFO(p.verbosity >= 1, "Calculating result on CPU (OpenMP)");
-    omp_set_num_threads(4);
+    if(getenv("OMP_NUM_THREADS") == NULL) omp_set_num_threads(4); // Default unless set by the caller
     Timer timer;
+    Energy energy;
+    energy_start(&energy, 0, 0);
     startTimer(&timer);
     nodeLevel[srcNode] = 0;
     prevFrontier[0] = srcNode;
@@ -83,11 +85,18 @@ int main(int argc, char** argv) {
 
     }
     stopTimer(&timer);
+    energy_stop(&energy, 0);
     if(p.verbosity == 0) PRINT("%f", getElapsedTime(timer)*1e3);
     PRINT_INFO(p.verbosity >= 1, "Elapsed time: %f ms", getElapsedTime(timer)*1e3);
+    if(p.verbosity >= 1) {
+        printf("\033[0;32mINFO:\033[0m    Energy ");
+        energy_print(&energy, 0, 1, csrGraph.numEdges);
+        printf("\n");
+    }
 
     // Calculating result on CPU sequentially
     PRINT_INFO(p.verbosity >= 1, "Calculating result on CPU (sequential)");
+    energy_start(&energy, 1, 0);
     startTimer(&timer);
     nodeLevelRef[srcNode] = 0;
     prevFrontier[0] = srcNode;
@@ -122,8 +131,14 @@ int main(int argc, char** argv) {
 
     }
     stopTimer(&timer);
+    energy_stop(&energy, 1);
     if(p.verbosity == 0) PRINT("%f", getElapsedTime(timer)*1e3);
     PRINT_INFO(p.verbosity >= 1, "Elapsed time: %f ms", getElapsedTime(timer)*1e3);
+    if(p.verbosity >= 1) {
+        printf("\033[0;32mINFO:\033[0m    Energy ");
+        energy_print(&energy, 1, 1, csrGraph.numEdges);
+        printf("\n");
+    }
 
     // Verifying result
     PRINT_INFO(p.verbosity >= 1, "Verifying the result");
@@ -135,7 +150,6 @@ int main(int argc, char** argv) {
 
 
     // Deallocate data structures
-    freeCOOGraph(cooGraph);
     freeCSRGraph(csrGraph);
     free(nodeLevel);
     free(buffer1);
@@ -19,11 +19,15 @@ BARRIER_INIT(my_barrier, NR_TASKLETS);
 BARRIER_INIT(bfsBarrier, NR_TASKLETS);
 MUTEX_INIT(nextFrontierMutex);
 
+// Kernel cycles of the last launch (read by the host after every level)
+__host uint64_t kernel_cycles;
+
 // main
 int main() {
 
     if(me() == 0) {
         mem_reset(); // Reset the heap
+        perfcounter_config(COUNT_CYCLES, true);
     }
     // Barrier
     barrier_wait(&my_barrier);
@@ -39,6 +43,7 @@ int main() {
     uint32_t numNodes = params_w->dpuNumNodes;
     uint32_t nodePtrsOffset = params_w->dpuNodePtrsOffset;
     uint32_t level = params_w->level;
+    uint32_t hostFrontier = params_w->hostFrontier;
     uint32_t nodePtrs_m = params_w->dpuNodePtrs_m;
     uint32_t neighborIdxs_m = params_w->dpuNeighborIdxs_m;
     uint32_t nodeLevel_m = params_w->dpuNodeLevel_m;
@@ -62,42 +67,45 @@ int main() {
         uint64_t* cache_w = mem_alloc(sizeof(uint64_t));
 
         // Update current frontier and visited list based on the next frontier from the previous iteration
-        for(uint32_t nodeTileIdx = me(); nodeTileIdx < numGlobalNodes/64; nodeTileIdx += NR_TASKLETS) {
+        // (in out-of-core mode the host provides them)
+        if(!hostFrontier) {
+            for(uint32_t nodeTileIdx = me(); nodeTileIdx < numGlobalNodes/64; nodeTileIdx += NR_TASKLETS) {
 
-            // Get the next frontier tile from MRAM
-            uint64_t nextFrontierTile = load8B(nextFrontier_m, nodeTileIdx, cache_w);
+                // Get the next frontier tile from MRAM
+                uint64_t nextFrontierTile = load8B(nextFrontier_m, nodeTileIdx, cache_w);
 
-            // Process next frontier tile if it is not empty 
-            if(nextFrontierTile) {
+                // Process next frontier tile if it is not empty 
+                if(nextFrontierTile) {
 
-                // Mark everything that was previously added to the next frontier as visited
-                uint64_t visitedTile = load8B(visited_m, nodeTileIdx, cache_w);
-                visitedTile |= nextFrontierTile;
-                store8B(visitedTile, visited_m, nodeTileIdx, cache_w);
+                    // Mark everything that was previously added to the next frontier as visited
+                    uint64_t visitedTile = load8B(visited_m, nodeTileIdx, cache_w);
+                    visitedTile |= nextFrontierTile;
+                    store8B(visitedTile, visited_m, nodeTileIdx, cache_w);
 
-                // Clear the next frontier
-                store8B(0, nextFrontier_m, nodeTileIdx, cache_w);
+                    // Clear the next frontier
+                    store8B(0, nextFrontier_m, nodeTileIdx, cache_w);
 
-            }
+                }
 
-            // Extract the current frontier from the previous next frontier and update node levels
-            uint32_t startTileIdx = startNodeIdx/64;
-            uint32_t numTiles = numNodes/64;
-            if(startTileIdx <= nodeTileIdx && nodeTileIdx < startTileIdx + numTiles) {
+                // Extract the current frontier from the previous next frontier and update node levels
+                uint32_t startTileIdx = startNodeIdx/64;
+                uint32_t numTiles = numNodes/64;
+                if(startTileIdx <= nodeTileIdx && nodeTileIdx < startTileIdx + numTiles) {
 
-                // Update current frontier
-                store8B(nextFrontierTile, currentFrontier_m, nodeTileIdx - startTileIdx, cache_w);
+                    // Update current frontier
+                    store8B(nextFrontierTile, currentFrontier_m, nodeTileIdx - startTileIdx, cache_w);
 
-                // Update node levels
-                if(nextFrontierTile) {
-                    for(uint32_t node = nodeTileIdx*64; node < (nodeTileIdx + 1)*64; ++node) {
-                        if(isSet(nextFrontierTile, node%64)) {
-                            store4B(level, nodeLevel_m, node - startNodeIdx, cache_w); // No false sharing so no need for locks
+                    // Update node levels
+                    if(nextFrontierTile) {
+                        for(uint32_t node = nodeTileIdx*64; node < (nodeTileIdx + 1)*64; ++node) {
+                            if(isSet(nextFrontierTile, node%64)) {
+                                store4B(level, nodeLevel_m, node - startNodeIdx, cache_w); // No false sharing so no need for locks
+                            }
                         }
                     }
                 }
-            }
 
+            }
         }
 
         // Wait until all tasklets have updated the current frontier
@@ -142,5 +150,11 @@ int main() {
 
     }
 
+    // Wait until all tasklets are done and record the kernel cycles
+    barrier_wait(&bfsBarrier);
+    if(me() == 0) {
+        kernel_cycles = perfcounter_get();
+    }
+
     return 0;
 }
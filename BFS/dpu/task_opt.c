@@ -0,0 +1,239 @@
+/*
+* BFS with multiple tasklets (optimized MRAM accesses)
+*
+* Same MRAM layout and semantics as task.c, but:
+*   - frontier, visited and next frontier tiles are moved in blocks of TILES_PER_BLOCK tiles
+*   - each current frontier tile is loaded once and only its set bits are visited
+*   - the node pointers of a non-empty tile are fetched with a single transfer
+*   - adjacency lists are streamed through the sequential reader
+*   - visited tiles are served from a small per-tasklet WRAM cache
+*   - next frontier updates are protected by striped locks selected by tile index
+*
+*/
+#include <stdio.h>
+
+#include <alloc.h>
+#include <barrier.h>
+#include <defs.h>
+#include <mram.h>
+#include <mutex_pool.h>
+#include <perfcounter.h>
+#include <seqread.h>
+
+#include "dpu-utils.h"
+#include "../support/common.h"
+
+// Number of 64-node tiles moved per MRAM-WRAM transfer
+#ifndef TILES_PER_BLOCK
+#define TILES_PER_BLOCK 16
+#endif
+// Visited cache: VISITED_CACHE_LINES direct-mapped lines of VISITED_LINE_TILES tiles
+#ifndef VISITED_LINE_TILES
+#define VISITED_LINE_TILES 8
+#endif
+#ifndef VISITED_CACHE_LINES
+#define VISITED_CACHE_LINES 4
+#endif
+// Number of locks protecting the next frontier
+#ifndef NR_FRONTIER_LOCKS
+#define NR_FRONTIER_LOCKS 8
+#endif
+
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+BARRIER_INIT(bfsBarrier, NR_TASKLETS);
+MUTEX_POOL_INIT(nextFrontierLocks, NR_FRONTIER_LOCKS);
+
+// Kernel cycles of the last launch (read by the host after every level)
+__host uint64_t kernel_cycles;
+
+// Return a visited tile, loading its cache line from MRAM on a miss
+// (the last line stops at numGlobalTiles, the end of the visited list)
+static uint64_t* visitedTileRef(uint32_t visited_m, uint32_t numGlobalTiles, uint32_t tileIdx, uint64_t* visitedCache_w, uint32_t* visitedTags_w) {
+    uint32_t lineIdx = tileIdx/VISITED_LINE_TILES;
+    uint32_t slot = lineIdx%VISITED_CACHE_LINES;
+    uint64_t* line_w = &visitedCache_w[slot*VISITED_LINE_TILES];
+    if(visitedTags_w[slot] != lineIdx) {
+        uint32_t lineStartTile = lineIdx*VISITED_LINE_TILES;
+        uint32_t lineNumTiles = (lineStartTile + VISITED_LINE_TILES <= numGlobalTiles)?VISITED_LINE_TILES:(numGlobalTiles - lineStartTile);
+        mram_read((__mram_ptr void const*)(visited_m + lineStartTile*sizeof(uint64_t)), line_w, lineNumTiles*sizeof(uint64_t));
+        visitedTags_w[slot] = lineIdx;
+    }
+    return &line_w[tileIdx%VISITED_LINE_TILES];
+}
+
+// main
+int main() {
+
+    if(me() == 0) {
+        mem_reset(); // Reset the heap
+        perfcounter_config(COUNT_CYCLES, true);
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    // Load parameters
+    uint32_t params_m = (uint32_t) DPU_MRAM_HEAP_POINTER;
+    struct DPUParams* params_w = (struct DPUParams*) mem_alloc(ROUND_UP_TO_MULTIPLE_OF_8(sizeof(struct DPUParams)));
+    mram_read((__mram_ptr void const*)params_m, params_w, ROUND_UP_TO_MULTIPLE_OF_8(sizeof(struct DPUParams)));
+
+    // Extract parameters
+    uint32_t numGlobalNodes = params_w->numNodes;
+    uint32_t startNodeIdx = params_w->dpuStartNodeIdx;
+    uint32_t numNodes = params_w->dpuNumNodes;
+    uint32_t nodePtrsOffset = params_w->dpuNodePtrsOffset;
+    uint32_t level = params_w->level;
+    uint32_t hostFrontier = params_w->hostFrontier;
+    uint32_t nodePtrs_m = params_w->dpuNodePtrs_m;
+    uint32_t neighborIdxs_m = params_w->dpuNeighborIdxs_m;
+    uint32_t nodeLevel_m = params_w->dpuNodeLevel_m;
+    uint32_t visited_m = params_w->dpuVisited_m;
+    uint32_t currentFrontier_m = params_w->dpuCurrentFrontier_m;
+    uint32_t nextFrontier_m = params_w->dpuNextFrontier_m;
+
+    if(numNodes > 0) {
+
+        uint32_t numGlobalTiles = numGlobalNodes/64;
+        uint32_t startTileIdx = startNodeIdx/64;
+        uint32_t numTiles = numNodes/64;
+
+        // Allocate WRAM buffers for each tasklet to use throughout
+        uint64_t* cache_w = mem_alloc(sizeof(uint64_t));
+        uint64_t* tiles_w = mem_alloc(TILES_PER_BLOCK*sizeof(uint64_t));
+        uint64_t* visitedTiles_w = mem_alloc(TILES_PER_BLOCK*sizeof(uint64_t));
+        uint32_t* tileBuffer_w = mem_alloc(ROUND_UP_TO_MULTIPLE_OF_8((64 + 2)*sizeof(uint32_t))); // Node levels or node pointers of one tile
+
+        // Update current frontier and visited list based on the next frontier from the previous iteration
+        // (in out-of-core mode the host provides them)
+        if(!hostFrontier) {
+            for(uint32_t blockTileIdx = me()*TILES_PER_BLOCK; blockTileIdx < numGlobalTiles; blockTileIdx += NR_TASKLETS*TILES_PER_BLOCK) {
+
+                uint32_t blockNumTiles = (blockTileIdx + TILES_PER_BLOCK <= numGlobalTiles)?TILES_PER_BLOCK:(numGlobalTiles - blockTileIdx);
+                uint32_t blockBytes = blockNumTiles*sizeof(uint64_t);
+
+                // Get the next frontier tiles from MRAM
+                mram_read((__mram_ptr void const*)(nextFrontier_m + blockTileIdx*sizeof(uint64_t)), tiles_w, blockBytes);
+                uint64_t blockNonEmpty = 0;
+                for(uint32_t t = 0; t < blockNumTiles; ++t) {
+                    blockNonEmpty |= tiles_w[t];
+                }
+
+                // Process next frontier tiles if they are not all empty
+                if(blockNonEmpty) {
+
+                    // Mark everything that was previously added to the next frontier as visited
+                    mram_read((__mram_ptr void const*)(visited_m + blockTileIdx*sizeof(uint64_t)), visitedTiles_w, blockBytes);
+                    for(uint32_t t = 0; t < blockNumTiles; ++t) {
+                        visitedTiles_w[t] |= tiles_w[t];
+                    }
+                    mram_write(visitedTiles_w, (__mram_ptr void*)(visited_m + blockTileIdx*sizeof(uint64_t)), blockBytes);
+
+                    // Clear the next frontier
+                    for(uint32_t t = 0; t < blockNumTiles; ++t) {
+                        visitedTiles_w[t] = 0;
+                    }
+                    mram_write(visitedTiles_w, (__mram_ptr void*)(nextFrontier_m + blockTileIdx*sizeof(uint64_t)), blockBytes);
+
+                }
+
+                // Extract the current frontier from the previous next frontier and update node levels
+                uint32_t ownedStart = (blockTileIdx > startTileIdx)?blockTileIdx:startTileIdx;
+                uint32_t ownedEnd = (blockTileIdx + blockNumTiles < startTileIdx + numTiles)?(blockTileIdx + blockNumTiles):(startTileIdx + numTiles);
+                if(ownedStart < ownedEnd) {
+
+                    // Update current frontier
+                    mram_write(&tiles_w[ownedStart - blockTileIdx], (__mram_ptr void*)(currentFrontier_m + (ownedStart - startTileIdx)*sizeof(uint64_t)), (ownedEnd - ownedStart)*sizeof(uint64_t));
+
+                    // Update node levels, one tile of levels per transfer
+                    for(uint32_t nodeTileIdx = ownedStart; nodeTileIdx < ownedEnd; ++nodeTileIdx) {
+                        uint64_t nextFrontierTile = tiles_w[nodeTileIdx - blockTileIdx];
+                        if(nextFrontierTile) {
+                            uint32_t levels_m = nodeLevel_m + (nodeTileIdx*64 - startNodeIdx)*sizeof(uint32_t);
+                            if(~nextFrontierTile) { // Partially set tile: keep the other levels
+                                mram_read((__mram_ptr void const*)levels_m, tileBuffer_w, 64*sizeof(uint32_t));
+                            }
+                            for(uint32_t node = 0; node < 64; ++node) {
+                                if(isSet(nextFrontierTile, node)) {
+                                    tileBuffer_w[node] = level; // No false sharing so no need for locks
+                                }
+                            }
+                            mram_write(tileBuffer_w, (__mram_ptr void*)levels_m, 64*sizeof(uint32_t));
+                        }
+                    }
+                }
+
+            }
+        }
+
+        // Wait until all tasklets have updated the current frontier
+        barrier_wait(&bfsBarrier);
+
+        // Set up the adjacency reader and the visited cache (visited is read-only from here on)
+        seqreader_t neighborReader;
+        uint32_t* neighbors_w = seqread_init(seqread_alloc(), (__mram_ptr void*)neighborIdxs_m, &neighborReader);
+        uint64_t* visitedCache_w = mem_alloc(VISITED_CACHE_LINES*VISITED_LINE_TILES*sizeof(uint64_t));
+        uint32_t* visitedTags_w = mem_alloc(ROUND_UP_TO_MULTIPLE_OF_8(VISITED_CACHE_LINES*sizeof(uint32_t)));
+        for(uint32_t slot = 0; slot < VISITED_CACHE_LINES; ++slot) {
+            visitedTags_w[slot] = UINT32_MAX;
+        }
+
+        // Visit neighbors of the current frontier, one block of tiles at a time
+        for(uint32_t blockTileIdx = me()*TILES_PER_BLOCK; blockTileIdx < numTiles; blockTileIdx += NR_TASKLETS*TILES_PER_BLOCK) {
+
+            uint32_t blockNumTiles = (blockTileIdx + TILES_PER_BLOCK <= numTiles)?TILES_PER_BLOCK:(numTiles - blockTileIdx);
+            mram_read((__mram_ptr void const*)(currentFrontier_m + blockTileIdx*sizeof(uint64_t)), tiles_w, blockNumTiles*sizeof(uint64_t));
+
+            for(uint32_t t = 0; t < blockNumTiles; ++t) {
+                uint64_t currentFrontierTile = tiles_w[t];
+                if(!currentFrontierTile) {
+                    continue;
+                }
+
+                // Load the 65 node pointers of the tile at once (nodePtrs holds numNodes + 1 entries rounded up to 8B)
+                uint32_t tileFirstNode = (blockTileIdx + t)*64;
+                mram_read((__mram_ptr void const*)(nodePtrs_m + tileFirstNode*sizeof(uint32_t)), tileBuffer_w, ROUND_UP_TO_MULTIPLE_OF_8((64 + 1)*sizeof(uint32_t)));
+
+                while(currentFrontierTile) { // For each node in the current frontier
+                    uint32_t nodeInTile = __builtin_ctzll(currentFrontierTile);
+                    resetBit(currentFrontierTile, nodeInTile);
+
+                    // Visit its neighbors
+                    uint32_t nodePtr = tileBuffer_w[nodeInTile] - nodePtrsOffset;
+                    uint32_t nextNodePtr = tileBuffer_w[nodeInTile + 1] - nodePtrsOffset;
+                    if(nodePtr == nextNodePtr) {
+                        continue;
+                    }
+                    neighbors_w = seqread_seek((__mram_ptr void*)(neighborIdxs_m + nodePtr*sizeof(uint32_t)), &neighborReader);
+                    for(uint32_t i = nodePtr; i < nextNodePtr; ++i) {
+                        uint32_t neighbor = *neighbors_w;
+                        neighbors_w = seqread_get(neighbors_w, sizeof(uint32_t), &neighborReader); // Last read will be out of bounds and unused
+                        uint32_t neighborTileIdx = neighbor/64;
+                        uint64_t* visitedTile_w = visitedTileRef(visited_m, numGlobalTiles, neighborTileIdx, visitedCache_w, visitedTags_w);
+                        if(!isSet(*visitedTile_w, neighbor%64)) { // Neighbor not previously visited
+                            // Add neighbor to next frontier
+                            mutex_pool_lock(&nextFrontierLocks, neighborTileIdx);
+                            uint64_t nextFrontierTile = load8B(nextFrontier_m, neighborTileIdx, cache_w);
+                            if(!isSet(nextFrontierTile, neighbor%64)) {
+                                setBit(nextFrontierTile, neighbor%64);
+                                store8B(nextFrontierTile, nextFrontier_m, neighborTileIdx, cache_w);
+                            }
+                            mutex_pool_unlock(&nextFrontierLocks, neighborTileIdx);
+                            // Remember locally that it is already in the next frontier (the cache is never written back)
+                            setBit(*visitedTile_w, neighbor%64);
+                        }
+                    }
+                }
+            }
+        }
+
+    }
+
+    // Wait until all tasklets are done and record the kernel cycles
+    barrier_wait(&bfsBarrier);
+    if(me() == 0) {
+        kernel_cycles = perfcounter_get();
+    }
+
+    return 0;
+}
+
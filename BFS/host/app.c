@@ -14,12 +14,14 @@
 #include <unistd.h>
 
 #include "mram-management.h"
+#include "out-of-core.h"
 #include "../support/common.h"
 #include "../support/graph.h"
 #include "../support/params.h"
 #include "../support/timer.h"
 #include "../support/utils.h"
 #include "../support/prim_results.h"
+#include "../support/xfer_queue.h"
 
 #ifndef ENERGY
 #define ENERGY 0
@@ -39,6 +41,8 @@ int main(int argc, char** argv) {
     // Timer and profiling
     Timer timer;
     float loadTime = 0.0f, dpuTime = 0.0f, hostTime = 0.0f, retrieveTime = 0.0f, CPUTime = 0.0f;
+    uint64_t dpuCycles = 0; // Sum over levels of the slowest DPU's kernel cycles
+    xfer_stats_t xferStats = {0}; // Transfers of the in-core mode, requested and issued by the queue
     #if ENERGY
     struct dpu_probe_t probe;
     DPU_ASSERT(dpu_probe_init("energy_probe", &probe));
@@ -55,9 +59,8 @@ int main(int argc, char** argv) {
 
     // Initialize BFS data structures
     PRINT_INFO(p.verbosity >= 1, "Reading graph %s", p.fileName);
-    struct COOGraph cooGraph = readCOOGraph(p.fileName);
-    PRINT_INFO(p.verbosity >= 1, "    Graph has %d nodes and %d edges", cooGraph.numNodes, cooGraph.numEdges);
-    struct CSRGraph csrGraph = coo2csr(cooGraph);
+    struct CSRGraph csrGraph = readGraph(p.fileName);
+    PRINT_INFO(p.verbosity >= 1, "    Graph has %d nodes and %d edges", csrGraph.numNodes, csrGraph.numEdges);
     uint32_t numNodes = csrGraph.numNodes;
     uint32_t* nodePtrs = csrGraph.nodePtrs;
     uint32_t* neighborIdxs = csrGraph.neighborIdxs;
@@ -68,187 +71,229 @@ int main(int argc, char** argv) {
     setBit(nextFrontier[0], 0); // Initialize frontier to first node
     uint32_t level = 1;
 
-    // Partition data structure across DPUs
-    uint32_t numNodesPerDPU = ROUND_UP_TO_MULTIPLE_OF_64((numNodes - 1)/numDPUs + 1);
-    PRINT_INFO(p.verbosity >= 1, "Assigning %u nodes per DPU", numNodesPerDPU);
-    struct DPUParams dpuParams[numDPUs];
-    uint32_t dpuParams_m[numDPUs];
     unsigned int dpuIdx = 0;
-    DPU_FOREACH (dpu_set, dpu) {
-
-        // Allocate parameters
-        struct mram_heap_allocator_t allocator;
-        init_allocator(&allocator);
-        dpuParams_m[dpuIdx] = mram_heap_alloc(&allocator, sizeof(struct DPUParams));
-
-        // Find DPU's nodes
-        uint32_t dpuStartNodeIdx = dpuIdx*numNodesPerDPU;
-        uint32_t dpuNumNodes;
-        if(dpuStartNodeIdx > numNodes) {
-            dpuNumNodes = 0;
-        } else if(dpuStartNodeIdx + numNodesPerDPU > numNodes) {
-            dpuNumNodes = numNodes - dpuStartNodeIdx;
-        } else {
-            dpuNumNodes = numNodesPerDPU;
-        }
-        dpuParams[dpuIdx].dpuNumNodes = dpuNumNodes;
-        PRINT_INFO(p.verbosity >= 2, "    DPU %u:", dpuIdx);
-        PRINT_INFO(p.verbosity >= 2, "        Receives %u nodes", dpuNumNodes);
-
-        // Partition edges and copy data
-        if(dpuNumNodes > 0) {
-
-            // Find DPU's CSR graph partition
-            uint32_t* dpuNodePtrs_h = &nodePtrs[dpuStartNodeIdx];
-            uint32_t dpuNodePtrsOffset = dpuNodePtrs_h[0];
-            uint32_t* dpuNeighborIdxs_h = neighborIdxs + dpuNodePtrsOffset;
-            uint32_t dpuNumNeighbors = dpuNodePtrs_h[dpuNumNodes] - dpuNodePtrsOffset;
-            uint32_t* dpuNodeLevel_h = &nodeLevel[dpuStartNodeIdx];
-
-            // Allocate MRAM
-            uint32_t dpuNodePtrs_m = mram_heap_alloc(&allocator, (dpuNumNodes + 1)*sizeof(uint32_t));
-            uint32_t dpuNeighborIdxs_m = mram_heap_alloc(&allocator, dpuNumNeighbors*sizeof(uint32_t));
-            uint32_t dpuNodeLevel_m = mram_heap_alloc(&allocator, dpuNumNodes*sizeof(uint32_t));
-            uint32_t dpuVisited_m = mram_heap_alloc(&allocator, numNodes/64*sizeof(uint64_t));
-            uint32_t dpuCurrentFrontier_m = mram_heap_alloc(&allocator, dpuNumNodes/64*sizeof(uint64_t));
-            uint32_t dpuNextFrontier_m = mram_heap_alloc(&allocator, numNodes/64*sizeof(uint64_t));
-            PRINT_INFO(p.verbosity >= 2, "        Total memory allocated is %d bytes", allocator.totalAllocated);
-
-            // Set up DPU parameters
-            dpuParams[dpuIdx].numNodes = numNodes;
-            dpuParams[dpuIdx].dpuStartNodeIdx = dpuStartNodeIdx;
-            dpuParams[dpuIdx].dpuNodePtrsOffset = dpuNodePtrsOffset;
-            dpuParams[dpuIdx].level = level;
-            dpuParams[dpuIdx].dpuNodePtrs_m = dpuNodePtrs_m;
-            dpuParams[dpuIdx].dpuNeighborIdxs_m = dpuNeighborIdxs_m;
-            dpuParams[dpuIdx].dpuNodeLevel_m = dpuNodeLevel_m;
-            dpuParams[dpuIdx].dpuVisited_m = dpuVisited_m;
-            dpuParams[dpuIdx].dpuCurrentFrontier_m = dpuCurrentFrontier_m;
-            dpuParams[dpuIdx].dpuNextFrontier_m = dpuNextFrontier_m;
-
-            // Send data to DPU
-            PRINT_INFO(p.verbosity >= 2, "        Copying data to DPU");
-            startTimer(&timer);
-            copyToDPU(dpu, (uint8_t*)dpuNodePtrs_h, dpuNodePtrs_m, (dpuNumNodes + 1)*sizeof(uint32_t));
-            copyToDPU(dpu, (uint8_t*)dpuNeighborIdxs_h, dpuNeighborIdxs_m, dpuNumNeighbors*sizeof(uint32_t));
-            copyToDPU(dpu, (uint8_t*)dpuNodeLevel_h, dpuNodeLevel_m, dpuNumNodes*sizeof(uint32_t));
-            copyToDPU(dpu, (uint8_t*)visited, dpuVisited_m, numNodes/64*sizeof(uint64_t));
-            copyToDPU(dpu, (uint8_t*)nextFrontier, dpuNextFrontier_m, numNodes/64*sizeof(uint64_t));
-            // NOTE: No need to copy current frontier because it is written before being read
-            stopTimer(&timer);
-            loadTime += getElapsedTime(timer);
+    uint32_t nextFrontierEmpty = 0;
+    if(p.partitionsPerDPU > 1) {
 
-        }
+        // Stream graph partitions through MRAM every level
+        bfsOutOfCore(dpu_set, numDPUs, csrGraph, p.partitionsPerDPU, nodeLevel, p.verbosity, &loadTime, &dpuTime, &hostTime, &dpuCycles);
+        PRINT_INFO(p.verbosity >= 1, "CPU-DPU Time: %f ms", loadTime*1e3);
+        PRINT_INFO(p.verbosity >= 1, "DPU Kernel Time: %f ms", dpuTime*1e3);
+        PRINT_INFO(p.verbosity >= 1, "DPU Kernel Cycles: %lu", (unsigned long)dpuCycles);
+        PRINT_INFO(p.verbosity >= 1, "Inter-DPU Time: %f ms", hostTime*1e3);
 
-        // Send parameters to DPU
-        PRINT_INFO(p.verbosity >= 2, "        Copying parameters to DPU");
-        startTimer(&timer);
-        copyToDPU(dpu, (uint8_t*)&dpuParams[dpuIdx], dpuParams_m[dpuIdx], sizeof(struct DPUParams));
-        stopTimer(&timer);
-        loadTime += getElapsedTime(timer);
+    } else {
 
-        ++dpuIdx;
+        // Partition data structure across DPUs
+        uint32_t numNodesPerDPU = ROUND_UP_TO_MULTIPLE_OF_64((numNodes - 1)/numDPUs + 1);
+        PRINT_INFO(p.verbosity >= 1, "Assigning %u nodes per DPU", numNodesPerDPU);
+        struct DPUParams dpuParams[numDPUs];
+        uint32_t dpuParams_m[numDPUs];
+        uint64_t dpuLevelCycles[numDPUs];
+        xfer_queue_t queue;
+        xfer_queue_init(&queue, dpu_set);
+        dpuIdx = 0;
+        DPU_FOREACH (dpu_set, dpu) {
 
-    }
-    PRINT_INFO(p.verbosity >= 1, "    CPU-DPU Time: %f ms", loadTime*1e3);
+            // Allocate parameters
+            struct mram_heap_allocator_t allocator;
+            init_allocator(&allocator);
+            dpuParams_m[dpuIdx] = mram_heap_alloc(&allocator, sizeof(struct DPUParams));
 
-    // Iterate until next frontier is empty
-    uint32_t nextFrontierEmpty = 0;
-    while(!nextFrontierEmpty) {
+            // Find DPU's nodes
+            uint32_t dpuStartNodeIdx = dpuIdx*numNodesPerDPU;
+            uint32_t dpuNumNodes;
+            if(dpuStartNodeIdx > numNodes) {
+                dpuNumNodes = 0;
+            } else if(dpuStartNodeIdx + numNodesPerDPU > numNodes) {
+                dpuNumNodes = numNodes - dpuStartNodeIdx;
+            } else {
+                dpuNumNodes = numNodesPerDPU;
+            }
+            dpuParams[dpuIdx].dpuNumNodes = dpuNumNodes;
+            PRINT_INFO(p.verbosity >= 2, "    DPU %u:", dpuIdx);
+            PRINT_INFO(p.verbosity >= 2, "        Receives %u nodes", dpuNumNodes);
 
-        PRINT_INFO(p.verbosity >= 1, "Processing current frontier for level %u", level);
-
-	#if ENERGY
-	DPU_ASSERT(dpu_probe_start(&probe));
-	#endif
-        // Run all DPUs
-        PRINT_INFO(p.verbosity >= 1, "    Booting DPUs");
-        startTimer(&timer);
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
-        stopTimer(&timer);
-        dpuTime += getElapsedTime(timer);
-        PRINT_INFO(p.verbosity >= 2, "    Level DPU Time: %f ms", getElapsedTime(timer)*1e3);
-	#if ENERGY
-    	DPU_ASSERT(dpu_probe_stop(&probe));
-    	double energy;
-    	DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &energy));
-	tenergy += energy;
-	#endif
-
-
-
-        // Copy back next frontier from all DPUs and compute their union as the current frontier
-        startTimer(&timer);
-        dpuIdx = 0;
-        DPU_FOREACH (dpu_set, dpu) {
-            uint32_t dpuNumNodes = dpuParams[dpuIdx].dpuNumNodes;
+            // Queue parameters (read when the queue is flushed, after the loop)
+            xfer_queue_copy(&queue, DPU_XFER_TO_DPU, dpuIdx, DPU_MRAM_HEAP_POINTER_NAME, dpuParams_m[dpuIdx], (uint8_t*)&dpuParams[dpuIdx], ROUND_UP_TO_MULTIPLE_OF_8(sizeof(struct DPUParams)));
+
+            // Partition edges and copy data
             if(dpuNumNodes > 0) {
-                if(dpuIdx == 0) {
-                    copyFromDPU(dpu, dpuParams[dpuIdx].dpuNextFrontier_m, (uint8_t*)currentFrontier, numNodes/64*sizeof(uint64_t));
-                } else {
-                    copyFromDPU(dpu, dpuParams[dpuIdx].dpuNextFrontier_m, (uint8_t*)nextFrontier, numNodes/64*sizeof(uint64_t));
-                    for(uint32_t i = 0; i < numNodes/64; ++i) {
-                        currentFrontier[i] |= nextFrontier[i];
-                    }
-                }
-                ++dpuIdx;
+
+                // Find DPU's CSR graph partition
+                uint32_t* dpuNodePtrs_h = &nodePtrs[dpuStartNodeIdx];
+                uint32_t dpuNodePtrsOffset = dpuNodePtrs_h[0];
+                uint32_t* dpuNeighborIdxs_h = neighborIdxs + dpuNodePtrsOffset;
+                uint32_t dpuNumNeighbors = dpuNodePtrs_h[dpuNumNodes] - dpuNodePtrsOffset;
+                uint32_t* dpuNodeLevel_h = &nodeLevel[dpuStartNodeIdx];
+
+                // Allocate MRAM (next frontier and visited list first, at the same offsets on every DPU
+                // like the parameters, so that each of their transfers is one push for all DPUs)
+                uint32_t dpuNextFrontier_m = mram_heap_alloc(&allocator, numNodes/64*sizeof(uint64_t));
+                uint32_t dpuVisited_m = mram_heap_alloc(&allocator, numNodes/64*sizeof(uint64_t));
+                uint32_t dpuNodePtrs_m = mram_heap_alloc(&allocator, (dpuNumNodes + 1)*sizeof(uint32_t));
+                uint32_t dpuNeighborIdxs_m = mram_heap_alloc(&allocator, dpuNumNeighbors*sizeof(uint32_t));
+                uint32_t dpuNodeLevel_m = mram_heap_alloc(&allocator, dpuNumNodes*sizeof(uint32_t));
+                uint32_t dpuCurrentFrontier_m = mram_heap_alloc(&allocator, dpuNumNodes/64*sizeof(uint64_t));
+                PRINT_INFO(p.verbosity >= 2, "        Total memory allocated is %d bytes", allocator.totalAllocated);
+
+                // Set up DPU parameters
+                dpuParams[dpuIdx].numNodes = numNodes;
+                dpuParams[dpuIdx].dpuStartNodeIdx = dpuStartNodeIdx;
+                dpuParams[dpuIdx].dpuNodePtrsOffset = dpuNodePtrsOffset;
+                dpuParams[dpuIdx].level = level;
+                dpuParams[dpuIdx].hostFrontier = 0;
+                dpuParams[dpuIdx].dpuNodePtrs_m = dpuNodePtrs_m;
+                dpuParams[dpuIdx].dpuNeighborIdxs_m = dpuNeighborIdxs_m;
+                dpuParams[dpuIdx].dpuNodeLevel_m = dpuNodeLevel_m;
+                dpuParams[dpuIdx].dpuVisited_m = dpuVisited_m;
+                dpuParams[dpuIdx].dpuCurrentFrontier_m = dpuCurrentFrontier_m;
+                dpuParams[dpuIdx].dpuNextFrontier_m = dpuNextFrontier_m;
+
+                // Queue data, in MRAM order
+                PRINT_INFO(p.verbosity >= 2, "        Copying data to DPU");
+                xfer_queue_copy(&queue, DPU_XFER_TO_DPU, dpuIdx, DPU_MRAM_HEAP_POINTER_NAME, dpuNextFrontier_m, (uint8_t*)nextFrontier, ROUND_UP_TO_MULTIPLE_OF_8(numNodes/64*sizeof(uint64_t)));
+                xfer_queue_copy(&queue, DPU_XFER_TO_DPU, dpuIdx, DPU_MRAM_HEAP_POINTER_NAME, dpuVisited_m, (uint8_t*)visited, ROUND_UP_TO_MULTIPLE_OF_8(numNodes/64*sizeof(uint64_t)));
+                xfer_queue_copy(&queue, DPU_XFER_TO_DPU, dpuIdx, DPU_MRAM_HEAP_POINTER_NAME, dpuNodePtrs_m, (uint8_t*)dpuNodePtrs_h, ROUND_UP_TO_MULTIPLE_OF_8((dpuNumNodes + 1)*sizeof(uint32_t)));
+                xfer_queue_copy(&queue, DPU_XFER_TO_DPU, dpuIdx, DPU_MRAM_HEAP_POINTER_NAME, dpuNeighborIdxs_m, (uint8_t*)dpuNeighborIdxs_h, ROUND_UP_TO_MULTIPLE_OF_8(dpuNumNeighbors*sizeof(uint32_t)));
+                xfer_queue_copy(&queue, DPU_XFER_TO_DPU, dpuIdx, DPU_MRAM_HEAP_POINTER_NAME, dpuNodeLevel_m, (uint8_t*)dpuNodeLevel_h, ROUND_UP_TO_MULTIPLE_OF_8(dpuNumNodes*sizeof(uint32_t)));
+                // NOTE: No need to copy current frontier because it is written before being read
+
             }
+
+            ++dpuIdx;
+
         }
 
-        // Check if the next frontier is empty, and copy data to DPU if not empty
-        nextFrontierEmpty = 1;
-        for(uint32_t i = 0; i < numNodes/64; ++i) {
-            if(currentFrontier[i]) {
-                nextFrontierEmpty = 0;
-                break;
+        // Send parameters and data to all DPUs
+        startPhase(&timer, PHASE_C2D);
+        TRACE_BEGIN("xfer", "xfer_queue_flush", -1, -1);
+        xfer_queue_flush(&queue);
+        TRACE_END();
+        stopPhase(&timer, PHASE_C2D);
+        loadTime += getElapsedTime(timer);
+        PRINT_INFO(p.verbosity >= 1, "    CPU-DPU Time: %f ms", loadTime*1e3);
+
+        // Iterate until next frontier is empty
+        nextFrontierEmpty = 0;
+        while(!nextFrontierEmpty) {
+
+            PRINT_INFO(p.verbosity >= 1, "Processing current frontier for level %u", level);
+
+    	#if ENERGY
+    	DPU_ASSERT(dpu_probe_start(&probe));
+    	#endif
+            // Run all DPUs
+            PRINT_INFO(p.verbosity >= 1, "    Booting DPUs");
+            startPhase(&timer, PHASE_DPU);
+            TRACE_BEGIN("launch", "BFS level", level, -1);
+            DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            TRACE_END();
+            stopPhase(&timer, PHASE_DPU);
+            dpuTime += getElapsedTime(timer);
+            PRINT_INFO(p.verbosity >= 2, "    Level DPU Time: %f ms", getElapsedTime(timer)*1e3);
+    	#if ENERGY
+        	DPU_ASSERT(dpu_probe_stop(&probe));
+        	double energy;
+        	DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &energy));
+    	tenergy += energy;
+    	#endif
+
+            // Collect the kernel cycles of the slowest DPU for this level
+            DPU_FOREACH (dpu_set, dpu, dpuIdx) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, &dpuLevelCycles[dpuIdx]));
             }
-        }
-        if(!nextFrontierEmpty) {
-            ++level;
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "kernel_cycles", 0, sizeof(uint64_t), DPU_XFER_DEFAULT));
+            uint64_t levelCycles = 0;
+            for(dpuIdx = 0; dpuIdx < numDPUs; ++dpuIdx) {
+                if(dpuLevelCycles[dpuIdx] > levelCycles) levelCycles = dpuLevelCycles[dpuIdx];
+            }
+            dpuCycles += levelCycles;
+            PRINT_INFO(p.verbosity >= 2, "    Level DPU Cycles: %lu", (unsigned long)levelCycles);
+
+
+            // Copy back next frontier from all DPUs and compute their union as the current frontier
+            startPhase(&timer, PHASE_INTER_DPU);
             dpuIdx = 0;
             DPU_FOREACH (dpu_set, dpu) {
                 uint32_t dpuNumNodes = dpuParams[dpuIdx].dpuNumNodes;
                 if(dpuNumNodes > 0) {
-                    // Copy current frontier to all DPUs (place in next frontier and DPU will update visited and copy to current frontier)
-                    copyToDPU(dpu, (uint8_t*)currentFrontier, dpuParams[dpuIdx].dpuNextFrontier_m, numNodes/64*sizeof(uint64_t));
-                    // Copy new level to DPU
-                    dpuParams[dpuIdx].level = level;
-                    copyToDPU(dpu, (uint8_t*)&dpuParams[dpuIdx], dpuParams_m[dpuIdx], sizeof(struct DPUParams));
+                    if(dpuIdx == 0) {
+                        copyFromDPU(dpu, dpuParams[dpuIdx].dpuNextFrontier_m, (uint8_t*)currentFrontier, numNodes/64*sizeof(uint64_t));
+                    } else {
+                        copyFromDPU(dpu, dpuParams[dpuIdx].dpuNextFrontier_m, (uint8_t*)nextFrontier, numNodes/64*sizeof(uint64_t));
+                        for(uint32_t i = 0; i < numNodes/64; ++i) {
+                            currentFrontier[i] |= nextFrontier[i];
+                        }
+                    }
                     ++dpuIdx;
                 }
             }
-        }
-        stopTimer(&timer);
-        hostTime += getElapsedTime(timer);
-        PRINT_INFO(p.verbosity >= 2, "    Level Inter-DPU Time: %f ms", getElapsedTime(timer)*1e3);
 
-    }
-    PRINT_INFO(p.verbosity >= 1, "DPU Kernel Time: %f ms", dpuTime*1e3);
-    PRINT_INFO(p.verbosity >= 1, "Inter-DPU Time: %f ms", hostTime*1e3);
-    #if ENERGY
-    PRINT_INFO(p.verbosity >= 1, "    DPU Energy: %f J", tenergy);
-    #endif
+            // Check if the next frontier is empty, and copy data to DPU if not empty
+            nextFrontierEmpty = 1;
+            for(uint32_t i = 0; i < numNodes/64; ++i) {
+                if(currentFrontier[i]) {
+                    nextFrontierEmpty = 0;
+                    break;
+                }
+            }
+            if(!nextFrontierEmpty) {
+                ++level;
+                dpuIdx = 0;
+                DPU_FOREACH (dpu_set, dpu) {
+                    uint32_t dpuNumNodes = dpuParams[dpuIdx].dpuNumNodes;
+                    if(dpuNumNodes > 0) {
+                        // Copy new level to DPU
+                        dpuParams[dpuIdx].level = level;
+                        xfer_queue_copy(&queue, DPU_XFER_TO_DPU, dpuIdx, DPU_MRAM_HEAP_POINTER_NAME, dpuParams_m[dpuIdx], (uint8_t*)&dpuParams[dpuIdx], ROUND_UP_TO_MULTIPLE_OF_8(sizeof(struct DPUParams)));
+                        // Copy current frontier to all DPUs (place in next frontier and DPU will update visited and copy to current frontier)
+                        xfer_queue_copy(&queue, DPU_XFER_TO_DPU, dpuIdx, DPU_MRAM_HEAP_POINTER_NAME, dpuParams[dpuIdx].dpuNextFrontier_m, (uint8_t*)currentFrontier, ROUND_UP_TO_MULTIPLE_OF_8(numNodes/64*sizeof(uint64_t)));
+                        ++dpuIdx;
+                    }
+                }
+                TRACE_BEGIN("xfer", "xfer_queue_flush", level, -1);
+                xfer_queue_flush(&queue);
+                TRACE_END();
+            }
+            stopPhase(&timer, PHASE_INTER_DPU);
+            hostTime += getElapsedTime(timer);
+            PRINT_INFO(p.verbosity >= 2, "    Level Inter-DPU Time: %f ms", getElapsedTime(timer)*1e3);
 
-    // Copy back node levels
-    PRINT_INFO(p.verbosity >= 1, "Copying back the result");
-    startTimer(&timer);
-    dpuIdx = 0;
-    DPU_FOREACH (dpu_set, dpu) {
-        uint32_t dpuNumNodes = dpuParams[dpuIdx].dpuNumNodes;
-        if(dpuNumNodes > 0) {
-            uint32_t dpuStartNodeIdx = dpuIdx*numNodesPerDPU;
-            copyFromDPU(dpu, dpuParams[dpuIdx].dpuNodeLevel_m, (uint8_t*)(nodeLevel + dpuStartNodeIdx), dpuNumNodes*sizeof(float));
         }
-        ++dpuIdx;
+        PRINT_INFO(p.verbosity >= 1, "DPU Kernel Time: %f ms", dpuTime*1e3);
+        PRINT_INFO(p.verbosity >= 1, "DPU Kernel Cycles: %lu", (unsigned long)dpuCycles);
+        PRINT_INFO(p.verbosity >= 1, "Inter-DPU Time: %f ms", hostTime*1e3);
+        #if ENERGY
+        PRINT_INFO(p.verbosity >= 1, "    DPU Energy: %f J", tenergy);
+        #endif
+
+        // Copy back node levels
+        PRINT_INFO(p.verbosity >= 1, "Copying back the result");
+        startPhase(&timer, PHASE_D2C);
+        dpuIdx = 0;
+        DPU_FOREACH (dpu_set, dpu) {
+            uint32_t dpuNumNodes = dpuParams[dpuIdx].dpuNumNodes;
+            if(dpuNumNodes > 0) {
+                uint32_t dpuStartNodeIdx = dpuIdx*numNodesPerDPU;
+                copyFromDPU(dpu, dpuParams[dpuIdx].dpuNodeLevel_m, (uint8_t*)(nodeLevel + dpuStartNodeIdx), dpuNumNodes*sizeof(float));
+            }
+            ++dpuIdx;
+        }
+        stopPhase(&timer, PHASE_D2C);
+        retrieveTime += getElapsedTime(timer);
+        PRINT_INFO(p.verbosity >= 1, "    DPU-CPU Time: %f ms", retrieveTime*1e3);
+
+        xferStats = queue.stats;
+        PRINT_INFO(p.verbosity >= 1, "Transfers requested %lu, issued %lu, staged %lu bytes", (unsigned long)xferStats.requested, (unsigned long)xferStats.issued, (unsigned long)xferStats.staged_bytes);
+        xfer_queue_free(&queue);
+
     }
-    stopTimer(&timer);
-    retrieveTime += getElapsedTime(timer);
-    PRINT_INFO(p.verbosity >= 1, "    DPU-CPU Time: %f ms", retrieveTime*1e3);
 
     // Calculating result on CPU
     PRINT_INFO(p.verbosity >= 1, "Calculating result on CPU");
     uint32_t* nodeLevelReference = calloc(numNodes, sizeof(uint32_t)); // Node's BFS level (initially all 0 meaning not reachable)
-    startTimer(&timer);
+    startPhase(&timer, PHASE_CPU);
     memset(nextFrontier, 0, numNodes/64*sizeof(uint64_t));
     setBit(nextFrontier[0], 0); // Initialize frontier to first node
     nextFrontierEmpty = 0;
@@ -292,7 +337,7 @@ int main(int argc, char** argv) {
         }
         ++level;
     }
-    stopTimer(&timer);
+    stopPhase(&timer, PHASE_CPU);
     CPUTime = getElapsedTime(timer);
     PRINT_INFO(p.verbosity >= 1, "CPU Version Time: %f ms", CPUTime*1e3);
     if(p.verbosity == 0) PRINT("CPU Version Time (ms): %f    CPU-DPU Time(ms): %f    DPU Kernel Time (ms): %f    Inter-DPU Time (ms): %f    DPU-CPU Time (ms): %f", CPUTime*1e3, loadTime*1e3, dpuTime*1e3, hostTime*1e3, retrieveTime*1e3);
@@ -329,9 +374,25 @@ int main(int argc, char** argv) {
         update_csv(RESULTS_FILE, TEST_NAME, "U_C2D", loadTime*1e3);
         update_csv(RESULTS_FILE, TEST_NAME, "U_D2C", retrieveTime*1e3);
         update_csv(RESULTS_FILE, TEST_NAME, "UPMEM", dpuTime*1e3);
+        update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)csrGraph.numEdges, (double)numDPUs);
+        if(xferStats.requested) {
+            update_csv(RESULTS_FILE, TEST_NAME, "Xfer_requested", (double)xferStats.requested);
+            update_csv(RESULTS_FILE, TEST_NAME, "Xfer_issued", (double)xferStats.issued);
+        }
+#if PERF_EVENTS
+    {
+        // Host counters of each phase, named after the matching CSV column
+        const char* phaseNames[NUM_PHASES] = {"CPU", "U_C2D", "UPMEM", "Inter-DPU", "U_D2C"};
+        for(int phase = 0; phase < NUM_PHASES; ++phase) {
+            printf("%s ", phaseNames[phase]);
+            prim_perf_print(phase, 1);
+            printf("\n");
+            update_csv_perf_events(RESULTS_FILE, TEST_NAME, phase, 1, phaseNames[phase]);
+        }
+    }
+#endif
 
     // Deallocate data structures
-    freeCOOGraph(cooGraph);
     freeCSRGraph(csrGraph);
     free(nodeLevel);
     free(visited);
@@ -0,0 +1,253 @@
+
+#ifndef _OUT_OF_CORE_H_
+#define _OUT_OF_CORE_H_
+
+// Out-of-core BFS: the graph is split into more edge partitions than DPUs and
+// the partitions are streamed through MRAM on every level. Each DPU keeps the
+// visited list and its next frontier resident, plus one partition slot that
+// the rest of MRAM is left to. Every round loads the next partition of each DPU
+// (the transfers of the ranks proceed in parallel) and then runs it; transfers
+// and launches on a rank execute in order, so a second slot would not overlap
+// them and would only halve the partition size. Only partitions containing
+// frontier nodes are loaded.
+// The host tracks the current frontier, the visited list and the node levels.
+
+#include <dpu.h>
+
+#include "mram-management.h"
+#include "../support/common.h"
+#include "../support/graph.h"
+#include "../support/timer.h"
+#include "../support/utils.h"
+
+struct GraphPartition {
+    uint32_t startNodeIdx; /* First node of the partition (multiple of 64) */
+    uint32_t numNodes; /* Number of nodes in the partition (multiple of 64) */
+    uint32_t numEdges; /* Number of edges leaving the partition's nodes */
+};
+
+// Split the graph into numPartitions ranges of whole 64-node tiles with about the same number of edges
+static struct GraphPartition* partitionGraphByEdges(struct CSRGraph csrGraph, uint32_t numPartitions) {
+    struct GraphPartition* partitions = calloc(numPartitions, sizeof(struct GraphPartition));
+    uint32_t numTiles = csrGraph.numNodes/64;
+    uint64_t edgesPerPartition = ((uint64_t)csrGraph.numEdges + numPartitions - 1)/numPartitions;
+    uint32_t partitionIdx = 0;
+    uint32_t startTileIdx = 0;
+    for(uint32_t tileIdx = 0; tileIdx < numTiles; ++tileIdx) {
+        uint64_t partitionEdges = csrGraph.nodePtrs[(tileIdx + 1)*64] - csrGraph.nodePtrs[startTileIdx*64];
+        if((partitionEdges >= edgesPerPartition && partitionIdx < numPartitions - 1) || tileIdx == numTiles - 1) {
+            partitions[partitionIdx].startNodeIdx = startTileIdx*64;
+            partitions[partitionIdx].numNodes = (tileIdx + 1 - startTileIdx)*64;
+            partitions[partitionIdx].numEdges = (uint32_t)partitionEdges;
+            ++partitionIdx;
+            startTileIdx = tileIdx + 1;
+        }
+    }
+    // Remaining partitions are empty and never loaded
+    return partitions;
+}
+
+static int partitionInFrontier(struct GraphPartition* partition, uint64_t* frontier) {
+    for(uint32_t tileIdx = partition->startNodeIdx/64; tileIdx < (partition->startNodeIdx + partition->numNodes)/64; ++tileIdx) {
+        if(frontier[tileIdx]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void pushToDPUAsync(struct dpu_set_t dpu, void* hostPtr, uint32_t mramIdx, uint32_t size) {
+    if(size > 0) {
+        TRACE_BEGIN("xfer", "pushToDPUAsync", -1, ROUND_UP_TO_MULTIPLE_OF_8(size));
+        DPU_ASSERT(dpu_prepare_xfer(dpu, hostPtr));
+        DPU_ASSERT(dpu_push_xfer(dpu, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, mramIdx, ROUND_UP_TO_MULTIPLE_OF_8(size), DPU_XFER_ASYNC));
+        TRACE_END();
+    }
+}
+
+// Computes node levels (nodeLevel must be zeroed) and accumulates the time spent in each phase
+// (the partition loads of every round count as CPU-DPU time)
+static void bfsOutOfCore(struct dpu_set_t dpu_set, uint32_t numDPUs, struct CSRGraph csrGraph, uint32_t partitionsPerDPU, uint32_t* nodeLevel, unsigned int verbosity,
+        float* loadTime, float* dpuTime, float* hostTime, uint64_t* dpuCycles) {
+
+    Timer timer;
+    struct dpu_set_t dpu;
+    uint32_t numNodes = csrGraph.numNodes;
+    uint32_t numTiles = numNodes/64;
+    uint32_t numPartitions = numDPUs*partitionsPerDPU;
+
+    // Partition the graph (partition i is processed by DPU i%numDPUs)
+    struct GraphPartition* partitions = partitionGraphByEdges(csrGraph, numPartitions);
+    uint32_t maxPartitionNodes = 0, maxPartitionEdges = 0;
+    for(uint32_t i = 0; i < numPartitions; ++i) {
+        if(partitions[i].numNodes > maxPartitionNodes) maxPartitionNodes = partitions[i].numNodes;
+        if(partitions[i].numEdges > maxPartitionEdges) maxPartitionEdges = partitions[i].numEdges;
+    }
+    PRINT_INFO(verbosity >= 1, "Streaming %u partitions (%u per DPU), largest has %u nodes and %u edges", numPartitions, partitionsPerDPU, maxPartitionNodes, maxPartitionEdges);
+
+    // Allocate MRAM (same layout on every DPU): parameters, resident bitmaps, and the partition slot
+    struct mram_heap_allocator_t allocator;
+    init_allocator(&allocator);
+    uint32_t params_m = mram_heap_alloc(&allocator, sizeof(struct DPUParams));
+    uint32_t visited_m = mram_heap_alloc(&allocator, numTiles*sizeof(uint64_t));
+    uint32_t nextFrontier_m = mram_heap_alloc(&allocator, numTiles*sizeof(uint64_t));
+    uint32_t slotNodePtrs_m = mram_heap_alloc(&allocator, (maxPartitionNodes + 1)*sizeof(uint32_t));
+    uint32_t slotNeighborIdxs_m = mram_heap_alloc(&allocator, maxPartitionEdges*sizeof(uint32_t));
+    uint32_t slotCurrentFrontier_m = mram_heap_alloc(&allocator, maxPartitionNodes/64*sizeof(uint64_t));
+    PRINT_INFO(verbosity >= 1, "    Total memory allocated per DPU is %u bytes", allocator.totalAllocated);
+
+    // Host-side BFS state
+    uint64_t* visited = calloc(numTiles, sizeof(uint64_t));
+    uint64_t* currentFrontier = calloc(numTiles, sizeof(uint64_t));
+    uint64_t* nextFrontier = calloc(numTiles, sizeof(uint64_t));
+    uint64_t* dpuNextFrontier = calloc(numTiles, sizeof(uint64_t));
+    setBit(currentFrontier[0], 0); // Initialize frontier to first node
+    setBit(visited[0], 0);
+    nodeLevel[0] = 1;
+    uint32_t level = 1;
+
+    // Per-round state (kept until the asynchronous transfers of the round have completed)
+    struct DPUParams* roundParams = calloc(numDPUs, sizeof(struct DPUParams));
+    uint64_t* roundCycles = calloc(numDPUs, sizeof(uint64_t));
+    uint32_t* activePartitions = malloc(numPartitions*sizeof(uint32_t)); // activePartitions[d*partitionsPerDPU + k] is DPU d's k-th partition to load
+    uint32_t* numActivePartitions = malloc(numDPUs*sizeof(uint32_t));
+    uint64_t streamedBytes = 0, partitionLoads = 0, skippedPartitions = 0;
+
+    uint32_t frontierEmpty = 0;
+    while(!frontierEmpty) {
+
+        PRINT_INFO(verbosity >= 1, "Processing current frontier for level %u", level);
+
+        // Send the visited list and clear the next frontier
+        startPhase(&timer, PHASE_INTER_DPU);
+        TRACE_BEGIN("xfer", "Broadcast visited", level, (int64_t)numTiles*sizeof(uint64_t)*numDPUs);
+        DPU_ASSERT(dpu_broadcast_to(dpu_set, DPU_MRAM_HEAP_POINTER_NAME, visited_m, visited, numTiles*sizeof(uint64_t), DPU_XFER_DEFAULT));
+        TRACE_END();
+        memset(nextFrontier, 0, numTiles*sizeof(uint64_t));
+        TRACE_BEGIN("xfer", "Clear next frontier", level, (int64_t)numTiles*sizeof(uint64_t)*numDPUs);
+        DPU_ASSERT(dpu_broadcast_to(dpu_set, DPU_MRAM_HEAP_POINTER_NAME, nextFrontier_m, nextFrontier, numTiles*sizeof(uint64_t), DPU_XFER_DEFAULT));
+        TRACE_END();
+
+        // Select the partitions with frontier nodes
+        uint32_t numRounds = 0;
+        for(uint32_t d = 0; d < numDPUs; ++d) {
+            numActivePartitions[d] = 0;
+            for(uint32_t k = 0; k < partitionsPerDPU; ++k) {
+                struct GraphPartition* partition = &partitions[k*numDPUs + d];
+                if(partition->numNodes > 0 && partitionInFrontier(partition, currentFrontier)) {
+                    activePartitions[d*partitionsPerDPU + numActivePartitions[d]++] = k*numDPUs + d;
+                } else if(partition->numNodes > 0) {
+                    ++skippedPartitions;
+                }
+            }
+            if(numActivePartitions[d] > numRounds) numRounds = numActivePartitions[d];
+        }
+        stopPhase(&timer, PHASE_INTER_DPU);
+        *hostTime += getElapsedTime(timer);
+        PRINT_INFO(verbosity >= 2, "    Level partition rounds: %u", numRounds);
+
+        // Stream the partitions: every round loads the next active partition of each DPU, then runs it
+        uint64_t levelCycles = 0;
+        float levelLoadTime = 0.0f, levelDpuTime = 0.0f;
+        for(uint32_t r = 0; r < numRounds; ++r) {
+            startPhase(&timer, PHASE_C2D);
+            uint32_t d = 0;
+            DPU_FOREACH (dpu_set, dpu, d) {
+                struct DPUParams* params = &roundParams[d];
+                memset(params, 0, sizeof(struct DPUParams));
+                if(r < numActivePartitions[d]) {
+                    struct GraphPartition* partition = &partitions[activePartitions[d*partitionsPerDPU + r]];
+                    uint32_t* partitionNodePtrs = &csrGraph.nodePtrs[partition->startNodeIdx];
+                    params->dpuNumNodes = partition->numNodes;
+                    params->numNodes = numNodes;
+                    params->dpuStartNodeIdx = partition->startNodeIdx;
+                    params->dpuNodePtrsOffset = partitionNodePtrs[0];
+                    params->level = level;
+                    params->hostFrontier = 1;
+                    params->dpuNodePtrs_m = slotNodePtrs_m;
+                    params->dpuNeighborIdxs_m = slotNeighborIdxs_m;
+                    params->dpuVisited_m = visited_m;
+                    params->dpuCurrentFrontier_m = slotCurrentFrontier_m;
+                    params->dpuNextFrontier_m = nextFrontier_m;
+                    pushToDPUAsync(dpu, partitionNodePtrs, slotNodePtrs_m, (partition->numNodes + 1)*sizeof(uint32_t));
+                    pushToDPUAsync(dpu, csrGraph.neighborIdxs + partitionNodePtrs[0], slotNeighborIdxs_m, partition->numEdges*sizeof(uint32_t));
+                    pushToDPUAsync(dpu, &currentFrontier[partition->startNodeIdx/64], slotCurrentFrontier_m, partition->numNodes/64*sizeof(uint64_t));
+                    streamedBytes += (partition->numNodes + 1)*sizeof(uint32_t) + partition->numEdges*sizeof(uint32_t) + partition->numNodes/8;
+                    ++partitionLoads;
+                }
+                pushToDPUAsync(dpu, params, params_m, sizeof(struct DPUParams));
+            }
+            DPU_ASSERT(dpu_sync(dpu_set));
+            stopPhase(&timer, PHASE_C2D);
+            levelLoadTime += getElapsedTime(timer);
+
+            startPhase(&timer, PHASE_DPU);
+            TRACE_BEGIN("launch", "BFS partition round", level, -1);
+            DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            TRACE_END();
+            stopPhase(&timer, PHASE_DPU);
+            levelDpuTime += getElapsedTime(timer);
+
+            // Kernel cycles of the slowest DPU of the round
+            DPU_FOREACH (dpu_set, dpu, d) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, &roundCycles[d]));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "kernel_cycles", 0, sizeof(uint64_t), DPU_XFER_DEFAULT));
+            uint64_t maxCycles = 0;
+            for(d = 0; d < numDPUs; ++d) {
+                if(roundCycles[d] > maxCycles) maxCycles = roundCycles[d];
+            }
+            levelCycles += maxCycles;
+        }
+        *loadTime += levelLoadTime;
+        *dpuTime += levelDpuTime;
+        *dpuCycles += levelCycles;
+        PRINT_INFO(verbosity >= 2, "    Level CPU-DPU Time: %f ms", levelLoadTime*1e3);
+        PRINT_INFO(verbosity >= 2, "    Level DPU Time: %f ms", levelDpuTime*1e3);
+        PRINT_INFO(verbosity >= 2, "    Level DPU Cycles: %lu", (unsigned long)levelCycles);
+
+        // Merge the next frontiers, filter visited nodes and assign levels
+        startPhase(&timer, PHASE_INTER_DPU);
+        DPU_FOREACH (dpu_set, dpu) {
+            copyFromDPU(dpu, nextFrontier_m, (uint8_t*)dpuNextFrontier, numTiles*sizeof(uint64_t));
+            for(uint32_t i = 0; i < numTiles; ++i) {
+                nextFrontier[i] |= dpuNextFrontier[i];
+            }
+        }
+        ++level;
+        frontierEmpty = 1;
+        for(uint32_t tileIdx = 0; tileIdx < numTiles; ++tileIdx) {
+            uint64_t frontierTile = nextFrontier[tileIdx] & ~visited[tileIdx];
+            currentFrontier[tileIdx] = frontierTile;
+            if(frontierTile) {
+                frontierEmpty = 0;
+                visited[tileIdx] |= frontierTile;
+                for(uint32_t node = tileIdx*64; node < (tileIdx + 1)*64; ++node) {
+                    if(isSet(frontierTile, node%64)) {
+                        nodeLevel[node] = level;
+                    }
+                }
+            }
+        }
+        stopPhase(&timer, PHASE_INTER_DPU);
+        *hostTime += getElapsedTime(timer);
+        PRINT_INFO(verbosity >= 2, "    Level Inter-DPU Time: %f ms", getElapsedTime(timer)*1e3);
+
+    }
+    PRINT_INFO(verbosity >= 1, "Streamed %lu partitions (%lu bytes), skipped %lu partitions without frontier nodes", (unsigned long)partitionLoads, (unsigned long)streamedBytes, (unsigned long)skippedPartitions);
+    PRINT_INFO(verbosity >= 1, "    Streaming bandwidth: %f MB/s", streamedBytes/(*loadTime*1e6));
+
+    free(partitions);
+    free(visited);
+    free(currentFrontier);
+    free(nextFrontier);
+    free(dpuNextFrontier);
+    free(roundParams);
+    free(roundCycles);
+    free(activePartitions);
+    free(numActivePartitions);
+
+}
+
+#endif
+
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+# Per-level kernel cycles of the reference (task) and optimized (task_opt) DPU kernels
+mkdir -p profile
+for g in loc-gowalla roadNet-PA LiveJournal1
+do
+	for j in task task_opt
+	do
+		for k in 8 16
+		do
+			NR_DPUS=64 NR_TASKLETS=$k KERNEL=$j make all
+			wait
+			./bin/host_code -v 2 -f data/${g} > profile/${j}_${g}_tl${k}.txt
+			wait
+			make clean
+			wait
+		done
+	done
+done
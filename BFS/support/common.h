@@ -17,6 +17,7 @@ struct DPUParams {
     uint32_t dpuStartNodeIdx; /* The index of the first node assigned to this DPU  */
     uint32_t dpuNodePtrsOffset; /* Offset of the node pointers */
     uint32_t level; /* The current BFS level */
+    uint32_t hostFrontier; /* Non-zero if the host provides the current frontier and visited list (out-of-core mode) */
     uint32_t dpuNodePtrs_m;
     uint32_t dpuNeighborIdxs_m;
     uint32_t dpuNodeLevel_m;
@@ -25,5 +26,10 @@ struct DPUParams {
     uint32_t dpuNextFrontier_m;
 };
 
+// Host transfer queue merges adjacent transfers (see support/xfer_queue.h)
+#ifndef COALESCE
+#define COALESCE 1
+#endif
+
 #endif
 
@@ -4,6 +4,8 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "common.h"
 #include "utils.h"
@@ -112,5 +114,72 @@ static void freeCSRGraph(struct CSRGraph csrGraph) {
     free(csrGraph.neighborIdxs);
 }
 
+// Binary CSR written by SpMV/data/generate/csrgen (little endian):
+//   char magic[8] = "PRIMCSR1"; uint32_t numRows, numCols, numNonzeros, flags;
+//   uint32_t rowPtrs[numRows + 1]; uint32_t colIdxs[numNonzeros]; float values[numNonzeros] (if flags & 1)
+#define CSR_FILE_MAGIC "PRIMCSR1"
+
+static int isBinaryCSRFile(const char* fileName) {
+    char magic[8];
+    FILE* fp = fopen(fileName, "rb");
+    if(fp == NULL) return 0;
+    int isCSR = (fread(magic, 1, 8, fp) == 8) && (memcmp(magic, CSR_FILE_MAGIC, 8) == 0);
+    fclose(fp);
+    return isCSR;
+}
+
+static void freadOrExit(void* ptr, size_t size, size_t count, FILE* fp, const char* fileName) {
+    if(fread(ptr, size, count, fp) != count) {
+        PRINT_ERROR("Reading graph %s: file is truncated", fileName);
+        exit(1);
+    }
+}
+
+// Edge values (if any) are ignored
+static struct CSRGraph readCSRGraph(const char* fileName) {
+
+    struct CSRGraph csrGraph;
+
+    FILE* fp = fopen(fileName, "rb");
+    if(fp == NULL) {
+        PRINT_ERROR("Cannot open graph %s", fileName);
+        exit(1);
+    }
+    char magic[8];
+    uint32_t header[4];
+    freadOrExit(magic, 1, 8, fp, fileName);
+    freadOrExit(header, sizeof(uint32_t), 4, fp, fileName);
+    uint32_t numRows = header[0], numCols = header[1];
+
+    // Same padding as readCOOGraph: square, multiple of 64 nodes
+    csrGraph.numNodes = (numRows > numCols)? numRows : numCols;
+    if(csrGraph.numNodes%64 != 0) {
+        csrGraph.numNodes += (64 - csrGraph.numNodes%64);
+    }
+    csrGraph.numEdges = header[2];
+    csrGraph.nodePtrs = (uint32_t*) calloc(ROUND_UP_TO_MULTIPLE_OF_2(csrGraph.numNodes + 1), sizeof(uint32_t));
+    csrGraph.neighborIdxs = (uint32_t*)malloc(ROUND_UP_TO_MULTIPLE_OF_8(csrGraph.numEdges*sizeof(uint32_t)));
+    freadOrExit(csrGraph.nodePtrs, sizeof(uint32_t), numRows + 1, fp, fileName);
+    for(uint32_t nodeIdx = numRows + 1; nodeIdx <= csrGraph.numNodes; ++nodeIdx) {
+        csrGraph.nodePtrs[nodeIdx] = csrGraph.numEdges;
+    }
+    freadOrExit(csrGraph.neighborIdxs, sizeof(uint32_t), csrGraph.numEdges, fp, fileName);
+    fclose(fp);
+
+    return csrGraph;
+
+}
+
+// Binary CSR or text COO, chosen by the file contents
+static struct CSRGraph readGraph(const char* fileName) {
+    if(isBinaryCSRFile(fileName)) {
+        return readCSRGraph(fileName);
+    }
+    struct COOGraph cooGraph = readCOOGraph(fileName);
+    struct CSRGraph csrGraph = coo2csr(cooGraph);
+    freeCOOGraph(cooGraph);
+    return csrGraph;
+}
+
 #endif
 
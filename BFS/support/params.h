@@ -10,6 +10,7 @@ static void usage() {
             "\n"
             "\nBenchmark-specific options:"
             "\n    -f <F>    input matrix file name (default=data/roadNet-CA.txt)"
+            "\n    -p <P>    # of graph partitions per DPU (default=1, >1 streams partitions through MRAM every level)"
             "\n"
             "\nGeneral options:"
             "\n    -v <V>    verbosity"
@@ -20,6 +21,7 @@ static void usage() {
 typedef struct Params {
   const char* fileName;
   unsigned int verbosity;
+  unsigned int partitionsPerDPU;
 } Params;
 
 static struct Params input_params(int argc, char **argv) {
@@ -27,11 +29,13 @@ static struct Params input_params(int argc, char **argv) {
     //p.fileName      = "/home/amit.choudhari/eval/prim-benchmarks/BFS/data/LiveJournal1";
     p.fileName      = "./data/LiveJournal1";
     p.verbosity     = 1;
+    p.partitionsPerDPU = 1;
     int opt;
-    while((opt = getopt(argc, argv, "f:v:h")) >= 0) {
+    while((opt = getopt(argc, argv, "f:v:p:h")) >= 0) {
         switch(opt) {
             case 'f': p.fileName    = optarg;       break;
             case 'v': p.verbosity   = atoi(optarg); break;
+            case 'p': p.partitionsPerDPU = atoi(optarg); break;
             case 'h': usage(); exit(0);
             default:
                       PRINT_ERROR("Unrecognized option!");
@@ -40,6 +44,8 @@ static struct Params input_params(int argc, char **argv) {
         }
     }
 
+    assert(p.partitionsPerDPU >= 1 && "Invalid # of partitions per DPU!");
+
     return p;
 }
 
@@ -0,0 +1,141 @@
+#ifndef PRIM_RAPL_H
+#define PRIM_RAPL_H
+
+// Header-only CPU energy measurement through the Linux powercap RAPL interface.
+// - Package energy is the sum of all intel-rapl:<socket> zones, DRAM energy the sum of
+//   their "dram" subzones (AMD processors expose the package zones under the same name)
+// - Counters are sampled at start/stop and accumulated per slot, like the Timer
+// - If the zones are missing or not readable (energy_uj is root-only on recent kernels,
+//   VMs and containers usually hide it), energy is reported as n/a
+//
+// Usage:
+//   Energy energy;
+//   energy_start(&energy, 0, rep);  ...  energy_stop(&energy, 0);
+//   printf("Energy "); energy_print(&energy, 0, n_reps, nr_elements);
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef PRIM_RAPL_PATH
+#define PRIM_RAPL_PATH "/sys/class/powercap"
+#endif
+#define PRIM_RAPL_MAX_ZONES 16
+#define PRIM_RAPL_MAX_SLOTS 7
+#define PRIM_RAPL_PATH_LEN 512
+
+enum { RAPL_PACKAGE, RAPL_DRAM, RAPL_NR_DOMAINS };
+static const char *const RAPL_DOMAIN_NAMES[RAPL_NR_DOMAINS] = { "package", "dram" };
+
+typedef struct {
+    int initialized;
+    int nr_zones;
+    int domain[PRIM_RAPL_MAX_ZONES];
+    char path[PRIM_RAPL_MAX_ZONES][PRIM_RAPL_PATH_LEN]; // .../energy_uj
+    uint64_t max_range[PRIM_RAPL_MAX_ZONES]; // Microjoules before the counter wraps around
+} prim_rapl_zones_t;
+
+static prim_rapl_zones_t prim_rapl_zones;
+
+typedef struct Energy {
+    uint64_t begin[PRIM_RAPL_MAX_SLOTS][PRIM_RAPL_MAX_ZONES];
+    double joules[PRIM_RAPL_MAX_SLOTS][RAPL_NR_DOMAINS];
+} Energy;
+
+static int rapl_read_u64(const char *path, uint64_t *value) {
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+    unsigned long long v;
+    int ok = (fscanf(f, "%llu", &v) == 1);
+    fclose(f);
+    if (ok) *value = (uint64_t)v;
+    return ok;
+}
+
+static void rapl_add_zone(const char *zone, int domain) {
+    prim_rapl_zones_t *z = &prim_rapl_zones;
+    if (z->nr_zones == PRIM_RAPL_MAX_ZONES) return;
+    char path[PRIM_RAPL_PATH_LEN];
+    uint64_t value;
+    snprintf(path, sizeof(path), "%s/%s/max_energy_range_uj", PRIM_RAPL_PATH, zone);
+    if (!rapl_read_u64(path, &z->max_range[z->nr_zones])) z->max_range[z->nr_zones] = 0;
+    snprintf(z->path[z->nr_zones], sizeof(z->path[0]), "%s/%s/energy_uj", PRIM_RAPL_PATH, zone);
+    if (!rapl_read_u64(z->path[z->nr_zones], &value)) return; // Present but not readable
+    if (z->max_range[z->nr_zones] == 0)
+        fprintf(stderr, "[WARNING] RAPL zone %s has no max_energy_range_uj, intervals in which its counter wraps around are dropped\n", zone);
+    z->domain[z->nr_zones++] = domain;
+}
+
+static void rapl_init(void) {
+    prim_rapl_zones_t *z = &prim_rapl_zones;
+    z->initialized = 1;
+    z->nr_zones = 0;
+    DIR *dir = opendir(PRIM_RAPL_PATH);
+    if (dir) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            // Package zones are intel-rapl:<socket>, their subzones intel-rapl:<socket>:<n>
+            unsigned int socket, sub;
+            char tail;
+            char path[PRIM_RAPL_PATH_LEN], name[32];
+            int depth;
+            if (sscanf(entry->d_name, "intel-rapl:%u:%u%c", &socket, &sub, &tail) == 2) depth = 2;
+            else if (sscanf(entry->d_name, "intel-rapl:%u%c", &socket, &tail) == 1) depth = 1;
+            else continue;
+            snprintf(path, sizeof(path), "%s/%s/name", PRIM_RAPL_PATH, entry->d_name);
+            FILE *f = fopen(path, "r");
+            if (!f) continue;
+            if (fscanf(f, "%31s", name) != 1) name[0] = '\0';
+            fclose(f);
+            if (depth == 1 && strncmp(name, "package", 7) == 0) rapl_add_zone(entry->d_name, RAPL_PACKAGE);
+            else if (depth == 2 && strcmp(name, "dram") == 0) rapl_add_zone(entry->d_name, RAPL_DRAM);
+        }
+        closedir(dir);
+    }
+    if (z->nr_zones == 0)
+        fprintf(stderr, "[WARNING] RAPL energy counters in %s are not readable, energy is not reported\n", PRIM_RAPL_PATH);
+}
+
+static int rapl_available(int domain) {
+    for (int k = 0; k < prim_rapl_zones.nr_zones; k++)
+        if (prim_rapl_zones.domain[k] == domain) return 1;
+    return 0;
+}
+
+static void energy_start(Energy *energy, int i, int rep) {
+    if (!prim_rapl_zones.initialized) rapl_init();
+    if (rep == 0) memset(energy->joules[i], 0, sizeof(energy->joules[i]));
+    for (int k = 0; k < prim_rapl_zones.nr_zones; k++)
+        if (!rapl_read_u64(prim_rapl_zones.path[k], &energy->begin[i][k])) energy->begin[i][k] = 0;
+}
+
+static void energy_stop(Energy *energy, int i) {
+    for (int k = 0; k < prim_rapl_zones.nr_zones; k++) {
+        uint64_t end;
+        if (!rapl_read_u64(prim_rapl_zones.path[k], &end)) continue;
+        // A wrap-around cannot be corrected without the range of the counter
+        if (end < energy->begin[i][k] && prim_rapl_zones.max_range[k] == 0) continue;
+        uint64_t delta = (end >= energy->begin[i][k]) ? end - energy->begin[i][k]
+                                                      : end + prim_rapl_zones.max_range[k] - energy->begin[i][k];
+        energy->joules[i][prim_rapl_zones.domain[k]] += delta / 1e6;
+    }
+}
+
+// Average energy in joules of one repetition of slot i (negative if unavailable)
+static double energy_joules(Energy *energy, int i, int domain, int reps) {
+    if (!rapl_available(domain)) return -1.0;
+    return energy->joules[i][domain] / (reps > 0 ? reps : 1);
+}
+
+static void energy_print(Energy *energy, int i, int reps, uint64_t nr_elements) {
+    for (int d = 0; d < RAPL_NR_DOMAINS; d++) {
+        double joules = energy_joules(energy, i, d, reps);
+        if (joules < 0.0)
+            printf("%s: n/a\t", RAPL_DOMAIN_NAMES[d]);
+        else
+            printf("%s: %f J (%e J/element)\t", RAPL_DOMAIN_NAMES[d], joules, nr_elements ? joules / nr_elements : 0.0);
+    }
+}
+
+#endif // PRIM_RAPL_H
@@ -5,6 +5,11 @@
 #include <stdio.h>
 #include <sys/time.h>
 
+#if PERF_EVENTS
+#include "perf_events.h"
+#endif
+#include "trace.h"
+
 typedef struct Timer {
     struct timeval startTime;
     struct timeval endTime;
@@ -23,5 +28,33 @@ static float getElapsedTime(Timer timer) {
                    + (timer.endTime.tv_usec - timer.startTime.tv_usec)/1.0e6));
 }
 
+// Host phases, which accumulate the optional hardware counters (PERF_EVENTS=1) across levels
+// and appear as host events in the optional trace (TRACE=1)
+enum HostPhase { PHASE_CPU, PHASE_C2D, PHASE_DPU, PHASE_INTER_DPU, PHASE_D2C, NUM_PHASES };
+
+#if TRACE
+static const char* const PHASE_NAMES[NUM_PHASES] = { "CPU", "CPU-DPU", "DPU Kernel", "Inter-DPU", "DPU-CPU" };
+#endif
+
+static void startPhase(Timer* timer, enum HostPhase phase) {
+    TRACE_BEGIN("host", PHASE_NAMES[phase], -1, -1);
+#if PERF_EVENTS
+    prim_perf_start(phase, 1);
+#else
+    (void) phase;
+#endif
+    startTimer(timer);
+}
+
+static void stopPhase(Timer* timer, enum HostPhase phase) {
+    stopTimer(timer);
+#if PERF_EVENTS
+    prim_perf_stop(phase);
+#else
+    (void) phase;
+#endif
+    TRACE_END();
+}
+
 #endif
 
@@ -0,0 +1,141 @@
+/**
+* @file bitmap.c
+* @brief Bitmap index queries on the CPU: the columns and queries of the DPU version, AVX2
+* word operations and popcount, OpenMP over chunks of words
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include <omp.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include "../../support/timer.h"
+#include "../../support/rapl.h"
+#include "../../support/params.h"
+#include "../../support/bitmaps.h"
+
+// Words evaluated at a time by a thread, kept in L1
+#define CHUNK 2048
+
+#if defined(__AVX2__)
+// Popcount of the 64-bit lanes by 4-bit table lookups (Mula), summed with SAD
+static inline __m256i popcount256(__m256i v) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low));
+    __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+/**
+* @brief evaluates a query over words [first, first + n) with 256-bit operations, n a multiple of 4
+*/
+static uint64_t bitmap_eval_avx2(uint64_t *acc, const uint64_t *bitmaps, uint64_t stride, const query_t *query, uint64_t first, uint64_t n) {
+    memcpy(acc, bitmaps + query->column[0] * stride + first, n * sizeof(uint64_t));
+    for (uint32_t i = 1; i < MAX_OPERANDS && query->op[i] != OP_END; i++) {
+        const uint64_t *column = bitmaps + query->column[i] * stride + first;
+        for (uint64_t w = 0; w < n; w += 4) {
+            __m256i a = _mm256_loadu_si256((const __m256i *) (acc + w));
+            __m256i b = _mm256_loadu_si256((const __m256i *) (column + w));
+            a = query->op[i] == OP_OR ? _mm256_or_si256(a, b) : query->op[i] == OP_AND ? _mm256_and_si256(a, b) : _mm256_andnot_si256(b, a);
+            _mm256_storeu_si256((__m256i *) (acc + w), a);
+        }
+    }
+    __m256i sum = _mm256_setzero_si256();
+    for (uint64_t w = 0; w < n; w += 4)
+        sum = _mm256_add_epi64(sum, popcount256(_mm256_loadu_si256((const __m256i *) (acc + w))));
+    return (uint64_t) _mm256_extract_epi64(sum, 0) + _mm256_extract_epi64(sum, 1) + _mm256_extract_epi64(sum, 2) + _mm256_extract_epi64(sum, 3);
+}
+#endif
+
+/**
+* @brief popcount of every query, one chunk of words per iteration
+*/
+static void bitmap(uint64_t *counts, const uint64_t *bitmaps, uint64_t n_words, const query_t *queries, uint32_t n_queries, int t) {
+    omp_set_num_threads(t);
+    for (uint32_t q = 0; q < n_queries; q++) {
+        uint64_t count = 0;
+        #pragma omp parallel reduction(+:count)
+        {
+            uint64_t acc[CHUNK] __attribute__((aligned(32)));
+            #pragma omp for schedule(static)
+            for (uint64_t first = 0; first < n_words; first += CHUNK) {
+                uint64_t n = first + CHUNK <= n_words ? CHUNK : n_words - first;
+#if defined(__AVX2__)
+                uint64_t n_vec = n & ~3ULL;
+                count += bitmap_eval_avx2(acc, bitmaps, n_words, &queries[q], first, n_vec);
+                if (n_vec < n)
+                    count += bitmap_eval(acc, bitmaps, n_words, &queries[q], first + n_vec, n - n_vec);
+#else
+                count += bitmap_eval(acc, bitmaps, n_words, &queries[q], first, n);
+#endif
+            }
+        }
+        counts[q] = count;
+    }
+}
+
+/**
+* @brief Main of the CPU baseline.
+*/
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    const uint64_t n_words = divceil((uint64_t) p.n_rows, 64);
+    uint64_t *bitmaps = (uint64_t *) malloc(p.n_columns * n_words * sizeof(uint64_t));
+    query_t *queries = (query_t *) malloc(p.n_queries * sizeof(query_t));
+    uint64_t *counts = (uint64_t *) malloc(p.n_queries * sizeof(uint64_t));
+    generate_bitmaps(bitmaps, p.n_columns, n_words, p.n_rows);
+    generate_queries(queries, p.n_queries, p.n_operands, p.n_columns);
+    printf("Rows %u, columns %u (%lu MB), queries %u x %u operands, %s kernel\n", p.n_rows, p.n_columns,
+            (unsigned long) ((p.n_columns * n_words * sizeof(uint64_t)) >> 20), p.n_queries, p.n_operands,
+#if defined(__AVX2__)
+            "AVX2"
+#else
+            "scalar"
+#endif
+            );
+
+    Timer timer;
+    Energy energy;
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+        if (rep >= p.n_warmup) {
+            energy_start(&energy, 0, rep - p.n_warmup);
+            start(&timer, 0, rep - p.n_warmup);
+        }
+        bitmap(counts, bitmaps, n_words, queries, p.n_queries, p.n_threads);
+        if (rep >= p.n_warmup) {
+            stop(&timer, 0);
+            energy_stop(&energy, 0);
+        }
+    }
+
+    uint64_t checksum = 0;
+    for (uint32_t q = 0; q < p.n_queries; q++)
+        checksum += counts[q];
+
+    const double operand_words = (double) p.n_queries * p.n_operands * n_words;
+    printf("Kernel ");
+    print(&timer, 0, p.n_reps);
+    printf("\n");
+    printf("Operand GB/s: %f\tChecksum: %lu\n", operand_words * sizeof(uint64_t) / (timer.time[0] / p.n_reps * 1e3), (unsigned long) checksum);
+    printf("Energy ");
+    energy_print(&energy, 0, p.n_reps, (uint64_t) operand_words);
+    printf("\n");
+
+    free(bitmaps);
+    free(queries);
+    free(counts);
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+* Bitmap index queries with multiple tasklets
+* Every tasklet evaluates the queries over its blocks of words: the first column of a
+* query is read into the result block and every other column is combined with 64-bit
+* word operations, then the block is counted or written back
+*
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <barrier.h>
+
+#include "../support/common.h"
+
+__host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+__host query_t DPU_QUERIES[MAX_QUERIES];
+__host uint64_t DPU_RESULTS[MAX_QUERIES]; // Popcount of every query over the rows of this DPU
+
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+// Popcounts of every tasklet
+static uint64_t counts[NR_TASKLETS][MAX_QUERIES];
+
+// main
+int main() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){
+        mem_reset(); // Reset the heap
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    uint32_t n_words = DPU_INPUT_ARGUMENTS.n_words;
+    uint32_t column_bytes = DPU_INPUT_ARGUMENTS.column_bytes;
+    uint32_t n_queries = DPU_INPUT_ARGUMENTS.n_queries;
+    uint32_t output = DPU_INPUT_ARGUMENTS.output;
+
+    // Address of the columns and results in MRAM
+    uint32_t mram_base_addr_C = (uint32_t)DPU_MRAM_HEAP_POINTER;
+    uint32_t mram_base_addr_R = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.result_offset);
+
+    // Initialize a local cache for the result block and for the block of a column
+    uint64_t *cache_A = (uint64_t *) mem_alloc(BLOCK_SIZE);
+    uint64_t *cache_B = (uint64_t *) mem_alloc(BLOCK_SIZE);
+    const uint32_t words_per_block = BLOCK_SIZE >> 3;
+
+    for (unsigned int q = 0; q < n_queries; q++) {
+        const query_t *query = &DPU_QUERIES[q];
+        uint64_t count = 0;
+
+        for(unsigned int first = tasklet_id * words_per_block; first < n_words; first += words_per_block * NR_TASKLETS){
+
+            // Bound checking
+            uint32_t n = first + words_per_block <= n_words ? words_per_block : n_words - first;
+            uint32_t l_size_bytes = n << 3;
+
+            // Load cache with the first column, then combine the others
+            mram_read((__mram_ptr void const*)(mram_base_addr_C + query->column[0] * column_bytes + (first << 3)), cache_A, l_size_bytes);
+            for (unsigned int i = 1; i < MAX_OPERANDS && query->op[i] != OP_END; i++) {
+                mram_read((__mram_ptr void const*)(mram_base_addr_C + query->column[i] * column_bytes + (first << 3)), cache_B, l_size_bytes);
+                switch (query->op[i]) {
+                    case OP_OR:
+                        for (unsigned int w = 0; w < n; w++)
+                            cache_A[w] |= cache_B[w];
+                        break;
+                    case OP_AND:
+                        for (unsigned int w = 0; w < n; w++)
+                            cache_A[w] &= cache_B[w];
+                        break;
+                    case OP_ANDNOT:
+                        for (unsigned int w = 0; w < n; w++)
+                            cache_A[w] &= ~cache_B[w];
+                        break;
+                }
+            }
+
+            if (output == OUTPUT_BITMAP) {
+                // Write cache to current MRAM block
+                mram_write(cache_A, (__mram_ptr void*)(mram_base_addr_R + q * column_bytes + (first << 3)), l_size_bytes);
+            } else {
+                for (unsigned int w = 0; w < n; w++)
+                    count += __builtin_popcountll(cache_A[w]);
+            }
+        }
+        counts[tasklet_id][q] = count;
+    }
+
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    // Add up the popcounts of the tasklets
+    if (tasklet_id == 0) {
+        for (unsigned int q = 0; q < n_queries; q++) {
+            uint64_t count = 0;
+            for (unsigned int t = 0; t < NR_TASKLETS; t++)
+                count += counts[t][q];
+            DPU_RESULTS[q] = count;
+        }
+    }
+
+    return 0;
+}
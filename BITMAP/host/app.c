@@ -0,0 +1,272 @@
+/**
+* app.c
+* BITMAP Host Application Source File
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <omp.h>
+
+#include "../support/common.h"
+#include "../support/timer.h"
+#include "../support/params.h"
+#include "../support/bitmaps.h"
+#include "../support/prim_results.h"
+
+#if ENERGY
+#include <dpu_probe.h>
+#endif
+
+// Define the DPU Binary path as DPU_BINARY here
+#ifndef DPU_BINARY
+#define DPU_BINARY "./bin/bitmap_dpu"
+#endif
+
+// Words evaluated at a time by a host thread
+#define HOST_CHUNK 4096
+
+// Queries on the host CPU; the chunks of every query are spread over the threads
+static void bitmap_host(uint64_t *counts, uint64_t *results, const uint64_t *bitmaps, uint64_t stride, uint64_t n_words,
+        const query_t *queries, uint32_t n_queries, unsigned int n_threads) {
+    for (uint32_t q = 0; q < n_queries; q++) {
+        uint64_t count = 0;
+        #pragma omp parallel num_threads(n_threads) reduction(+:count)
+        {
+            uint64_t *acc = (uint64_t *) malloc(HOST_CHUNK * sizeof(uint64_t));
+            #pragma omp for schedule(static)
+            for (uint64_t first = 0; first < n_words; first += HOST_CHUNK) {
+                uint64_t n = first + HOST_CHUNK <= n_words ? HOST_CHUNK : n_words - first;
+                count += bitmap_eval(results ? results + q * stride + first : acc, bitmaps, stride, &queries[q], first, n);
+            }
+            free(acc);
+        }
+        counts[q] = count;
+    }
+}
+
+// Main of the Host Application
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+    struct dpu_set_t dpu_set, dpu;
+    uint32_t nr_of_dpus;
+
+#if ENERGY
+    struct dpu_probe_t probe;
+    DPU_ASSERT(dpu_probe_init("energy_probe", &probe));
+#endif
+
+    // Allocate DPUs and load binary
+    DPU_ASSERT(dpu_alloc(NR_DPUS, NULL, &dpu_set));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
+    printf("Allocated %d DPU(s)\n", nr_of_dpus);
+    printf("NR_TASKLETS\t%d\tBL\t%d\n", NR_TASKLETS, BL);
+
+    // Every DPU holds words_per_dpu consecutive words of every column; the columns are padded
+    // with zero words to whole DPUs, which leaves every query result unchanged
+    const uint64_t n_words = divceil((uint64_t) p.n_rows, 64);
+    const uint32_t words_per_dpu = divceil(n_words, nr_of_dpus);
+    const uint64_t stride = (uint64_t) words_per_dpu * nr_of_dpus;
+    const bool bitmap_output = p.output == OUTPUT_BITMAP;
+    uint64_t *bitmaps = (uint64_t *) malloc(p.n_columns * stride * sizeof(uint64_t));
+    query_t *queries = (query_t *) malloc(p.n_queries * sizeof(query_t));
+    uint64_t *counts_host = (uint64_t *) malloc(p.n_queries * sizeof(uint64_t));
+    uint64_t *counts = (uint64_t *) malloc(p.n_queries * sizeof(uint64_t));
+    uint64_t *results_host = bitmap_output ? (uint64_t *) malloc(p.n_queries * stride * sizeof(uint64_t)) : NULL;
+    uint64_t *results = bitmap_output ? (uint64_t *) malloc(p.n_queries * stride * sizeof(uint64_t)) : NULL;
+    uint64_t *dpu_counts = (uint64_t *) malloc((uint64_t) nr_of_dpus * p.n_queries * sizeof(uint64_t));
+    generate_bitmaps(bitmaps, p.n_columns, stride, p.n_rows);
+    generate_queries(queries, p.n_queries, p.n_operands, p.n_columns);
+    printf("Rows %u, columns %u (%lu MB), queries %u x %u operands, %s\n", p.n_rows, p.n_columns,
+            (unsigned long) ((p.n_columns * n_words * sizeof(uint64_t)) >> 20), p.n_queries, p.n_operands,
+            bitmap_output ? "result bitmaps" : "popcounts");
+
+    // Timer
+    Timer timer;
+
+    // Load the columns once
+    start(&timer, 4, 0);
+    const uint32_t column_bytes = words_per_dpu * sizeof(uint64_t);
+    assert((uint64_t) column_bytes * (p.n_columns + (bitmap_output ? p.n_queries : 0)) <= DPU_CAPACITY && "Columns do not fit in MRAM, use more DPUs!");
+    unsigned int i = 0;
+    for (uint32_t c = 0; c < p.n_columns; c++) {
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, bitmaps + c * stride + (uint64_t) words_per_dpu * i));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, c * column_bytes, column_bytes, DPU_XFER_DEFAULT));
+    }
+    stop(&timer, 4);
+
+    dpu_arguments_t *input_args = (dpu_arguments_t *) malloc(nr_of_dpus * sizeof(dpu_arguments_t));
+    for (i = 0; i < nr_of_dpus; i++) {
+        uint64_t first = (uint64_t) words_per_dpu * i;
+        input_args[i].n_words = first >= n_words ? 0 : first + words_per_dpu <= n_words ? words_per_dpu : n_words - first;
+        input_args[i].column_bytes = column_bytes;
+        input_args[i].n_columns = p.n_columns;
+        input_args[i].n_queries = p.n_queries;
+        input_args[i].output = p.output;
+        input_args[i].result_offset = p.n_columns * column_bytes;
+    }
+#if ENERGY
+    double tavg_energy=0;
+#endif
+
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+
+        if (rep >= p.n_warmup)
+            start(&timer, 0, rep - p.n_warmup);
+        // Computation on host CPU
+        bitmap_host(counts_host, results_host, bitmaps, stride, n_words, queries, p.n_queries, p.n_threads);
+        if (rep >= p.n_warmup)
+            stop(&timer, 0);
+
+        if (rep >= p.n_warmup)
+            start(&timer, 1, rep - p.n_warmup);
+        // Copy input arguments to DPUs and broadcast the queries
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+        DPU_ASSERT(dpu_broadcast_to(dpu_set, "DPU_QUERIES", 0, queries, p.n_queries * sizeof(query_t), DPU_XFER_DEFAULT));
+        if (rep >= p.n_warmup)
+            stop(&timer, 1);
+
+#if ENERGY
+        if (rep >= p.n_warmup) {
+            DPU_ASSERT(dpu_probe_start(&probe));
+        }
+#endif
+        if (rep >= p.n_warmup)
+            start(&timer, 2, rep - p.n_warmup);
+        // Launch kernel on DPUs
+        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+        if (rep >= p.n_warmup)
+            stop(&timer, 2);
+#if ENERGY
+        if (rep >= p.n_warmup) {
+            DPU_ASSERT(dpu_probe_stop(&probe));
+            double avg_energy;
+            DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &avg_energy));
+            tavg_energy += avg_energy;
+        }
+#endif
+
+#if PRINT
+        // Display DPU Logs
+        DPU_FOREACH(dpu_set, dpu) {
+            DPU_ASSERT(dpulog_read_for_dpu(dpu.dpu, stdout));
+        }
+#endif
+
+        if (rep >= p.n_warmup)
+            start(&timer, 3, rep - p.n_warmup);
+        if (bitmap_output) {
+            // The row ranges of the DPUs are consecutive: every DPU writes its words in place
+            for (uint32_t q = 0; q < p.n_queries; q++) {
+                DPU_FOREACH(dpu_set, dpu, i) {
+                    DPU_ASSERT(dpu_prepare_xfer(dpu, results + q * stride + (uint64_t) words_per_dpu * i));
+                }
+                DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, input_args[0].result_offset + q * column_bytes, column_bytes, DPU_XFER_DEFAULT));
+            }
+        } else {
+            // Add up the popcounts of the DPUs
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_counts + (uint64_t) p.n_queries * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "DPU_RESULTS", 0, p.n_queries * sizeof(uint64_t), DPU_XFER_DEFAULT));
+            for (uint32_t q = 0; q < p.n_queries; q++) {
+                counts[q] = 0;
+                for (i = 0; i < nr_of_dpus; i++)
+                    counts[q] += dpu_counts[(uint64_t) p.n_queries * i + q];
+            }
+        }
+        if (rep >= p.n_warmup)
+            stop(&timer, 3);
+
+    }
+
+    // Print timing results
+    printf("CPU version ");
+    print(&timer, 0, p.n_reps);
+    printf("CPU-DPU ");
+    print(&timer, 1, p.n_reps);
+    printf("DPU Kernel ");
+    print(&timer, 2, p.n_reps);
+    printf("DPU-CPU ");
+    print(&timer, 3, p.n_reps);
+    printf("Column load ");
+    print(&timer, 4, 1);
+    printf("\n");
+
+    // Operand words streamed per second
+    const double operand_words = (double) p.n_queries * p.n_operands * n_words;
+    double gbs_cpu = operand_words * sizeof(uint64_t) / (prim_timer_ms_avg(&timer, 0, p.n_reps) * 1e6);
+    double gbs_dpu = operand_words * sizeof(uint64_t) / (prim_timer_ms_avg(&timer, 2, p.n_reps) * 1e6);
+    printf("Operand GB/s CPU (%u threads): %f\tDPU Kernel: %f\n", p.n_threads, gbs_cpu, gbs_dpu);
+
+    // update CSV
+#define TEST_NAME "BITMAP"
+#define RESULTS_FILE "../prim_results.csv"
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 0, p.n_reps, "CPU");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    // Elements are the operand words
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, operand_words, (double)nr_of_dpus);
+    update_csv(RESULTS_FILE, TEST_NAME, "GBs_CPU", gbs_cpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "GBs_DPU", gbs_dpu);
+
+#if ENERGY
+    printf("DPU Energy (J): %f \t ", tavg_energy / p.n_reps);
+#endif
+
+    // Check output
+    bool status = true;
+    if (bitmap_output) {
+        for (uint32_t q = 0; q < p.n_queries; q++) {
+            for (uint64_t w = 0; w < n_words; w++) {
+                if (results_host[q * stride + w] != results[q * stride + w]) {
+                    status = false;
+#if PRINT
+                    printf("Query %u word %lu: %016lx -- %016lx\n", q, w, results_host[q * stride + w], results[q * stride + w]);
+#endif
+                }
+            }
+        }
+    } else {
+        for (uint32_t q = 0; q < p.n_queries; q++) {
+            if (counts_host[q] != counts[q]) {
+                status = false;
+#if PRINT
+                printf("Query %u: %lu -- %lu\n", q, counts_host[q], counts[q]);
+#endif
+            }
+        }
+    }
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    free(bitmaps);
+    free(queries);
+    free(counts_host);
+    free(counts);
+    free(results_host);
+    free(results);
+    free(dpu_counts);
+    free(input_args);
+    DPU_ASSERT(dpu_free(dpu_set));
+
+    return status ? 0 : -1;
+}
@@ -0,0 +1,87 @@
+#ifndef _BITMAPS_H_
+#define _BITMAPS_H_
+
+// Host-side column and query generator and the scalar query evaluation, shared by the
+// host application and the CPU baseline. Column c of a bitmap array starts at c * stride.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+// xorshift64*: the same columns and queries for every run, host and baseline alike
+static inline uint64_t bm_rand(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+// Column c has a density of 1/2, 1/4, 1/8 or 1/16 of set bits (c % 4); the words past the
+// last row are zero
+static void generate_bitmaps(uint64_t *bitmaps, uint32_t n_columns, uint64_t stride, uint64_t n_rows) {
+    uint64_t s = 0x853C49E6748FEA9BULL;
+    uint64_t n_words = divceil(n_rows, 64);
+    for (uint32_t c = 0; c < n_columns; c++) {
+        uint64_t *column = bitmaps + c * stride;
+        for (uint64_t w = 0; w < n_words; w++) {
+            uint64_t word = bm_rand(&s);
+            for (uint32_t d = 0; d < c % 4; d++)
+                word &= bm_rand(&s);
+            column[w] = word;
+        }
+        if (n_rows % 64)
+            column[n_words - 1] &= (1ULL << (n_rows % 64)) - 1;
+        memset(column + n_words, 0, (stride - n_words) * sizeof(uint64_t));
+    }
+}
+
+// Queries over n_operands distinct columns, with random operators after the first
+static void generate_queries(query_t *queries, uint32_t n_queries, uint32_t n_operands, uint32_t n_columns) {
+    uint64_t s = 0x9E3779B97F4A7C15ULL;
+    static const uint8_t ops[] = {OP_AND, OP_OR, OP_ANDNOT};
+    for (uint32_t q = 0; q < n_queries; q++) {
+        for (uint32_t i = 0; i < MAX_OPERANDS; i++) {
+            queries[q].op[i] = OP_END;
+            queries[q].column[i] = 0;
+        }
+        for (uint32_t i = 0; i < n_operands; i++) {
+            uint32_t c, j;
+            do {
+                c = bm_rand(&s) % n_columns;
+                for (j = 0; j < i && queries[q].column[j] != c; j++)
+                    ;
+            } while (j < i);
+            queries[q].op[i] = i == 0 ? OP_OR : ops[bm_rand(&s) % 3];
+            queries[q].column[i] = c;
+        }
+    }
+}
+
+// Evaluates a query over words [first, first + n) into acc and returns its popcount
+static uint64_t bitmap_eval(uint64_t *acc, const uint64_t *bitmaps, uint64_t stride, const query_t *query, uint64_t first, uint64_t n) {
+    memcpy(acc, bitmaps + query->column[0] * stride + first, n * sizeof(uint64_t));
+    for (uint32_t i = 1; i < MAX_OPERANDS && query->op[i] != OP_END; i++) {
+        const uint64_t *column = bitmaps + query->column[i] * stride + first;
+        switch (query->op[i]) {
+            case OP_OR:
+                for (uint64_t w = 0; w < n; w++)
+                    acc[w] |= column[w];
+                break;
+            case OP_AND:
+                for (uint64_t w = 0; w < n; w++)
+                    acc[w] &= column[w];
+                break;
+            case OP_ANDNOT:
+                for (uint64_t w = 0; w < n; w++)
+                    acc[w] &= ~column[w];
+                break;
+        }
+    }
+    uint64_t count = 0;
+    for (uint64_t w = 0; w < n; w++)
+        count += __builtin_popcountll(acc[w]);
+    return count;
+}
+#endif
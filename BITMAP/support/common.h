@@ -0,0 +1,65 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+// Bitmap index: every column of the index is a bitmap over the rows, and the columns are
+// partitioned by row range across the DPUs. A query is a boolean expression over several
+// columns, evaluated in one pass over their words; every DPU returns the popcount of its
+// rows, or their result bitmap, and the host adds up or concatenates them.
+
+// Transfer size between MRAM and WRAM (blocks of 64-bit words)
+#ifdef BL
+#define BLOCK_SIZE_LOG2 BL
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#else
+#define BLOCK_SIZE_LOG2 10
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#define BL BLOCK_SIZE_LOG2
+#endif
+
+#define MAX_COLUMNS 256
+#define MAX_OPERANDS 16
+#define MAX_QUERIES 32
+
+// Operators of a query step; the first step of a query is an OR into an empty bitmap
+enum ops {
+    OP_OR,
+    OP_AND,
+    OP_ANDNOT, // result & ~column
+    OP_END     // No further steps
+};
+
+// A query, evaluated left to right: result = ((0 op[0] column[0]) op[1] column[1]) ...
+typedef struct {
+    uint8_t op[MAX_OPERANDS];
+    uint8_t column[MAX_OPERANDS];
+} query_t;
+
+enum outputs {
+    OUTPUT_POPCOUNT, // Number of rows that match
+    OUTPUT_BITMAP,   // Result bitmap
+    nr_outputs
+};
+
+// Structures used by both the host and the dpu to communicate information
+typedef struct {
+    uint32_t n_words;       // Words of this DPU in every column
+    uint32_t column_bytes;  // Column stride in the MRAM heap; column c starts at c * column_bytes
+    uint32_t n_columns;
+    uint32_t n_queries;
+    uint32_t output;
+    uint32_t result_offset; // Result bitmap of query q at result_offset + q * column_bytes
+} dpu_arguments_t;
+
+#define DPU_CAPACITY (64 << 20) // A DPU's capacity is 64 MiB
+
+#ifndef ENERGY
+#define ENERGY 0
+#endif
+#define PRINT 0
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+#define divceil(n, m) (((n)-1) / (m) + 1)
+#endif
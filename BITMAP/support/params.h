@@ -0,0 +1,76 @@
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "common.h"
+
+typedef struct Params {
+    unsigned int   n_rows;
+    unsigned int   n_columns;
+    unsigned int   n_operands;
+    unsigned int   n_queries;
+    unsigned int   output;
+    unsigned int   n_threads;
+    unsigned int   n_warmup;
+    unsigned int   n_reps;
+} Params;
+
+static void usage() {
+    fprintf(stderr,
+            "\nUsage:  ./program [options]"
+            "\n"
+            "\nGeneral options:"
+            "\n    -h        help"
+            "\n    -w <W>    # of untimed warmup iterations (default=1)"
+            "\n    -e <E>    # of timed repetition iterations (default=3)"
+            "\n    -t <T>    # of host threads for the merge, or of the CPU baseline (default=8)"
+            "\n"
+            "\nBenchmark-specific options:"
+            "\n    -r <R>    number of rows, bits of every column (default=134217728)"
+            "\n    -c <C>    number of columns, up to 256 (default=16)"
+            "\n    -o <O>    operands per query, up to 16 and C (default=4)"
+            "\n    -q <Q>    number of queries, up to 32 (default=8)"
+            "\n    -m <M>    output: 0 = popcount, 1 = result bitmap (default=0)"
+            "\n");
+}
+
+struct Params input_params(int argc, char **argv) {
+    struct Params p;
+    p.n_warmup      = 1;
+    p.n_reps        = 3;
+    p.n_threads     = 8;
+    p.n_rows        = 134217728;
+    p.n_columns     = 16;
+    p.n_operands    = 4;
+    p.n_queries     = 8;
+    p.output        = OUTPUT_POPCOUNT;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hw:e:t:r:c:o:q:m:")) >= 0) {
+        switch(opt) {
+            case 'h':
+                usage();
+                exit(0);
+                break;
+            case 'w': p.n_warmup      = atoi(optarg); break;
+            case 'e': p.n_reps        = atoi(optarg); break;
+            case 't': p.n_threads     = atoi(optarg); break;
+            case 'r': p.n_rows        = atoi(optarg); break;
+            case 'c': p.n_columns     = atoi(optarg); break;
+            case 'o': p.n_operands    = atoi(optarg); break;
+            case 'q': p.n_queries     = atoi(optarg); break;
+            case 'm': p.output        = atoi(optarg); break;
+            default:
+                      fprintf(stderr, "\nUnrecognized option!\n");
+                      usage();
+                      exit(0);
+        }
+    }
+    assert(p.n_rows > 0 && "Invalid # of rows!");
+    assert(p.n_columns > 0 && p.n_columns <= MAX_COLUMNS && "Invalid # of columns!");
+    assert(p.n_operands > 0 && p.n_operands <= MAX_OPERANDS && p.n_operands <= p.n_columns && "Invalid # of operands!");
+    assert(p.n_queries > 0 && p.n_queries <= MAX_QUERIES && "Invalid # of queries!");
+    assert(p.output < nr_outputs && p.n_threads > 0 && "Invalid output or thread count!");
+
+    return p;
+}
+#endif
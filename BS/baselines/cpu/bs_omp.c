@@ -9,6 +9,7 @@
 #include <time.h>
 #include <stdint.h>
 #include "timer.h"
+#include "../../support/rapl.h"
 
 #define DTYPE uint64_t
 /*
@@ -76,6 +77,7 @@ uint64_t binarySearch(DTYPE * input, uint64_t input_size, DTYPE* querys, unsigne
   int main(int argc, char **argv) {
 
     Timer timer;
+    Energy energy;
     uint64_t input_size = atol(argv[1]);
     uint64_t n_querys = atol(argv[2]);
 
@@ -89,9 +91,11 @@ uint64_t binarySearch(DTYPE * input, uint64_t input_size, DTYPE* querys, unsigne
     // Create an input file with arbitrary data.
     create_test_file(input, input_size, querys, n_querys);
 	
+    energy_start(&energy, 0, 0);
     start(&timer, 0, 0);
     result_host = binarySearch(input, input_size - 1, querys, n_querys);   
     stop(&timer, 0);
+    energy_stop(&energy, 0);
 
 
     int status = (result_host);
@@ -99,6 +103,9 @@ uint64_t binarySearch(DTYPE * input, uint64_t input_size, DTYPE* querys, unsigne
         printf("[OK] Execution time: ");
 	print(&timer, 0, 1);
 	printf("ms.\n");
+        printf("Energy ");
+        energy_print(&energy, 0, 1, n_querys);
+        printf("\n");
     } else {
         printf("[ERROR]\n");
     }
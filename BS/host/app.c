@@ -222,6 +222,14 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)num_querys, (double)nr_of_dpus);
+    // Million lookups per second, the same columns as HT (hash-table lookups on as many keys);
+    // end-to-end includes the push of the sorted array, as HT includes the build and load of its table
+    double mlookups_dpu = num_querys / (prim_timer_ms_avg(&timer, 2, p.n_reps) * 1e3);
+    double mlookups_e2e = num_querys / ((prim_timer_ms_avg(&timer, 1, p.n_reps) + prim_timer_ms_avg(&timer, 2, p.n_reps) + prim_timer_ms_avg(&timer, 3, p.n_reps)) * 1e3);
+    printf("\nMlookups/s DPU Kernel: %f\tEnd-to-end: %f\n", mlookups_dpu, mlookups_e2e);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mlookups_DPU", mlookups_dpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mlookups_E2E", mlookups_e2e);
 
 	#if ENERGY
 	double energy;
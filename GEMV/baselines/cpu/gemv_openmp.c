@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "../../support/timer.h"
+#include "../../support/rapl.h"
 #include "gemv_utils.h"
 
 int main(int argc, char *argv[])
@@ -31,17 +32,23 @@ int main(int argc, char *argv[])
     }
 
   Timer timer;
+  Energy energy;
+  energy_start(&energy, 0, 0);
   start(&timer, 0, 0);
 
 
    gemv(A, x, rows, cols, &b);
    
    stop(&timer, 0);
+   energy_stop(&energy, 0);
 
 
     printf("Kernel ");
     print(&timer, 0, 1);
     printf("\n");
+    printf("Energy ");
+    energy_print(&energy, 0, 1, rows * cols);
+    printf("\n");
 
 #if 0
   print_vec(x, rows);
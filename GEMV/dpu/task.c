@@ -40,9 +40,10 @@ int main() {
 	barrier_wait(&my_barrier);
 
 	int32_t n_size = DPU_INPUT_ARGUMENTS.n_size;
-	int32_t n_size_pad = DPU_INPUT_ARGUMENTS.n_size_pad;
 	uint32_t nr_rows = DPU_INPUT_ARGUMENTS.nr_rows;
-	uint32_t max_rows = DPU_INPUT_ARGUMENTS.max_rows;
+	uint32_t a_offset = DPU_INPUT_ARGUMENTS.a_offset;
+	uint32_t b_offset = DPU_INPUT_ARGUMENTS.b_offset;
+	uint32_t c_offset = DPU_INPUT_ARGUMENTS.c_offset;
 
 	unsigned int element_per_cacheC = 8/sizeof(T);
 
@@ -73,9 +74,9 @@ int main() {
 	}
 
 	// Address of the current row in MRAM
-	uint32_t mram_base_addr_A = (uint32_t) (DPU_MRAM_HEAP_POINTER + start_row * n_size * sizeof(T));
-	uint32_t mram_base_addr_B = (uint32_t) (DPU_MRAM_HEAP_POINTER + max_rows * n_size_pad * sizeof(T));
-	uint32_t mram_base_addr_C = (uint32_t) (DPU_MRAM_HEAP_POINTER + max_rows * n_size_pad * sizeof(T) + n_size_pad * sizeof(T) + start_row * sizeof(T));
+	uint32_t mram_base_addr_A = (uint32_t) (DPU_MRAM_HEAP_POINTER + a_offset + start_row * n_size * sizeof(T));
+	uint32_t mram_base_addr_B = (uint32_t) (DPU_MRAM_HEAP_POINTER + b_offset);
+	uint32_t mram_base_addr_C = (uint32_t) (DPU_MRAM_HEAP_POINTER + c_offset + start_row * sizeof(T));
 	uint32_t mram_temp_addr_A = mram_base_addr_A;
 	uint32_t mram_temp_addr_B = mram_base_addr_B;
 
@@ -96,7 +97,7 @@ int main() {
 	// for (unsigned int i = start_row; i < start_row + rows_per_tasklet; i += 2) {
 	for (unsigned int i = start_row; i < start_row + rows_per_tasklet; i += element_per_cacheC) {
 
-		mram_temp_addr_A = (uint32_t) (DPU_MRAM_HEAP_POINTER + i * n_size * sizeof(T));
+		mram_temp_addr_A = (uint32_t) (DPU_MRAM_HEAP_POINTER + a_offset + i * n_size * sizeof(T));
 		mram_temp_addr_B = mram_base_addr_B;
 
 		// cache_C[0] = 0;
@@ -63,6 +63,16 @@ static void gemv_host(T* C, T* A, T* B, unsigned int m_size, unsigned int n_size
 	}
 }
 
+// Push row chunk k of every DPU's weights to the start of MRAM
+static void push_weight_chunk(struct dpu_set_t dpu_set, uint32_t k, uint32_t chunk_rows, uint32_t n_size, uint32_t n_size_pad) {
+	struct dpu_set_t dpu;
+	uint32_t i;
+	DPU_FOREACH(dpu_set, dpu, i) {
+		DPU_ASSERT(dpu_prepare_xfer(dpu, A + (dpu_info[i].prev_rows_dpu + k * chunk_rows) * n_size));
+	}
+	DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, chunk_rows * n_size_pad * sizeof(T), DPU_XFER_DEFAULT));
+}
+
 // Main of the Host Application
 int main(int argc, char **argv) {
 
@@ -130,7 +140,62 @@ int main(int argc, char **argv) {
 		input_args[i].nr_rows = rows_per_dpu;
 	}
 
-	A = malloc(max_rows_per_dpu * nr_of_dpus * n_size_pad * sizeof(T));
+	// Split the rows of each DPU into chunks: a single chunk keeps the whole matrix resident,
+	// more chunks are loaded one after the other into the same MRAM rows, each followed by its
+	// launch (transfers and launches of a rank execute in order, so they cannot overlap)
+	uint32_t n_chunks = p.n_chunks;
+	if (n_chunks == 0) {
+		uint64_t resident_bytes = ((uint64_t) max_rows_per_dpu * n_size_pad + n_size_pad + max_rows_per_dpu) * sizeof(T);
+		n_chunks = 1;
+		if (resident_bytes > DPU_CAPACITY) {
+			uint64_t free_bytes = DPU_CAPACITY - (uint64_t) (n_size_pad + max_rows_per_dpu) * sizeof(T);
+			uint32_t fit_rows = (uint32_t) (free_bytes / (n_size_pad * sizeof(T))) & ~1u;
+			assert(fit_rows > 0 && "Two matrix rows do not fit in MRAM!");
+			n_chunks = (max_rows_per_dpu + fit_rows - 1) / fit_rows;
+		}
+	}
+	uint32_t chunk_rows, b_offset, c_offset, out_rows_per_dpu;
+	for (;;) {
+		chunk_rows = (max_rows_per_dpu + n_chunks - 1) / n_chunks;
+		if (chunk_rows % 2 == 1) // 4-byte elements
+			chunk_rows++;
+		b_offset = chunk_rows * n_size_pad * sizeof(T);
+		c_offset = b_offset + n_size_pad * sizeof(T);
+		out_rows_per_dpu = n_chunks * chunk_rows; // Output rows of chunk k start at row k * chunk_rows
+		// The rounded-up chunks can hold more output rows than the estimate: add chunks until they fit
+		if (p.n_chunks != 0 || chunk_rows <= 2 || (uint64_t) c_offset + out_rows_per_dpu * sizeof(T) <= DPU_CAPACITY)
+			break;
+		n_chunks++;
+	}
+	assert((uint64_t) c_offset + out_rows_per_dpu * sizeof(T) <= DPU_CAPACITY && "Matrix chunks do not fit in MRAM!");
+	if (n_chunks > 1)
+		printf("Streaming %u chunks of %u rows per DPU\n", n_chunks, chunk_rows);
+
+	// Input arguments of every chunk
+	dpu_arguments_t *chunk_args = (dpu_arguments_t *) malloc(n_chunks * nr_of_dpus * sizeof(dpu_arguments_t));
+	for (uint32_t k = 0; k < n_chunks; k++) {
+		for (i = 0; i < nr_of_dpus; i++) {
+			uint32_t first_row = k * chunk_rows;
+			dpu_arguments_t *args = &chunk_args[k * nr_of_dpus + i];
+			*args = input_args[i];
+			args->nr_rows = dpu_info[i].rows_per_dpu > first_row ? dpu_info[i].rows_per_dpu - first_row : 0;
+			if (args->nr_rows > chunk_rows)
+				args->nr_rows = chunk_rows;
+			args->max_rows = chunk_rows;
+			args->a_offset = 0;
+			args->b_offset = b_offset;
+			args->c_offset = c_offset + first_row * sizeof(T);
+		}
+	}
+
+	// Every chunk push reads chunk_rows * n_size_pad elements: zero the rows past the matrix
+	uint64_t a_elems = (uint64_t) m_size * n_size;
+	for (i = 0; i < nr_of_dpus; i++) {
+		uint64_t end = (uint64_t) (dpu_info[i].prev_rows_dpu + (n_chunks - 1) * chunk_rows) * n_size + chunk_rows * n_size_pad;
+		if (end > a_elems)
+			a_elems = end;
+	}
+	A = calloc(a_elems, sizeof(T));
 	B = malloc(n_size_pad * sizeof(T));
 	C = malloc(max_rows_per_dpu * nr_of_dpus * sizeof(T));
 
@@ -148,50 +213,87 @@ int main(int argc, char **argv) {
 
 
 
-		if (rep >= p.n_warmup)
-			start(&timer, 1, rep - p.n_warmup);
-		// Input arguments
-		i = 0;
-		DPU_FOREACH(dpu_set, dpu, i) {
-			// Copy input arguments to DPU
-			input_args[i].max_rows = max_rows_per_dpu;
-
-			DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
-		}
+		if (n_chunks == 1) {
+			if (rep >= p.n_warmup)
+				start(&timer, 1, rep - p.n_warmup);
+			// Input arguments
+			i = 0;
+			DPU_FOREACH(dpu_set, dpu, i) {
+				// Copy input arguments to DPU
+				DPU_ASSERT(dpu_prepare_xfer(dpu, chunk_args + i));
+			}
 
-		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+			DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
 
-		// Copy input array and vector
-		i = 0;
-		DPU_FOREACH(dpu_set, dpu, i) {
-			DPU_ASSERT(dpu_prepare_xfer(dpu, A + dpu_info[i].prev_rows_dpu * n_size));
-		}
-		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, max_rows_per_dpu * n_size_pad * sizeof(T), DPU_XFER_DEFAULT));
-		DPU_FOREACH(dpu_set, dpu, i) {
-			DPU_ASSERT(dpu_prepare_xfer(dpu, B));
-		}
-		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, max_rows_per_dpu * n_size_pad * sizeof(T) , n_size_pad * sizeof(T), DPU_XFER_DEFAULT));
+			// Copy input array and vector
+			i = 0;
+			push_weight_chunk(dpu_set, 0, chunk_rows, n_size, n_size_pad);
+			DPU_FOREACH(dpu_set, dpu, i) {
+				DPU_ASSERT(dpu_prepare_xfer(dpu, B));
+			}
+			DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, b_offset, n_size_pad * sizeof(T), DPU_XFER_DEFAULT));
 
-		if (rep >= p.n_warmup)
-			stop(&timer, 1);
+			if (rep >= p.n_warmup)
+				stop(&timer, 1);
 
-		// Run kernel on DPUs
-		if (rep >= p.n_warmup)
-		{
-			start(&timer, 2, rep - p.n_warmup);
+			// Run kernel on DPUs
+			if (rep >= p.n_warmup)
+			{
+				start(&timer, 2, rep - p.n_warmup);
 #if ENERGY
-			DPU_ASSERT(dpu_probe_start(&probe));
+				DPU_ASSERT(dpu_probe_start(&probe));
 #endif
-		}
+			}
 
-		DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+			DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
 
-		if (rep >= p.n_warmup)
-		{
-			stop(&timer, 2);
+			if (rep >= p.n_warmup)
+			{
+				stop(&timer, 2);
 #if ENERGY
-			DPU_ASSERT(dpu_probe_stop(&probe));
+				DPU_ASSERT(dpu_probe_stop(&probe));
 #endif
+			}
+		} else {
+			// Copy the vector
+			if (rep >= p.n_warmup)
+				start(&timer, 1, rep - p.n_warmup);
+			DPU_FOREACH(dpu_set, dpu, i) {
+				DPU_ASSERT(dpu_prepare_xfer(dpu, B));
+			}
+			DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, b_offset, n_size_pad * sizeof(T), DPU_XFER_DEFAULT));
+			if (rep >= p.n_warmup)
+				stop(&timer, 1);
+
+			// Stream the weights: load chunk k (CPU-DPU time), then run it (DPU time); timers
+			// accumulate over the chunks of a repetition
+			for (uint32_t k = 0; k < n_chunks; k++) {
+				if (rep >= p.n_warmup)
+					start(&timer, 1, 1);
+				DPU_FOREACH(dpu_set, dpu, i) {
+					DPU_ASSERT(dpu_prepare_xfer(dpu, chunk_args + k * nr_of_dpus + i));
+				}
+				DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+				push_weight_chunk(dpu_set, k, chunk_rows, n_size, n_size_pad);
+				if (rep >= p.n_warmup)
+					stop(&timer, 1);
+
+				if (rep >= p.n_warmup)
+				{
+					start(&timer, 2, k == 0 ? rep - p.n_warmup : 1);
+#if ENERGY
+					DPU_ASSERT(dpu_probe_start(&probe));
+#endif
+				}
+				DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+				if (rep >= p.n_warmup)
+				{
+					stop(&timer, 2);
+#if ENERGY
+					DPU_ASSERT(dpu_probe_stop(&probe));
+#endif
+				}
+			}
 		}
 #if PRINT
 		// Display DPU Logs
@@ -201,17 +303,18 @@ int main(int argc, char **argv) {
 #endif
 
 		// Retrieve results
-		C_dpu = malloc(max_rows_per_dpu * nr_of_dpus * sizeof(T));
+		C_dpu = malloc(out_rows_per_dpu * nr_of_dpus * sizeof(T));
 		if (rep >= p.n_warmup)
 			start(&timer, 3, rep - p.n_warmup);
 		i = 0;
 		DPU_FOREACH(dpu_set, dpu, i) {
-			DPU_ASSERT(dpu_prepare_xfer(dpu, C_dpu + i * max_rows_per_dpu));
+			DPU_ASSERT(dpu_prepare_xfer(dpu, C_dpu + i * out_rows_per_dpu));
 		}
-		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, max_rows_per_dpu * n_size_pad * sizeof(T) + n_size_pad * sizeof(T), max_rows_per_dpu * sizeof(T), DPU_XFER_DEFAULT));
+		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, c_offset, out_rows_per_dpu * sizeof(T), DPU_XFER_DEFAULT));
 		if(rep >= p.n_warmup)
 			stop(&timer, 3);
 	}
+
 #if ENERGY
 	double acc_energy, avg_energy, acc_time, avg_time;
 	DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_ACCUMULATE, &acc_energy));
@@ -229,6 +332,13 @@ int main(int argc, char **argv) {
 	print(&timer, 2, p.n_reps);
 	printf("DPU-CPU Time (ms): ");
 	print(&timer, 3, p.n_reps);
+	double transfer_bound = timer.time[1] / (timer.time[1] + timer.time[2]);
+	if (n_chunks > 1) {
+		double weight_bytes = (double) n_chunks * chunk_rows * n_size_pad * sizeof(T) * nr_of_dpus;
+		printf("\nWeight Streaming Bandwidth (GB/s): %f\t", weight_bytes / (timer.time[1] / p.n_reps) / 1e3);
+		// Share of the chunk time spent pushing the weights (and the vector) rather than running the kernel
+		printf("Transfer Bound (CPU-DPU / (CPU-DPU + DPU Kernel)): %.1f%%\t", 100.0 * transfer_bound);
+	}
 
         // update CSV
 #define TEST_NAME "GEMV"
@@ -237,6 +347,9 @@ int main(int argc, char **argv) {
         update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
         update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
         update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+        update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)m_size * n_size, (double)nr_of_dpus);
+        if (n_chunks > 1)
+            update_csv(RESULTS_FILE, TEST_NAME, "Transfer_bound", 100.0 * transfer_bound);
 
 #if ENERGY
 	printf("Energy (J): %f J\t", avg_energy);
@@ -248,10 +361,10 @@ int main(int argc, char **argv) {
 	i = 0;
 	for (n = 0; n < nr_of_dpus; n++) {
 		for (j = 0; j < dpu_info[n].rows_per_dpu; j++) {
-			if(C[i] != C_dpu[n * max_rows_per_dpu + j]) {
+			if(C[i] != C_dpu[n * out_rows_per_dpu + j]) {
 				status = false;
 #if PRINT
-	//			printf("%d: %d -- %d\n", i, C[i], C_dpu[n * max_rows_per_dpu + j]);
+	//			printf("%d: %d -- %d\n", i, C[i], C_dpu[n * out_rows_per_dpu + j]);
 #endif
 			}
 			i++;
@@ -268,6 +381,7 @@ int main(int argc, char **argv) {
 	free(B);
 	free(C);
 	free(C_dpu);
+	free(chunk_args);
 	DPU_ASSERT(dpu_free(dpu_set));
 
 #if ENERGY
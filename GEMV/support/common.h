@@ -7,6 +7,9 @@ typedef struct {
     uint32_t n_size_pad;
     uint32_t nr_rows;
     uint32_t max_rows;
+    uint32_t a_offset; // MRAM heap offsets (bytes) of the matrix rows, the vector and the output rows
+    uint32_t b_offset;
+    uint32_t c_offset;
 } dpu_arguments_t;
 
 // Specific information for each DPU
@@ -17,6 +20,9 @@ struct dpu_info_t {
 };
 struct dpu_info_t *dpu_info;
 
+// MRAM available for the matrix, the vector and the output of each DPU
+#define DPU_CAPACITY (64 << 20)
+
 // Transfer size between MRAM and WRAM
 #ifdef BL
 #define BLOCK_SIZE_LOG2 BL
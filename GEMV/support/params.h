@@ -8,6 +8,7 @@ typedef struct Params {
     unsigned int  n_size;
     unsigned int  n_warmup;
     unsigned int  n_reps;
+    unsigned int  n_chunks;
 }Params;
 
 static void usage() {
@@ -22,6 +23,7 @@ static void usage() {
             "\nBenchmark-specific options:"
             "\n    -m <I>    m_size (default=8192 elements)"
             "\n    -n <I>    n_size (default=8192 elements)"
+            "\n    -c <C>    # of row chunks streamed through MRAM per DPU (default=0, i.e., 1 if the matrix fits in MRAM, otherwise the minimum that fits)"
             "\n");
 }
 
@@ -31,9 +33,10 @@ struct Params input_params(int argc, char **argv) {
     p.n_size        = 8192;
     p.n_warmup      = 0;
     p.n_reps        = 1;
+    p.n_chunks      = 0;
 
     int opt;
-    while((opt = getopt(argc, argv, "hm:n:w:e:")) >= 0) {
+    while((opt = getopt(argc, argv, "hm:n:w:e:c:")) >= 0) {
         switch(opt) {
             case 'h':
                 usage();
@@ -43,6 +46,7 @@ struct Params input_params(int argc, char **argv) {
             case 'n': p.n_size        = atoi(optarg); break;
             case 'w': p.n_warmup      = atoi(optarg); break;
             case 'e': p.n_reps        = atoi(optarg); break;
+            case 'c': p.n_chunks      = atoi(optarg); break;
             default:
                       fprintf(stderr, "\nUnrecognized option!\n");
                       usage();
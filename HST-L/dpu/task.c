@@ -13,6 +13,7 @@
 #include <mutex.h>
 
 #include "../support/common.h"
+#include "../support/packed.h"
 
 __host dpu_arguments_t DPU_INPUT_ARGUMENTS;
 
@@ -82,6 +83,9 @@ int main_kernel1() {
 
     // Initialize a local cache to store the MRAM block
     T *cache_A = (T *) mem_alloc(BLOCK_SIZE);
+#if PACK
+    uint8_t *cache_P = (uint8_t *) mem_alloc(packed_bytes(REGS, PACK));
+#endif
 	
     // Local histogram
     if (tasklet_id < NR_HISTO){ // Allocate DPU histogram
@@ -107,7 +111,13 @@ int main_kernel1() {
         uint32_t l_size_bytes = (byte_index + BLOCK_SIZE >= input_size_dpu_bytes) ? (input_size_dpu_bytes - byte_index) : BLOCK_SIZE;
 
         // Load cache with current MRAM block
+#if PACK
+        // Packed pixels: read PACK bits per pixel and expand them in WRAM
+        mram_read((const __mram_ptr void*)(mram_base_addr_A + packed_bytes(byte_index >> DIV, PACK)), cache_P, packed_bytes(l_size_bytes >> DIV, PACK));
+        unpack_u32(cache_A, cache_P, l_size_bytes >> DIV, PACK);
+#else
         mram_read((const __mram_ptr void*)(mram_base_addr_A + byte_index), cache_A, l_size_bytes);
+#endif
 
         // Histogram in each tasklet
         histogram(my_histo, bins, cache_A, my_histo_id, l_size_bytes >> DIV);
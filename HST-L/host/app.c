@@ -17,6 +17,7 @@
 #include "../support/common.h"
 #include "../support/timer.h"
 #include "../support/params.h"
+#include "../support/packed.h"
 #include "../support/prim_results.h"
 
 // Define the DPU Binary path as DPU_BINARY here
@@ -30,6 +31,9 @@
 
 // Pointer declaration
 static T* A;
+#if PACK
+static uint8_t* A_packed;
+#endif
 static unsigned int* histo_host;
 static unsigned int* histo;
 
@@ -109,9 +113,20 @@ int main(int argc, char **argv) {
     const unsigned int input_size_dpu_8bytes = 
         ((input_size_dpu * sizeof(T)) % 8) != 0 ? roundup(input_size_dpu, 8) : input_size_dpu; // Input size per DPU (max.), 8-byte aligned
 
+#if PACK
+    const unsigned int transfer_size_dpu = packed_bytes(input_size_dpu_8bytes, PACK); // Packed input per DPU, 8-byte aligned
+#else
+    const unsigned int transfer_size_dpu = input_size_dpu_8bytes * sizeof(T);
+#endif
+
     // Input/output allocation
     A = malloc(input_size_dpu_8bytes * nr_of_dpus * sizeof(T));
+#if PACK
+    A_packed = malloc(transfer_size_dpu * nr_of_dpus);
+    uint8_t *bufferA = A_packed;
+#else
     T *bufferA = A;
+#endif
     histo_host = malloc(p.bins * sizeof(unsigned int));
     histo = malloc(nr_of_dpus * p.bins * sizeof(unsigned int));
 
@@ -131,6 +146,7 @@ int main(int argc, char **argv) {
     Timer timer;
 
     printf("NR_TASKLETS\t%d\tBL\t%d\tinput_size\t%u\n", NR_TASKLETS, BL, input_size);
+    printf("CPU-DPU bytes per DPU\t%u\t(%d-bit pixels)\n", transfer_size_dpu, PACK ? PACK : 32);
 
     // Loop over main kernel
     for(int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
@@ -147,18 +163,23 @@ int main(int argc, char **argv) {
         printf("Load input data\n");
         if(rep >= p.n_warmup)
             start(&timer, 1, rep - p.n_warmup);
+#if PACK
+        // Packing is part of the CPU-DPU transfer
+        for(i = 0; i < nr_of_dpus; i++)
+            pack_u32(A_packed + transfer_size_dpu * i, A + input_size_dpu_8bytes * i, input_size_dpu_8bytes, PACK);
+#endif
         // Input arguments
         unsigned int kernel = 0;
         i = 0;
 	    dpu_arguments_t input_arguments[NR_DPUS];
 	    for(i=0; i<nr_of_dpus-1; i++) {
 	        input_arguments[i].size=input_size_dpu_8bytes * sizeof(T); 
-	        input_arguments[i].transfer_size=input_size_dpu_8bytes * sizeof(T); 
+	        input_arguments[i].transfer_size=transfer_size_dpu; 
 	        input_arguments[i].bins=p.bins;
 	        input_arguments[i].kernel=kernel;
 	    }
 	    input_arguments[nr_of_dpus-1].size=(input_size_8bytes - input_size_dpu_8bytes * (NR_DPUS-1)) * sizeof(T); 
-	    input_arguments[nr_of_dpus-1].transfer_size=input_size_dpu_8bytes * sizeof(T); 
+	    input_arguments[nr_of_dpus-1].transfer_size=transfer_size_dpu; 
 	    input_arguments[nr_of_dpus-1].bins=p.bins;
 	    input_arguments[nr_of_dpus-1].kernel=kernel;
 
@@ -169,9 +190,9 @@ int main(int argc, char **argv) {
         }
         DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(input_arguments[0]), DPU_XFER_DEFAULT));
         DPU_FOREACH(dpu_set, dpu, i) {
-            DPU_ASSERT(dpu_prepare_xfer(dpu, bufferA + input_size_dpu_8bytes * i));
+            DPU_ASSERT(dpu_prepare_xfer(dpu, bufferA + (transfer_size_dpu / sizeof(*bufferA)) * i));
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, input_size_dpu_8bytes * sizeof(T), DPU_XFER_DEFAULT));
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, transfer_size_dpu, DPU_XFER_DEFAULT));
         if(rep >= p.n_warmup)
             stop(&timer, 1);
 
@@ -211,7 +232,7 @@ int main(int argc, char **argv) {
         DPU_FOREACH(dpu_set, dpu, i) {
             DPU_ASSERT(dpu_prepare_xfer(dpu, histo + p.bins * i));
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, input_size_dpu_8bytes * sizeof(T), p.bins * sizeof(unsigned int), DPU_XFER_DEFAULT));
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, transfer_size_dpu, p.bins * sizeof(unsigned int), DPU_XFER_DEFAULT));
 		
         // Final histogram merging
         for(i = 1; i < nr_of_dpus; i++){
@@ -241,6 +262,7 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)input_size, (double)nr_of_dpus);
 
     #if ENERGY
     double energy;
@@ -286,6 +308,9 @@ int main(int argc, char **argv) {
 
     // Deallocation
     free(A);
+#if PACK
+    free(A_packed);
+#endif
     free(histo_host);
     free(histo);
     DPU_ASSERT(dpu_free(dpu_set));
@@ -18,6 +18,17 @@
 
 // Pixel depth
 #define DEPTH 12
+
+// Pixel transfer format: 0 sends 32-bit pixels, 12 or 16 packs them (see packed.h)
+#ifndef PACK
+#define PACK 0
+#endif
+#if PACK != 0 && PACK != 12 && PACK != 16
+#error "PACK must be 0, 12 or 16"
+#endif
+#if PACK && REGS % 16 != 0
+#error "PACK needs blocks of a multiple of 16 pixels (BL >= 6)"
+#endif
 #define ByteSwap16(n) (((((unsigned int)n) << 8) & 0xFF00) | ((((unsigned int)n) >> 8) & 0x00FF))
 
 // Structures used by both the host and the dpu to communicate information 
@@ -0,0 +1,77 @@
+#ifndef _PACKED_H_
+#define _PACKED_H_
+
+// Packed-integer transfer format for inputs with a small value range.
+// Values of 8, 12 or 16 bits are stored little endian, back to back, in groups of
+// PACK_GROUP values, so every group starts on an 8-byte boundary of MRAM and a
+// group-aligned range of n values takes packed_bytes(n, bits) bytes.
+// The host packs with pack_u32() before the CPU-DPU transfer; the DPU reads the
+// packed block into WRAM and expands it with unpack_u32().
+
+#include <stdint.h>
+
+#define PACK_GROUP 16
+#define packed_bytes(n, bits) ((((n) + PACK_GROUP - 1) / PACK_GROUP) * PACK_GROUP * (bits) / 8)
+
+// 8 values of 12 bits in 3 words
+static inline void pack12x8(uint32_t *w, const uint32_t *s) {
+    uint32_t v0 = s[0] & 0xFFF, v1 = s[1] & 0xFFF, v2 = s[2] & 0xFFF, v3 = s[3] & 0xFFF;
+    uint32_t v4 = s[4] & 0xFFF, v5 = s[5] & 0xFFF, v6 = s[6] & 0xFFF, v7 = s[7] & 0xFFF;
+    w[0] = v0 | (v1 << 12) | (v2 << 24);
+    w[1] = (v2 >> 8) | (v3 << 4) | (v4 << 16) | (v5 << 28);
+    w[2] = (v5 >> 4) | (v6 << 8) | (v7 << 20);
+}
+
+// Packs n values (only the low bits are kept); the last group is padded with zeros
+static inline void pack_u32(uint8_t *dst, const uint32_t *src, uint64_t n, unsigned int bits) {
+    uint64_t packed = n * bits / 8;
+    if (bits == 8) {
+        for (uint64_t i = 0; i < n; i++)
+            dst[i] = (uint8_t) src[i];
+    } else if (bits == 16) {
+        uint16_t *d = (uint16_t *) dst;
+        for (uint64_t i = 0; i < n; i++)
+            d[i] = (uint16_t) src[i];
+    } else { // 12 bits: branch free over groups of 8, so that the compiler vectorizes it
+        uint32_t *d = (uint32_t *) dst;
+        uint64_t n_full = n & ~(uint64_t)7;
+        for (uint64_t i = 0; i < n_full; i += 8)
+            pack12x8(d + (i >> 3) * 3, src + i);
+        if (n_full < n) {
+            uint32_t tail[8] = {0};
+            for (uint64_t i = n_full; i < n; i++)
+                tail[i - n_full] = src[i];
+            pack12x8(d + (n_full >> 3) * 3, tail);
+            packed = (n_full + 8) * 12 / 8;
+        }
+    }
+    // Zero padding up to the end of the group
+    for (uint64_t b = packed; b < packed_bytes(n, bits); b++)
+        dst[b] = 0;
+}
+
+// Unpacks n values from a group-aligned packed buffer; dst needs room for n rounded up to 8
+static inline void unpack_u32(uint32_t *dst, const uint8_t *src, unsigned int n, unsigned int bits) {
+    if (bits == 8) {
+        for (unsigned int i = 0; i < n; i++)
+            dst[i] = src[i];
+    } else if (bits == 16) {
+        const uint16_t *s = (const uint16_t *) src;
+        for (unsigned int i = 0; i < n; i++)
+            dst[i] = s[i];
+    } else {
+        const uint32_t *s = (const uint32_t *) src;
+        for (unsigned int i = 0; i < n; i += 8, s += 3, dst += 8) {
+            uint32_t w0 = s[0], w1 = s[1], w2 = s[2];
+            dst[0] = w0 & 0xFFF;
+            dst[1] = (w0 >> 12) & 0xFFF;
+            dst[2] = (w0 >> 24) | ((w1 & 0xF) << 8);
+            dst[3] = (w1 >> 4) & 0xFFF;
+            dst[4] = (w1 >> 16) & 0xFFF;
+            dst[5] = (w1 >> 28) | ((w2 & 0xFF) << 4);
+            dst[6] = (w2 >> 8) & 0xFFF;
+            dst[7] = w2 >> 20;
+        }
+    }
+}
+#endif
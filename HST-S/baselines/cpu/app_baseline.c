@@ -22,6 +22,7 @@
 
 #include "../../support/common.h"
 #include "../../support/timer.h"
+#include "../../support/rapl.h"
 
 // Pointer declaration
 static T* A;
@@ -170,6 +171,8 @@ int main(int argc, char **argv) {
     read_input(A, p);
 
     Timer timer;
+    Energy energy;
+    energy_start(&energy, 0, 0);
     start(&timer, 0, 0);
 
 	if(!p.exp)
@@ -180,9 +183,13 @@ int main(int argc, char **argv) {
     histogram_host(histo_host, A, p.bins, input_size, p.exp, nr_of_dpus, p.n_threads);
 
     stop(&timer, 0);
+    energy_stop(&energy, 0);
     printf("Kernel ");
     print(&timer, 0, 1);
     printf("\n");
+    printf("Energy ");
+    energy_print(&energy, 0, 1, input_size);
+    printf("\n");
 	
     return 0;
 }
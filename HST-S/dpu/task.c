@@ -11,8 +11,13 @@
 #include <barrier.h>
 
 #include "../support/common.h"
+#include "../support/packed.h"
+#include "../support/codec.h"
 
 __host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+#if COMPRESS
+__host codec_stats_t DPU_CODEC_STATS[NR_TASKLETS];
+#endif
 
 // Array for communication between adjacent tasklets
 uint32_t* message[NR_TASKLETS];
@@ -47,6 +52,9 @@ int main_kernel1() {
 #endif
     if (tasklet_id == 0){ // Initialize once the cycle counter
         mem_reset(); // Reset the heap
+#if COMPRESS
+        perfcounter_config(COUNT_CYCLES, true);
+#endif
     }
     // Barrier
     barrier_wait(&my_barrier);
@@ -62,6 +70,14 @@ int main_kernel1() {
 
     // Initialize a local cache to store the MRAM block
     T *cache_A = (T *) mem_alloc(BLOCK_SIZE);
+#if PACK
+    uint8_t *cache_P = (uint8_t *) mem_alloc(packed_bytes(REGS, PACK));
+#endif
+#if COMPRESS
+    uint8_t *cache_C = (uint8_t *) mem_alloc(BLOCK_SIZE);
+    codec_entry_t *entry = (codec_entry_t *) mem_alloc(sizeof(codec_entry_t));
+    uint64_t decode_cycles = 0;
+#endif
 	
     // Local histogram
     uint32_t *histo = (uint32_t *) mem_alloc(bins * sizeof(uint32_t));
@@ -78,12 +94,33 @@ int main_kernel1() {
         uint32_t l_size_bytes = (byte_index + BLOCK_SIZE >= input_size_dpu_bytes) ? (input_size_dpu_bytes - byte_index) : BLOCK_SIZE;
 
         // Load cache with current MRAM block
+#if PACK
+        // Packed pixels: read PACK bits per pixel and expand them in WRAM
+        mram_read((const __mram_ptr void*)(mram_base_addr_A + packed_bytes(byte_index >> DIV, PACK)), cache_P, packed_bytes(l_size_bytes >> DIV, PACK));
+        unpack_u32(cache_A, cache_P, l_size_bytes >> DIV, PACK);
+#elif COMPRESS
+        // Compressed pixels: look the block up in the directory, read it and expand it in WRAM
+        mram_read((__mram_ptr void const*)(mram_base_addr_A + (byte_index >> BLOCK_SIZE_LOG2) * sizeof(codec_entry_t)), entry, sizeof(codec_entry_t));
+        if (entry->scheme == CODEC_RAW)
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + entry->offset), cache_A, entry->bytes);
+        else {
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + entry->offset), cache_C, entry->bytes);
+            perfcounter_t decode_start = perfcounter_get();
+            codec_decode(cache_A, cache_C);
+            decode_cycles += perfcounter_get() - decode_start;
+        }
+#else
         mram_read((const __mram_ptr void*)(mram_base_addr_A + byte_index), cache_A, l_size_bytes);
+#endif
 
         // Histogram in each tasklet
         histogram(histo, bins, cache_A, l_size_bytes >> DIV);
 
     }
+#if COMPRESS
+    DPU_CODEC_STATS[tasklet_id].decode_cycles = decode_cycles;
+    DPU_CODEC_STATS[tasklet_id].cycles = perfcounter_get();
+#endif
     message[tasklet_id] = histo;
 
     // Barrier
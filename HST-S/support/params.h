@@ -2,6 +2,7 @@
 #define _PARAMS_H_
 
 #include "common.h"
+#include "codec.h"
 
 typedef struct Params {
     unsigned int   input_size;
@@ -11,6 +12,7 @@ typedef struct Params {
     const char *file_name;
     int  exp;
     int  dpu_s;
+    unsigned int  codec;
 }Params;
 
 static void usage() {
@@ -27,6 +29,7 @@ static void usage() {
         "\n    -i <I>    input size (default=1536*1024 elements)"
         "\n    -b <B>    histogram size (default=256 bins)"
         "\n    -f <F>    input image file (default=../input/image_VanHateren.iml)"
+        "\n    -c <C>    compression scheme of COMPRESS=1 builds: 0 = smallest per block, 1 = FOR, 2 = DELTA, 3 = RLE (default=0)"
         "\n");
 }
 
@@ -39,9 +42,10 @@ struct Params input_params(int argc, char **argv) {
     p.exp           = 0;
     p.file_name     = "./input/image_VanHateren.iml";
     p.dpu_s         = 64;
+    p.codec         = CODEC_AUTO;
 
     int opt;
-    while((opt = getopt(argc, argv, "hi:b:w:e:f:x:z:")) >= 0) {
+    while((opt = getopt(argc, argv, "hi:b:w:e:f:x:z:c:")) >= 0) {
         switch(opt) {
         case 'h':
         usage();
@@ -54,6 +58,7 @@ struct Params input_params(int argc, char **argv) {
         case 'f': p.file_name     = optarg; break;
         case 'x': p.exp           = atoi(optarg); break;
         case 'z': p.dpu_s         = atoi(optarg); break;
+        case 'c': p.codec         = atoi(optarg); break;
         default:
             fprintf(stderr, "\nUnrecognized option!\n");
             usage();
@@ -61,6 +66,7 @@ struct Params input_params(int argc, char **argv) {
         }
     }
     assert(NR_DPUS > 0 && "Invalid # of dpus!");
+    assert(p.codec < nr_codec_schemes && "Invalid compression scheme!");
 
     return p;
 }
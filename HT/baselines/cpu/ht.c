@@ -0,0 +1,83 @@
+/**
+* @file ht.c
+* @brief Hash-table point lookups on the CPU: the cuckoo table of the DPU version, OpenMP over queries
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include <omp.h>
+#include "../../support/timer.h"
+#include "../../support/rapl.h"
+#include "../../support/params.h"
+#include "../../support/table.h"
+
+/**
+* @brief looks every query up in one table holding all the keys
+*/
+static void ht_lookups(const ht_table_t *table, const DTYPE *queries, DTYPE *results, uint64_t n_queries, int t) {
+    omp_set_num_threads(t);
+    #pragma omp parallel for schedule(static)
+    for (uint64_t q = 0; q < n_queries; q++)
+        results[q] = ht_lookup(table, queries[q]);
+}
+
+/**
+* @brief Main of the CPU baseline.
+*/
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    DTYPE *keys = (DTYPE *) malloc((uint64_t) p.n_keys * sizeof(DTYPE));
+    DTYPE *values = (DTYPE *) malloc((uint64_t) p.n_keys * sizeof(DTYPE));
+    DTYPE *queries = (DTYPE *) malloc((uint64_t) p.n_queries * sizeof(DTYPE));
+    DTYPE *results = (DTYPE *) malloc((uint64_t) p.n_queries * sizeof(DTYPE));
+    generate_keys(keys, values, p.n_keys);
+    generate_queries(queries, p.n_queries, p.n_keys, p.miss, 7);
+
+    ht_table_t table;
+    ht_build(&table, keys, values, p.n_keys, ht_buckets_for(p.n_keys));
+    printf("Keys %u, queries %u (%u%% absent), buckets %u (%u KB)\n", p.n_keys, p.n_queries, p.miss,
+            table.n_buckets, (unsigned int) ((uint64_t) table.n_buckets * BUCKET_BYTES >> 10));
+
+    Timer timer;
+    Energy energy;
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+        if (rep >= p.n_warmup) {
+            energy_start(&energy, 0, rep - p.n_warmup);
+            start(&timer, 0, rep - p.n_warmup);
+        }
+        ht_lookups(&table, queries, results, p.n_queries, p.n_threads);
+        if (rep >= p.n_warmup) {
+            stop(&timer, 0);
+            energy_stop(&energy, 0);
+        }
+    }
+
+    uint64_t found = 0;
+    for (unsigned int q = 0; q < p.n_queries; q++)
+        found += results[q] != NOT_FOUND;
+
+    printf("Kernel ");
+    print(&timer, 0, p.n_reps);
+    printf("\n");
+    printf("Mlookups/s: %f\tFound: %lu\n", p.n_queries / (timer.time[0] / p.n_reps), found);
+    printf("Energy ");
+    energy_print(&energy, 0, p.n_reps, p.n_queries);
+    printf("\n");
+
+    ht_free(&table);
+    free(keys);
+    free(values);
+    free(queries);
+    free(results);
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+* Hash-table point lookups with multiple tasklets
+* Every tasklet reads a block of queries, probes one or two buckets of the cuckoo
+* table per query and writes the values back in query order
+*
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <barrier.h>
+
+#include "../support/common.h"
+#include "../support/hash.h"
+
+__host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+__host dpu_results_t DPU_RESULTS[NR_TASKLETS];
+
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+// main
+int main() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){
+        mem_reset(); // Reset the heap
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    uint32_t query_bytes = DPU_INPUT_ARGUMENTS.n_queries * sizeof(DTYPE);
+    uint32_t mask = DPU_INPUT_ARGUMENTS.bucket_mask;
+
+    // Addresses of the table, queries and results in MRAM
+    uint32_t mram_base_addr_T = (uint32_t)DPU_MRAM_HEAP_POINTER;
+    uint32_t mram_base_addr_Q = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.query_offset);
+    uint32_t mram_base_addr_R = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.result_offset);
+
+    // Initialize a local cache to store the MRAM blocks
+    DTYPE *cache_Q = (DTYPE *) mem_alloc(BLOCK_SIZE);
+    DTYPE *cache_R = (DTYPE *) mem_alloc(BLOCK_SIZE);
+    bucket_t *bucket = (bucket_t *) mem_alloc(BUCKET_BYTES);
+
+    uint32_t lookups = 0, second_reads = 0;
+    for(unsigned int byte_index = tasklet_id << BLOCK_SIZE_LOG2; byte_index < query_bytes; byte_index += BLOCK_SIZE * NR_TASKLETS){
+
+        // Bound checking
+        uint32_t l_size_bytes = (byte_index + BLOCK_SIZE >= query_bytes) ? (query_bytes - byte_index) : BLOCK_SIZE;
+
+        // Load cache with current MRAM block
+        mram_read((__mram_ptr void const*)(mram_base_addr_Q + byte_index), cache_Q, l_size_bytes);
+
+        for (unsigned int j = 0; j < l_size_bytes / sizeof(DTYPE); j++) {
+            DTYPE key = cache_Q[j];
+            DTYPE value = NOT_FOUND;
+            mram_read((__mram_ptr void const*)(mram_base_addr_T + ht_bucket1(key, mask) * BUCKET_BYTES), bucket, BUCKET_BYTES);
+            if (!ht_probe(bucket, key, &value)) {
+                mram_read((__mram_ptr void const*)(mram_base_addr_T + ht_bucket2(key, mask) * BUCKET_BYTES), bucket, BUCKET_BYTES);
+                ht_probe(bucket, key, &value);
+                second_reads++;
+            }
+            cache_R[j] = value;
+        }
+        lookups += l_size_bytes / sizeof(DTYPE);
+
+        // Write cache to current MRAM block
+        mram_write(cache_R, (__mram_ptr void*)(mram_base_addr_R + byte_index), l_size_bytes);
+
+    }
+    DPU_RESULTS[tasklet_id].lookups = lookups;
+    DPU_RESULTS[tasklet_id].second_reads = second_reads;
+
+    return 0;
+}
@@ -0,0 +1,379 @@
+/**
+* app.c
+* HT Host Application Source File
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <omp.h>
+
+#include "../support/common.h"
+#include "../support/timer.h"
+#include "../support/params.h"
+#include "../support/table.h"
+#include "../support/prim_results.h"
+
+#if ENERGY
+#include <dpu_probe.h>
+#endif
+
+// Define the DPU Binary path as DPU_BINARY here
+#ifndef DPU_BINARY
+#define DPU_BINARY "./bin/ht_dpu"
+#endif
+
+// Queries of a batch, grouped by owner DPU: DPU i has count[i] queries from i * cap
+typedef struct {
+    DTYPE *queries;
+    DTYPE *results;
+    uint32_t *perm;      // Position of every routed query in the batch
+    uint32_t *owner;     // Owner DPU of every query of the batch
+    uint32_t *hist;      // Per-thread histograms, then scatter positions
+    uint32_t *count;
+    uint32_t cap;
+    uint64_t capacity;   // Slots allocated in queries, results and perm
+} router_t;
+
+// Lookups on the host CPU, on one table holding every key
+static void ht_host(const ht_table_t *table, const DTYPE *queries, DTYPE *results, uint64_t n_queries) {
+    for (uint64_t q = 0; q < n_queries; q++)
+        results[q] = ht_lookup(table, queries[q]);
+}
+
+// Routes n queries to their owner DPUs in one parallel partition pass: every thread
+// builds the histogram of its chunk, a prefix sum (DPU major, thread minor) gives
+// each thread its own slots, then every thread scatters its chunk
+static void route_queries(router_t *r, const DTYPE *queries, uint32_t n, uint32_t nr_of_dpus, unsigned int n_threads) {
+    #pragma omp parallel num_threads(n_threads)
+    {
+        unsigned int t = omp_get_thread_num();
+        unsigned int n_team = omp_get_num_threads(); // Can be fewer than n_threads
+        uint32_t *hist = r->hist + (uint64_t) t * nr_of_dpus;
+        uint32_t first = (uint64_t) n * t / n_team, last = (uint64_t) n * (t + 1) / n_team;
+        memset(hist, 0, nr_of_dpus * sizeof(uint32_t));
+        for (uint32_t q = first; q < last; q++) {
+            r->owner[q] = ht_owner(queries[q], nr_of_dpus);
+            hist[r->owner[q]]++;
+        }
+        #pragma omp barrier
+        #pragma omp single
+        {
+            r->cap = 0;
+            for (uint32_t i = 0; i < nr_of_dpus; i++) {
+                uint32_t count = 0;
+                for (unsigned int u = 0; u < n_team; u++)
+                    count += r->hist[(uint64_t) u * nr_of_dpus + i];
+                r->count[i] = count;
+                if (count > r->cap)
+                    r->cap = count;
+            }
+            if ((uint64_t) r->cap * nr_of_dpus > r->capacity) {
+                r->capacity = (uint64_t) r->cap * nr_of_dpus;
+                r->queries = (DTYPE *) realloc(r->queries, r->capacity * sizeof(DTYPE));
+                r->results = (DTYPE *) realloc(r->results, r->capacity * sizeof(DTYPE));
+                r->perm = (uint32_t *) realloc(r->perm, r->capacity * sizeof(uint32_t));
+            }
+            for (uint32_t i = 0; i < nr_of_dpus; i++) {
+                uint32_t pos = i * r->cap;
+                for (unsigned int u = 0; u < n_team; u++) {
+                    uint32_t count = r->hist[(uint64_t) u * nr_of_dpus + i];
+                    r->hist[(uint64_t) u * nr_of_dpus + i] = pos;
+                    pos += count;
+                }
+            }
+        }
+        for (uint32_t q = first; q < last; q++) {
+            uint32_t pos = hist[r->owner[q]]++;
+            r->queries[pos] = queries[q];
+            r->perm[pos] = q;
+        }
+    }
+}
+
+// Puts the results of the DPUs back in query order
+static void unroute_results(const router_t *r, DTYPE *results, uint32_t nr_of_dpus, unsigned int n_threads) {
+    #pragma omp parallel for num_threads(n_threads) schedule(static)
+    for (uint32_t i = 0; i < nr_of_dpus; i++) {
+        for (uint32_t j = i * r->cap; j < i * r->cap + r->count[i]; j++)
+            results[r->perm[j]] = r->results[j];
+    }
+}
+
+// Main of the Host Application
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+    struct dpu_set_t dpu_set, dpu;
+    uint32_t nr_of_dpus;
+
+#if ENERGY
+    struct dpu_probe_t probe;
+    DPU_ASSERT(dpu_probe_init("energy_probe", &probe));
+#endif
+
+    // Allocate DPUs and load binary
+    DPU_ASSERT(dpu_alloc(NR_DPUS, NULL, &dpu_set));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
+    printf("Allocated %d DPU(s)\n", nr_of_dpus);
+    printf("NR_TASKLETS\t%d\tBL\t%d\tBUCKET_SLOTS\t%d\n", NR_TASKLETS, BL, BUCKET_SLOTS);
+
+    // Keys, values and queries
+    DTYPE *keys = (DTYPE *) malloc((uint64_t) p.n_keys * sizeof(DTYPE));
+    DTYPE *values = (DTYPE *) malloc((uint64_t) p.n_keys * sizeof(DTYPE));
+    DTYPE *queries = (DTYPE *) malloc((uint64_t) p.n_queries * sizeof(DTYPE));
+    DTYPE *results_host = (DTYPE *) malloc((uint64_t) p.n_queries * sizeof(DTYPE));
+    DTYPE *results = (DTYPE *) malloc((uint64_t) p.n_queries * sizeof(DTYPE));
+    generate_keys(keys, values, p.n_keys);
+    generate_queries(queries, p.n_queries, p.n_keys, p.miss, 7);
+    printf("Keys %u, queries %u (%u%% absent), %u per batch\n", p.n_keys, p.n_queries, p.miss, p.batch);
+
+    // Timer
+    Timer timer;
+
+    // Hash-partition the keys and build one table per DPU; all tables get the
+    // number of buckets of the largest one, so they go to MRAM in one transfer
+    start(&timer, 4, 0);
+    uint32_t *key_count = (uint32_t *) calloc(nr_of_dpus + 1, sizeof(uint32_t));
+    DTYPE *part_keys = (DTYPE *) malloc((uint64_t) p.n_keys * sizeof(DTYPE));
+    DTYPE *part_values = (DTYPE *) malloc((uint64_t) p.n_keys * sizeof(DTYPE));
+    for (uint32_t k = 0; k < p.n_keys; k++)
+        key_count[ht_owner(keys[k], nr_of_dpus) + 1]++;
+    uint32_t max_keys = 0;
+    for (uint32_t i = 0; i < nr_of_dpus; i++) {
+        if (key_count[i + 1] > max_keys)
+            max_keys = key_count[i + 1];
+        key_count[i + 1] += key_count[i];
+    }
+    uint32_t *fill = (uint32_t *) malloc(nr_of_dpus * sizeof(uint32_t));
+    memcpy(fill, key_count, nr_of_dpus * sizeof(uint32_t));
+    for (uint32_t k = 0; k < p.n_keys; k++) {
+        uint32_t pos = fill[ht_owner(keys[k], nr_of_dpus)]++;
+        part_keys[pos] = keys[k];
+        part_values[pos] = values[k];
+    }
+    ht_table_t *tables = (ht_table_t *) malloc(nr_of_dpus * sizeof(ht_table_t));
+    uint32_t n_buckets = ht_buckets_for(max_keys);
+    for (uint32_t i = 0; i < nr_of_dpus; i++)
+        tables[i].n_buckets = 0;
+    // A table that overflows doubles its buckets; rebuild every table with fewer
+    // buckets than the largest one until all of them agree (a rebuild can grow too)
+    for (bool grown = true; grown;) {
+        grown = false;
+        for (uint32_t i = 0; i < nr_of_dpus; i++) {
+            if (tables[i].n_buckets == n_buckets)
+                continue;
+            if (tables[i].n_buckets)
+                ht_free(&tables[i]);
+            ht_build(&tables[i], part_keys + key_count[i], part_values + key_count[i], key_count[i + 1] - key_count[i], n_buckets);
+            if (tables[i].n_buckets > n_buckets) {
+                n_buckets = tables[i].n_buckets;
+                grown = true;
+            }
+        }
+    }
+    uint32_t table_bytes = n_buckets * BUCKET_BYTES;
+    assert((uint64_t) n_buckets * BUCKET_BYTES + 2 * sizeof(DTYPE) <= DPU_CAPACITY && "Table does not fit in MRAM!");
+    unsigned int i = 0;
+    DPU_FOREACH(dpu_set, dpu, i) {
+        DPU_ASSERT(dpu_prepare_xfer(dpu, tables[i].buckets));
+    }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, table_bytes, DPU_XFER_DEFAULT));
+    stop(&timer, 4);
+    printf("Buckets per DPU %u (%u KB), keys per DPU %u max, load %.2f\n", n_buckets, table_bytes >> 10,
+            max_keys, (double) max_keys / ((double) n_buckets * BUCKET_SLOTS));
+
+    // Same layout on the host for the CPU version
+    ht_table_t table;
+    ht_build(&table, keys, values, p.n_keys, ht_buckets_for(p.n_keys));
+
+    router_t router;
+    memset(&router, 0, sizeof(router));
+    router.owner = (uint32_t *) malloc((uint64_t) p.batch * sizeof(uint32_t));
+    router.hist = (uint32_t *) malloc((uint64_t) p.n_threads * nr_of_dpus * sizeof(uint32_t));
+    router.count = (uint32_t *) malloc(nr_of_dpus * sizeof(uint32_t));
+    dpu_arguments_t *input_args = (dpu_arguments_t *) malloc(nr_of_dpus * sizeof(dpu_arguments_t));
+    dpu_results_t *dpu_results = (dpu_results_t *) malloc((uint64_t) nr_of_dpus * NR_TASKLETS * sizeof(dpu_results_t));
+    uint64_t lookups = 0, second_reads = 0;
+#if ENERGY
+    double tavg_energy=0;
+#endif
+
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+
+        if (rep >= p.n_warmup)
+            start(&timer, 0, rep - p.n_warmup);
+        // Computation on host CPU
+        ht_host(&table, queries, results_host, p.n_queries);
+        if (rep >= p.n_warmup)
+            stop(&timer, 0);
+
+        for (unsigned int first = 0, b = 0; first < p.n_queries; first += p.batch, b++) {
+            unsigned int n = first + p.batch < p.n_queries ? p.batch : p.n_queries - first;
+
+            if (rep >= p.n_warmup)
+                start(&timer, 1, rep - p.n_warmup + b);
+            route_queries(&router, queries + first, n, nr_of_dpus, p.n_threads);
+            uint32_t query_offset = table_bytes;
+            uint32_t result_offset = query_offset + router.cap * sizeof(DTYPE);
+            assert((uint64_t) result_offset + router.cap * sizeof(DTYPE) <= DPU_CAPACITY && "Batch does not fit in MRAM, use a smaller -b");
+            for (i = 0; i < nr_of_dpus; i++) {
+                input_args[i].n_queries = router.count[i];
+                input_args[i].bucket_mask = n_buckets - 1;
+                input_args[i].query_offset = query_offset;
+                input_args[i].result_offset = result_offset;
+            }
+
+            // Copy input arguments and queries to DPUs
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, router.queries + (uint64_t) router.cap * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, query_offset, router.cap * sizeof(DTYPE), DPU_XFER_DEFAULT));
+            if (rep >= p.n_warmup)
+                stop(&timer, 1);
+
+#if ENERGY
+            if (rep >= p.n_warmup) {
+                DPU_ASSERT(dpu_probe_start(&probe));
+            }
+#endif
+            if (rep >= p.n_warmup)
+                start(&timer, 2, rep - p.n_warmup + b); // Do not re-initialize the counter
+            // Launch kernel on DPUs
+            DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            if (rep >= p.n_warmup)
+                stop(&timer, 2);
+#if ENERGY
+            if (rep >= p.n_warmup) {
+                DPU_ASSERT(dpu_probe_stop(&probe));
+                double avg_energy;
+                DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &avg_energy));
+                tavg_energy += avg_energy;
+            }
+#endif
+
+#if PRINT
+            // Display DPU Logs
+            DPU_FOREACH(dpu_set, dpu) {
+                DPU_ASSERT(dpulog_read_for_dpu(dpu.dpu, stdout));
+            }
+#endif
+
+            if (rep >= p.n_warmup)
+                start(&timer, 3, rep - p.n_warmup + b);
+            // Retrieve results and put them back in query order
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, router.results + (uint64_t) router.cap * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, result_offset, router.cap * sizeof(DTYPE), DPU_XFER_DEFAULT));
+            unroute_results(&router, results + first, nr_of_dpus, p.n_threads);
+            if (rep >= p.n_warmup)
+                stop(&timer, 3);
+
+            // MRAM reads per lookup, from the last repetition
+            if (rep == p.n_warmup + p.n_reps - 1) {
+                DPU_FOREACH(dpu_set, dpu, i) {
+                    DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_results + (uint64_t) NR_TASKLETS * i));
+                }
+                DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "DPU_RESULTS", 0, NR_TASKLETS * sizeof(dpu_results_t), DPU_XFER_DEFAULT));
+                for (uint64_t t = 0; t < (uint64_t) nr_of_dpus * NR_TASKLETS; t++) {
+                    lookups += dpu_results[t].lookups;
+                    second_reads += dpu_results[t].second_reads;
+                }
+            }
+        }
+
+    }
+
+    // Print timing results
+    printf("CPU version ");
+    print(&timer, 0, p.n_reps);
+    printf("CPU-DPU ");
+    print(&timer, 1, p.n_reps);
+    printf("DPU Kernel ");
+    print(&timer, 2, p.n_reps);
+    printf("DPU-CPU ");
+    print(&timer, 3, p.n_reps);
+    printf("Table build and load ");
+    print(&timer, 4, 1);
+    printf("\n");
+
+    // Million lookups per second; end-to-end covers the table build and load plus routing, transfers,
+    // kernel and reordering of one repetition, as BS, which pushes its sorted array in every repetition
+    double ms_e2e = prim_timer_ms_avg(&timer, 4, 1) + prim_timer_ms_avg(&timer, 1, p.n_reps) + prim_timer_ms_avg(&timer, 2, p.n_reps) + prim_timer_ms_avg(&timer, 3, p.n_reps);
+    double mlookups_cpu = p.n_queries / (prim_timer_ms_avg(&timer, 0, p.n_reps) * 1e3);
+    double mlookups_dpu = p.n_queries / (prim_timer_ms_avg(&timer, 2, p.n_reps) * 1e3);
+    double mlookups_e2e = p.n_queries / (ms_e2e * 1e3);
+    printf("Mlookups/s CPU: %f\tDPU Kernel: %f\tEnd-to-end: %f\n", mlookups_cpu, mlookups_dpu, mlookups_e2e);
+    printf("MRAM bucket reads per lookup: %f\n", lookups ? 1.0 + (double) second_reads / lookups : 0.0);
+
+    // update CSV; BS writes the same Mlookups columns for the comparison at equal data size
+#define TEST_NAME "HT"
+#define RESULTS_FILE "../prim_results.csv"
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 0, p.n_reps, "CPU");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)p.n_queries, (double)nr_of_dpus);
+    update_csv(RESULTS_FILE, TEST_NAME, "Keys", (double)p.n_keys);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mlookups_CPU", mlookups_cpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mlookups_DPU", mlookups_dpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mlookups_E2E", mlookups_e2e);
+
+#if ENERGY
+    printf("DPU Energy (J): %f \t ", tavg_energy / p.n_reps);
+#endif
+
+    // Check output
+    bool status = true;
+    for (uint32_t q = 0; q < p.n_queries; q++) {
+        if (results_host[q] != results[q]) {
+            status = false;
+#if PRINT
+            printf("Query %u: %ld -- %ld\n", q, results_host[q], results[q]);
+#endif
+        }
+    }
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    for (i = 0; i < nr_of_dpus; i++)
+        ht_free(&tables[i]);
+    ht_free(&table);
+    free(tables);
+    free(keys);
+    free(values);
+    free(part_keys);
+    free(part_values);
+    free(key_count);
+    free(fill);
+    free(queries);
+    free(results_host);
+    free(results);
+    free(router.queries);
+    free(router.results);
+    free(router.perm);
+    free(router.owner);
+    free(router.hist);
+    free(router.count);
+    free(input_args);
+    free(dpu_results);
+    DPU_ASSERT(dpu_free(dpu_set));
+
+    return status ? 0 : -1;
+}
@@ -0,0 +1,59 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+// Hash-table point lookups: keys are hash-partitioned across the DPUs and every DPU
+// owns a bucketized cuckoo table in MRAM. A key lives in one of its two candidate
+// buckets, so a lookup costs one or two bucket-sized MRAM reads.
+
+// Transfer size between MRAM and WRAM (query and result blocks)
+#ifdef BL
+#define BLOCK_SIZE_LOG2 BL
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#else
+#define BLOCK_SIZE_LOG2 8
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#define BL BLOCK_SIZE_LOG2
+#endif
+
+// Key and value type, as BS
+#define DTYPE int64_t
+
+// Slots per bucket: a bucket holds the keys and then the values (64 bytes with 4 slots)
+#ifndef BUCKET_SLOTS
+#define BUCKET_SLOTS 4
+#endif
+#define BUCKET_BYTES (BUCKET_SLOTS * 2 * sizeof(DTYPE))
+#define EMPTY_KEY INT64_MIN   // Marks a free slot; not a valid key
+#define NOT_FOUND ((DTYPE) -1) // Result of a missing key
+
+typedef struct {
+    DTYPE keys[BUCKET_SLOTS];
+    DTYPE values[BUCKET_SLOTS];
+} bucket_t;
+
+// Structures used by both the host and the dpu to communicate information
+typedef struct {
+    uint32_t n_queries;     // Queries routed to this DPU
+    uint32_t bucket_mask;   // Buckets per DPU - 1 (a power of two)
+    uint32_t query_offset;  // Offsets in the MRAM heap; the table starts at 0
+    uint32_t result_offset;
+} dpu_arguments_t;
+
+typedef struct {
+    uint32_t lookups;
+    uint32_t second_reads;  // Lookups that needed the second bucket
+} dpu_results_t;
+
+#define DPU_CAPACITY (64 << 20) // A DPU's capacity is 64 MiB
+
+#ifndef ENERGY
+#define ENERGY 0
+#endif
+#define PRINT 0
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+#define divceil(n, m) (((n)-1) / (m) + 1)
+#endif
@@ -0,0 +1,47 @@
+#ifndef _HASH_H_
+#define _HASH_H_
+
+// Hash functions and bucket probe shared by the host, the DPUs and the CPU baseline.
+// Only 32-bit arithmetic, which the DPU does natively.
+
+#include <stdint.h>
+
+#include "common.h"
+
+#define SEED_OWNER   0x2545F491u // Owner DPU of a key
+#define SEED_BUCKET1 0x9E3779B1u
+#define SEED_BUCKET2 0x85EBCA77u
+
+// Both halves of the key, then the murmur3 finalizer
+static inline uint32_t ht_hash(DTYPE key, uint32_t seed) {
+    uint32_t h = ((uint32_t) key ^ seed) + (uint32_t) ((uint64_t) key >> 32) * 0xCC9E2D51u;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+static inline uint32_t ht_bucket1(DTYPE key, uint32_t mask) {
+    return ht_hash(key, SEED_BUCKET1) & mask;
+}
+
+// Never the same bucket as ht_bucket1 (tables have at least 2 buckets)
+static inline uint32_t ht_bucket2(DTYPE key, uint32_t mask) {
+    uint32_t b1 = ht_hash(key, SEED_BUCKET1) & mask;
+    uint32_t b2 = ht_hash(key, SEED_BUCKET2) & mask;
+    return b2 == b1 ? b1 ^ 1 : b2;
+}
+
+// Returns 1 and the value if key is in the bucket
+static inline int ht_probe(const bucket_t *bucket, DTYPE key, DTYPE *value) {
+    for (unsigned int s = 0; s < BUCKET_SLOTS; s++) {
+        if (bucket->keys[s] == key) {
+            *value = bucket->values[s];
+            return 1;
+        }
+    }
+    return 0;
+}
+#endif
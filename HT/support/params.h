@@ -0,0 +1,71 @@
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "common.h"
+
+typedef struct Params {
+    unsigned int   n_keys;
+    unsigned int   n_queries;
+    unsigned int   miss;
+    unsigned int   batch;
+    unsigned int   n_threads;
+    unsigned int   n_warmup;
+    unsigned int   n_reps;
+} Params;
+
+static void usage() {
+    fprintf(stderr,
+            "\nUsage:  ./program [options]"
+            "\n"
+            "\nGeneral options:"
+            "\n    -h        help"
+            "\n    -w <W>    # of untimed warmup iterations (default=1)"
+            "\n    -e <E>    # of timed repetition iterations (default=3)"
+            "\n    -t <T>    # of host threads for query routing, or of the CPU baseline (default=8)"
+            "\n"
+            "\nBenchmark-specific options:"
+            "\n    -n <N>    number of keys in the table (default=2048576, the array size of BS)"
+            "\n    -q <Q>    number of queries (default=1048576)"
+            "\n    -m <M>    queries for absent keys, in percent (default=10)"
+            "\n    -b <B>    queries per batch, 0 for a single batch (default=0)"
+            "\n");
+}
+
+struct Params input_params(int argc, char **argv) {
+    struct Params p;
+    p.n_warmup      = 1;
+    p.n_reps        = 3;
+    p.n_threads     = 8;
+    p.n_keys        = 2048576;
+    p.n_queries     = 1048576;
+    p.miss          = 10;
+    p.batch         = 0;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hw:e:t:n:q:m:b:")) >= 0) {
+        switch(opt) {
+            case 'h':
+                usage();
+                exit(0);
+                break;
+            case 'w': p.n_warmup      = atoi(optarg); break;
+            case 'e': p.n_reps        = atoi(optarg); break;
+            case 't': p.n_threads     = atoi(optarg); break;
+            case 'n': p.n_keys        = atoi(optarg); break;
+            case 'q': p.n_queries     = atoi(optarg); break;
+            case 'm': p.miss          = atoi(optarg); break;
+            case 'b': p.batch         = atoi(optarg); break;
+            default:
+                      fprintf(stderr, "\nUnrecognized option!\n");
+                      usage();
+                      exit(0);
+        }
+    }
+    if (p.batch == 0 || p.batch > p.n_queries)
+        p.batch = p.n_queries;
+    assert(p.n_keys > 0 && p.n_queries > 0 && "Invalid # of keys or queries!");
+    assert(p.miss <= 100 && p.n_threads > 0 && "Invalid miss rate or thread count!");
+
+    return p;
+}
+#endif
@@ -0,0 +1,137 @@
+#ifndef _TABLE_H_
+#define _TABLE_H_
+
+// Host-side key/query generator and cuckoo table builder, shared by the host
+// application and the CPU baseline. The buckets are laid out exactly as the DPUs
+// read them, so a DPU table is pushed to MRAM as is.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "hash.h"
+
+#define MAX_LOAD 0.85 // Largest fraction of occupied slots when a table is sized
+#define MAX_KICKS 512 // Evictions before an insertion gives up
+
+typedef struct {
+    bucket_t *buckets;
+    uint32_t n_buckets;
+    uint32_t mask;
+    uint64_t n_keys;
+} ht_table_t;
+
+// xorshift64*: the same queries and evictions for every run, host and baseline alike
+static inline uint64_t ht_rand(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+// splitmix64 finalizer, a bijection: key i of the table is ht_key(2 * i) and maps to
+// value i, odd inputs give keys that are never in the table
+static inline DTYPE ht_key(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return (DTYPE) (x ^ (x >> 31));
+}
+
+// Owner DPU of a key
+static inline uint32_t ht_owner(DTYPE key, uint32_t nr_of_dpus) {
+    return (uint32_t) (((uint64_t) ht_hash(key, SEED_OWNER) * nr_of_dpus) >> 32);
+}
+
+static void generate_keys(DTYPE *keys, DTYPE *values, uint64_t n_keys) {
+    for (uint64_t i = 0; i < n_keys; i++) {
+        keys[i] = ht_key(2 * i);
+        values[i] = (DTYPE) i;
+    }
+}
+
+// Uniform queries over the keys; miss percent of them look for absent keys
+static void generate_queries(DTYPE *queries, uint64_t n_queries, uint64_t n_keys, unsigned int miss, uint64_t seed) {
+    uint64_t s = seed * 0x9E3779B97F4A7C15ULL + 1;
+    for (uint64_t q = 0; q < n_queries; q++) {
+        uint64_t i = ht_rand(&s) % n_keys;
+        queries[q] = ht_rand(&s) % 100 < miss ? ht_key(2 * i + 1) : ht_key(2 * i);
+    }
+}
+
+// Smallest power of two number of buckets for n_keys at MAX_LOAD
+static uint32_t ht_buckets_for(uint64_t n_keys) {
+    uint64_t needed = (uint64_t) (n_keys / (BUCKET_SLOTS * MAX_LOAD)) + 1;
+    uint32_t n_buckets = 2;
+    while (n_buckets < needed)
+        n_buckets <<= 1;
+    return n_buckets;
+}
+
+static void ht_free(ht_table_t *t) {
+    free(t->buckets);
+    t->buckets = NULL;
+}
+
+// Cuckoo insertion: a free slot in either bucket, else evict a random slot and move
+// the victim to its other bucket. Returns 0 (and loses a key) if the table is too full.
+static int ht_insert(ht_table_t *t, DTYPE key, DTYPE value, uint64_t *s) {
+    uint32_t b = ht_bucket1(key, t->mask);
+    for (unsigned int kick = 0; kick < MAX_KICKS; kick++) {
+        uint32_t candidates[2] = {ht_bucket1(key, t->mask), ht_bucket2(key, t->mask)};
+        for (unsigned int c = 0; c < 2; c++) {
+            bucket_t *bucket = &t->buckets[candidates[c]];
+            for (unsigned int slot = 0; slot < BUCKET_SLOTS; slot++) {
+                if (bucket->keys[slot] == EMPTY_KEY) {
+                    bucket->keys[slot] = key;
+                    bucket->values[slot] = value;
+                    t->n_keys++;
+                    return 1;
+                }
+            }
+        }
+        bucket_t *bucket = &t->buckets[b];
+        unsigned int victim = ht_rand(s) % BUCKET_SLOTS;
+        DTYPE victim_key = bucket->keys[victim], victim_value = bucket->values[victim];
+        bucket->keys[victim] = key;
+        bucket->values[victim] = value;
+        key = victim_key;
+        value = victim_value;
+        b = ht_bucket1(key, t->mask) == b ? ht_bucket2(key, t->mask) : ht_bucket1(key, t->mask);
+    }
+    return 0;
+}
+
+// Builds a table of n keys with at least n_buckets buckets, doubling them until every key fits
+static void ht_build(ht_table_t *t, const DTYPE *keys, const DTYPE *values, uint64_t n, uint32_t n_buckets) {
+    for (;; n_buckets <<= 1) {
+        t->n_buckets = n_buckets;
+        t->mask = n_buckets - 1;
+        t->n_keys = 0;
+        t->buckets = (bucket_t *) malloc((uint64_t) n_buckets * sizeof(bucket_t));
+        for (uint32_t b = 0; b < n_buckets; b++) {
+            for (unsigned int slot = 0; slot < BUCKET_SLOTS; slot++) {
+                t->buckets[b].keys[slot] = EMPTY_KEY;
+                t->buckets[b].values[slot] = 0;
+            }
+        }
+        uint64_t s = 0x853C49E6748FEA9BULL;
+        uint64_t i = 0;
+        while (i < n && ht_insert(t, keys[i], values[i], &s))
+            i++;
+        if (i == n)
+            return;
+        ht_free(t);
+    }
+}
+
+// Probes the same one or two buckets as the DPU kernel
+static inline DTYPE ht_lookup(const ht_table_t *t, DTYPE key) {
+    DTYPE value;
+    if (ht_probe(&t->buckets[ht_bucket1(key, t->mask)], key, &value))
+        return value;
+    if (ht_probe(&t->buckets[ht_bucket2(key, t->mask)], key, &value))
+        return value;
+    return NOT_FOUND;
+}
+#endif
@@ -0,0 +1,77 @@
+/**
+* @file kmer.c
+* @brief k-mer counting on the CPU: the reads of the DPU version, counted by OpenMP threads
+* into a shared lock-free table
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include <omp.h>
+#include "../../support/timer.h"
+#include "../../support/rapl.h"
+#include "../../support/params.h"
+#include "../../support/reads.h"
+
+/**
+* @brief Main of the CPU baseline.
+*/
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    const uint64_t n_kmers = (uint64_t) p.n_reads * (p.read_length - p.k + 1);
+    char *reads = (char *) malloc((uint64_t) p.n_reads * p.read_length);
+    entry_t *top = (entry_t *) malloc(p.top * sizeof(entry_t));
+    km_table_t table;
+    km_table_init(&table, n_kmers < p.genome_length ? n_kmers : p.genome_length);
+    generate_reads(reads, p.n_reads, p.read_length, p.genome_length);
+    printf("Reads %u x %u bases (%.1fx coverage of %u), k %u\n", p.n_reads, p.read_length,
+            (double) p.n_reads * p.read_length / p.genome_length, p.genome_length, p.k);
+
+    Timer timer;
+    Energy energy;
+    uint32_t n_top = 0;
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+        if (rep >= p.n_warmup) {
+            energy_start(&energy, 0, rep - p.n_warmup);
+            start(&timer, 0, rep - p.n_warmup);
+        }
+        km_table_clear(&table, p.n_threads);
+        km_count(&table, reads, p.n_reads, p.read_length, p.k, p.n_threads);
+        n_top = km_top(top, p.top, &table);
+        if (rep >= p.n_warmup) {
+            stop(&timer, 0);
+            energy_stop(&energy, 0);
+        }
+    }
+
+    uint64_t distinct = 0;
+    for (uint64_t e = 0; e <= table.mask; e++)
+        distinct += table.entries[e].kmer != EMPTY_KMER;
+
+    printf("Kernel ");
+    print(&timer, 0, p.n_reps);
+    printf("\n");
+    printf("Mkmers/s: %f\tDistinct k-mers: %lu\n", n_kmers / (timer.time[0] / p.n_reps), (unsigned long) distinct);
+    for (uint32_t j = 0; j < n_top; j++) {
+        char kmer[MAX_K + 1];
+        km_decode(kmer, top[j].kmer, p.k);
+        printf("%s\t%lu\n", kmer, (unsigned long) top[j].count);
+    }
+    printf("Energy ");
+    energy_print(&energy, 0, p.n_reps, n_kmers);
+    printf("\n");
+
+    free(reads);
+    free(top);
+    free(table.entries);
+
+    return 0;
+}
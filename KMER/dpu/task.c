@@ -0,0 +1,208 @@
+/*
+* k-mer counting with multiple tasklets
+* Every tasklet rolls the canonical k-mers of its blocks of reads and counts the ones of
+* this DPU's partition in a direct-mapped WRAM cache; evicted entries are added to the
+* MRAM table. At the end the tasklets compact the table for the host
+*
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <barrier.h>
+#include <mutex_pool.h>
+
+#include "../support/common.h"
+#include "../support/kmer.h"
+
+__host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+__host dpu_results_t DPU_RESULTS;
+
+// Number of mutexes guarding the MRAM table buckets (bucket b uses lock b % NR_TABLE_LOCKS)
+#ifndef NR_TABLE_LOCKS
+#define NR_TABLE_LOCKS 8
+#endif
+
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+MUTEX_POOL_INIT(table_locks, NR_TABLE_LOCKS);
+
+// Entries in the buckets of every tasklet, for the compaction, and statistics
+static uint32_t entries[NR_TASKLETS];
+static dpu_results_t results[NR_TASKLETS];
+
+// Adds count to the entry of kmer, probing the buckets from b on; false if the table is full
+// Each bucket is updated under its lock. Slots are never freed, so a bucket a tasklet found full
+// stays full, and every tasklet adding the same k-mer finds it in the first free slot of its probe
+static bool table_add(uint32_t mram_base_addr_T, uint32_t bucket_mask, uint32_t b, uint64_t kmer, uint64_t count, entry_t *bucket) {
+    for (uint32_t probes = 0; probes <= bucket_mask; probes++, b = (b + 1) & bucket_mask) {
+        uint32_t addr = mram_base_addr_T + b * BUCKET_BYTES;
+        mutex_pool_lock(&table_locks, b);
+        mram_read((__mram_ptr void const*)addr, bucket, BUCKET_BYTES);
+        for (unsigned int s = 0; s < BUCKET_SLOTS; s++) {
+            if (bucket[s].kmer == kmer || bucket[s].kmer == EMPTY_KMER) {
+                bucket[s].kmer = kmer;
+                bucket[s].count += count;
+                mram_write(&bucket[s], (__mram_ptr void*)(addr + s * sizeof(entry_t)), sizeof(entry_t));
+                mutex_pool_unlock(&table_locks, b);
+                return true;
+            }
+        }
+        mutex_pool_unlock(&table_locks, b);
+    }
+    return false;
+}
+
+// main
+int main() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){
+        mem_reset(); // Reset the heap
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    uint32_t n_reads = DPU_INPUT_ARGUMENTS.n_reads;
+    uint32_t read_length = DPU_INPUT_ARGUMENTS.read_length;
+    uint32_t k = DPU_INPUT_ARGUMENTS.k;
+    uint32_t partition = DPU_INPUT_ARGUMENTS.partition;
+    uint32_t partition_bits = DPU_INPUT_ARGUMENTS.partition_bits;
+    uint32_t partition_mask = (1 << partition_bits) - 1;
+    uint32_t bucket_mask = DPU_INPUT_ARGUMENTS.bucket_mask;
+    uint32_t read_words = divceil(read_length, 32);
+    uint32_t table_bytes = (bucket_mask + 1) * BUCKET_BYTES;
+
+    // Addresses of the reads, table and compacted entries in MRAM
+    uint32_t mram_base_addr_R = (uint32_t)DPU_MRAM_HEAP_POINTER;
+    uint32_t mram_base_addr_T = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.table_offset);
+    uint32_t mram_base_addr_O = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.output_offset);
+
+    // Initialize a local cache to store the MRAM blocks, a bucket and the k-mer cache
+    entry_t *cache_B = (entry_t *) mem_alloc(BLOCK_SIZE);
+    entry_t *bucket = (entry_t *) mem_alloc(BUCKET_BYTES);
+    entry_t *cache = (entry_t *) mem_alloc(CACHE_ENTRIES * sizeof(entry_t));
+
+    // Clear the table
+    for (unsigned int i = 0; i < BLOCK_SIZE / sizeof(entry_t); i++) {
+        cache_B[i].kmer = EMPTY_KMER;
+        cache_B[i].count = 0;
+    }
+    for(unsigned int byte_index = tasklet_id << BLOCK_SIZE_LOG2; byte_index < table_bytes; byte_index += BLOCK_SIZE * NR_TASKLETS){
+        uint32_t l_size_bytes = (byte_index + BLOCK_SIZE >= table_bytes) ? (table_bytes - byte_index) : BLOCK_SIZE;
+        mram_write(cache_B, (__mram_ptr void*)(mram_base_addr_T + byte_index), l_size_bytes);
+    }
+    for (unsigned int i = 0; i < CACHE_ENTRIES; i++)
+        cache[i].kmer = EMPTY_KMER;
+
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    uint32_t kmers = 0, spills = 0, overflow = 0;
+    uint64_t *cache_R = (uint64_t *) cache_B;
+    uint32_t reads_per_block = BLOCK_SIZE / (read_words << 3);
+    for(unsigned int first = tasklet_id * reads_per_block; first < n_reads; first += reads_per_block * NR_TASKLETS){
+
+        // Bound checking
+        uint32_t n = first + reads_per_block <= n_reads ? reads_per_block : n_reads - first;
+
+        // Load cache with current MRAM block
+        mram_read((__mram_ptr void const*)(mram_base_addr_R + first * (read_words << 3)), cache_R, n * (read_words << 3));
+
+        for (unsigned int r = 0; r < n; r++) {
+            const uint64_t *read = cache_R + r * read_words;
+            uint64_t fwd = 0, rev = 0;
+            for (unsigned int i = 0; i < read_length; i++) {
+                km_roll(&fwd, &rev, (read[i >> 5] >> ((i & 31) << 1)) & 3, k);
+                if (i + 1 < k)
+                    continue;
+                uint64_t kmer = fwd < rev ? fwd : rev;
+                uint32_t h = km_hash(kmer);
+                if ((h & partition_mask) != partition)
+                    continue;
+                kmers++;
+
+                // Count in the cache; a different k-mer in the slot goes to the MRAM table
+                entry_t *e = &cache[(h >> 16) & (CACHE_ENTRIES - 1)];
+                if (e->kmer == kmer) {
+                    e->count++;
+                    continue;
+                }
+                if (e->kmer != EMPTY_KMER) {
+                    spills++;
+                    overflow |= !table_add(mram_base_addr_T, bucket_mask, (km_hash(e->kmer) >> partition_bits) & bucket_mask, e->kmer, e->count, bucket);
+                }
+                e->kmer = kmer;
+                e->count = 1;
+            }
+        }
+    }
+
+    // Flush the cache
+    for (unsigned int i = 0; i < CACHE_ENTRIES; i++) {
+        if (cache[i].kmer != EMPTY_KMER) {
+            spills++;
+            overflow |= !table_add(mram_base_addr_T, bucket_mask, (km_hash(cache[i].kmer) >> partition_bits) & bucket_mask, cache[i].kmer, cache[i].count, bucket);
+        }
+    }
+
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    // Compaction: every tasklet counts the entries of its range of buckets, then writes them
+    // after the entries of the previous tasklets
+    uint32_t range_bytes = divceil(bucket_mask + 1, NR_TASKLETS) * BUCKET_BYTES;
+    uint32_t first_byte = tasklet_id * range_bytes;
+    uint32_t last_byte = first_byte + range_bytes < table_bytes ? first_byte + range_bytes : table_bytes;
+    uint32_t count = 0;
+    for (unsigned int byte_index = first_byte; byte_index < last_byte; byte_index += BLOCK_SIZE) {
+        uint32_t l_size_bytes = (byte_index + BLOCK_SIZE >= last_byte) ? (last_byte - byte_index) : BLOCK_SIZE;
+        mram_read((__mram_ptr void const*)(mram_base_addr_T + byte_index), cache_B, l_size_bytes);
+        for (unsigned int i = 0; i < l_size_bytes / sizeof(entry_t); i++)
+            count += cache_B[i].kmer != EMPTY_KMER;
+    }
+    entries[tasklet_id] = count;
+    results[tasklet_id].overflow = overflow;
+    results[tasklet_id].kmers = kmers;
+    results[tasklet_id].spills = spills;
+
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    uint32_t offset = 0;
+    for (unsigned int t = 0; t < tasklet_id; t++)
+        offset += entries[t];
+    uint32_t n_out = 0;
+    for (unsigned int byte_index = first_byte; byte_index < last_byte; byte_index += BLOCK_SIZE) {
+        uint32_t l_size_bytes = (byte_index + BLOCK_SIZE >= last_byte) ? (last_byte - byte_index) : BLOCK_SIZE;
+        mram_read((__mram_ptr void const*)(mram_base_addr_T + byte_index), cache_B, l_size_bytes);
+        for (unsigned int i = 0; i < l_size_bytes / sizeof(entry_t); i++) {
+            if (cache_B[i].kmer == EMPTY_KMER)
+                continue;
+            cache[n_out++] = cache_B[i];
+            if (n_out == CACHE_ENTRIES) {
+                mram_write(cache, (__mram_ptr void*)(mram_base_addr_O + offset * sizeof(entry_t)), n_out * sizeof(entry_t));
+                offset += n_out;
+                n_out = 0;
+            }
+        }
+    }
+    if (n_out > 0)
+        mram_write(cache, (__mram_ptr void*)(mram_base_addr_O + offset * sizeof(entry_t)), n_out * sizeof(entry_t));
+
+    if (tasklet_id == 0) {
+        DPU_RESULTS.n_entries = DPU_RESULTS.overflow = DPU_RESULTS.kmers = DPU_RESULTS.spills = 0;
+        for (unsigned int t = 0; t < NR_TASKLETS; t++) {
+            DPU_RESULTS.n_entries += entries[t];
+            DPU_RESULTS.overflow |= results[t].overflow;
+            DPU_RESULTS.kmers += results[t].kmers;
+            DPU_RESULTS.spills += results[t].spills;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,288 @@
+/**
+* app.c
+* KMER Host Application Source File
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <omp.h>
+
+#include "../support/common.h"
+#include "../support/timer.h"
+#include "../support/params.h"
+#include "../support/kmer.h"
+#include "../support/reads.h"
+#include "../support/prim_results.h"
+
+#if ENERGY
+#include <dpu_probe.h>
+#endif
+
+// Define the DPU Binary path as DPU_BINARY here
+#ifndef DPU_BINARY
+#define DPU_BINARY "./bin/kmer_dpu"
+#endif
+
+// Adds the entries of every DPU to the table, one DPU per iteration
+static void merge_entries(km_table_t *t, const entry_t *entries, uint32_t max_entries, const dpu_results_t *results,
+        uint32_t nr_of_dpus, unsigned int n_threads) {
+    #pragma omp parallel for num_threads(n_threads) schedule(dynamic)
+    for (uint32_t i = 0; i < nr_of_dpus; i++) {
+        const entry_t *e = entries + (uint64_t) max_entries * i;
+        for (uint32_t j = 0; j < results[i].n_entries; j++)
+            km_table_add(t, e[j].kmer, e[j].count);
+    }
+}
+
+// Main of the Host Application
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+    struct dpu_set_t dpu_set, dpu;
+    uint32_t nr_of_dpus;
+
+#if ENERGY
+    struct dpu_probe_t probe;
+    DPU_ASSERT(dpu_probe_init("energy_probe", &probe));
+#endif
+
+    // Allocate DPUs and load binary
+    DPU_ASSERT(dpu_alloc(NR_DPUS, NULL, &dpu_set));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
+    printf("Allocated %d DPU(s)\n", nr_of_dpus);
+    printf("NR_TASKLETS\t%d\tBL\t%d\n", NR_TASKLETS, BL);
+    assert(nr_of_dpus % p.partitions == 0 && "The # of DPUs must be a multiple of the # of partitions!");
+
+    // DPU i counts partition i % P of the reads of group i / P
+    const uint32_t n_groups = nr_of_dpus / p.partitions;
+    const uint32_t partition_bits = __builtin_ctz(p.partitions);
+    const uint32_t reads_per_group = divceil(p.n_reads, n_groups);
+    const uint32_t read_words = divceil(p.read_length, 32);
+    const uint64_t kmers_per_read = p.read_length - p.k + 1;
+    const uint64_t n_kmers = (uint64_t) p.n_reads * kmers_per_read;
+    assert(read_words * sizeof(uint64_t) <= BLOCK_SIZE && "Reads do not fit in a block, use a larger BL!");
+
+    // Distinct canonical k-mers are bounded by the k-mers of the reads and by the genome
+    uint64_t max_distinct = (uint64_t) reads_per_group * kmers_per_read < p.genome_length ? (uint64_t) reads_per_group * kmers_per_read : p.genome_length;
+    uint32_t n_buckets = 1;
+    while ((uint64_t) n_buckets * BUCKET_SLOTS < 2 * max_distinct / p.partitions + 256)
+        n_buckets <<= 1;
+    const uint32_t read_bytes = reads_per_group * read_words * sizeof(uint64_t);
+    const uint32_t table_bytes = n_buckets * BUCKET_BYTES;
+    assert((uint64_t) read_bytes + 2 * (uint64_t) table_bytes <= DPU_CAPACITY && "Reads and tables do not fit in MRAM, use more DPUs!");
+
+    char *reads = (char *) malloc((uint64_t) p.n_reads * p.read_length);
+    uint64_t *packed = (uint64_t *) calloc((uint64_t) reads_per_group * n_groups * read_words, sizeof(uint64_t));
+    dpu_results_t *results = (dpu_results_t *) malloc(nr_of_dpus * sizeof(dpu_results_t));
+    entry_t *entries = NULL;
+    uint32_t entries_capacity = 0;
+    km_table_t table_host, table;
+    km_table_init(&table_host, n_kmers < p.genome_length ? n_kmers : p.genome_length);
+    km_table_init(&table, n_kmers < p.genome_length ? n_kmers : p.genome_length);
+    entry_t *top_host = (entry_t *) malloc(p.top * sizeof(entry_t));
+    entry_t *top = (entry_t *) malloc(p.top * sizeof(entry_t));
+    generate_reads(reads, p.n_reads, p.read_length, p.genome_length);
+    printf("Reads %u x %u bases (%.1fx coverage of %u), k %u, %u groups x %u partitions, %u buckets per DPU\n",
+            p.n_reads, p.read_length, (double) p.n_reads * p.read_length / p.genome_length, p.genome_length, p.k,
+            n_groups, p.partitions, n_buckets);
+
+    dpu_arguments_t *input_args = (dpu_arguments_t *) malloc(nr_of_dpus * sizeof(dpu_arguments_t));
+    for (unsigned int i = 0; i < nr_of_dpus; i++) {
+        uint64_t first = (uint64_t) reads_per_group * (i / p.partitions);
+        input_args[i].n_reads = first >= p.n_reads ? 0 : first + reads_per_group <= p.n_reads ? reads_per_group : p.n_reads - first;
+        input_args[i].read_length = p.read_length;
+        input_args[i].k = p.k;
+        input_args[i].partition = i % p.partitions;
+        input_args[i].partition_bits = partition_bits;
+        input_args[i].bucket_mask = n_buckets - 1;
+        input_args[i].table_offset = read_bytes;
+        input_args[i].output_offset = read_bytes + table_bytes;
+    }
+
+    // Timer
+    Timer timer;
+#if ENERGY
+    double tavg_energy=0;
+#endif
+    uint32_t n_top_host = 0, n_top = 0;
+    uint64_t spills = 0, overflow = 0;
+
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+
+        if (rep >= p.n_warmup)
+            start(&timer, 0, rep - p.n_warmup);
+        // Computation on host CPU
+        km_table_clear(&table_host, p.n_threads);
+        km_count(&table_host, reads, p.n_reads, p.read_length, p.k, p.n_threads);
+        n_top_host = km_top(top_host, p.top, &table_host);
+        if (rep >= p.n_warmup)
+            stop(&timer, 0);
+
+        if (rep >= p.n_warmup)
+            start(&timer, 1, rep - p.n_warmup);
+        // Pack the reads and copy every group of reads to its DPUs, with the input arguments
+        pack_reads(packed, reads, p.n_reads, p.read_length, p.n_threads);
+        unsigned int i = 0;
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, packed + (uint64_t) reads_per_group * read_words * (i / p.partitions)));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, read_bytes, DPU_XFER_DEFAULT));
+        if (rep >= p.n_warmup)
+            stop(&timer, 1);
+
+#if ENERGY
+        if (rep >= p.n_warmup) {
+            DPU_ASSERT(dpu_probe_start(&probe));
+        }
+#endif
+        if (rep >= p.n_warmup)
+            start(&timer, 2, rep - p.n_warmup);
+        // Launch kernel on DPUs
+        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+        if (rep >= p.n_warmup)
+            stop(&timer, 2);
+#if ENERGY
+        if (rep >= p.n_warmup) {
+            DPU_ASSERT(dpu_probe_stop(&probe));
+            double avg_energy;
+            DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &avg_energy));
+            tavg_energy += avg_energy;
+        }
+#endif
+
+#if PRINT
+        // Display DPU Logs
+        DPU_FOREACH(dpu_set, dpu) {
+            DPU_ASSERT(dpulog_read_for_dpu(dpu.dpu, stdout));
+        }
+#endif
+
+        if (rep >= p.n_warmup)
+            start(&timer, 3, rep - p.n_warmup);
+        // Retrieve the compacted tables and merge them
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, results + i));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "DPU_RESULTS", 0, sizeof(dpu_results_t), DPU_XFER_DEFAULT));
+        uint32_t max_entries = 0;
+        spills = overflow = 0;
+        for (i = 0; i < nr_of_dpus; i++) {
+            if (results[i].n_entries > max_entries)
+                max_entries = results[i].n_entries;
+            spills += results[i].spills;
+            overflow |= results[i].overflow;
+        }
+        if (max_entries > entries_capacity) {
+            free(entries);
+            entries = (entry_t *) malloc((uint64_t) max_entries * nr_of_dpus * sizeof(entry_t));
+            entries_capacity = max_entries;
+        }
+        if (max_entries > 0) {
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, entries + (uint64_t) max_entries * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, input_args[0].output_offset, max_entries * sizeof(entry_t), DPU_XFER_DEFAULT));
+        }
+        km_table_clear(&table, p.n_threads);
+        merge_entries(&table, entries, max_entries, results, nr_of_dpus, p.n_threads);
+        n_top = km_top(top, p.top, &table);
+        if (rep >= p.n_warmup)
+            stop(&timer, 3);
+
+    }
+
+    // Print timing results
+    printf("CPU version ");
+    print(&timer, 0, p.n_reps);
+    printf("CPU-DPU ");
+    print(&timer, 1, p.n_reps);
+    printf("DPU Kernel ");
+    print(&timer, 2, p.n_reps);
+    printf("DPU-CPU ");
+    print(&timer, 3, p.n_reps);
+    printf("\n");
+
+    // k-mers counted per second; end-to-end covers packing, the kernel and the merge
+    double ms_e2e = prim_timer_ms_avg(&timer, 1, p.n_reps) + prim_timer_ms_avg(&timer, 2, p.n_reps) + prim_timer_ms_avg(&timer, 3, p.n_reps);
+    double mkmers_cpu = n_kmers / (prim_timer_ms_avg(&timer, 0, p.n_reps) * 1e3);
+    double mkmers_dpu = n_kmers / (prim_timer_ms_avg(&timer, 2, p.n_reps) * 1e3);
+    double mkmers_e2e = n_kmers / (ms_e2e * 1e3);
+    printf("Mkmers/s CPU (%u threads): %f\tDPU Kernel: %f\tEnd-to-end: %f\n", p.n_threads, mkmers_cpu, mkmers_dpu, mkmers_e2e);
+    printf("WRAM cache hit rate: %f\n", 1.0 - (double) spills / n_kmers);
+    for (uint32_t j = 0; j < n_top; j++) {
+        char kmer[MAX_K + 1];
+        km_decode(kmer, top[j].kmer, p.k);
+        printf("%s\t%lu\n", kmer, (unsigned long) top[j].count);
+    }
+
+    // update CSV
+#define TEST_NAME "KMER"
+#define RESULTS_FILE "../prim_results.csv"
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 0, p.n_reps, "CPU");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    // Elements are the k-mers of the reads
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)n_kmers, (double)nr_of_dpus);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mkmers_CPU", mkmers_cpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mkmers_DPU", mkmers_dpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mkmers_E2E", mkmers_e2e);
+
+#if ENERGY
+    printf("DPU Energy (J): %f \t ", tavg_energy / p.n_reps);
+#endif
+
+    // Check output: the same distinct k-mers and counts, and the same top k-mers
+    bool status = !overflow && n_top == n_top_host;
+    if (overflow)
+        printf("DPU tables are full\n");
+    uint64_t distinct_host = 0, distinct = 0;
+    for (uint64_t e = 0; e <= table_host.mask; e++) {
+        if (table_host.entries[e].kmer == EMPTY_KMER)
+            continue;
+        distinct_host++;
+        if (km_table_get(&table, table_host.entries[e].kmer) != table_host.entries[e].count) {
+            status = false;
+#if PRINT
+            printf("k-mer %lx: %lu -- %lu\n", table_host.entries[e].kmer, table_host.entries[e].count, km_table_get(&table, table_host.entries[e].kmer));
+#endif
+        }
+    }
+    for (uint64_t e = 0; e <= table.mask; e++)
+        distinct += table.entries[e].kmer != EMPTY_KMER;
+    for (uint32_t j = 0; j < n_top && status; j++)
+        status = top[j].kmer == top_host[j].kmer && top[j].count == top_host[j].count;
+    status = status && distinct == distinct_host;
+    printf("Distinct k-mers: %lu\n", (unsigned long) distinct);
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    free(reads);
+    free(packed);
+    free(results);
+    free(entries);
+    free(table_host.entries);
+    free(table.entries);
+    free(top_host);
+    free(top);
+    free(input_args);
+    DPU_ASSERT(dpu_free(dpu_set));
+
+    return status ? 0 : -1;
+}
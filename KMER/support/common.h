@@ -0,0 +1,74 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+// k-mer counting over 2-bit packed reads: the DPUs form groups of P partitions, every
+// group counts a share of the reads, and every DPU of a group counts the canonical
+// k-mers of its hash partition in a table in MRAM, fronted by a WRAM cache per tasklet.
+// The host merges the tables of the groups.
+
+// Transfer size between MRAM and WRAM (blocks of packed reads, table clear and compaction)
+#ifdef BL
+#define BLOCK_SIZE_LOG2 BL
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#else
+#define BLOCK_SIZE_LOG2 10
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#define BL BLOCK_SIZE_LOG2
+#endif
+
+// Entries of the direct-mapped WRAM cache of every tasklet, a power of 2; an evicted entry
+// is added to the MRAM table. The cache is also the output buffer of the compaction, so it
+// takes at most 2048 bytes.
+#ifndef CACHE_ENTRIES
+#define CACHE_ENTRIES 64
+#endif
+#if CACHE_ENTRIES > 128 || (CACHE_ENTRIES & (CACHE_ENTRIES - 1))
+#error CACHE_ENTRIES must be a power of 2 up to 128
+#endif
+
+// Entries of an MRAM bucket, read and locked together
+#define BUCKET_SLOTS 4
+#define BUCKET_BYTES (BUCKET_SLOTS * sizeof(entry_t))
+
+#define MAX_K 31
+#define MAX_READ_LENGTH 4096
+
+// A k-mer (2 bits per base, the first base in the highest bits) and its count
+typedef struct {
+    uint64_t kmer;
+    uint64_t count;
+} entry_t;
+#define EMPTY_KMER 0xFFFFFFFFFFFFFFFFULL // Not a k-mer for k <= 31
+
+// Structures used by both the host and the dpu to communicate information
+typedef struct {
+    uint32_t n_reads;        // Reads of the group of this DPU
+    uint32_t read_length;    // Bases; a read takes divceil(read_length, 32) words
+    uint32_t k;
+    uint32_t partition;      // Hash partition of this DPU in its group
+    uint32_t partition_bits; // log2 of the partitions per group
+    uint32_t bucket_mask;    // Buckets of the table - 1
+    uint32_t table_offset;   // Offsets in the MRAM heap; the reads start at 0
+    uint32_t output_offset;  // Entries of the table, compacted
+} dpu_arguments_t;
+
+typedef struct {
+    uint32_t n_entries; // Distinct k-mers
+    uint32_t overflow;  // The table is full, some k-mers are not counted
+    uint32_t kmers;     // k-mers of this partition
+    uint32_t spills;    // Entries added to the MRAM table
+} dpu_results_t;
+
+#define DPU_CAPACITY (64 << 20) // A DPU's capacity is 64 MiB
+
+#ifndef ENERGY
+#define ENERGY 0
+#endif
+#define PRINT 0
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+#define divceil(n, m) (((n)-1) / (m) + 1)
+#endif
@@ -0,0 +1,36 @@
+#ifndef _KMER_H_
+#define _KMER_H_
+
+// Base encoding, rolling canonical k-mers and the k-mer hash, shared by the host, the
+// DPUs and the CPU baseline. The hash only uses 32-bit arithmetic: the DPU has no 32-bit
+// multiplier and emulates each multiply with mul_step instructions, which is still much
+// cheaper than 64-bit arithmetic. Its low partition_bits pick the partition, the next bits
+// the bucket.
+
+#include <stdint.h>
+
+#include "common.h"
+
+// A = 0, C = 1, T = 2, G = 3 (bits 1-2 of the ASCII code); the complement is b ^ 2
+#define KM_BASE(c) (((c) >> 1) & 3)
+#define KM_COMPLEMENT(b) ((b) ^ 2)
+#define KM_BASES "ACTG"
+
+// Shifts a base into the k-mer and into its reverse complement; the canonical k-mer is
+// the smaller of the two
+static inline void km_roll(uint64_t *fwd, uint64_t *rev, uint32_t b, uint32_t k) {
+    *fwd = ((*fwd << 2) | b) & ((1ULL << (2 * k)) - 1);
+    *rev = (*rev >> 2) | ((uint64_t) KM_COMPLEMENT(b) << (2 * (k - 1)));
+}
+
+// Both halves of the k-mer, then the murmur3 finalizer
+static inline uint32_t km_hash(uint64_t kmer) {
+    uint32_t h = ((uint32_t) kmer ^ 0x9E3779B1u) + (uint32_t) (kmer >> 32) * 0xCC9E2D51u;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+#endif
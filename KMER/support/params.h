@@ -0,0 +1,81 @@
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "common.h"
+
+typedef struct Params {
+    unsigned int   n_reads;
+    unsigned int   read_length;
+    unsigned int   k;
+    unsigned int   genome_length;
+    unsigned int   partitions;
+    unsigned int   top;
+    unsigned int   n_threads;
+    unsigned int   n_warmup;
+    unsigned int   n_reps;
+} Params;
+
+static void usage() {
+    fprintf(stderr,
+            "\nUsage:  ./program [options]"
+            "\n"
+            "\nGeneral options:"
+            "\n    -h        help"
+            "\n    -w <W>    # of untimed warmup iterations (default=1)"
+            "\n    -e <E>    # of timed repetition iterations (default=3)"
+            "\n    -t <T>    # of host threads for packing and merging, or of the CPU baseline (default=8)"
+            "\n"
+            "\nBenchmark-specific options:"
+            "\n    -r <R>    number of reads (default=65536)"
+            "\n    -l <L>    read length in bases, up to 4096 (default=150)"
+            "\n    -k <K>    k-mer length, up to 31 (default=21)"
+            "\n    -g <G>    length of the genome the reads are sampled from (default=1048576)"
+            "\n    -p <P>    hash partitions (DPUs) per group of reads, a power of 2 (default=4)"
+            "\n    -n <N>    most frequent k-mers to print (default=10)"
+            "\n");
+}
+
+struct Params input_params(int argc, char **argv) {
+    struct Params p;
+    p.n_warmup      = 1;
+    p.n_reps        = 3;
+    p.n_threads     = 8;
+    p.n_reads       = 65536;
+    p.read_length   = 150;
+    p.k             = 21;
+    p.genome_length = 1048576;
+    p.partitions    = 4;
+    p.top           = 10;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hw:e:t:r:l:k:g:p:n:")) >= 0) {
+        switch(opt) {
+            case 'h':
+                usage();
+                exit(0);
+                break;
+            case 'w': p.n_warmup      = atoi(optarg); break;
+            case 'e': p.n_reps        = atoi(optarg); break;
+            case 't': p.n_threads     = atoi(optarg); break;
+            case 'r': p.n_reads       = atoi(optarg); break;
+            case 'l': p.read_length   = atoi(optarg); break;
+            case 'k': p.k             = atoi(optarg); break;
+            case 'g': p.genome_length = atoi(optarg); break;
+            case 'p': p.partitions    = atoi(optarg); break;
+            case 'n': p.top           = atoi(optarg); break;
+            default:
+                      fprintf(stderr, "\nUnrecognized option!\n");
+                      usage();
+                      exit(0);
+        }
+    }
+    assert(p.n_reads > 0 && "Invalid # of reads!");
+    assert(p.k > 0 && p.k <= MAX_K && "Invalid k!");
+    assert(p.read_length >= p.k && p.read_length <= MAX_READ_LENGTH && "Invalid read length!");
+    assert(p.genome_length >= p.read_length && "Invalid genome length!");
+    assert(p.partitions > 0 && (p.partitions & (p.partitions - 1)) == 0 && "Invalid # of partitions, must be a power of 2!");
+    assert(p.n_threads > 0 && "Invalid # of threads!");
+
+    return p;
+}
+#endif
@@ -0,0 +1,144 @@
+#ifndef _READS_H_
+#define _READS_H_
+
+// Host-side read generator, 2-bit packing, the shared k-mer table and the reference
+// count, used by the host application and the CPU baseline.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "kmer.h"
+
+// xorshift64*: the same genome and reads for every run, host and baseline alike
+static inline uint64_t km_rand(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+// Reads of a random genome from random positions of either strand (ASCII, no separators),
+// so every k-mer of the genome is seen about n_reads * read_length / genome_length times
+static void generate_reads(char *reads, uint64_t n_reads, uint32_t read_length, uint32_t genome_length) {
+    uint64_t s = 0x853C49E6748FEA9BULL;
+    char *genome = (char *) malloc(genome_length);
+    for (uint32_t i = 0; i < genome_length; i++)
+        genome[i] = KM_BASES[km_rand(&s) & 3];
+    for (uint64_t r = 0; r < n_reads; r++) {
+        uint64_t x = km_rand(&s);
+        const char *g = genome + (x >> 1) % (genome_length - read_length + 1);
+        char *read = reads + r * read_length;
+        for (uint32_t i = 0; i < read_length; i++)
+            read[i] = x & 1 ? KM_BASES[KM_COMPLEMENT(KM_BASE(g[read_length - 1 - i]))] : g[i];
+    }
+    free(genome);
+}
+
+// Packs every read into divceil(read_length, 32) words, base i at bits 2 * (i % 32) of word i / 32
+static inline void pack_reads(uint64_t *packed, const char *reads, uint64_t n_reads, uint32_t read_length, unsigned int n_threads) {
+    const uint32_t words = divceil(read_length, 32);
+    #pragma omp parallel for num_threads(n_threads) schedule(static)
+    for (uint64_t r = 0; r < n_reads; r++) {
+        const char *read = reads + r * read_length;
+        for (uint32_t w = 0; w < words; w++) {
+            uint64_t word = 0;
+            for (uint32_t i = w * 32; i < read_length && i < w * 32 + 32; i++)
+                word |= (uint64_t) KM_BASE(read[i]) << (2 * (i % 32));
+            packed[r * words + w] = word;
+        }
+    }
+}
+
+// Open addressing with linear probing; concurrent adds claim empty slots with a CAS
+typedef struct {
+    entry_t *entries;
+    uint64_t mask;
+} km_table_t;
+
+// At least twice as many slots as distinct k-mers
+static void km_table_init(km_table_t *t, uint64_t max_kmers) {
+    uint64_t slots = 2;
+    while (slots < 2 * max_kmers)
+        slots <<= 1;
+    t->entries = (entry_t *) malloc(slots * sizeof(entry_t));
+    t->mask = slots - 1;
+}
+
+static void km_table_clear(km_table_t *t, unsigned int n_threads) {
+    #pragma omp parallel for num_threads(n_threads) schedule(static)
+    for (uint64_t i = 0; i <= t->mask; i++) {
+        t->entries[i].kmer = EMPTY_KMER;
+        t->entries[i].count = 0;
+    }
+}
+
+static inline void km_table_add(km_table_t *t, uint64_t kmer, uint64_t count) {
+    for (uint64_t i = km_hash(kmer) & t->mask; ; i = (i + 1) & t->mask) {
+        entry_t *e = &t->entries[i];
+        uint64_t cur = __atomic_load_n(&e->kmer, __ATOMIC_ACQUIRE);
+        if (cur == EMPTY_KMER) {
+            uint64_t expected = EMPTY_KMER;
+            if (__atomic_compare_exchange_n(&e->kmer, &expected, kmer, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                cur = kmer;
+            else
+                cur = expected;
+        }
+        if (cur == kmer) {
+            __atomic_fetch_add(&e->count, count, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+}
+
+static inline uint64_t km_table_get(const km_table_t *t, uint64_t kmer) {
+    for (uint64_t i = km_hash(kmer) & t->mask; t->entries[i].kmer != EMPTY_KMER; i = (i + 1) & t->mask)
+        if (t->entries[i].kmer == kmer)
+            return t->entries[i].count;
+    return 0;
+}
+
+// Counts the canonical k-mers of every read, one read per iteration
+static void km_count(km_table_t *t, const char *reads, uint64_t n_reads, uint32_t read_length, uint32_t k, unsigned int n_threads) {
+    #pragma omp parallel for num_threads(n_threads) schedule(static)
+    for (uint64_t r = 0; r < n_reads; r++) {
+        const char *read = reads + r * read_length;
+        uint64_t fwd = 0, rev = 0;
+        for (uint32_t i = 0; i < read_length; i++) {
+            km_roll(&fwd, &rev, KM_BASE(read[i]), k);
+            if (i + 1 >= k)
+                km_table_add(t, fwd < rev ? fwd : rev, 1);
+        }
+    }
+}
+
+// a is more frequent than b, ties go to the smaller k-mer
+static inline int km_before(entry_t a, entry_t b) {
+    return a.count > b.count || (a.count == b.count && a.kmer < b.kmer);
+}
+
+// The n most frequent k-mers, in order; returns how many there are
+static uint32_t km_top(entry_t *top, uint32_t n, const km_table_t *t) {
+    uint32_t size = 0;
+    if (n == 0)
+        return 0;
+    for (uint64_t i = 0; i <= t->mask; i++) {
+        entry_t e = t->entries[i];
+        if (e.kmer == EMPTY_KMER || (size == n && !km_before(e, top[n - 1])))
+            continue;
+        uint32_t j = size < n ? size++ : n - 1;
+        for (; j > 0 && km_before(e, top[j - 1]); j--)
+            top[j] = top[j - 1];
+        top[j] = e;
+    }
+    return size;
+}
+
+static void km_decode(char *out, uint64_t kmer, uint32_t k) {
+    for (uint32_t i = 0; i < k; i++)
+        out[i] = KM_BASES[(kmer >> (2 * (k - 1 - i))) & 3];
+    out[k] = '\0';
+}
+#endif
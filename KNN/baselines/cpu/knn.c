@@ -0,0 +1,79 @@
+/**
+* @file knn.c
+* @brief Brute-force top-k search on the CPU: the vectors and queries of the DPU version, OpenMP over queries
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include <omp.h>
+#include "../../support/timer.h"
+#include "../../support/rapl.h"
+#include "../../support/params.h"
+#include "../../support/vectors.h"
+
+/**
+* @brief exact top-k of every query, one query per iteration
+*/
+static void knn(neighbor_t *out, const T *vectors, uint64_t n_vectors, uint32_t dim, const T *queries, uint32_t n_queries,
+        uint32_t k, uint32_t metric, int t) {
+    omp_set_num_threads(t);
+    #pragma omp parallel for schedule(dynamic)
+    for (uint32_t q = 0; q < n_queries; q++)
+        knn_query(out + (uint64_t) q * k, vectors, n_vectors, dim, queries + (uint64_t) q * dim, k, metric);
+}
+
+/**
+* @brief Main of the CPU baseline.
+*/
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    T *vectors = (T *) malloc((uint64_t) p.n_vectors * p.dim * sizeof(T));
+    T *queries = (T *) malloc((uint64_t) p.n_queries * p.dim * sizeof(T));
+    neighbor_t *neighbors = (neighbor_t *) malloc((uint64_t) p.n_queries * p.k * sizeof(neighbor_t));
+    generate_vectors(vectors, p.n_vectors, p.dim);
+    generate_queries(queries, p.n_queries, vectors, p.n_vectors, p.dim);
+    printf("Vectors %u x %u int8 (%lu MB), queries %u, k %u, %s\n", p.n_vectors, p.dim,
+            (unsigned long) (((uint64_t) p.n_vectors * p.dim) >> 20), p.n_queries, p.k,
+            p.metric == METRIC_IP ? "inner product" : "squared L2");
+
+    Timer timer;
+    Energy energy;
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+        if (rep >= p.n_warmup) {
+            energy_start(&energy, 0, rep - p.n_warmup);
+            start(&timer, 0, rep - p.n_warmup);
+        }
+        knn(neighbors, vectors, p.n_vectors, p.dim, queries, p.n_queries, p.k, p.metric, p.n_threads);
+        if (rep >= p.n_warmup) {
+            stop(&timer, 0);
+            energy_stop(&energy, 0);
+        }
+    }
+
+    uint64_t checksum = 0;
+    for (uint64_t e = 0; e < (uint64_t) p.n_queries * p.k; e++)
+        checksum += neighbors[e].id;
+
+    printf("Kernel ");
+    print(&timer, 0, p.n_reps);
+    printf("\n");
+    printf("Queries/s: %f\tChecksum: %lu\n", p.n_queries / (timer.time[0] / p.n_reps * 1e-6), (unsigned long) checksum);
+    printf("Energy ");
+    energy_print(&energy, 0, p.n_reps, p.n_queries);
+    printf("\n");
+
+    free(vectors);
+    free(queries);
+    free(neighbors);
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+* Brute-force top-k search with multiple tasklets
+* Every tasklet scores blocks of database vectors against the whole batch of queries and
+* keeps its own top-k list per query; after a barrier the lists of a query are merged by
+* one tasklet and written best first
+*
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <barrier.h>
+
+#include "../support/common.h"
+#include "../support/topk.h"
+
+__host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+// Queries of the batch and top-k lists of every tasklet, shared for the merge
+static T *cache_Q;
+static neighbor_t *lists[NR_TASKLETS];
+static uint32_t *sizes[NR_TASKLETS];
+
+// main
+int main() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    uint32_t n_vectors = DPU_INPUT_ARGUMENTS.n_vectors;
+    uint32_t first_id = DPU_INPUT_ARGUMENTS.first_id;
+    uint32_t dim = DPU_INPUT_ARGUMENTS.dim;
+    uint32_t n_queries = DPU_INPUT_ARGUMENTS.n_queries;
+    uint32_t k = DPU_INPUT_ARGUMENTS.k;
+    uint32_t metric = DPU_INPUT_ARGUMENTS.metric;
+
+    // Addresses of the vectors, queries and neighbors in MRAM
+    uint32_t mram_base_addr_V = (uint32_t)DPU_MRAM_HEAP_POINTER;
+    uint32_t mram_base_addr_Q = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.query_offset);
+    uint32_t mram_base_addr_O = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.output_offset);
+
+    if (tasklet_id == 0){
+        mem_reset(); // Reset the heap
+
+        // Load the queries once for all tasklets
+        uint32_t query_bytes = n_queries * dim;
+        cache_Q = (T *) mem_alloc(query_bytes);
+        for (uint32_t byte_index = 0; byte_index < query_bytes; byte_index += 2048) {
+            uint32_t l_size_bytes = query_bytes - byte_index < 2048 ? query_bytes - byte_index : 2048;
+            mram_read((__mram_ptr void const*)(mram_base_addr_Q + byte_index), (uint8_t *) cache_Q + byte_index, l_size_bytes);
+        }
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    // Initialize a local cache to store the MRAM blocks, and the top-k lists of this tasklet
+    uint32_t vectors_per_block = dim < BLOCK_SIZE ? BLOCK_SIZE / dim : 1;
+    T *cache_V = (T *) mem_alloc(BLOCK_SIZE > MAX_DIM ? BLOCK_SIZE : MAX_DIM);
+    neighbor_t *list = (neighbor_t *) mem_alloc(n_queries * k * sizeof(neighbor_t));
+    uint32_t *size = (uint32_t *) mem_alloc(n_queries * sizeof(uint32_t));
+    neighbor_t *merged = (neighbor_t *) mem_alloc(MAX_K * sizeof(neighbor_t));
+    lists[tasklet_id] = list;
+    sizes[tasklet_id] = size;
+    for (unsigned int q = 0; q < n_queries; q++)
+        size[q] = 0;
+
+    for(unsigned int first = tasklet_id * vectors_per_block; first < n_vectors; first += vectors_per_block * NR_TASKLETS){
+
+        // Bound checking
+        uint32_t n = first + vectors_per_block <= n_vectors ? vectors_per_block : n_vectors - first;
+
+        // Load cache with current MRAM block
+        mram_read((__mram_ptr void const*)(mram_base_addr_V + first * dim), cache_V, n * dim);
+
+        for (unsigned int v = 0; v < n; v++) {
+            for (unsigned int q = 0; q < n_queries; q++) {
+                neighbor_t x = {knn_score(cache_V + v * dim, cache_Q + q * dim, dim, metric), first_id + first + v};
+                topk_push(list + q * k, &size[q], k, x);
+            }
+        }
+    }
+
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    // Merge the lists of every tasklet for the queries of this tasklet
+    for (unsigned int q = tasklet_id; q < n_queries; q += NR_TASKLETS) {
+        uint32_t n = 0;
+        for (unsigned int t = 0; t < NR_TASKLETS; t++)
+            for (unsigned int j = 0; j < sizes[t][q]; j++)
+                topk_push(merged, &n, k, lists[t][q * k + j]);
+        topk_sort(merged, n, k);
+
+        // Write the neighbors of the query
+        mram_write(merged, (__mram_ptr void*)(mram_base_addr_O + q * k * sizeof(neighbor_t)), k * sizeof(neighbor_t));
+    }
+
+    return 0;
+}
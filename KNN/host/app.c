@@ -0,0 +1,298 @@
+/**
+* app.c
+* KNN Host Application Source File
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <omp.h>
+
+#include "../support/common.h"
+#include "../support/timer.h"
+#include "../support/params.h"
+#include "../support/topk.h"
+#include "../support/vectors.h"
+#include "../support/prim_results.h"
+
+#if ENERGY
+#include <dpu_probe.h>
+#endif
+
+// Define the DPU Binary path as DPU_BINARY here
+#ifndef DPU_BINARY
+#define DPU_BINARY "./bin/knn_dpu"
+#endif
+
+// Head of the list of one DPU during the merge
+typedef struct {
+    neighbor_t x;
+    uint32_t dpu;
+    uint32_t pos;
+} head_t;
+
+static inline void heads_sift_down(head_t *heap, uint32_t n, uint32_t i) {
+    head_t h = heap[i];
+    for (;;) {
+        uint32_t c = 2 * i + 1;
+        if (c >= n)
+            break;
+        if (c + 1 < n && topk_better(heap[c + 1].x, heap[c].x))
+            c++;
+        if (!topk_better(heap[c].x, h.x))
+            break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    heap[i] = h;
+}
+
+// Exact search on the host CPU; one query per thread iteration
+static void knn_host(neighbor_t *out, const T *vectors, uint64_t n_vectors, uint32_t dim, const T *queries, uint32_t n_queries,
+        uint32_t k, uint32_t metric, unsigned int n_threads) {
+    #pragma omp parallel for num_threads(n_threads) schedule(dynamic)
+    for (uint32_t q = 0; q < n_queries; q++)
+        knn_query(out + (uint64_t) q * k, vectors, n_vectors, dim, queries + (uint64_t) q * dim, k, metric);
+}
+
+// k-way merge of the sorted lists of every DPU, for every query of a batch: a heap of
+// the list heads (best at the root) yields the k best neighbors in order
+static void merge_lists(neighbor_t *out, const neighbor_t *lists, uint32_t n_queries, uint32_t k, uint32_t nr_of_dpus, unsigned int n_threads) {
+    #pragma omp parallel num_threads(n_threads)
+    {
+        head_t *heap = (head_t *) malloc(nr_of_dpus * sizeof(head_t));
+        #pragma omp for schedule(static)
+        for (uint32_t q = 0; q < n_queries; q++) {
+            for (uint32_t i = 0; i < nr_of_dpus; i++) {
+                heap[i].x = lists[((uint64_t) i * n_queries + q) * k];
+                heap[i].dpu = i;
+                heap[i].pos = 0;
+            }
+            for (uint32_t i = nr_of_dpus / 2; i-- > 0; )
+                heads_sift_down(heap, nr_of_dpus, i);
+            for (uint32_t j = 0; j < k; j++) {
+                out[(uint64_t) q * k + j] = heap[0].x;
+                if (++heap[0].pos < k) {
+                    heap[0].x = lists[((uint64_t) heap[0].dpu * n_queries + q) * k + heap[0].pos];
+                } else {
+                    heap[0].x.score = INT32_MAX;
+                    heap[0].x.id = UINT32_MAX;
+                }
+                heads_sift_down(heap, nr_of_dpus, 0);
+            }
+        }
+        free(heap);
+    }
+}
+
+// Main of the Host Application
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+    struct dpu_set_t dpu_set, dpu;
+    uint32_t nr_of_dpus;
+
+#if ENERGY
+    struct dpu_probe_t probe;
+    DPU_ASSERT(dpu_probe_init("energy_probe", &probe));
+#endif
+
+    // Allocate DPUs and load binary
+    DPU_ASSERT(dpu_alloc(NR_DPUS, NULL, &dpu_set));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
+    printf("Allocated %d DPU(s)\n", nr_of_dpus);
+    printf("NR_TASKLETS\t%d\tBL\t%d\n", NR_TASKLETS, BL);
+
+    // Every DPU holds vectors_per_dpu consecutive vectors; the database is padded to whole DPUs
+    const uint32_t dim = p.dim;
+    const uint32_t vectors_per_dpu = divceil(p.n_vectors, nr_of_dpus);
+    T *vectors = (T *) calloc((uint64_t) vectors_per_dpu * nr_of_dpus * dim, sizeof(T));
+    T *queries = (T *) malloc((uint64_t) p.n_queries * dim * sizeof(T));
+    neighbor_t *neighbors_host = (neighbor_t *) malloc((uint64_t) p.n_queries * p.k * sizeof(neighbor_t));
+    neighbor_t *neighbors = (neighbor_t *) malloc((uint64_t) p.n_queries * p.k * sizeof(neighbor_t));
+    neighbor_t *lists = (neighbor_t *) malloc((uint64_t) nr_of_dpus * p.batch * p.k * sizeof(neighbor_t));
+    generate_vectors(vectors, p.n_vectors, dim);
+    generate_queries(queries, p.n_queries, vectors, p.n_vectors, dim);
+    printf("Vectors %u x %u int8 (%lu MB), queries %u, k %u, %s, %u queries per launch\n", p.n_vectors, dim,
+            (unsigned long) (((uint64_t) p.n_vectors * dim) >> 20), p.n_queries, p.k,
+            p.metric == METRIC_IP ? "inner product" : "squared L2", p.batch);
+
+    // Timer
+    Timer timer;
+
+    // Load the database once
+    start(&timer, 4, 0);
+    const uint32_t vector_bytes = vectors_per_dpu * dim;
+    assert((uint64_t) vectors_per_dpu * dim + MAX_QUERY_BYTES + MAX_CANDIDATES * sizeof(neighbor_t) <= DPU_CAPACITY && "Database does not fit in MRAM, use more DPUs!");
+    unsigned int i = 0;
+    DPU_FOREACH(dpu_set, dpu, i) {
+        DPU_ASSERT(dpu_prepare_xfer(dpu, vectors + (uint64_t) vectors_per_dpu * dim * i));
+    }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, vector_bytes, DPU_XFER_DEFAULT));
+    stop(&timer, 4);
+
+    dpu_arguments_t *input_args = (dpu_arguments_t *) malloc(nr_of_dpus * sizeof(dpu_arguments_t));
+    const uint32_t query_offset = vector_bytes;
+    const uint32_t output_offset = query_offset + MAX_QUERY_BYTES;
+#if ENERGY
+    double tavg_energy=0;
+#endif
+
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+
+        if (rep >= p.n_warmup)
+            start(&timer, 0, rep - p.n_warmup);
+        // Computation on host CPU
+        knn_host(neighbors_host, vectors, p.n_vectors, dim, queries, p.n_queries, p.k, p.metric, p.n_threads);
+        if (rep >= p.n_warmup)
+            stop(&timer, 0);
+
+        for (unsigned int first = 0, b = 0; first < p.n_queries; first += p.batch, b++) {
+            unsigned int n = first + p.batch < p.n_queries ? p.batch : p.n_queries - first;
+
+            if (rep >= p.n_warmup)
+                start(&timer, 1, rep - p.n_warmup + b);
+            for (i = 0; i < nr_of_dpus; i++) {
+                uint64_t first_id = (uint64_t) vectors_per_dpu * i;
+                input_args[i].n_vectors = first_id >= p.n_vectors ? 0 : first_id + vectors_per_dpu <= p.n_vectors ? vectors_per_dpu : p.n_vectors - first_id;
+                input_args[i].first_id = first_id;
+                input_args[i].dim = dim;
+                input_args[i].n_queries = n;
+                input_args[i].k = p.k;
+                input_args[i].metric = p.metric;
+                input_args[i].query_offset = query_offset;
+                input_args[i].output_offset = output_offset;
+            }
+
+            // Copy input arguments to DPUs and broadcast the queries of the batch
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+            DPU_ASSERT(dpu_broadcast_to(dpu_set, DPU_MRAM_HEAP_POINTER_NAME, query_offset, queries + (uint64_t) first * dim, n * dim, DPU_XFER_DEFAULT));
+            if (rep >= p.n_warmup)
+                stop(&timer, 1);
+
+#if ENERGY
+            if (rep >= p.n_warmup) {
+                DPU_ASSERT(dpu_probe_start(&probe));
+            }
+#endif
+            if (rep >= p.n_warmup)
+                start(&timer, 2, rep - p.n_warmup + b); // Do not re-initialize the counter
+            // Launch kernel on DPUs
+            DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            if (rep >= p.n_warmup)
+                stop(&timer, 2);
+#if ENERGY
+            if (rep >= p.n_warmup) {
+                DPU_ASSERT(dpu_probe_stop(&probe));
+                double avg_energy;
+                DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &avg_energy));
+                tavg_energy += avg_energy;
+            }
+#endif
+
+#if PRINT
+            // Display DPU Logs
+            DPU_FOREACH(dpu_set, dpu) {
+                DPU_ASSERT(dpulog_read_for_dpu(dpu.dpu, stdout));
+            }
+#endif
+
+            if (rep >= p.n_warmup)
+                start(&timer, 3, rep - p.n_warmup + b);
+            // Retrieve the top-k lists of every DPU and merge them
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, lists + (uint64_t) n * p.k * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, output_offset, n * p.k * sizeof(neighbor_t), DPU_XFER_DEFAULT));
+            merge_lists(neighbors + (uint64_t) first * p.k, lists, n, p.k, nr_of_dpus, p.n_threads);
+            if (rep >= p.n_warmup)
+                stop(&timer, 3);
+        }
+
+    }
+
+    // Print timing results
+    printf("CPU version ");
+    print(&timer, 0, p.n_reps);
+    printf("CPU-DPU ");
+    print(&timer, 1, p.n_reps);
+    printf("DPU Kernel ");
+    print(&timer, 2, p.n_reps);
+    printf("DPU-CPU ");
+    print(&timer, 3, p.n_reps);
+    printf("Database load ");
+    print(&timer, 4, 1);
+    printf("\n");
+
+    // Recall at k against the exact CPU search, which is also the output check
+    uint64_t found = 0;
+    for (uint32_t q = 0; q < p.n_queries; q++)
+        for (uint32_t j = 0; j < p.k; j++)
+            for (uint32_t l = 0; l < p.k; l++)
+                found += neighbors[(uint64_t) q * p.k + j].id == neighbors_host[(uint64_t) q * p.k + l].id;
+    double recall = (double) found / ((double) p.n_queries * p.k);
+
+    // Queries per second; end-to-end covers the broadcast, the kernel and the merge
+    double ms_e2e = prim_timer_ms_avg(&timer, 1, p.n_reps) + prim_timer_ms_avg(&timer, 2, p.n_reps) + prim_timer_ms_avg(&timer, 3, p.n_reps);
+    double qps_cpu = p.n_queries / (prim_timer_ms_avg(&timer, 0, p.n_reps) * 1e-3);
+    double qps_dpu = p.n_queries / (prim_timer_ms_avg(&timer, 2, p.n_reps) * 1e-3);
+    double qps_e2e = p.n_queries / (ms_e2e * 1e-3);
+    printf("Queries/s CPU (%u threads): %f\tDPU Kernel: %f\tEnd-to-end: %f\n", p.n_threads, qps_cpu, qps_dpu, qps_e2e);
+    printf("Recall@%u: %f\n", p.k, recall);
+
+    // update CSV
+#define TEST_NAME "KNN"
+#define RESULTS_FILE "../prim_results.csv"
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 0, p.n_reps, "CPU");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    // Elements are the query-vector pairs
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)p.n_queries * p.n_vectors, (double)nr_of_dpus);
+    update_csv(RESULTS_FILE, TEST_NAME, "QPS_CPU", qps_cpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "QPS_DPU", qps_dpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "QPS_E2E", qps_e2e);
+    update_csv(RESULTS_FILE, TEST_NAME, "Recall", recall);
+
+#if ENERGY
+    printf("DPU Energy (J): %f \t ", tavg_energy / p.n_reps);
+#endif
+
+    // Check output: ties are broken by id, so the exact lists are unique
+    bool status = true;
+    for (uint64_t e = 0; e < (uint64_t) p.n_queries * p.k; e++) {
+        if (neighbors_host[e].score != neighbors[e].score || neighbors_host[e].id != neighbors[e].id) {
+            status = false;
+#if PRINT
+            printf("Query %lu [%lu]: %u (%d) -- %u (%d)\n", e / p.k, e % p.k, neighbors_host[e].id, neighbors_host[e].score,
+                    neighbors[e].id, neighbors[e].score);
+#endif
+        }
+    }
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    free(vectors);
+    free(queries);
+    free(neighbors_host);
+    free(neighbors);
+    free(lists);
+    free(input_args);
+    DPU_ASSERT(dpu_free(dpu_set));
+
+    return status ? 0 : -1;
+}
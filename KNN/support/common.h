@@ -0,0 +1,63 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+// Brute-force k-nearest-neighbor search over int8 vectors: the database is partitioned
+// across the DPUs, every batch of queries is broadcast, and every DPU returns the k best
+// of its vectors for each query. The host merges the per-DPU lists.
+
+// Transfer size between MRAM and WRAM (blocks of database vectors)
+#ifdef BL
+#define BLOCK_SIZE_LOG2 BL
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#else
+#define BLOCK_SIZE_LOG2 9
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#define BL BLOCK_SIZE_LOG2
+#endif
+
+#define T int8_t
+
+// Largest dimension (a multiple of 8) and WRAM budget of the top-k lists: every tasklet
+// keeps k candidates per query of a batch, so batch * k is bounded
+#define MAX_DIM 512
+#define MAX_K 32
+#define MAX_CANDIDATES 128
+#define MAX_QUERY_BYTES 8192 // Queries of a batch, kept in WRAM
+
+enum metrics {
+    METRIC_IP, // Inner product, the largest is the best
+    METRIC_L2, // Squared Euclidean distance, the smallest is the best
+    nr_metrics
+};
+
+// A candidate: the lowest score is the best (the inner product is negated), ties go to the lowest id
+typedef struct {
+    int32_t score;
+    uint32_t id;
+} neighbor_t;
+
+// Structures used by both the host and the dpu to communicate information
+typedef struct {
+    uint32_t n_vectors;     // Vectors of this DPU
+    uint32_t first_id;      // Global id of its first vector
+    uint32_t dim;
+    uint32_t n_queries;     // Queries of the batch
+    uint32_t k;
+    uint32_t metric;
+    uint32_t query_offset;  // Offsets in the MRAM heap; the vectors start at 0
+    uint32_t output_offset; // k neighbors per query, best first
+} dpu_arguments_t;
+
+#define DPU_CAPACITY (64 << 20) // A DPU's capacity is 64 MiB
+
+#ifndef ENERGY
+#define ENERGY 0
+#endif
+#define PRINT 0
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+#define divceil(n, m) (((n)-1) / (m) + 1)
+#endif
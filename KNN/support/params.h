@@ -0,0 +1,83 @@
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "common.h"
+
+typedef struct Params {
+    unsigned int   n_vectors;
+    unsigned int   dim;
+    unsigned int   n_queries;
+    unsigned int   k;
+    unsigned int   metric;
+    unsigned int   batch;
+    unsigned int   n_threads;
+    unsigned int   n_warmup;
+    unsigned int   n_reps;
+} Params;
+
+static void usage() {
+    fprintf(stderr,
+            "\nUsage:  ./program [options]"
+            "\n"
+            "\nGeneral options:"
+            "\n    -h        help"
+            "\n    -w <W>    # of untimed warmup iterations (default=1)"
+            "\n    -e <E>    # of timed repetition iterations (default=3)"
+            "\n    -t <T>    # of host threads for the top-k merge, or of the CPU baseline (default=8)"
+            "\n"
+            "\nBenchmark-specific options:"
+            "\n    -n <N>    number of database vectors (default=1048576)"
+            "\n    -d <D>    dimension, a multiple of 8 up to 512 (default=128)"
+            "\n    -q <Q>    number of queries (default=256)"
+            "\n    -k <K>    neighbors per query, up to 32 (default=10)"
+            "\n    -m <M>    metric: 0 = inner product, 1 = squared L2 distance (default=0)"
+            "\n    -b <B>    queries per DPU launch, B * K <= 128 and B * D <= 8192 (default=8)"
+            "\n");
+}
+
+struct Params input_params(int argc, char **argv) {
+    struct Params p;
+    p.n_warmup      = 1;
+    p.n_reps        = 3;
+    p.n_threads     = 8;
+    p.n_vectors     = 1048576;
+    p.dim           = 128;
+    p.n_queries     = 256;
+    p.k             = 10;
+    p.metric        = METRIC_IP;
+    p.batch         = 8;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hw:e:t:n:d:q:k:m:b:")) >= 0) {
+        switch(opt) {
+            case 'h':
+                usage();
+                exit(0);
+                break;
+            case 'w': p.n_warmup      = atoi(optarg); break;
+            case 'e': p.n_reps        = atoi(optarg); break;
+            case 't': p.n_threads     = atoi(optarg); break;
+            case 'n': p.n_vectors     = atoi(optarg); break;
+            case 'd': p.dim           = atoi(optarg); break;
+            case 'q': p.n_queries     = atoi(optarg); break;
+            case 'k': p.k             = atoi(optarg); break;
+            case 'm': p.metric        = atoi(optarg); break;
+            case 'b': p.batch         = atoi(optarg); break;
+            default:
+                      fprintf(stderr, "\nUnrecognized option!\n");
+                      usage();
+                      exit(0);
+        }
+    }
+    if (p.batch > p.n_queries)
+        p.batch = p.n_queries;
+    assert(p.n_vectors > 0 && p.n_queries > 0 && "Invalid # of vectors or queries!");
+    assert(p.dim > 0 && p.dim <= MAX_DIM && p.dim % 8 == 0 && "Invalid dimension!");
+    assert(p.k > 0 && p.k <= MAX_K && p.k <= p.n_vectors && "Invalid k!");
+    assert(p.batch > 0 && p.batch * p.k <= MAX_CANDIDATES && "Invalid batch, B * K must be at most 128!");
+    assert(p.batch * p.dim <= MAX_QUERY_BYTES && "Invalid batch, B * D must be at most 8192!");
+    assert(p.metric < nr_metrics && p.n_threads > 0 && "Invalid metric or thread count!");
+
+    return p;
+}
+#endif
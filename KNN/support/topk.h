@@ -0,0 +1,76 @@
+#ifndef _TOPK_H_
+#define _TOPK_H_
+
+// Scores and bounded top-k lists shared by the DPUs, the host and the CPU baseline.
+// A list is a max-heap on (score, id) with the worst candidate at the root, so a new
+// candidate is compared with one entry and costs log k moves only when it gets in.
+
+#include <stdint.h>
+
+#include "common.h"
+
+static inline int32_t knn_score(const T *a, const T *b, uint32_t dim, uint32_t metric) {
+    int32_t acc = 0;
+    if (metric == METRIC_IP) {
+        for (uint32_t d = 0; d < dim; d++)
+            acc += (int32_t) a[d] * b[d];
+        return -acc;
+    }
+    for (uint32_t d = 0; d < dim; d++) {
+        int32_t diff = (int32_t) a[d] - b[d];
+        acc += diff * diff;
+    }
+    return acc;
+}
+
+// a is a better neighbor than b
+static inline int topk_better(neighbor_t a, neighbor_t b) {
+    return a.score < b.score || (a.score == b.score && a.id < b.id);
+}
+
+static inline void topk_sift_down(neighbor_t *heap, uint32_t n, uint32_t i) {
+    neighbor_t x = heap[i];
+    for (;;) {
+        uint32_t c = 2 * i + 1;
+        if (c >= n)
+            break;
+        if (c + 1 < n && topk_better(heap[c], heap[c + 1]))
+            c++;
+        if (!topk_better(x, heap[c]))
+            break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    heap[i] = x;
+}
+
+// Offers a candidate to a list of *n <= k entries
+static inline void topk_push(neighbor_t *heap, uint32_t *n, uint32_t k, neighbor_t x) {
+    if (*n < k) {
+        uint32_t i = (*n)++;
+        while (i > 0 && topk_better(heap[(i - 1) / 2], x)) {
+            heap[i] = heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap[i] = x;
+    } else if (topk_better(x, heap[0])) {
+        heap[0] = x;
+        topk_sift_down(heap, k, 0);
+    }
+}
+
+// Sorts a list in place, best first; missing entries (fewer than k vectors) become
+// INT32_MAX scores, which every merge puts last
+static inline void topk_sort(neighbor_t *heap, uint32_t n, uint32_t k) {
+    for (uint32_t m = n; m > 1; m--) {
+        neighbor_t worst = heap[0];
+        heap[0] = heap[m - 1];
+        heap[m - 1] = worst;
+        topk_sift_down(heap, m - 1, 0);
+    }
+    for (uint32_t i = n; i < k; i++) {
+        heap[i].score = INT32_MAX;
+        heap[i].id = UINT32_MAX;
+    }
+}
+#endif
@@ -0,0 +1,48 @@
+#ifndef _VECTORS_H_
+#define _VECTORS_H_
+
+// Host-side database and query generator and the exact reference search, shared by the
+// host application and the CPU baseline.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "topk.h"
+
+// xorshift64*: the same vectors and queries for every run, host and baseline alike
+static inline uint64_t knn_rand(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+static void generate_vectors(T *vectors, uint64_t n_vectors, uint32_t dim) {
+    uint64_t s = 0x853C49E6748FEA9BULL;
+    for (uint64_t i = 0; i < n_vectors * dim; i++)
+        vectors[i] = (T) (int) (knn_rand(&s) % 256 - 128);
+}
+
+// Every query is a database vector with noise in [-16, 16), as an embedding of a near duplicate
+static void generate_queries(T *queries, uint64_t n_queries, const T *vectors, uint64_t n_vectors, uint32_t dim) {
+    uint64_t s = 0x9E3779B97F4A7C15ULL;
+    for (uint64_t q = 0; q < n_queries; q++) {
+        const T *v = vectors + (knn_rand(&s) % n_vectors) * dim;
+        for (uint32_t d = 0; d < dim; d++) {
+            int x = v[d] + (int) (knn_rand(&s) % 32) - 16;
+            queries[q * dim + d] = (T) (x < -128 ? -128 : x > 127 ? 127 : x);
+        }
+    }
+}
+
+// Exact top-k of one query, best first
+static void knn_query(neighbor_t *out, const T *vectors, uint64_t n_vectors, uint32_t dim, const T *query, uint32_t k, uint32_t metric) {
+    uint32_t n = 0;
+    for (uint64_t i = 0; i < n_vectors; i++) {
+        neighbor_t x = {knn_score(vectors + i * dim, query, dim, metric), (uint32_t) i};
+        topk_push(out, &n, k, x);
+    }
+    topk_sort(out, n, k);
+}
+#endif
@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <stdint.h>
 #include "../../support/timer.h"
+#include "../../support/rapl.h"
 #include "../../support/common.h"
 
 T** A;
@@ -130,6 +131,7 @@ void usage() {
     uint64_t m_size = 20480;
 
     Timer timer;
+    Energy energy;
     A = malloc(NUM_LAYERS * sizeof(T*));
     for(int l = 0; l < NUM_LAYERS; l++)
         A[l] = malloc(n_size*m_size*sizeof(unsigned int));
@@ -139,15 +141,20 @@ void usage() {
     // Create an input file with arbitrary data.
     init_data(A, B, m_size, n_size);
 
+    energy_start(&energy, 0, 0);
     start(&timer, 0, 1);
     mlp_host(C, A, B, n_size, m_size);
     stop(&timer, 0);
+    energy_stop(&energy, 0);
 
     uint32_t sum = mlp_host_sum(n_size, m_size);
    
     printf("Kernel ");
     print(&timer, 0, 1);
     printf("\n");
+    printf("Energy ");
+    energy_print(&energy, 0, 1, NUM_LAYERS * n_size * m_size);
+    printf("\n");
 
     printf("SUM = %d \n", sum);
 
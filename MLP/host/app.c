@@ -22,6 +22,7 @@
 #include "../support/timer.h"
 #include "../support/params.h"
 #include "../support/prim_results.h"
+#include "../support/trace.h"
 
 // Define the DPU Binary path as DPU_BINARY here
 #ifndef DPU_BINARY
@@ -157,9 +158,11 @@ int main(int argc, char **argv) {
 	init_data(A, B, B_host, m_size, n_size);
 
 	// Compute output on CPU (performance comparison and verification purposes)
+	TRACE_BEGIN("host", "CPU MLP", -1, -1);
 	start(&timer, 0, 0);
 	mlp_host(C, A, B_host, m_size, n_size);
 	stop(&timer, 0);
+	TRACE_END();
 
 	for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
 		if (rep >= p.n_warmup)
@@ -167,24 +170,30 @@ int main(int argc, char **argv) {
 		// Input arguments
 		i = 0;
 		// Copy input arguments to DPU
+		TRACE_BEGIN("xfer", "Arguments", 0, (int64_t)sizeof(dpu_arguments_t) * nr_of_dpus);
 		DPU_FOREACH(dpu_set, dpu, i) {
 			input_args[i].max_rows = max_rows_per_dpu;
 			DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
 		}
 		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+		TRACE_END();
 
 
 		// Copy input array and vector
+		TRACE_BEGIN("xfer", "A[0] to DPUs", 0, (int64_t)max_rows_per_dpu * n_size_pad * sizeof(T) * nr_of_dpus);
 		i = 0;
 		DPU_FOREACH(dpu_set, dpu, i) {
 			DPU_ASSERT(dpu_prepare_xfer(dpu, A[0] + dpu_info[i].prev_rows_dpu * n_size));
 		}
 		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, max_rows_per_dpu * n_size_pad * sizeof(T), DPU_XFER_DEFAULT));
+		TRACE_END();
+		TRACE_BEGIN("xfer", "B to DPUs", 0, (int64_t)n_size_pad * sizeof(T) * nr_of_dpus);
 		i = 0;
 		DPU_FOREACH(dpu_set, dpu, i) {
 			DPU_ASSERT(dpu_prepare_xfer(dpu, B));
 		}
 		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, max_rows_per_dpu * n_size_pad * sizeof(T) , n_size_pad * sizeof(T), DPU_XFER_DEFAULT));
+		TRACE_END();
 		if (rep >= p.n_warmup)
 			stop(&timer, 1);
 
@@ -197,7 +206,9 @@ int main(int argc, char **argv) {
 #endif
 		}
 
+		TRACE_BEGIN("launch", "Layer", 0, -1);
 		DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+		TRACE_END();
 
 		if (rep >= p.n_warmup)
 		{
@@ -213,12 +224,15 @@ int main(int argc, char **argv) {
 			i = 0;
 
 			// Copy C_dpu
+			TRACE_BEGIN("xfer", "C from DPUs", lay, (int64_t)max_rows_per_dpu * sizeof(T) * nr_of_dpus);
 			DPU_FOREACH(dpu_set, dpu, i) {
 				DPU_ASSERT(dpu_prepare_xfer(dpu, C_dpu + i * max_rows_per_dpu));
 			}
 			DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, max_rows_per_dpu * n_size_pad * sizeof(T) + n_size_pad * sizeof(T), max_rows_per_dpu * sizeof(T), DPU_XFER_DEFAULT));
+			TRACE_END();
 
 			// B = C
+			TRACE_BEGIN("host", "B = C", lay, -1);
 			unsigned int n, j;
 			i = 0;
 			for (n = 0; n < nr_of_dpus; n++) {
@@ -227,18 +241,23 @@ int main(int argc, char **argv) {
 					i++;
 				}
 			}
+			TRACE_END();
+			TRACE_BEGIN("xfer", "B to DPUs", lay, (int64_t)n_size_pad * sizeof(T) * nr_of_dpus);
 			i = 0;
 			DPU_FOREACH(dpu_set, dpu, i) {
 				DPU_ASSERT(dpu_prepare_xfer(dpu, B_tmp));
 			}
 			DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, max_rows_per_dpu * n_size_pad * sizeof(T) , n_size_pad * sizeof(T), DPU_XFER_DEFAULT));
+			TRACE_END();
 
 			// Copy next matrix of weights
+			TRACE_BEGIN("xfer", "A[lay] to DPUs", lay, (int64_t)max_rows_per_dpu * n_size_pad * sizeof(T) * nr_of_dpus);
 			i = 0;
 			DPU_FOREACH(dpu_set, dpu, i) {
 				DPU_ASSERT(dpu_prepare_xfer(dpu, A[lay] + dpu_info[i].prev_rows_dpu * n_size));
 			}
 			DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, max_rows_per_dpu * n_size_pad * sizeof(T), DPU_XFER_DEFAULT));
+			TRACE_END();
 
 			if(rep >= p.n_warmup)
 				stop(&timer, 4);
@@ -251,7 +270,9 @@ int main(int argc, char **argv) {
 #endif
 			}
 
+			TRACE_BEGIN("launch", "Layer", lay, -1);
 			DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+			TRACE_END();
 
 			if (rep >= p.n_warmup)
 			{
@@ -270,6 +291,7 @@ int main(int argc, char **argv) {
 #endif
 
 		// Retrieve results
+		TRACE_BEGIN("xfer", "C from DPUs", NUM_LAYERS - 1, (int64_t)max_rows_per_dpu * sizeof(T) * nr_of_dpus);
 		if (rep >= p.n_warmup)
 			start(&timer, 3, rep - p.n_warmup);
 		i = 0;
@@ -279,6 +301,7 @@ int main(int argc, char **argv) {
 		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, max_rows_per_dpu * n_size_pad * sizeof(T) + n_size_pad * sizeof(T), max_rows_per_dpu * sizeof(T), DPU_XFER_DEFAULT));
 		if(rep >= p.n_warmup)
 			stop(&timer, 3);
+		TRACE_END();
 	}
 
 #if ENERGY
@@ -308,6 +331,7 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)m_size * n_size * NUM_LAYERS, (double)nr_of_dpus);
 
 #if ENERGY
 	printf("Energy (J): %f J\t", avg_energy);
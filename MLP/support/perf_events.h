@@ -0,0 +1,136 @@
+#ifndef PRIM_PERF_EVENTS_H
+#define PRIM_PERF_EVENTS_H
+
+// Header-only host hardware counters per timer phase (build with PERF_EVENTS=1).
+// - One perf_event_open group counting the calling (host) thread in user space:
+//   cycles, instructions, LLC misses, page faults and dTLB load misses
+// - Counts are accumulated per phase index (the Timer slot), reset when rep == 0
+// - Events the kernel or the PMU cannot provide are reported as n/a; if none can be
+//   opened (perf_event_paranoid, containers, VMs) phases are only timed
+// - Worker threads of the UPMEM runtime are not counted
+//
+// Usage (done by support/timer.h and support/prim_results.h):
+//   prim_perf_start(i, rep);  ...  prim_perf_stop(i);
+//   prim_perf_print(i, reps);
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#define PRIM_PERF_MAX_PHASES 16
+enum { PRIM_PERF_NR_EVENTS = 5 };
+
+static const char *const PRIM_PERF_EVENT_NAMES[PRIM_PERF_NR_EVENTS] = {
+    "cycles", "instructions", "llc_misses", "page_faults", "dtlb_misses"
+};
+static const uint32_t PRIM_PERF_EVENT_TYPES[PRIM_PERF_NR_EVENTS] = {
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE, PERF_TYPE_HW_CACHE
+};
+static const uint64_t PRIM_PERF_EVENT_CONFIGS[PRIM_PERF_NR_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_SW_PAGE_FAULTS,
+    PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+};
+
+typedef struct {
+    int initialized;
+    int leader;                         // Group leader, -1 if no event is available
+    int fd[PRIM_PERF_NR_EVENTS];        // -1 if the event is not available
+    int slot[PRIM_PERF_NR_EVENTS];      // Position of the event in a group read
+    int nr_open;
+    uint64_t begin[PRIM_PERF_MAX_PHASES][PRIM_PERF_NR_EVENTS];
+    uint64_t count[PRIM_PERF_MAX_PHASES][PRIM_PERF_NR_EVENTS];
+} prim_perf_state_t;
+
+static prim_perf_state_t prim_perf_state;
+
+static inline void prim_perf_init(void) {
+    prim_perf_state_t *s = &prim_perf_state;
+    s->initialized = 1;
+    s->leader = -1;
+    s->nr_open = 0;
+    int first_errno = 0;
+    for (int e = 0; e < PRIM_PERF_NR_EVENTS; e++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PRIM_PERF_EVENT_TYPES[e];
+        attr.config = PRIM_PERF_EVENT_CONFIGS[e];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.disabled = (s->leader < 0);
+        attr.exclude_kernel = 1; // Allowed with perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, s->leader, 0);
+        s->fd[e] = fd;
+        if (fd < 0) {
+            if (!first_errno) first_errno = errno;
+            continue;
+        }
+        if (s->leader < 0) s->leader = fd;
+        s->slot[e] = s->nr_open++;
+    }
+    if (s->leader < 0) {
+        fprintf(stderr, "[WARNING] perf_event_open: %s, host counters are disabled\n", strerror(first_errno));
+        return;
+    }
+    ioctl(s->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(s->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+// Current value of every event (0 if unavailable)
+static inline void prim_perf_read(uint64_t *values) {
+    prim_perf_state_t *s = &prim_perf_state;
+    uint64_t buf[1 + PRIM_PERF_NR_EVENTS]; // {nr, values[nr]}
+    if (s->leader < 0 || read(s->leader, buf, sizeof(buf)) < (ssize_t)sizeof(uint64_t)) {
+        memset(values, 0, PRIM_PERF_NR_EVENTS * sizeof(uint64_t));
+        return;
+    }
+    for (int e = 0; e < PRIM_PERF_NR_EVENTS; e++)
+        values[e] = (s->fd[e] >= 0) ? buf[1 + s->slot[e]] : 0;
+}
+
+static inline void prim_perf_start(int i, int rep) {
+    prim_perf_state_t *s = &prim_perf_state;
+    if (!s->initialized) prim_perf_init();
+    if (i < 0 || i >= PRIM_PERF_MAX_PHASES) return;
+    if (rep == 0) memset(s->count[i], 0, sizeof(s->count[i]));
+    prim_perf_read(s->begin[i]);
+}
+
+static inline void prim_perf_stop(int i) {
+    prim_perf_state_t *s = &prim_perf_state;
+    if (i < 0 || i >= PRIM_PERF_MAX_PHASES) return;
+    uint64_t end[PRIM_PERF_NR_EVENTS];
+    prim_perf_read(end);
+    for (int e = 0; e < PRIM_PERF_NR_EVENTS; e++)
+        s->count[i][e] += end[e] - s->begin[i][e];
+}
+
+static inline int prim_perf_available(int e) {
+    return prim_perf_state.initialized && prim_perf_state.fd[e] >= 0;
+}
+
+// Average count of event e per repetition of phase i
+static inline double prim_perf_avg(int i, int e, int reps) {
+    if (reps <= 0) reps = 1;
+    if (i < 0 || i >= PRIM_PERF_MAX_PHASES) return 0.0;
+    return (double)prim_perf_state.count[i][e] / (double)reps;
+}
+
+static inline void prim_perf_print(int i, int reps) {
+    for (int e = 0; e < PRIM_PERF_NR_EVENTS; e++) {
+        if (prim_perf_available(e))
+            printf("%s: %.0f\t", PRIM_PERF_EVENT_NAMES[e], prim_perf_avg(i, e, reps));
+        else
+            printf("%s: n/a\t", PRIM_PERF_EVENT_NAMES[e]);
+    }
+}
+
+#endif // PRIM_PERF_EVENTS_H
@@ -0,0 +1,140 @@
+/*
+* Gather of irregular MRAM elements with multiple tasklets
+* Every tasklet takes windows of indices and reads the elements either with one
+* transfer each (kernel1) or with the coalescing mram_gather helper (kernel2)
+*
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <perfcounter.h>
+#include <barrier.h>
+
+#include "../support/common.h"
+#include "../support/cyclecount.h"
+#include "../support/gather.h"
+
+__host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+__host dpu_results_t DPU_RESULTS[NR_TASKLETS];
+
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+extern int main_kernel1(void);
+extern int main_kernel2(void);
+
+int (*kernels[nr_kernels])(void) = {main_kernel1, main_kernel2};
+
+int main(void) {
+    // Kernel
+    return kernels[DPU_INPUT_ARGUMENTS.kernel]();
+}
+
+// main_kernel1
+int main_kernel1() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){ // Initialize once the cycle counter
+        mem_reset(); // Reset the heap
+
+        perfcounter_config(COUNT_CYCLES, true);
+    }
+    perfcounter_cycles cycles;
+    // Barrier
+    barrier_wait(&my_barrier);
+    timer_start(&cycles); // START TIMER
+    dpu_results_t *result = &DPU_RESULTS[tasklet_id];
+    result->dmas = 0;
+    result->bytes = 0;
+
+    uint32_t window = DPU_INPUT_ARGUMENTS.window;
+    uint32_t n_windows = DPU_INPUT_ARGUMENTS.n_indices / window;
+
+    // Addresses of the table, indices and outputs in MRAM
+    uint32_t mram_base_addr_A = (uint32_t)DPU_MRAM_HEAP_POINTER;
+    uint32_t mram_base_addr_I = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.size);
+    uint32_t mram_base_addr_O = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.output_offset);
+
+    // Initialize a local cache to store the indices and the gathered elements
+    uint32_t *cache_I = (uint32_t *) mem_alloc(MAX_WINDOW * sizeof(uint32_t));
+    T *cache_O = (T *) mem_alloc(MAX_WINDOW * sizeof(T));
+
+    for(unsigned int w = tasklet_id; w < n_windows; w += NR_TASKLETS){
+
+        // Load cache with current window of indices
+        mram_read((__mram_ptr void const*)(mram_base_addr_I + w * window * sizeof(uint32_t)), cache_I, window * sizeof(uint32_t));
+
+        // One transfer per element
+        for (unsigned int j = 0; j < window; j++) {
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + cache_I[j] * sizeof(T)), &cache_O[j], sizeof(T));
+        }
+        result->dmas += window;
+        result->bytes += window * sizeof(T);
+
+        // Write cache to current MRAM block
+        mram_write(cache_O, (__mram_ptr void*)(mram_base_addr_O + w * window * sizeof(T)), window * sizeof(T));
+    }
+
+    result->cycles = timer_stop(&cycles); // STOP TIMER
+
+    return 0;
+}
+
+// main_kernel2
+int main_kernel2() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){ // Initialize once the cycle counter
+        mem_reset(); // Reset the heap
+
+        perfcounter_config(COUNT_CYCLES, true);
+    }
+    perfcounter_cycles cycles;
+    // Barrier
+    barrier_wait(&my_barrier);
+    timer_start(&cycles); // START TIMER
+    dpu_results_t *result = &DPU_RESULTS[tasklet_id];
+    result->dmas = 0;
+    result->bytes = 0;
+
+    uint32_t window = DPU_INPUT_ARGUMENTS.window;
+    uint32_t n_windows = DPU_INPUT_ARGUMENTS.n_indices / window;
+    uint32_t max_gap = DPU_INPUT_ARGUMENTS.max_gap;
+
+    // Addresses of the table, indices and outputs in MRAM
+    uint32_t mram_base_addr_A = (uint32_t)DPU_MRAM_HEAP_POINTER;
+    uint32_t mram_base_addr_I = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.size);
+    uint32_t mram_base_addr_O = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.output_offset);
+
+    // Initialize a local cache to store the indices, the gathered elements and the coalesced transfers
+    uint32_t *cache_I = (uint32_t *) mem_alloc(MAX_WINDOW * sizeof(uint32_t));
+    T *cache_O = (T *) mem_alloc(MAX_WINDOW * sizeof(T));
+    uint8_t *buffer = (uint8_t *) mem_alloc(GATHER_DMA_MAX);
+
+    for(unsigned int w = tasklet_id; w < n_windows; w += NR_TASKLETS){
+
+        // Load cache with current window of indices
+        mram_read((__mram_ptr void const*)(mram_base_addr_I + w * window * sizeof(uint32_t)), cache_I, window * sizeof(uint32_t));
+
+        // Sorted and coalesced transfers
+        for (unsigned int j = 0; j < window; j++) {
+            cache_I[j] *= sizeof(T);
+        }
+        gather_stats_t stats = mram_gather(mram_base_addr_A, cache_I, window, sizeof(T), cache_O, buffer, max_gap);
+        result->dmas += stats.dmas;
+        result->bytes += stats.bytes;
+
+        // Write cache to current MRAM block
+        mram_write(cache_O, (__mram_ptr void*)(mram_base_addr_O + w * window * sizeof(T)), window * sizeof(T));
+    }
+
+    result->cycles = timer_stop(&cycles); // STOP TIMER
+
+    return 0;
+}
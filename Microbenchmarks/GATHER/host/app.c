@@ -0,0 +1,209 @@
+/**
+* app.c
+* Gather Host Application Source File
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+
+#include "../support/common.h"
+#include "../support/timer.h"
+#include "../support/params.h"
+
+// Define the DPU Binary path as DPU_BINARY here
+#ifndef DPU_BINARY
+#define DPU_BINARY "./bin/dpu_code"
+#endif
+
+static const char *kernel_names[nr_kernels] = {"single", "gather"};
+
+// Create input arrays: the requests of a window fall in span consecutive elements of the table
+static void read_input(T* A, uint32_t* I, unsigned int nr_elements, unsigned int nr_indices, unsigned int window, unsigned int span) {
+    srand(0);
+    printf("nr_elements\t%u\t", nr_elements);
+    for (unsigned int i = 0; i < nr_elements; i++) {
+        A[i] = (T) (rand());
+    }
+    for (unsigned int w = 0; w < nr_indices; w += window) {
+        unsigned int base = (span == 0 || span == nr_elements) ? 0 : rand() % (nr_elements - span);
+        unsigned int range = span == 0 ? nr_elements : span;
+        for (unsigned int j = 0; j < window; j++) {
+            I[w + j] = base + rand() % range;
+        }
+    }
+}
+
+// Compute output in the host
+static void gather_host(T* C, T* A, uint32_t* I, unsigned int nr_indices) {
+    for (unsigned int i = 0; i < nr_indices; i++) {
+        C[i] = A[I[i]];
+    }
+}
+
+// Pointer declaration
+static T* A;
+static uint32_t* I;
+static T* B;
+static T* C;
+
+// Main of the Host Application
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    struct dpu_set_t dpu_set, dpu;
+    uint32_t nr_of_dpus;
+
+    // Allocate DPUs and load binary
+    DPU_ASSERT(dpu_alloc(NR_DPUS, NULL, &dpu_set));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
+    printf("Allocated %d DPU(s)\n", nr_of_dpus);
+
+    unsigned int i = 0;
+    // Every DPU holds the same table and gathers its own indices
+    const unsigned int input_size = p.input_size;
+    const unsigned int indices_dpu = p.n_indices;
+    const unsigned int indices_bytes = (indices_dpu * sizeof(uint32_t) + 7) & ~7u;
+
+    // Input/output allocation
+    A = malloc(input_size * sizeof(T));
+    I = malloc(indices_dpu * nr_of_dpus * sizeof(uint32_t));
+    B = malloc(indices_dpu * nr_of_dpus * sizeof(T));
+    C = malloc(indices_dpu * nr_of_dpus * sizeof(T));
+
+    // Create an input file with arbitrary data
+    read_input(A, I, input_size, indices_dpu * nr_of_dpus, p.window, p.span);
+
+    // Timer declaration
+    Timer timer;
+
+    printf("NR_TASKLETS\t%d\twindow\t%u\tspan\t%u\tmax_gap\t%u\n", NR_TASKLETS, p.window, p.span, p.max_gap);
+
+    // Compute output on CPU (performance comparison and verification purposes)
+    for(int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+        if(rep >= p.n_warmup)
+            start(&timer, 0, rep - p.n_warmup);
+        gather_host(C, A, I, indices_dpu * nr_of_dpus);
+        if(rep >= p.n_warmup)
+            stop(&timer, 0);
+    }
+
+    printf("Load input data\n");
+    start(&timer, 1, 0);
+    // Copy input arrays
+    DPU_ASSERT(dpu_broadcast_to(dpu_set, DPU_MRAM_HEAP_POINTER_NAME, 0, A, input_size * sizeof(T), DPU_XFER_DEFAULT));
+    DPU_FOREACH(dpu_set, dpu, i) {
+        DPU_ASSERT(dpu_prepare_xfer(dpu, I + indices_dpu * i));
+    }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, input_size * sizeof(T), indices_bytes, DPU_XFER_DEFAULT));
+    stop(&timer, 1);
+    printf("CPU ");
+    print(&timer, 0, p.n_reps);
+    printf("CPU-DPU ");
+    print(&timer, 1, 1);
+    printf("\n");
+
+    bool status = true;
+    dpu_results_t results[nr_of_dpus][NR_TASKLETS];
+    for (unsigned int kernel = 0; kernel < nr_kernels; kernel++) {
+        // Input arguments
+        dpu_arguments_t input_arguments = {input_size * sizeof(T), indices_dpu, input_size * sizeof(T) + indices_bytes, p.window, p.max_gap, kernel};
+        DPU_ASSERT(dpu_broadcast_to(dpu_set, "DPU_INPUT_ARGUMENTS", 0, &input_arguments, sizeof(input_arguments), DPU_XFER_DEFAULT));
+
+        double cc = 0;
+        uint64_t dmas = 0, bytes = 0;
+        for(int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+
+            // Run DPU kernel
+            if(rep >= p.n_warmup)
+                start(&timer, 2, rep - p.n_warmup);
+            DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            if(rep >= p.n_warmup)
+                stop(&timer, 2);
+
+#if PRINT
+            {
+                unsigned int each_dpu = 0;
+                printf("Display DPU Logs\n");
+                DPU_FOREACH (dpu_set, dpu) {
+                    printf("DPU#%d:\n", each_dpu);
+                    DPU_ASSERT(dpulog_read_for_dpu(dpu.dpu, stdout));
+                    each_dpu++;
+                }
+            }
+#endif
+
+            // Retrieve tasklet timings and transfer counts
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, results[i]));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "DPU_RESULTS", 0, NR_TASKLETS * sizeof(dpu_results_t), DPU_XFER_DEFAULT));
+            if(rep >= p.n_warmup) {
+                uint64_t max_cycles = 0;
+                dmas = 0;
+                bytes = 0;
+                for (i = 0; i < nr_of_dpus; i++) {
+                    for (unsigned int each_tasklet = 0; each_tasklet < NR_TASKLETS; each_tasklet++) {
+                        if (results[i][each_tasklet].cycles > max_cycles)
+                            max_cycles = results[i][each_tasklet].cycles;
+                        dmas += results[i][each_tasklet].dmas;
+                        bytes += results[i][each_tasklet].bytes;
+                    }
+                }
+                cc += (double)max_cycles;
+            }
+        }
+
+        printf("Retrieve results\n");
+        start(&timer, 3, 0);
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, B + indices_dpu * i));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, input_size * sizeof(T) + indices_bytes, indices_dpu * sizeof(T), DPU_XFER_DEFAULT));
+        stop(&timer, 3);
+
+        // Effective transfer per useful (gathered) element
+        const double elements = (double) indices_dpu * nr_of_dpus;
+        printf("%s\tDPU cycles  = %g cc\tcycles/element\t%.2f\tbytes/element\t%.2f\tDMAs/element\t%.3f\n", kernel_names[kernel],
+            cc / p.n_reps, cc / p.n_reps / indices_dpu, bytes / elements, dmas / elements);
+        printf("DPU Kernel ");
+        print(&timer, 2, p.n_reps);
+        printf("DPU-CPU ");
+        print(&timer, 3, 1);
+        printf("\n");
+
+        // Check output
+        for (i = 0; i < indices_dpu * nr_of_dpus; i++) {
+            if(C[i] != B[i]){
+                status = false;
+#if PRINT
+                printf("%d: %lu -- %lu\n", i, C[i], B[i]);
+#endif
+            }
+        }
+        memset(B, 0, indices_dpu * nr_of_dpus * sizeof(T));
+    }
+
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    free(A);
+    free(I);
+    free(B);
+    free(C);
+    DPU_ASSERT(dpu_free(dpu_set));
+
+    return status ? 0 : -1;
+}
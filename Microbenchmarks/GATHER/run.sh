@@ -0,0 +1,20 @@
+#!/bin/bash
+
+NR_DPUS=1 NR_TASKLETS=16 make all
+wait
+
+# Locality: requests of a window within 64 elements (one coalesced transfer) up to the whole table
+for r in 64 256 1024 4096 16384 65536 262144 0
+do
+    ./bin/host_code -w 0 -e 1 -i 1048576 -n 65536 -b 64 -r ${r} >& profile/r${r}_b64.txt
+    wait
+done
+
+# Window: requests sorted and coalesced together, at a locality of 4096 elements
+for b in 2 4 8 16 32 64 128
+do
+    ./bin/host_code -w 0 -e 1 -i 1048576 -n 65536 -b ${b} -r 4096 >& profile/r4096_b${b}.txt
+    wait
+done
+
+make clean
@@ -0,0 +1,36 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+// Structures used by both the host and the dpu to communicate information 
+typedef struct {
+    uint32_t size;      // Table bytes
+    uint32_t n_indices; // Gathered elements
+    uint32_t output_offset; // MRAM offset of the gathered elements, after the table and the indices
+    uint32_t window;    // Requests per gather
+    uint32_t max_gap;   // Largest hole read through, in bytes
+	enum kernels {
+	    kernel1 = 0, // One transfer per element
+	    kernel2 = 1, // mram_gather
+	    nr_kernels = 2,
+	} kernel;
+} dpu_arguments_t;
+
+typedef struct {
+    uint64_t cycles;
+    uint32_t dmas;
+    uint32_t bytes;
+} dpu_results_t;
+
+// Largest window of the benchmark: its indices, outputs and the DMA buffer of 16 tasklets fit in WRAM
+#define MAX_WINDOW 128
+
+// Data type
+#define T uint64_t
+
+#define PERF 1 // Use perfcounters?
+#define PRINT 0
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+#endif
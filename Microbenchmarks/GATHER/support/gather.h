@@ -0,0 +1,87 @@
+#ifndef _GATHER_H_
+#define _GATHER_H_
+
+// DPU gather helper for irregular MRAM reads (SpMV input vector, BFS neighbors, ...).
+// A window of requests is sorted by address and cut into the fewest aligned DMA
+// transfers: a transfer grows while the next request is at most max_gap bytes past
+// its end and the whole transfer fits in GATHER_DMA_MAX bytes. Reading a hole costs
+// about 0.5 cycles per byte, starting a new transfer about 77 cycles, so holes of
+// up to ~128 bytes are worth reading through.
+
+#include <stdint.h>
+#include <mram.h>
+
+// Requests per call: the request position lives in the low bits of its sort key
+#define GATHER_POS_BITS 8
+#define GATHER_WINDOW_MAX (1 << GATHER_POS_BITS)
+
+// Largest coalesced transfer, and size of the WRAM buffer passed to mram_gather
+#ifndef GATHER_DMA_MAX
+#define GATHER_DMA_MAX 512
+#endif
+
+typedef struct {
+    uint32_t dmas;  // Transfers issued
+    uint32_t bytes; // Bytes transferred
+} gather_stats_t;
+
+// Shell sort of the keys, small windows do not pay for anything smarter
+static void gather_sort(uint32_t *keys, unsigned int n) {
+    const unsigned int gaps[] = {57, 23, 10, 4, 1};
+    for (unsigned int g = 0; g < sizeof(gaps) / sizeof(gaps[0]); g++) {
+        unsigned int gap = gaps[g];
+        for (unsigned int i = gap; i < n; i++) {
+            uint32_t k = keys[i];
+            unsigned int j = i;
+            for (; j >= gap && keys[j - gap] > k; j -= gap)
+                keys[j] = keys[j - gap];
+            keys[j] = k;
+        }
+    }
+}
+
+// out[i] = the elem_size-byte element (4 or 8) at byte offset offsets[i] from mram_base,
+// for n <= GATHER_WINDOW_MAX requests. mram_base is 8-byte aligned, offsets are multiples
+// of elem_size below 64 MB and are overwritten. buffer holds GATHER_DMA_MAX bytes.
+static gather_stats_t mram_gather(uint32_t mram_base, uint32_t *offsets, unsigned int n, unsigned int elem_size,
+        void *out, uint8_t *buffer, uint32_t max_gap) {
+    gather_stats_t stats = {0, 0};
+
+    // Key: 4-byte word of the request, then its position
+    for (unsigned int i = 0; i < n; i++)
+        offsets[i] = ((offsets[i] >> 2) << GATHER_POS_BITS) | i;
+    gather_sort(offsets, n);
+
+    for (unsigned int i = 0; i < n; ) {
+        uint32_t first = (offsets[i] >> GATHER_POS_BITS) << 2;
+        uint32_t seg_start = first & ~7u;
+        uint32_t seg_end = (first + elem_size + 7) & ~7u;
+
+        // Extend the transfer over the next requests
+        unsigned int j = i + 1;
+        for (; j < n; j++) {
+            uint32_t offset = (offsets[j] >> GATHER_POS_BITS) << 2;
+            uint32_t end = (offset + elem_size + 7) & ~7u;
+            if ((offset & ~7u) > seg_end + max_gap || end - seg_start > GATHER_DMA_MAX)
+                break;
+            if (end > seg_end)
+                seg_end = end;
+        }
+
+        mram_read((__mram_ptr void const*)(mram_base + seg_start), buffer, seg_end - seg_start);
+        stats.dmas++;
+        stats.bytes += seg_end - seg_start;
+
+        // Scatter the elements to their positions
+        for (; i < j; i++) {
+            uint32_t pos = offsets[i] & (GATHER_WINDOW_MAX - 1);
+            uint32_t offset = ((offsets[i] >> GATHER_POS_BITS) << 2) - seg_start;
+            if (elem_size == 8)
+                ((uint64_t *) out)[pos] = *(uint64_t *) (buffer + offset);
+            else
+                ((uint32_t *) out)[pos] = *(uint32_t *) (buffer + offset);
+        }
+    }
+    return stats;
+}
+#endif
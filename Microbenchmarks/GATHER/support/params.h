@@ -0,0 +1,72 @@
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "common.h"
+
+typedef struct Params {
+    unsigned int   input_size;
+    unsigned int   n_indices;
+    unsigned int   window;
+    unsigned int   span;
+    unsigned int   max_gap;
+    int   n_warmup;
+    int   n_reps;
+}Params;
+
+static void usage() {
+    fprintf(stderr,
+        "\nUsage:  ./program [options]"
+        "\n"
+        "\nGeneral options:"
+        "\n    -h        help"
+        "\n    -w <W>    # of untimed warmup iterations (default=1)"
+        "\n    -e <E>    # of timed repetition iterations (default=3)"
+        "\n"
+        "\nBenchmark-specific options:"
+        "\n    -i <I>    table size per DPU (default=1M elements)"
+        "\n    -n <N>    gathered elements per DPU (default=64K)"
+        "\n    -b <B>    window: requests sorted and coalesced together, 2 to 128 (default=64)"
+        "\n    -r <R>    locality: the requests of a window fall in R consecutive elements, 0 for the whole table (default=0)"
+        "\n    -g <G>    largest hole read through by a coalesced transfer, in bytes (default=128)"
+        "\n");
+}
+
+struct Params input_params(int argc, char **argv) {
+    struct Params p;
+    p.input_size    = 1 << 20;
+    p.n_indices     = 64 << 10;
+    p.window        = 64;
+    p.span          = 0;
+    p.max_gap       = 128;
+    p.n_warmup      = 1;
+    p.n_reps        = 3;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hi:n:b:r:g:w:e:")) >= 0) {
+        switch(opt) {
+        case 'h':
+        usage();
+        exit(0);
+        break;
+        case 'i': p.input_size    = atoi(optarg); break;
+        case 'n': p.n_indices     = atoi(optarg); break;
+        case 'b': p.window        = atoi(optarg); break;
+        case 'r': p.span          = atoi(optarg); break;
+        case 'g': p.max_gap       = atoi(optarg); break;
+        case 'w': p.n_warmup      = atoi(optarg); break;
+        case 'e': p.n_reps        = atoi(optarg); break;
+        default:
+            fprintf(stderr, "\nUnrecognized option!\n");
+            usage();
+            exit(0);
+        }
+    }
+    assert(NR_DPUS > 0 && "Invalid # of dpus!");
+    assert(p.window >= 2 && p.window <= MAX_WINDOW && p.window % 2 == 0 && "Invalid window!");
+    assert(p.n_indices % p.window == 0 && "# of elements must be a multiple of the window!");
+    assert(p.span <= p.input_size && "Invalid locality!");
+    assert((uint64_t) p.input_size * sizeof(T) + (uint64_t) p.n_indices * (sizeof(uint32_t) + sizeof(T)) < (64 << 20) && "Inputs do not fit in MRAM!");
+
+    return p;
+}
+#endif
@@ -23,8 +23,9 @@ T ran[128]; // Current random numbers
 BARRIER_INIT(my_barrier, NR_TASKLETS);
 
 extern int main_kernel1(void);
+extern int main_kernel2(void);
 
-int (*kernels[nr_kernels])(void) = {main_kernel1};
+int (*kernels[nr_kernels])(void) = {main_kernel1, main_kernel2};
 
 int main(void) { 
     // Kernel
@@ -93,3 +94,100 @@ int main_kernel1() {
 	
     return 0;
 }
+
+// Shell sort of a block of updates by table address
+static void sort_updates(T *updates, unsigned int n, T mask) {
+    const unsigned int gaps[] = {57, 23, 10, 4, 1};
+    for (unsigned int g = 0; g < sizeof(gaps) / sizeof(gaps[0]); g++) {
+        unsigned int gap = gaps[g];
+        for (unsigned int i = gap; i < n; i++) {
+            T u = updates[i];
+            uint32_t address = u & mask;
+            unsigned int j = i;
+            for (; j >= gap && (uint32_t)(updates[j - gap] & mask) > address; j -= gap)
+                updates[j] = updates[j - gap];
+            updates[j] = u;
+        }
+    }
+}
+
+// main_kernel2
+int main_kernel2() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){ // Initialize once the cycle counter
+        mem_reset(); // Reset the heap
+#if PERF
+        perfcounter_config(COUNT_CYCLES, true);
+#endif
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+#if PERF
+    perfcounter_cycles cycles;
+    timer_start(&cycles); // START TIMER
+    dpu_results_t *result = &DPU_RESULTS[tasklet_id];
+    result->cycles = 0;
+#endif
+
+    uint32_t input_size_dpu = DPU_INPUT_ARGUMENTS.size / sizeof(T);
+    uint32_t update_bytes = DPU_INPUT_ARGUMENTS.n_updates * sizeof(T);
+    T mask = input_size_dpu - 1;
+
+    // Table slice, then the updates routed to this DPU
+    uint32_t mram_base_addr_A = (uint32_t)DPU_MRAM_HEAP_POINTER;
+    uint32_t mram_base_addr_U = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.size);
+
+    // Initialize a local cache to store the MRAM blocks
+    T *cache_U = (T *) mem_alloc(BLOCK_SIZE);
+    T *cache_A = (T *) mem_alloc(SEGMENT_BYTES);
+
+    for(unsigned int byte_index = tasklet_id << BLOCK_SIZE_LOG2; byte_index < update_bytes; byte_index += BLOCK_SIZE * NR_TASKLETS){
+
+        // Bound checking
+        uint32_t l_size_bytes = (byte_index + BLOCK_SIZE >= update_bytes) ? (update_bytes - byte_index) : BLOCK_SIZE;
+        unsigned int n = l_size_bytes / sizeof(T);
+
+        // Load cache with current MRAM block
+        mram_read((__mram_ptr void const*)(mram_base_addr_U + byte_index), cache_U, l_size_bytes);
+
+        if (!DPU_INPUT_ARGUMENTS.sort) {
+            // Same update as kernel1, one read and one write of 8 bytes
+            for (unsigned int i = 0; i < n; i++) {
+                uint32_t address = cache_U[i] & mask;
+                mram_read((__mram_ptr void const*)(mram_base_addr_A + address * sizeof(T)), cache_A, sizeof(T));
+                *cache_A = address;
+                mram_write(cache_A, (__mram_ptr void*)(mram_base_addr_A + address * sizeof(T)), sizeof(T));
+            }
+            continue;
+        }
+
+        // Sorted: one read per segment, then only the runs of updated words are written,
+        // since other tasklets may update the rest of the segment meanwhile
+        sort_updates(cache_U, n, mask);
+        for (unsigned int i = 0; i < n; ) {
+            uint32_t segment = (cache_U[i] & mask) & ~(SEGMENT_BYTES / sizeof(T) - 1);
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + segment * sizeof(T)), cache_A, SEGMENT_BYTES);
+            uint32_t touched = 0;
+            for (; i < n && (uint32_t)(cache_U[i] & mask) < segment + SEGMENT_BYTES / sizeof(T); i++) {
+                uint32_t word = (cache_U[i] & mask) - segment;
+                cache_A[word] = cache_U[i] & mask;
+                touched |= 1u << word;
+            }
+            while (touched) {
+                unsigned int first = __builtin_ctz(touched);
+                unsigned int run = __builtin_ctz(~(touched >> first));
+                mram_write(&cache_A[first], (__mram_ptr void*)(mram_base_addr_A + (segment + first) * sizeof(T)), run * sizeof(T));
+                touched &= ~(((1u << run) - 1) << first);
+            }
+        }
+    }
+
+#if PERF
+    result->cycles += timer_stop(&cycles); // STOP TIMER
+#endif
+
+    return 0;
+}
@@ -12,6 +12,7 @@
 #include <unistd.h>
 #include <getopt.h>
 #include <assert.h>
+#include <omp.h>
 
 #include "../support/common.h"
 #include "../support/timer.h"
@@ -61,6 +62,250 @@ static void gups_host(T* B, unsigned int nr_elements) {
     }
 }
 
+// Owner DPU of an update in distributed mode: the high half of the random number picks
+// the DPU, the low bits the entry of its slice (ran & (input_size_dpu - 1), as kernel1).
+// The high half is hashed first: small values of the generator would all go to DPU 0.
+static inline uint32_t gups_owner(T ran, uint32_t nr_of_dpus) {
+    uint32_t h = (uint32_t) (ran >> 32) * 0x9E3779B1u;
+    return (uint32_t) (((uint64_t) h * nr_of_dpus) >> 32);
+}
+
+// Update streams over the global table: 128 HPCC streams, 16 updates per table entry
+static void gups_updates(T* updates, uint64_t n_updates) {
+    T ran[128];
+    for (unsigned int j = 0; j < 128; j++)
+        ran[j] = HPCC_starts((n_updates / 128) * j);
+    for (uint64_t i = 0; i < n_updates / 128; i++) {
+        for (unsigned int j = 0; j < 128; j++) {
+            ran[j] = (ran[j] << 1) ^ ((S) ran[j] < 0 ? POLY : 0);
+            updates[i * 128 + j] = ran[j];
+        }
+    }
+}
+
+// Compute output in the host (distributed mode)
+static void gups_host_distributed(T* B, const T* updates, uint64_t n_updates, unsigned int input_size_dpu, uint32_t nr_of_dpus) {
+    for (uint64_t u = 0; u < n_updates; u++) {
+        T address = updates[u] & (input_size_dpu - 1);
+        B[(uint64_t) gups_owner(updates[u], nr_of_dpus) * input_size_dpu + address] = address;
+    }
+}
+
+// Parallel radix partition of n updates by owner DPU: per-thread histograms, a prefix
+// sum (DPU major, thread minor), then every thread scatters its chunk to its own slots.
+// DPU i gets count[i] updates from routed + i * cap; returns cap, the largest count.
+static uint32_t route_updates(const T* updates, uint32_t n, uint32_t nr_of_dpus, unsigned int n_threads,
+        uint32_t* owner, uint32_t* hist, uint32_t* count, T** routed, uint64_t* capacity) {
+    uint32_t cap = 0;
+    #pragma omp parallel num_threads(n_threads)
+    {
+        unsigned int t = omp_get_thread_num();
+        unsigned int n_team = omp_get_num_threads(); // Can be fewer than n_threads
+        uint32_t* h = hist + (uint64_t) t * nr_of_dpus;
+        uint32_t first = (uint64_t) n * t / n_team, last = (uint64_t) n * (t + 1) / n_team;
+        memset(h, 0, nr_of_dpus * sizeof(uint32_t));
+        for (uint32_t u = first; u < last; u++) {
+            owner[u] = gups_owner(updates[u], nr_of_dpus);
+            h[owner[u]]++;
+        }
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (uint32_t d = 0; d < nr_of_dpus; d++) {
+                count[d] = 0;
+                for (unsigned int v = 0; v < n_team; v++)
+                    count[d] += hist[(uint64_t) v * nr_of_dpus + d];
+                if (count[d] > cap)
+                    cap = count[d];
+            }
+            if ((uint64_t) cap * nr_of_dpus > *capacity) {
+                *capacity = (uint64_t) cap * nr_of_dpus;
+                *routed = (T*) realloc(*routed, *capacity * sizeof(T));
+            }
+            for (uint32_t d = 0; d < nr_of_dpus; d++) {
+                uint64_t pos = (uint64_t) d * cap;
+                for (unsigned int v = 0; v < n_team; v++) {
+                    uint32_t c = hist[(uint64_t) v * nr_of_dpus + d];
+                    hist[(uint64_t) v * nr_of_dpus + d] = pos - (uint64_t) d * cap;
+                    pos += c;
+                }
+            }
+        }
+        T* r = *routed;
+        for (uint32_t u = first; u < last; u++)
+            r[(uint64_t) owner[u] * cap + h[owner[u]]++] = updates[u];
+    }
+    return cap;
+}
+
+// Distributed GUPS: the host generates the update streams over the global table, routes
+// them to the DPUs owning the entries in batches, and the DPUs apply them (kernel2)
+static bool gups_distributed(struct Params* p, struct dpu_set_t dpu_set, uint32_t nr_of_dpus) {
+    struct dpu_set_t dpu;
+    unsigned int i = 0;
+    double cc = 0;
+    const unsigned int input_size = p->exp == 0 ? p->input_size * nr_of_dpus : p->input_size;
+    const unsigned int input_size_dpu = input_size / nr_of_dpus;
+    assert((input_size_dpu & (input_size_dpu - 1)) == 0 && input_size_dpu * sizeof(T) >= SEGMENT_BYTES && "Table slices must be a power of two of at least 8 entries!");
+    const uint64_t n_updates = 16 * (uint64_t) input_size_dpu * nr_of_dpus;
+    const uint32_t batch = p->batch * nr_of_dpus < n_updates ? p->batch * nr_of_dpus : n_updates;
+
+    // Input/output allocation
+    A = malloc((uint64_t) input_size_dpu * nr_of_dpus * sizeof(T));
+    B = malloc((uint64_t) input_size_dpu * nr_of_dpus * sizeof(T));
+    T* updates = malloc(n_updates * sizeof(T));
+    read_input(A, B, input_size_dpu * nr_of_dpus);
+    gups_updates(updates, n_updates);
+    printf("updates\t%lu\tbatch\t%u\tsort\t%d\n", n_updates, batch, p->sort);
+
+    uint32_t* owner = malloc(batch * sizeof(uint32_t));
+    uint32_t* hist = malloc((uint64_t) p->n_threads * nr_of_dpus * sizeof(uint32_t));
+    uint32_t* count = malloc(nr_of_dpus * sizeof(uint32_t));
+    T* routed = NULL;
+    uint64_t capacity = 0;
+    dpu_arguments_t* input_arguments = malloc(nr_of_dpus * sizeof(dpu_arguments_t));
+    dpu_results_t* results = malloc((uint64_t) nr_of_dpus * NR_TASKLETS * sizeof(dpu_results_t));
+    uint64_t max_count = 0;
+
+    // Timer declaration: 4 is the routing, 5 the transfer of the updates
+    Timer timer;
+
+    printf("NR_TASKLETS\t%d\tBL\t%d\n", NR_TASKLETS, BL);
+
+    // Loop over main kernel
+    for(int rep = 0; rep < p->n_warmup + p->n_reps; rep++) {
+
+        // Compute output on CPU (performance comparison and verification purposes)
+        if(rep >= p->n_warmup)
+            start(&timer, 0, rep - p->n_warmup);
+        gups_host_distributed(B, updates, n_updates, input_size_dpu, nr_of_dpus);
+        if(rep >= p->n_warmup)
+            stop(&timer, 0);
+
+        printf("Load input data\n");
+        if(rep >= p->n_warmup)
+            start(&timer, 1, rep - p->n_warmup);
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, A + (uint64_t) input_size_dpu * i));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, input_size_dpu * sizeof(T), DPU_XFER_DEFAULT));
+        if(rep >= p->n_warmup)
+            stop(&timer, 1);
+
+        printf("Run program on DPU(s) \n");
+        for (uint64_t first = 0, b = 0; first < n_updates; first += batch, b++) {
+            uint32_t n = first + batch < n_updates ? batch : n_updates - first;
+
+            if(rep >= p->n_warmup)
+                start(&timer, 4, rep - p->n_warmup + b);
+            uint32_t cap = route_updates(updates + first, n, nr_of_dpus, p->n_threads, owner, hist, count, &routed, &capacity);
+            if(rep >= p->n_warmup)
+                stop(&timer, 4);
+            assert(input_size_dpu * sizeof(T) + (uint64_t) cap * sizeof(T) <= (64 << 20) && "Batch does not fit in MRAM, use a smaller -b");
+            if (cap > max_count)
+                max_count = cap;
+
+            if(rep >= p->n_warmup)
+                start(&timer, 5, rep - p->n_warmup + b);
+            for (uint32_t d = 0; d < nr_of_dpus; d++)
+                input_arguments[d] = (dpu_arguments_t) {input_size_dpu * sizeof(T), kernel2, count[d], p->sort};
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, input_arguments + i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, routed + (uint64_t) cap * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, input_size_dpu * sizeof(T), cap * sizeof(T), DPU_XFER_DEFAULT));
+            if(rep >= p->n_warmup)
+                stop(&timer, 5);
+
+            // Run DPU kernel
+            if(rep >= p->n_warmup)
+                start(&timer, 2, rep - p->n_warmup + b);
+            DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            if(rep >= p->n_warmup)
+                stop(&timer, 2);
+
+#if PERF
+            // Slowest DPU of the batch
+            if(rep >= p->n_warmup) {
+                DPU_FOREACH(dpu_set, dpu, i) {
+                    DPU_ASSERT(dpu_prepare_xfer(dpu, results + (uint64_t) NR_TASKLETS * i));
+                }
+                DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "DPU_RESULTS", 0, NR_TASKLETS * sizeof(dpu_results_t), DPU_XFER_DEFAULT));
+                uint64_t max_cycles = 0;
+                for (uint64_t t = 0; t < (uint64_t) nr_of_dpus * NR_TASKLETS; t++)
+                    if (results[t].cycles > max_cycles)
+                        max_cycles = results[t].cycles;
+                cc += (double)max_cycles;
+            }
+#endif
+        }
+
+        printf("Retrieve results\n");
+        if(rep >= p->n_warmup)
+            start(&timer, 3, rep - p->n_warmup);
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, A + (uint64_t) input_size_dpu * i));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, input_size_dpu * sizeof(T), DPU_XFER_DEFAULT));
+        if(rep >= p->n_warmup)
+            stop(&timer, 3);
+    }
+    printf("DPU cycles  = %g cc\n", cc / p->n_reps);
+
+    // Print timing results
+    printf("CPU ");
+    print(&timer, 0, p->n_reps);
+    printf("CPU-DPU ");
+    print(&timer, 1, p->n_reps);
+    printf("Routing ");
+    print(&timer, 4, p->n_reps);
+    printf("Updates CPU-DPU ");
+    print(&timer, 5, p->n_reps);
+    printf("DPU Kernel ");
+    print(&timer, 2, p->n_reps);
+    printf("DPU-CPU ");
+    print(&timer, 3, p->n_reps);
+    printf("\n");
+
+    // The table stays in MRAM: system GUPS counts routing, update transfers and kernel
+    double s_kernel = timer.time[2] / (1e6 * p->n_reps);
+    double s_system = (timer.time[2] + timer.time[4] + timer.time[5]) / (1e6 * p->n_reps);
+    printf("GUPS DPU kernel: %f\tSystem (routing + transfers + kernel): %f\tCPU: %f\n",
+            n_updates / s_kernel * 1e-9, n_updates / s_system * 1e-9, n_updates / (timer.time[0] / (1e6 * p->n_reps)) * 1e-9);
+    printf("Largest batch per DPU: %lu updates (%.2fx the mean)\n", max_count, (double) max_count * nr_of_dpus / batch);
+
+    // Check output
+    bool status = true;
+    for (uint64_t e = 0; e < (uint64_t) input_size_dpu * nr_of_dpus; e++) {
+        if(B[e] != A[e]){
+            status = false;
+#if PRINT
+            printf("%lu: %lu -- %lu\n", e, B[e], A[e]);
+#endif
+        }
+    }
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    free(A);
+    free(B);
+    free(updates);
+    free(owner);
+    free(hist);
+    free(count);
+    free(routed);
+    free(input_arguments);
+    free(results);
+    return status;
+}
+
 // Main of the Host Application
 int main(int argc, char **argv) {
 
@@ -75,6 +320,12 @@ int main(int argc, char **argv) {
     DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
     printf("Allocated %d DPU(s)\n", nr_of_dpus);
 
+    if (p.distributed) {
+        bool status = gups_distributed(&p, dpu_set, nr_of_dpus);
+        DPU_ASSERT(dpu_free(dpu_set));
+        return status ? 0 : -1;
+    }
+
     unsigned int i = 0;
     double cc = 0;
     double cc_min = 0;
@@ -109,7 +360,7 @@ int main(int argc, char **argv) {
         // Input arguments
         const unsigned int input_size_dpu = input_size / nr_of_dpus;
         unsigned int kernel = 0;
-        dpu_arguments_t input_arguments = {input_size_dpu * sizeof(T), kernel};
+        dpu_arguments_t input_arguments = {input_size_dpu * sizeof(T), kernel, 0, 0};
         DPU_ASSERT(dpu_copy_to(dpu_set, "DPU_INPUT_ARGUMENTS", 0, (const void *)&input_arguments, sizeof(input_arguments)));
         // Copy input arrays
         i = 0;
@@ -12,3 +12,17 @@ do
             wait
 	done
 done
+
+# Distributed GUPS: updates over the whole table, routed by the host (unsorted and sorted in WRAM)
+for i in 64
+do
+	for s in 0 1
+	do
+            NR_DPUS=$i NR_TASKLETS=16 BL=10 make all
+            wait
+            ./bin/host_code -w 0 -e 1 -i 2097152 -d 1 -s $s >& profile/gups_distributed_${i}_sort${s}.txt
+            wait
+            make clean
+            wait
+	done
+done
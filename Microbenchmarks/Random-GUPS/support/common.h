@@ -5,9 +5,12 @@
 typedef struct {
     uint32_t size;
 	enum kernels {
-	    kernel1 = 0,
-	    nr_kernels = 1,
+	    kernel1 = 0, // Updates generated on the DPU, within its own table slice
+	    kernel2 = 1, // Distributed: updates over the global table, routed by the host
+	    nr_kernels = 2,
 	} kernel;
+    uint32_t n_updates; // kernel2: updates of this batch, after the table slice in MRAM
+    uint32_t sort;      // kernel2: sort every WRAM block of updates by address first
 } dpu_arguments_t;
 
 typedef struct {
@@ -24,6 +27,9 @@ typedef struct {
 #define BL BLOCK_SIZE_LOG2
 #endif
 
+// Distributed GUPS: sorted updates to the same SEGMENT_BYTES of MRAM share one read
+#define SEGMENT_BYTES 64
+
 // Data type
 #define T uint64_t
 #define S int64_t
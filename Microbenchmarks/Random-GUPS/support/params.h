@@ -8,6 +8,10 @@ typedef struct Params {
     int   n_warmup;
     int   n_reps;
     int  exp;
+    int  distributed;
+    int  sort;
+    unsigned int   batch;
+    unsigned int   n_threads;
 }Params;
 
 static void usage() {
@@ -22,6 +26,10 @@ static void usage() {
         "\n"
         "\nBenchmark-specific options:"
         "\n    -i <I>    input size (default=8K elements)"
+        "\n    -d <D>    distributed GUPS: host-routed updates over the whole table (default=0)"
+        "\n    -s <S>    distributed: sort every WRAM block of updates by address (default=0)"
+        "\n    -b <B>    distributed: updates per DPU in each batch (default=64K)"
+        "\n    -t <T>    distributed: # of host threads routing the updates (default=8)"
         "\n");
 }
 
@@ -31,9 +39,13 @@ struct Params input_params(int argc, char **argv) {
     p.n_warmup      = 1;
     p.n_reps        = 3;
     p.exp           = 0;
+    p.distributed   = 0;
+    p.sort          = 0;
+    p.batch         = 64 << 10;
+    p.n_threads     = 8;
 
     int opt;
-    while((opt = getopt(argc, argv, "hi:w:e:x:")) >= 0) {
+    while((opt = getopt(argc, argv, "hi:w:e:x:d:s:b:t:")) >= 0) {
         switch(opt) {
         case 'h':
         usage();
@@ -43,6 +55,10 @@ struct Params input_params(int argc, char **argv) {
         case 'w': p.n_warmup      = atoi(optarg); break;
         case 'e': p.n_reps        = atoi(optarg); break;
         case 'x': p.exp           = atoi(optarg); break;
+        case 'd': p.distributed   = atoi(optarg); break;
+        case 's': p.sort          = atoi(optarg); break;
+        case 'b': p.batch         = atoi(optarg); break;
+        case 't': p.n_threads     = atoi(optarg); break;
         default:
             fprintf(stderr, "\nUnrecognized option!\n");
             usage();
@@ -50,6 +66,7 @@ struct Params input_params(int argc, char **argv) {
         }
     }
     assert(NR_DPUS > 0 && "Invalid # of dpus!");
+    assert(p.batch > 0 && p.n_threads > 0 && "Invalid batch or thread count!");
 
     return p;
 }
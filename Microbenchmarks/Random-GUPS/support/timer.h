@@ -37,9 +37,9 @@
 
 typedef struct Timer{
 
-    struct timeval startTime[4];
-    struct timeval stopTime[4];
-    double         time[4];
+    struct timeval startTime[6];
+    struct timeval stopTime[6];
+    double         time[6];
 
 }Timer;
 
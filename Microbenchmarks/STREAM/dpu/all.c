@@ -0,0 +1,139 @@
+/*
+* STREAM Copy, Copy (WRAM), Scale, Add and Triad in one binary (OP=all)
+* The host selects the kernel. A and B are only read and every kernel writes C,
+* so the five kernels run back to back on the same input
+*
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <perfcounter.h>
+#include <barrier.h>
+
+#include "../support/common.h"
+#include "../support/cyclecount.h"
+
+#ifdef WRAM
+#error "OP=all measures MRAM bandwidth, build a single OP with MEM=WRAM"
+#endif
+
+__host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+__host dpu_results_t DPU_RESULTS[NR_TASKLETS];
+
+// Copy
+static void copyw_dpu(T *bufferB, T *bufferA) {
+
+    #pragma unroll
+    for (unsigned int i = 0; i < BLOCK_SIZE / sizeof(T); i++){
+        bufferB[i] = bufferA[i];
+    }
+
+}
+
+// Scale
+static void scale_dpu(T *bufferB, T *bufferA, T scalar) {
+
+    #pragma unroll
+    for (unsigned int i = 0; i < BLOCK_SIZE / sizeof(T); i++){
+        bufferB[i] = scalar * bufferA[i];
+    }
+
+}
+
+// Add
+static void add_dpu(T *bufferC, T *bufferA, T *bufferB) {
+
+    #pragma unroll
+    for (unsigned int i = 0; i < BLOCK_SIZE / sizeof(T); i++){
+        bufferC[i] = bufferA[i] + bufferB[i];
+    }
+
+}
+
+// Triad
+static void triad_dpu(T *bufferC, T *bufferA, T *bufferB, T scalar) {
+
+    #pragma unroll
+    for (unsigned int i = 0; i < BLOCK_SIZE / sizeof(T); i++){
+        bufferC[i] = bufferA[i] + scalar * bufferB[i];
+    }
+
+}
+
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+// Kernel body, specialized for every kernel by the main_* functions below
+static inline int stream_kernel(const unsigned int kernel) {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){ // Initialize once the cycle counter
+        mem_reset(); // Reset the heap
+
+        perfcounter_config(COUNT_CYCLES, true);
+    }
+    perfcounter_cycles cycles;
+    // Barrier
+    barrier_wait(&my_barrier);
+    timer_start(&cycles); // START TIMER
+
+    uint32_t input_size_dpu = DPU_INPUT_ARGUMENTS.size / sizeof(T);
+
+    T scalar = (T)input_size_dpu; // Simply use this number as a scalar
+
+    dpu_results_t *result = &DPU_RESULTS[tasklet_id];
+    result->cycles = 0;
+
+    // Address of the current processing block in MRAM
+    uint32_t mram_base_addr_A = (uint32_t)(DPU_MRAM_HEAP_POINTER + (tasklet_id << BLOCK_SIZE_LOG2));
+    uint32_t mram_base_addr_B = (uint32_t)(DPU_MRAM_HEAP_POINTER + (tasklet_id << BLOCK_SIZE_LOG2) + input_size_dpu * sizeof(T));
+    uint32_t mram_base_addr_C = (uint32_t)(DPU_MRAM_HEAP_POINTER + (tasklet_id << BLOCK_SIZE_LOG2) + 2 * input_size_dpu * sizeof(T));
+
+    // Initialize a local cache to store the MRAM block
+    T *cache_A = (T *) mem_alloc(BLOCK_SIZE);
+    T *cache_B = (T *) mem_alloc(BLOCK_SIZE);
+
+    for(unsigned int byte_index = 0; byte_index < input_size_dpu * sizeof(T); byte_index += BLOCK_SIZE * NR_TASKLETS){
+
+        // Load cache with current MRAM block
+        mram_read((__mram_ptr void const*)(mram_base_addr_A + byte_index), cache_A, BLOCK_SIZE);
+        if (kernel == STREAM_ADD || kernel == STREAM_TRIAD)
+            mram_read((__mram_ptr void const*)(mram_base_addr_B + byte_index), cache_B, BLOCK_SIZE);
+
+        T *cache_out = cache_B;
+        if (kernel == STREAM_COPY)
+            cache_out = cache_A;
+        else if (kernel == STREAM_COPYW)
+            copyw_dpu(cache_B, cache_A);
+        else if (kernel == STREAM_SCALE)
+            scale_dpu(cache_B, cache_A, scalar);
+        else if (kernel == STREAM_ADD)
+            add_dpu(cache_B, cache_A, cache_B);
+        else
+            triad_dpu(cache_B, cache_A, cache_B, scalar);
+
+        // Write cache to current MRAM block
+        mram_write(cache_out, (__mram_ptr void*)(mram_base_addr_C + byte_index), BLOCK_SIZE);
+
+    }
+
+    result->cycles = timer_stop(&cycles); // STOP TIMER
+    return 0;
+}
+
+int main_copy() { return stream_kernel(STREAM_COPY); }
+int main_copyw() { return stream_kernel(STREAM_COPYW); }
+int main_scale() { return stream_kernel(STREAM_SCALE); }
+int main_add() { return stream_kernel(STREAM_ADD); }
+int main_triad() { return stream_kernel(STREAM_TRIAD); }
+
+int (*kernels[nr_stream_kernels])(void) = {main_copy, main_copyw, main_scale, main_add, main_triad};
+
+int main(void) {
+    // Kernel
+    return kernels[DPU_INPUT_ARGUMENTS.kernel]();
+}
@@ -25,7 +25,7 @@
 // Pointer declaration
 static T* A;
 static T* B;
-#if defined(add) || defined(triad)
+#if defined(add) || defined(triad) || defined(all)
 static T* C;
 #endif
 static T* C2;
@@ -40,6 +40,7 @@ static void read_input(T* A, T* B, unsigned int nr_elements) {
     }
 }
 
+#ifndef all
 // Compute output in the host
 #if defined(add) || defined(triad)
 static void stream_host(T* C, T* B, T* A, unsigned int nr_elements) {
@@ -246,3 +247,219 @@ int main(int argc, char **argv) {
 	
     return status ? 0 : -1;
 }
+#else
+#include "../support/host_stream.h"
+
+static const char *stream_names[nr_stream_kernels] = {"copy", "copyw", "scale", "add", "triad"};
+
+#define MAX_POINTS 64
+
+// One configuration of the DPU sweep
+typedef struct {
+    uint32_t nr_of_dpus;
+    uint32_t nr_ranks;
+    double ms[nr_stream_kernels];     // Average kernel time, launch included
+    double cycles[nr_stream_kernels]; // Average cycles of the slowest DPU
+} stream_point_t;
+
+// Compute output of a kernel in the host
+static void stream_host_kernel(T* C, T* A, T* B, unsigned int nr_elements, unsigned int kernel, T scalar) {
+    for (unsigned int i = 0; i < nr_elements; i++) {
+        if (kernel == STREAM_SCALE)
+            C[i] = scalar * A[i];
+        else if (kernel == STREAM_ADD)
+            C[i] = A[i] + B[i];
+        else if (kernel == STREAM_TRIAD)
+            C[i] = A[i] + scalar * B[i];
+        else // copy, copyw
+            C[i] = A[i];
+    }
+}
+
+// Runs the five kernels on a set of DPUs. Every DPU gets the same input, so the host
+// arrays stay at one DPU's size whatever the number of ranks; the output of the first
+// and last DPU of every rank is checked.
+static bool run_point(struct dpu_set_t dpu_set, stream_point_t *point, unsigned int input_size_dpu, struct Params *p) {
+    struct dpu_set_t dpu, rank;
+    uint32_t i, each_rank;
+    const uint32_t nr_of_dpus = point->nr_of_dpus;
+    const T scalar = (T) input_size_dpu;
+    bool status = true;
+    Timer timer;
+
+    // Copy input arrays
+    DPU_ASSERT(dpu_broadcast_to(dpu_set, DPU_MRAM_HEAP_POINTER_NAME, 0, A, input_size_dpu * sizeof(T), DPU_XFER_DEFAULT));
+    DPU_ASSERT(dpu_broadcast_to(dpu_set, DPU_MRAM_HEAP_POINTER_NAME, input_size_dpu * sizeof(T), B, input_size_dpu * sizeof(T), DPU_XFER_DEFAULT));
+
+    dpu_results_t *results = (dpu_results_t *) malloc(nr_of_dpus * NR_TASKLETS * sizeof(dpu_results_t));
+
+    for (unsigned int kernel = 0; kernel < nr_stream_kernels; kernel++) {
+        dpu_arguments_t input_arguments = {input_size_dpu * sizeof(T), kernel};
+        DPU_ASSERT(dpu_broadcast_to(dpu_set, "DPU_INPUT_ARGUMENTS", 0, &input_arguments, sizeof(input_arguments), DPU_XFER_DEFAULT));
+
+        point->cycles[kernel] = 0;
+        for (int rep = 0; rep < p->n_warmup + p->n_reps; rep++) {
+            if(rep >= p->n_warmup)
+                start(&timer, 2, rep - p->n_warmup);
+            DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            if(rep >= p->n_warmup)
+                stop(&timer, 2);
+
+            // Retrieve tasklet timings
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, results + i * NR_TASKLETS));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "DPU_RESULTS", 0, NR_TASKLETS * sizeof(dpu_results_t), DPU_XFER_DEFAULT));
+            uint64_t max_cycles = 0;
+            for (i = 0; i < nr_of_dpus * NR_TASKLETS; i++)
+                if (results[i].cycles > max_cycles)
+                    max_cycles = results[i].cycles;
+            if(rep >= p->n_warmup)
+                point->cycles[kernel] += (double)max_cycles;
+        }
+        point->cycles[kernel] /= p->n_reps;
+        point->ms[kernel] = timer.time[2] / (1000 * p->n_reps);
+
+        // Check output
+        stream_host_kernel(C2, A, B, input_size_dpu, kernel, scalar);
+        DPU_RANK_FOREACH(dpu_set, rank, each_rank) {
+            uint32_t nr_dpus_rank;
+            DPU_ASSERT(dpu_get_nr_dpus(rank, &nr_dpus_rank));
+            DPU_FOREACH(rank, dpu, i) {
+                if (i != 0 && i != nr_dpus_rank - 1)
+                    continue;
+                DPU_ASSERT(dpu_copy_from(dpu, DPU_MRAM_HEAP_POINTER_NAME, 2 * input_size_dpu * sizeof(T), C, input_size_dpu * sizeof(T)));
+                if (memcmp(C, C2, input_size_dpu * sizeof(T)) != 0) {
+                    status = false;
+#if PRINT
+                    printf("%s: DPU %u of rank %u differs\n", stream_names[kernel], i, each_rank);
+#endif
+                }
+            }
+        }
+
+        const double bytes = (double) nr_of_dpus * input_size_dpu * stream_bytes(kernel);
+        printf("%s\tDPUs\t%u\tranks\t%u\tDPU cycles\t%g cc\tDPU Kernel Time (ms): %f\tMB/s\t%.1f\tMB/s (launch)\t%.1f\n",
+            stream_names[kernel], nr_of_dpus, point->nr_ranks, point->cycles[kernel], point->ms[kernel],
+            bytes * p->freq_mhz / point->cycles[kernel], bytes / (point->ms[kernel] * 1000));
+    }
+
+    free(results);
+    return status;
+}
+
+// Main of the Host Application
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    struct dpu_set_t dpu_set;
+    // Weak scaling, the input size is per DPU
+    const unsigned int input_size_dpu = p.input_size;
+    assert(input_size_dpu * sizeof(T) % (BLOCK_SIZE * NR_TASKLETS) == 0 && "Input size must be a multiple of NR_TASKLETS blocks!");
+    assert(3 * (uint64_t) input_size_dpu * sizeof(T) <= (64 << 20) && "Input does not fit in MRAM!");
+
+    // Input/output allocation
+    A = malloc(input_size_dpu * sizeof(T));
+    B = malloc(input_size_dpu * sizeof(T));
+    C = malloc(input_size_dpu * sizeof(T));
+    C2 = malloc(input_size_dpu * sizeof(T));
+
+    // Create an input file with arbitrary data
+    read_input(A, B, input_size_dpu);
+    printf("NR_TASKLETS\t%d\tBL\t%d\n", NR_TASKLETS, BL);
+
+    // DPU configurations: NR_DPUS, or powers of two DPUs within a rank, then powers of two ranks up to all of them
+    uint32_t points[MAX_POINTS];
+    bool whole_ranks[MAX_POINTS];
+    unsigned int n_points = 0;
+    if (p.sweep) {
+        uint32_t total_dpus, total_ranks;
+        DPU_ASSERT(dpu_alloc_ranks(DPU_ALLOCATE_ALL, NULL, &dpu_set));
+        DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &total_dpus));
+        DPU_ASSERT(dpu_get_nr_ranks(dpu_set, &total_ranks));
+        DPU_ASSERT(dpu_free(dpu_set));
+        for (uint32_t n = 1; n < total_dpus / total_ranks; n <<= 1) {
+            points[n_points] = n;
+            whole_ranks[n_points++] = false;
+        }
+        for (uint32_t r = 1; r < total_ranks && n_points < MAX_POINTS - 1; r <<= 1) {
+            points[n_points] = r;
+            whole_ranks[n_points++] = true;
+        }
+        points[n_points] = total_ranks;
+        whole_ranks[n_points++] = true;
+    } else {
+        points[n_points] = NR_DPUS;
+        whole_ranks[n_points++] = false;
+    }
+
+    // PIM: aggregate MRAM bandwidth of every configuration
+    stream_point_t sweep[MAX_POINTS];
+    bool status = true;
+    for (unsigned int s = 0; s < n_points; s++) {
+        if (whole_ranks[s])
+            DPU_ASSERT(dpu_alloc_ranks(points[s], NULL, &dpu_set));
+        else
+            DPU_ASSERT(dpu_alloc(points[s], NULL, &dpu_set));
+        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
+        DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &sweep[s].nr_of_dpus));
+        DPU_ASSERT(dpu_get_nr_ranks(dpu_set, &sweep[s].nr_ranks));
+        printf("Allocated %d DPU(s) in %d rank(s)\n", sweep[s].nr_of_dpus, sweep[s].nr_ranks);
+
+        status = run_point(dpu_set, &sweep[s], input_size_dpu, &p) && status;
+        DPU_ASSERT(dpu_free(dpu_set));
+    }
+
+    // Host: DRAM bandwidth of the same kernels
+    host_stream_t host = {p.node, p.n_threads, {0}};
+    bool host_ok = false;
+    if (p.host_size > 0) {
+        host_ok = host_stream(&host, p.host_size, (T) input_size_dpu, p.n_warmup, p.n_reps);
+        if (!host_ok)
+            printf("No CPUs on NUMA node %d, host STREAM skipped\n", p.node);
+        for (unsigned int kernel = 0; host_ok && kernel < nr_stream_kernels; kernel++) {
+            printf("%s\thost threads\t%u\tnode\t%d\tCPU Time (ms): %f\tMB/s\t%.1f\n", stream_names[kernel], host.n_threads, host.node,
+                host.ms[kernel], (double) p.host_size * stream_bytes(kernel) / (host.ms[kernel] * 1000));
+        }
+    }
+
+    // Summary: PIM aggregate internal bandwidth (cycles of the slowest DPU) against host DRAM bandwidth
+    printf("\nAggregate bandwidth (MB/s), DPUs at %u MHz", p.freq_mhz);
+    if (host_ok)
+        printf(", host with %u threads on %s %d", host.n_threads, host.node < 0 ? "all nodes" : "node", host.node);
+    printf("\nkernel");
+    for (unsigned int s = 0; s < n_points; s++)
+        printf("\t%u DPUs", sweep[s].nr_of_dpus);
+    if (host_ok)
+        printf("\thost\tPIM/host");
+    printf("\n");
+    for (unsigned int kernel = 0; kernel < nr_stream_kernels; kernel++) {
+        printf("%s", stream_names[kernel]);
+        double pim = 0;
+        for (unsigned int s = 0; s < n_points; s++) {
+            pim = (double) sweep[s].nr_of_dpus * input_size_dpu * stream_bytes(kernel) * p.freq_mhz / sweep[s].cycles[kernel];
+            printf("\t%.1f", pim);
+        }
+        if (host_ok) {
+            double dram = (double) p.host_size * stream_bytes(kernel) / (host.ms[kernel] * 1000);
+            printf("\t%.1f\t%.2f", dram, pim / dram);
+        }
+        printf("\n");
+    }
+
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    free(A);
+    free(B);
+    free(C);
+    free(C2);
+
+    return status ? 0 : -1;
+}
+#endif
@@ -33,3 +33,10 @@ do
         done
 	done
 done
+
+# Suite: the five kernels from 1 DPU up to all ranks, against the host STREAM on NUMA node 0
+NR_DPUS=1 NR_TASKLETS=16 BL=10 MEM=MRAM OP=all make all
+wait
+./bin/host_code -w 1 -e 3 -i 2097152 -s 1 -c 0 >& profile/suite_MRAM.txt
+wait
+make clean
@@ -10,6 +10,16 @@ typedef struct {
 	} kernel;
 } dpu_arguments_t;
 
+// Kernels of the OP=all binary, passed in dpu_arguments_t.kernel
+enum stream_kernels {
+    STREAM_COPY = 0,
+    STREAM_COPYW,
+    STREAM_SCALE,
+    STREAM_ADD,
+    STREAM_TRIAD,
+    nr_stream_kernels,
+};
+
 typedef struct {
     uint64_t cycles;
 } dpu_results_t;
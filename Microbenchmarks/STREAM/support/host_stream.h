@@ -0,0 +1,134 @@
+#ifndef _HOST_STREAM_H_
+#define _HOST_STREAM_H_
+
+// Multithreaded host STREAM with the same kernels, data type and byte counts as the
+// DPU suite (OP=all). Every thread is pinned to a CPU of one NUMA node and first
+// touches its own static chunk of the arrays, so the pages are allocated on that node
+// and each thread streams local DRAM. No libnuma: the CPUs of a node are read from sysfs.
+// Needs _GNU_SOURCE (sched_setaffinity) and OpenMP.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <omp.h>
+
+#include "common.h"
+
+#define MAX_CPUS 1024
+
+typedef struct {
+    int node;                             // NUMA node, -1 for every CPU of the process
+    unsigned int n_threads;
+    double ms[nr_stream_kernels];        // Average time per kernel
+} host_stream_t;
+
+// CPUs of a NUMA node (sysfs cpulist, e.g. "0-15,32-47"), or all CPUs the process may run on
+static unsigned int node_cpus(int node, int *cpus) {
+    unsigned int n = 0;
+    if (node < 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            for (int c = 0; c < MAX_CPUS && c < CPU_SETSIZE; c++)
+                if (CPU_ISSET(c, &set))
+                    cpus[n++] = c;
+        return n;
+    }
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return 0;
+    int first, last;
+    while (n < MAX_CPUS && fscanf(f, "%d", &first) == 1) {
+        last = first;
+        int c = fgetc(f);
+        if (c == '-') {
+            if (fscanf(f, "%d", &last) != 1)
+                break;
+            c = fgetc(f);
+        }
+        for (int cpu = first; cpu <= last && n < MAX_CPUS; cpu++)
+            cpus[n++] = cpu;
+        if (c != ',')
+            break;
+    }
+    fclose(f);
+    return n;
+}
+
+// Bytes per element of a kernel: copy, copyw and scale read A and write C, add and triad also read B
+static inline unsigned int stream_bytes(unsigned int kernel) {
+    return (kernel == STREAM_ADD || kernel == STREAM_TRIAD ? 3 : 2) * sizeof(T);
+}
+
+// Runs the five kernels on arrays of n elements. Returns 0 if the node has no CPUs.
+static int host_stream(host_stream_t *h, uint64_t n, T scalar, int n_warmup, int n_reps) {
+    static int cpus[MAX_CPUS];
+    unsigned int n_cpus = node_cpus(h->node, cpus);
+    if (n_cpus == 0)
+        return 0;
+    if (h->n_threads == 0)
+        h->n_threads = n_cpus;
+
+    T *A = (T *) malloc(n * sizeof(T));
+    T *B = (T *) malloc(n * sizeof(T));
+    T *C = (T *) malloc(n * sizeof(T));
+    for (unsigned int k = 0; k < nr_stream_kernels; k++)
+        h->ms[k] = 0.0;
+
+#pragma omp parallel num_threads(h->n_threads)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[omp_get_thread_num() % n_cpus], &set);
+        sched_setaffinity(0, sizeof(set), &set);
+
+        // First touch, with the same static partition as the kernels
+#pragma omp for schedule(static)
+        for (uint64_t i = 0; i < n; i++) {
+            A[i] = (T) i;
+            B[i] = (T) (n - i);
+            C[i] = 0;
+        }
+
+        double t0 = 0.0;
+        for (int rep = 0; rep < n_warmup + n_reps; rep++) {
+            for (unsigned int k = 0; k < nr_stream_kernels; k++) {
+#pragma omp barrier
+#pragma omp master
+                t0 = omp_get_wtime();
+                // copyw only differs from copy by staging the block in WRAM, on the host it is a copy
+                if (k == STREAM_COPY || k == STREAM_COPYW) {
+#pragma omp for schedule(static)
+                    for (uint64_t i = 0; i < n; i++)
+                        C[i] = A[i];
+                } else if (k == STREAM_SCALE) {
+#pragma omp for schedule(static)
+                    for (uint64_t i = 0; i < n; i++)
+                        C[i] = scalar * A[i];
+                } else if (k == STREAM_ADD) {
+#pragma omp for schedule(static)
+                    for (uint64_t i = 0; i < n; i++)
+                        C[i] = A[i] + B[i];
+                } else {
+#pragma omp for schedule(static)
+                    for (uint64_t i = 0; i < n; i++)
+                        C[i] = A[i] + scalar * B[i];
+                }
+#pragma omp master
+                if (rep >= n_warmup)
+                    h->ms[k] += (omp_get_wtime() - t0) * 1000.0;
+            }
+        }
+    }
+    for (unsigned int k = 0; k < nr_stream_kernels; k++)
+        h->ms[k] /= n_reps;
+
+    free(A);
+    free(B);
+    free(C);
+    return 1;
+}
+#endif
@@ -8,6 +8,11 @@ typedef struct Params {
     int   n_warmup;
     int   n_reps;
     int  exp;
+    int  sweep;
+    unsigned int   host_size;
+    unsigned int   n_threads;
+    int  node;
+    unsigned int   freq_mhz;
 }Params;
 
 static void usage() {
@@ -22,6 +27,13 @@ static void usage() {
         "\n"
         "\nBenchmark-specific options:"
         "\n    -i <I>    input size (default=8K elements)"
+        "\n"
+        "\nSuite options (OP=all, input size is per DPU):"
+        "\n    -s <S>    NR_DPUS only (0) or sweep from 1 DPU up to all ranks (1) (default=0)"
+        "\n    -n <N>    host STREAM array size, 0 to skip it (default=32M elements)"
+        "\n    -t <T>    # of host STREAM threads, 0 for one per CPU of the node (default=0)"
+        "\n    -c <C>    NUMA node of the host STREAM threads and arrays, -1 for all nodes (default=0)"
+        "\n    -f <F>    DPU frequency in MHz, to convert cycles to bandwidth (default=350)"
         "\n");
 }
 
@@ -31,9 +43,14 @@ struct Params input_params(int argc, char **argv) {
     p.n_warmup      = 1;
     p.n_reps        = 3;
     p.exp           = 0;
+    p.sweep         = 0;
+    p.host_size     = 32 << 20;
+    p.n_threads     = 0;
+    p.node          = 0;
+    p.freq_mhz      = 350;
 
     int opt;
-    while((opt = getopt(argc, argv, "hi:w:e:x:")) >= 0) {
+    while((opt = getopt(argc, argv, "hi:w:e:x:s:n:t:c:f:")) >= 0) {
         switch(opt) {
         case 'h':
         usage();
@@ -43,6 +60,11 @@ struct Params input_params(int argc, char **argv) {
         case 'w': p.n_warmup      = atoi(optarg); break;
         case 'e': p.n_reps        = atoi(optarg); break;
         case 'x': p.exp           = atoi(optarg); break;
+        case 's': p.sweep         = atoi(optarg); break;
+        case 'n': p.host_size     = atoi(optarg); break;
+        case 't': p.n_threads     = atoi(optarg); break;
+        case 'c': p.node          = atoi(optarg); break;
+        case 'f': p.freq_mhz      = atoi(optarg); break;
         default:
             fprintf(stderr, "\nUnrecognized option!\n");
             usage();
@@ -50,6 +72,7 @@ struct Params input_params(int argc, char **argv) {
         }
     }
     assert(NR_DPUS > 0 && "Invalid # of dpus!");
+    assert(p.freq_mhz > 0 && "Invalid DPU frequency!");
 
     return p;
 }
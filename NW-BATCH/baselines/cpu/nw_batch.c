@@ -0,0 +1,83 @@
+/**
+* @file nw_batch.c
+* @brief Batched Needleman-Wunsch on the CPU: one pair per OpenMP iteration
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include <omp.h>
+#include "../../support/timer.h"
+#include "../../support/rapl.h"
+#include "../../support/params.h"
+#include "../../support/align.h"
+
+/**
+* @brief aligns every pair; each thread owns its score row and traceback matrix
+*/
+static void nw_batch(pair_set_t *set, int32_t penalty, pair_result_t *results, int t) {
+    omp_set_num_threads(t);
+    #pragma omp parallel
+    {
+        int32_t *H = (int32_t *) malloc((MAX_LEN + 1) * sizeof(int32_t));
+        uint8_t *dir = (uint8_t *) malloc((uint64_t) MAX_LEN * (MAX_LEN + 1));
+        // Pair lengths differ, so pairs are handed out dynamically
+        #pragma omp for schedule(dynamic, 16)
+        for (unsigned int k = 0; k < set->n_pairs; k++) {
+            results[k].score = align_pair(set->pool + set->offset_a[k], set->len_a[k], set->pool + set->offset_b[k], set->len_b[k],
+                    penalty, H, dir, results[k].ops, &results[k].n_ops);
+        }
+        free(H);
+        free(dir);
+    }
+}
+
+/**
+* @brief Main of the CPU baseline.
+*/
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    pair_set_t set;
+    generate_pairs(&set, p.n_pairs, p.min_len, p.max_len, p.mutation, 7);
+    printf("Pairs %u, lengths %u-%u, mutation %u%%, cells %lu\n", p.n_pairs, p.min_len, p.max_len, p.mutation, set.cells);
+    pair_result_t *results = (pair_result_t *) malloc(p.n_pairs * sizeof(pair_result_t));
+
+    Timer timer;
+    Energy energy;
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+        if (rep >= p.n_warmup) {
+            energy_start(&energy, 0, rep - p.n_warmup);
+            start(&timer, 0, rep - p.n_warmup);
+        }
+        nw_batch(&set, p.penalty, results, p.n_threads);
+        if (rep >= p.n_warmup) {
+            stop(&timer, 0);
+            energy_stop(&energy, 0);
+        }
+    }
+
+    int64_t checksum = 0;
+    for (unsigned int k = 0; k < p.n_pairs; k++)
+        checksum += results[k].score;
+
+    printf("Kernel ");
+    print(&timer, 0, p.n_reps);
+    printf("\n");
+    printf("GCUPS: %f\tScore checksum: %ld\n", set.cells / (timer.time[0] / p.n_reps * 1e3), checksum);
+    printf("Energy ");
+    energy_print(&energy, 0, p.n_reps, set.cells);
+    printf("\n");
+
+    free_pairs(&set);
+    free(results);
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+/**
+* Batched Needleman-Wunsch with multiple tasklets
+* Each tasklet aligns whole pairs: one score row lives in WRAM, the traceback
+* directions of every row are written to a per-tasklet MRAM scratch area
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <barrier.h>
+#include <mutex.h>
+
+#include "../support/common.h"
+
+#define SEQ_CACHE 64 // Bytes of sequence a fetched at once
+#define SEQ_B_BYTES ((MAX_LEN + 7) & ~7)
+
+__host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+
+uint32_t curr_pair; // protected by MUTEX
+
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+MUTEX_INIT(pair_mutex);
+
+// Next pair to align
+static uint32_t get_pair() {
+    mutex_lock(pair_mutex);
+    uint32_t value = curr_pair;
+    curr_pair++;
+    mutex_unlock(pair_mutex);
+    return value;
+}
+
+// Reads len bytes (8-byte aligned in MRAM) in chunks of at most 2048 bytes
+static void read_seq(uint32_t mram_addr, uint8_t *wram, uint32_t len) {
+    uint32_t bytes = (len + 7) & ~7;
+    for (uint32_t done = 0; done < bytes; done += 2048) {
+        uint32_t size = bytes - done < 2048 ? bytes - done : 2048;
+        mram_read((__mram_ptr void const *) (mram_addr + done), wram + done, size);
+    }
+}
+
+// Appends one run to a CIGAR that is built backwards; false once it does not fit
+static inline int cigar_push(pair_result_t *res, uint32_t op, uint32_t len) {
+    if (res->n_ops == CIGAR_OPS)
+        return 0;
+    res->ops[res->n_ops++] = (len << 2) | op;
+    return 1;
+}
+
+// Fills the score row and the MRAM traceback of one pair, then walks it back
+static void align(uint32_t pool, pair_desc_t *desc, uint32_t penalty, uint32_t scratch,
+        int16_t *H, uint8_t *seq_b, uint8_t *cache_a, uint32_t *dir_row, uint32_t *cache_dir, pair_result_t *res) {
+    uint32_t la = desc->len_a;
+    uint32_t lb = desc->len_b;
+    int16_t pen = (int16_t) penalty;
+    uint32_t row_bytes = (((lb + 1 + 15) >> 4) * sizeof(uint32_t) + 7) & ~7;
+
+    read_seq(pool + desc->offset_b, seq_b, lb);
+    for (uint32_t j = 0; j <= lb; j++)
+        H[j] = -(int16_t) j * pen;
+
+    for (uint32_t i = 1; i <= la; i++) {
+        if (((i - 1) & (SEQ_CACHE - 1)) == 0)
+            mram_read((__mram_ptr void const *) (pool + desc->offset_a + i - 1), cache_a, SEQ_CACHE);
+        uint8_t base_a = cache_a[(i - 1) & (SEQ_CACHE - 1)];
+        int16_t diag = H[0];
+        H[0] = -(int16_t) i * pen;
+        uint32_t word = DIR_UP; // Column 0
+        for (uint32_t j = 1; j <= lb; j++) {
+            int16_t best = diag + (base_a == seq_b[j - 1] ? MATCH : MISMATCH);
+            uint32_t d = DIR_DIAG;
+            int16_t up = H[j] - pen;
+            int16_t left = H[j - 1] - pen;
+            if (up > best) { best = up; d = DIR_UP; }
+            if (left > best) { best = left; d = DIR_LEFT; }
+            diag = H[j];
+            H[j] = best;
+            word |= d << ((j & 15) << 1);
+            if ((j & 15) == 15) {
+                dir_row[j >> 4] = word;
+                word = 0;
+            }
+        }
+        if ((lb & 15) != 15)
+            dir_row[lb >> 4] = word;
+        mram_write(dir_row, (__mram_ptr void *) (scratch + (i - 1) * DIR_ROW_BYTES), row_bytes);
+    }
+    res->score = H[lb];
+
+    // Traceback from the bottom-right corner, 8 bytes of directions per MRAM read
+    uint32_t i = la, j = lb, op = 0, run = 0;
+    uint32_t cached = 0xFFFFFFFF;
+    res->n_ops = 0;
+    while (i > 0 || j > 0) {
+        uint32_t next;
+        if (i == 0) next = OP_I;
+        else if (j == 0) next = OP_D;
+        else {
+            uint32_t addr = scratch + (i - 1) * DIR_ROW_BYTES + (j >> 4) * sizeof(uint32_t);
+            if ((addr & ~7) != cached) {
+                cached = addr & ~7;
+                mram_read((__mram_ptr void const *) cached, cache_dir, 8);
+            }
+            uint32_t d = (cache_dir[(addr >> 2) & 1] >> ((j & 15) << 1)) & 3;
+            next = d == DIR_DIAG ? OP_M : (d == DIR_UP ? OP_D : OP_I);
+        }
+        if (next == OP_M) { i--; j--; }
+        else if (next == OP_D) i--;
+        else j--;
+        if (run > 0 && next != op) {
+            if (!cigar_push(res, op, run)) { res->n_ops = OPS_TRUNCATED; return; }
+            run = 0;
+        }
+        op = next;
+        run++;
+    }
+    if (run > 0 && !cigar_push(res, op, run)) { res->n_ops = OPS_TRUNCATED; return; }
+
+    // Runs were collected from the end of the alignment
+    for (uint32_t k = 0; k < res->n_ops / 2; k++) {
+        uint32_t t = res->ops[k];
+        res->ops[k] = res->ops[res->n_ops - 1 - k];
+        res->ops[res->n_ops - 1 - k] = t;
+    }
+}
+
+// main
+int main() {
+    unsigned int tasklet_id = me();
+    if (tasklet_id == 0){ // Initialize once the pair counter
+        mem_reset(); // Reset the heap
+        curr_pair = 0;
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    uint32_t n_pairs = DPU_INPUT_ARGUMENTS.n_pairs;
+    uint32_t penalty = DPU_INPUT_ARGUMENTS.penalty;
+    uint32_t mram_base_addr_desc = (uint32_t) (DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.desc_offset);
+    uint32_t mram_base_addr_pool = (uint32_t) (DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.pool_offset);
+    uint32_t mram_base_addr_result = (uint32_t) (DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.result_offset);
+    // Traceback scratch of this tasklet, at the beginning of the heap
+    uint32_t mram_scratch = (uint32_t) (DPU_MRAM_HEAP_POINTER + tasklet_id * TRACEBACK_BYTES);
+#if PRINT
+    printf("tasklet_id = %d, n_pairs = %d \n", tasklet_id, n_pairs);
+#endif
+
+    // WRAM buffers of this tasklet
+    int16_t *H = (int16_t *) mem_alloc(((MAX_LEN + 1) * sizeof(int16_t) + 7) & ~7);
+    uint8_t *seq_b = (uint8_t *) mem_alloc(SEQ_B_BYTES);
+    uint8_t *cache_a = (uint8_t *) mem_alloc(SEQ_CACHE);
+    uint32_t *dir_row = (uint32_t *) mem_alloc(DIR_ROW_BYTES);
+    uint32_t *cache_dir = (uint32_t *) mem_alloc(8);
+    pair_desc_t *desc = (pair_desc_t *) mem_alloc(sizeof(pair_desc_t));
+    pair_result_t *res = (pair_result_t *) mem_alloc(sizeof(pair_result_t));
+
+    // Pairs have different lengths, so tasklets take them one at a time
+    for (uint32_t pair = get_pair(); pair < n_pairs; pair = get_pair()) {
+        mram_read((__mram_ptr void const *) (mram_base_addr_desc + pair * sizeof(pair_desc_t)), desc, sizeof(pair_desc_t));
+        align(mram_base_addr_pool, desc, penalty, mram_scratch, H, seq_b, cache_a, dir_row, cache_dir, res);
+        mram_write(res, (__mram_ptr void *) (mram_base_addr_result + pair * sizeof(pair_result_t)), sizeof(pair_result_t));
+    }
+
+    return 0;
+}
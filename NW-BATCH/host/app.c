@@ -0,0 +1,320 @@
+/**
+* app.c
+* NW-BATCH Host Application Source File
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+
+#include "../support/common.h"
+#include "../support/timer.h"
+#include "../support/params.h"
+#include "../support/align.h"
+#include "../support/prim_results.h"
+#include "../support/trace.h"
+
+#if ENERGY
+#include <dpu_probe.h>
+#endif
+
+// Define the DPU Binary path as DPU_BINARY here
+#ifndef DPU_BINARY
+#define DPU_BINARY "./bin/nw_batch_dpu"
+#endif
+
+// Scratch for the traceback directions of every tasklet, at the beginning of the heap
+#define SCRATCH_BYTES ((uint64_t) NR_TASKLETS * TRACEBACK_BYTES)
+
+// Alignment of every pair on the host CPU
+static void nw_batch_host(pair_set_t *set, unsigned int penalty, int32_t *H, uint8_t *dir, pair_result_t *results) {
+    for (unsigned int k = 0; k < set->n_pairs; k++) {
+        results[k].score = align_pair(set->pool + set->offset_a[k], set->len_a[k], set->pool + set->offset_b[k], set->len_b[k],
+                penalty, H, dir, results[k].ops, &results[k].n_ops);
+    }
+}
+
+// Splits pairs [first, last) over nr_of_dpus DPUs with about the same number of cells each
+static void split_by_cells(pair_set_t *set, unsigned int first, unsigned int last, unsigned int nr_of_dpus, unsigned int *bounds) {
+    uint64_t cells = 0;
+    for (unsigned int k = first; k < last; k++)
+        cells += (uint64_t) set->len_a[k] * set->len_b[k];
+    uint64_t acc = 0;
+    unsigned int k = first;
+    bounds[0] = first;
+    for (unsigned int i = 0; i < nr_of_dpus; i++) {
+        uint64_t target = cells * (i + 1) / nr_of_dpus;
+        while (k < last && acc < target) {
+            acc += (uint64_t) set->len_a[k] * set->len_b[k];
+            k++;
+        }
+        bounds[i + 1] = k;
+    }
+    bounds[nr_of_dpus] = last;
+}
+
+// Main of the Host Application
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+    struct dpu_set_t dpu_set, dpu;
+    uint32_t nr_of_dpus;
+
+#if ENERGY
+    struct dpu_probe_t probe;
+    DPU_ASSERT(dpu_probe_init("energy probe", &probe));
+#endif
+
+    // Allocate DPUs and load binary
+    DPU_ASSERT(dpu_alloc(NR_DPUS, NULL, &dpu_set));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
+    printf("Allocated %d DPU(s)\n", nr_of_dpus);
+    printf("Allocated %d TASKLET(s) per DPU\n", NR_TASKLETS);
+
+    // Input pairs
+    pair_set_t set;
+    generate_pairs(&set, p.n_pairs, p.min_len, p.max_len, p.mutation, 7);
+    printf("Pairs %u, lengths %u-%u, mutation %u%%, cells %lu\n", p.n_pairs, p.min_len, p.max_len, p.mutation, set.cells);
+
+    pair_result_t *results_host = (pair_result_t *) malloc(p.n_pairs * sizeof(pair_result_t));
+    pair_result_t *results = (pair_result_t *) malloc(p.n_pairs * sizeof(pair_result_t));
+    int32_t *H = (int32_t *) malloc((MAX_LEN + 1) * sizeof(int32_t));
+    uint8_t *dir = (uint8_t *) malloc((uint64_t) MAX_LEN * (MAX_LEN + 1));
+
+    // Per-DPU staging buffers, grown when a batch needs more
+    const unsigned int batch_pairs = p.batch * nr_of_dpus;
+    unsigned int *bounds = (unsigned int *) malloc((nr_of_dpus + 1) * sizeof(unsigned int));
+    dpu_arguments_t *input_args = (dpu_arguments_t *) malloc(nr_of_dpus * sizeof(dpu_arguments_t));
+    uint64_t desc_capacity = 0, pool_capacity = 0;
+    pair_desc_t *desc_buffer = NULL;
+    uint8_t *pool_buffer = NULL;
+    pair_result_t *result_buffer = NULL;
+
+    // Timer
+    Timer timer;
+#if ENERGY
+    double tavg_energy=0;
+#endif
+
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+
+        TRACE_BEGIN("host", "CPU NW-BATCH", rep, -1);
+        if (rep >= p.n_warmup)
+            start(&timer, 0, rep - p.n_warmup);
+        // Computation on host CPU
+        nw_batch_host(&set, p.penalty, H, dir, results_host);
+        if (rep >= p.n_warmup)
+            stop(&timer, 0);
+        TRACE_END();
+
+        if (rep >= p.n_warmup)
+            start(&timer, 4, rep - p.n_warmup);
+        for (unsigned int first = 0, b = 0; first < p.n_pairs; first += batch_pairs, b++) {
+            unsigned int last = first + batch_pairs < p.n_pairs ? first + batch_pairs : p.n_pairs;
+            split_by_cells(&set, first, last, nr_of_dpus, bounds);
+
+            // Every DPU receives the same transfer sizes: the largest of the batch
+            uint32_t max_pairs = 0, max_pool = 0;
+            for (unsigned int i = 0; i < nr_of_dpus; i++) {
+                uint32_t pool_bytes = 0;
+                for (unsigned int k = bounds[i]; k < bounds[i + 1]; k++)
+                    pool_bytes += SEQ_PAD(set.len_a[k]) + SEQ_PAD(set.len_b[k]);
+                if (bounds[i + 1] - bounds[i] > max_pairs)
+                    max_pairs = bounds[i + 1] - bounds[i];
+                if (pool_bytes > max_pool)
+                    max_pool = pool_bytes;
+            }
+            uint32_t desc_offset = SCRATCH_BYTES;
+            uint32_t pool_offset = desc_offset + max_pairs * sizeof(pair_desc_t);
+            uint32_t result_offset = pool_offset + max_pool;
+            assert((uint64_t) result_offset + max_pairs * sizeof(pair_result_t) <= DPU_CAPACITY && "Batch does not fit in MRAM, use a smaller -b");
+
+            if (max_pairs > desc_capacity) {
+                desc_capacity = max_pairs;
+                desc_buffer = (pair_desc_t *) realloc(desc_buffer, nr_of_dpus * desc_capacity * sizeof(pair_desc_t));
+                result_buffer = (pair_result_t *) realloc(result_buffer, nr_of_dpus * desc_capacity * sizeof(pair_result_t));
+            }
+            if (max_pool > pool_capacity) {
+                pool_capacity = max_pool;
+                pool_buffer = (uint8_t *) realloc(pool_buffer, nr_of_dpus * pool_capacity);
+            }
+
+            if (rep >= p.n_warmup)
+                start(&timer, 1, rep - p.n_warmup + b);
+            // Pack descriptors and sequences of every DPU
+            for (unsigned int i = 0; i < nr_of_dpus; i++) {
+                pair_desc_t *desc = desc_buffer + i * desc_capacity;
+                uint8_t *pool = pool_buffer + i * pool_capacity;
+                uint32_t offset = 0;
+                for (unsigned int k = bounds[i]; k < bounds[i + 1]; k++) {
+                    pair_desc_t *d = &desc[k - bounds[i]];
+                    d->offset_a = offset;
+                    d->len_a = set.len_a[k];
+                    memcpy(pool + offset, set.pool + set.offset_a[k], SEQ_PAD(d->len_a));
+                    offset += SEQ_PAD(d->len_a);
+                    d->offset_b = offset;
+                    d->len_b = set.len_b[k];
+                    memcpy(pool + offset, set.pool + set.offset_b[k], SEQ_PAD(d->len_b));
+                    offset += SEQ_PAD(d->len_b);
+                }
+                input_args[i].n_pairs = bounds[i + 1] - bounds[i];
+                input_args[i].penalty = p.penalty;
+                input_args[i].desc_offset = desc_offset;
+                input_args[i].pool_offset = pool_offset;
+                input_args[i].result_offset = result_offset;
+            }
+
+            // Copy input arguments and pairs to DPUs
+            unsigned int i = 0;
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
+            }
+            TRACE_BEGIN("xfer", "Arguments", b, (int64_t)sizeof(dpu_arguments_t) * nr_of_dpus);
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+            TRACE_END();
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, desc_buffer + i * desc_capacity));
+            }
+            TRACE_BEGIN("xfer", "Descriptors CPU-DPU", b, (int64_t)max_pairs * sizeof(pair_desc_t) * nr_of_dpus);
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, desc_offset, max_pairs * sizeof(pair_desc_t), DPU_XFER_DEFAULT));
+            TRACE_END();
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, pool_buffer + i * pool_capacity));
+            }
+            TRACE_BEGIN("xfer", "Sequences CPU-DPU", b, (int64_t)max_pool * nr_of_dpus);
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, pool_offset, max_pool, DPU_XFER_DEFAULT));
+            TRACE_END();
+            if (rep >= p.n_warmup)
+                stop(&timer, 1);
+
+#if ENERGY
+            if (rep >= p.n_warmup) {
+                DPU_ASSERT(dpu_probe_start(&probe));
+            }
+#endif
+            if (rep >= p.n_warmup)
+                start(&timer, 2, rep - p.n_warmup + b); // Do not re-initialize the counter
+            // Launch kernel on DPUs
+            TRACE_BEGIN("launch", "NW-BATCH", b, -1);
+            DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            TRACE_END();
+            if (rep >= p.n_warmup)
+                stop(&timer, 2);
+#if ENERGY
+            if (rep >= p.n_warmup) {
+                DPU_ASSERT(dpu_probe_stop(&probe));
+                double avg_energy;
+                DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &avg_energy));
+                tavg_energy += avg_energy;
+            }
+#endif
+
+#if PRINT
+            // Display DPU Logs
+            DPU_FOREACH(dpu_set, dpu) {
+                DPU_ASSERT(dpulog_read_for_dpu(dpu.dpu, stdout));
+            }
+#endif
+
+            if (rep >= p.n_warmup)
+                start(&timer, 3, rep - p.n_warmup + b);
+            // Retrieve results
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, result_buffer + i * desc_capacity));
+            }
+            TRACE_BEGIN("xfer", "Results DPU-CPU", b, (int64_t)max_pairs * sizeof(pair_result_t) * nr_of_dpus);
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, result_offset, max_pairs * sizeof(pair_result_t), DPU_XFER_DEFAULT));
+            TRACE_END();
+            for (i = 0; i < nr_of_dpus; i++) {
+                memcpy(results + bounds[i], result_buffer + i * desc_capacity, (bounds[i + 1] - bounds[i]) * sizeof(pair_result_t));
+            }
+            if (rep >= p.n_warmup)
+                stop(&timer, 3);
+        }
+        if (rep >= p.n_warmup)
+            stop(&timer, 4);
+
+    }
+
+    // Print timing results
+    printf("CPU version ");
+    print(&timer, 0, p.n_reps);
+    printf("CPU-DPU ");
+    print(&timer, 1, p.n_reps);
+    printf("DPU Kernel ");
+    print(&timer, 2, p.n_reps);
+    printf("DPU-CPU ");
+    print(&timer, 3, p.n_reps);
+    printf("End-to-end ");
+    print(&timer, 4, p.n_reps);
+    printf("\n");
+
+    // Giga cell updates per second
+    double gcups_cpu = set.cells / (prim_timer_ms_avg(&timer, 0, p.n_reps) * 1e6);
+    double gcups_dpu = set.cells / (prim_timer_ms_avg(&timer, 2, p.n_reps) * 1e6);
+    double gcups_e2e = set.cells / (prim_timer_ms_avg(&timer, 4, p.n_reps) * 1e6);
+    printf("GCUPS CPU: %f\tDPU Kernel: %f\tEnd-to-end: %f\n", gcups_cpu, gcups_dpu, gcups_e2e);
+
+    // update CSV
+#define TEST_NAME "NW-BATCH"
+#define RESULTS_FILE "../prim_results.csv"
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 0, p.n_reps, "CPU");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)set.cells, (double)nr_of_dpus);
+    update_csv(RESULTS_FILE, TEST_NAME, "GCUPS_CPU", gcups_cpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "GCUPS_DPU", gcups_dpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "GCUPS_E2E", gcups_e2e);
+
+#if ENERGY
+    printf("DPU Energy (J): %f \t ", tavg_energy / p.n_reps);
+#endif
+
+    // Check output: scores always, CIGARs unless truncated
+    bool status = true;
+    unsigned int truncated = 0;
+    for (unsigned int k = 0; k < p.n_pairs; k++) {
+        bool equal = results_host[k].score == results[k].score && results_host[k].n_ops == results[k].n_ops;
+        if (equal && results[k].n_ops != OPS_TRUNCATED)
+            equal = memcmp(results_host[k].ops, results[k].ops, results[k].n_ops * sizeof(uint32_t)) == 0;
+        if (results[k].n_ops == OPS_TRUNCATED)
+            truncated++;
+        if (!equal) {
+            status = false;
+#if PRINT
+            printf("Pair %u: score %d %d, ops %u %u\n", k, results_host[k].score, results[k].score, results_host[k].n_ops, results[k].n_ops);
+#endif
+        }
+    }
+    if (truncated)
+        printf("%u pair(s) with more than %d CIGAR operations: only the score is reported\n", truncated, CIGAR_OPS);
+
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    free_pairs(&set);
+    free(results_host);
+    free(results);
+    free(H);
+    free(dir);
+    free(bounds);
+    free(input_args);
+    free(desc_buffer);
+    free(pool_buffer);
+    free(result_buffer);
+    DPU_ASSERT(dpu_free(dpu_set));
+
+    return status ? 0 : -1;
+}
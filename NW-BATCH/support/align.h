@@ -0,0 +1,155 @@
+#ifndef _ALIGN_H_
+#define _ALIGN_H_
+
+// Host-side pair generator and reference aligner, shared by the host application
+// and the CPU baseline. Scoring, tie-breaking (diagonal, then up, then left) and
+// CIGAR encoding match dpu/task.c exactly, so results can be compared bit for bit.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define SEQ_PAD(len) (((len) + 7) & ~7u) // Sequences are 8-byte aligned in the pool
+
+// A set of pairs; sequences are stored back to back in one pool
+typedef struct {
+    uint8_t  *pool;
+    uint64_t *offset_a;
+    uint64_t *offset_b;
+    uint32_t *len_a;
+    uint32_t *len_b;
+    uint32_t n_pairs;
+    uint64_t cells;        // Sum of len_a * len_b
+} pair_set_t;
+
+// xorshift64*: the same pairs for every run, host and baseline alike
+static inline uint64_t nwb_rand(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+// Sequence a is random, b is a copy of a with substitutions, insertions and deletions
+static void generate_pairs(pair_set_t *set, unsigned int n_pairs, unsigned int min_len,
+        unsigned int max_len, unsigned int mutation, uint64_t seed) {
+    uint64_t s = seed * 0x9E3779B97F4A7C15ULL + 1;
+    set->n_pairs = n_pairs;
+    set->pool = (uint8_t *) malloc((uint64_t) n_pairs * 2 * SEQ_PAD(max_len));
+    set->offset_a = (uint64_t *) malloc(n_pairs * sizeof(uint64_t));
+    set->offset_b = (uint64_t *) malloc(n_pairs * sizeof(uint64_t));
+    set->len_a = (uint32_t *) malloc(n_pairs * sizeof(uint32_t));
+    set->len_b = (uint32_t *) malloc(n_pairs * sizeof(uint32_t));
+    set->cells = 0;
+
+    uint64_t offset = 0;
+    for (unsigned int k = 0; k < n_pairs; k++) {
+        uint32_t la = min_len + nwb_rand(&s) % (max_len - min_len + 1);
+        uint8_t *a = set->pool + offset;
+        for (uint32_t i = 0; i < la; i++)
+            a[i] = nwb_rand(&s) & 3;
+        set->offset_a[k] = offset;
+        set->len_a[k] = la;
+        offset += SEQ_PAD(la);
+
+        uint8_t *b = set->pool + offset;
+        uint32_t lb = 0;
+        for (uint32_t i = 0; i < la && lb < max_len; i++) {
+            uint64_t r = nwb_rand(&s);
+            if (r % 100 >= mutation) {
+                b[lb++] = a[i];
+                continue;
+            }
+            switch ((r >> 32) % 3) {
+                case 0: b[lb++] = (a[i] + 1 + (r >> 40) % 3) & 3; break; // Substitution
+                case 1: b[lb++] = (r >> 40) & 3;                          // Insertion
+                        if (lb < max_len) b[lb++] = a[i];
+                        break;
+                default: break;                                          // Deletion
+            }
+        }
+        if (lb == 0)
+            b[lb++] = a[0];
+        set->offset_b[k] = offset;
+        set->len_b[k] = lb;
+        offset += SEQ_PAD(lb);
+        set->cells += (uint64_t) la * lb;
+    }
+}
+
+static void free_pairs(pair_set_t *set) {
+    free(set->pool);
+    free(set->offset_a);
+    free(set->offset_b);
+    free(set->len_a);
+    free(set->len_b);
+}
+
+// Appends one run to a CIGAR that is built backwards; false once it does not fit
+static inline int cigar_push(uint32_t *ops, uint32_t *n_ops, uint32_t op, uint32_t len) {
+    if (*n_ops == CIGAR_OPS)
+        return 0;
+    ops[(*n_ops)++] = (len << 2) | op;
+    return 1;
+}
+
+// Global alignment of a (rows) against b (columns) with a linear gap penalty.
+// H needs lb + 1 entries and dir la * (lb + 1) bytes. Returns the score and
+// fills ops / n_ops (OPS_TRUNCATED if the CIGAR has more than CIGAR_OPS runs).
+static int32_t align_pair(const uint8_t *a, uint32_t la, const uint8_t *b, uint32_t lb, int32_t penalty,
+        int32_t *H, uint8_t *dir, uint32_t *ops, uint32_t *n_ops) {
+    for (uint32_t j = 0; j <= lb; j++)
+        H[j] = -(int32_t) j * penalty;
+
+    for (uint32_t i = 1; i <= la; i++) {
+        uint8_t *d = dir + (uint64_t) (i - 1) * (lb + 1);
+        int32_t diag = H[0];
+        H[0] = -(int32_t) i * penalty;
+        d[0] = DIR_UP;
+        for (uint32_t j = 1; j <= lb; j++) {
+            int32_t best = diag + (a[i - 1] == b[j - 1] ? MATCH : MISMATCH);
+            uint8_t dj = DIR_DIAG;
+            int32_t up = H[j] - penalty;
+            int32_t left = H[j - 1] - penalty;
+            if (up > best) { best = up; dj = DIR_UP; }
+            if (left > best) { best = left; dj = DIR_LEFT; }
+            diag = H[j];
+            H[j] = best;
+            d[j] = dj;
+        }
+    }
+    int32_t score = H[lb];
+
+    // Traceback from the bottom-right corner, merging runs of the same operation
+    uint32_t i = la, j = lb, op = 0, run = 0;
+    *n_ops = 0;
+    while (i > 0 || j > 0) {
+        uint32_t next;
+        if (i == 0) next = OP_I;
+        else if (j == 0) next = OP_D;
+        else {
+            uint8_t dj = dir[(uint64_t) (i - 1) * (lb + 1) + j];
+            next = dj == DIR_DIAG ? OP_M : (dj == DIR_UP ? OP_D : OP_I);
+        }
+        if (next == OP_M) { i--; j--; }
+        else if (next == OP_D) i--;
+        else j--;
+        if (run > 0 && next != op) {
+            if (!cigar_push(ops, n_ops, op, run)) { *n_ops = OPS_TRUNCATED; return score; }
+            run = 0;
+        }
+        op = next;
+        run++;
+    }
+    if (run > 0 && !cigar_push(ops, n_ops, op, run)) { *n_ops = OPS_TRUNCATED; return score; }
+
+    // Runs were collected from the end of the alignment
+    for (uint32_t k = 0; k < *n_ops / 2; k++) {
+        uint32_t t = ops[k];
+        ops[k] = ops[*n_ops - 1 - k];
+        ops[*n_ops - 1 - k] = t;
+    }
+    return score;
+}
+#endif
@@ -0,0 +1,67 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+// Batched Needleman-Wunsch: every tasklet aligns whole, independent pairs
+// (global alignment, linear gap penalty) and does its own traceback
+
+// Longest sequence a DPU can align (WRAM holds one score row and one sequence per tasklet)
+#ifndef MAX_LEN
+#define MAX_LEN 1024
+#endif
+
+// CIGAR operations kept per pair; longer traces only report the score
+#ifndef CIGAR_OPS
+#define CIGAR_OPS 62
+#endif
+
+#define MATCH 1
+#define MISMATCH -1
+
+// CIGAR operation codes, stored as (length << 2) | op
+#define OP_M 0 // Match or mismatch (diagonal)
+#define OP_I 1 // Base of b only (left)
+#define OP_D 2 // Base of a only (up)
+#define OPS_TRUNCATED 0xFFFFFFFF // n_ops of a trace longer than CIGAR_OPS
+
+// Traceback directions, 2 bits per cell, 16 cells per 32-bit word
+#define DIR_DIAG 0
+#define DIR_UP 1
+#define DIR_LEFT 2
+#define DIR_ROW_BYTES ((((MAX_LEN + 1 + 15) / 16) * 4 + 7) / 8 * 8)
+#define TRACEBACK_BYTES (MAX_LEN * DIR_ROW_BYTES) // MRAM scratch per tasklet
+
+// Structures used by both the host and the dpu to communicate information
+typedef struct {
+    uint32_t n_pairs;
+    uint32_t penalty;
+    uint32_t desc_offset;   // Offsets in the MRAM heap
+    uint32_t pool_offset;
+    uint32_t result_offset;
+    uint32_t dummy;
+} dpu_arguments_t;
+
+// One pair: offsets (8-byte aligned) of both sequences in the pool, bases as bytes 0..3
+typedef struct {
+    uint32_t offset_a;
+    uint32_t len_a;
+    uint32_t offset_b;
+    uint32_t len_b;
+} pair_desc_t;
+
+typedef struct {
+    int32_t score;
+    uint32_t n_ops;
+    uint32_t ops[CIGAR_OPS];
+} pair_result_t;
+
+#define DPU_CAPACITY (64 << 20) // A DPU's capacity is 64 MiB
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+#define PRINT 0
+#ifndef ENERGY
+#define ENERGY 0
+#endif
+#endif
@@ -0,0 +1,80 @@
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "common.h"
+
+typedef struct Params {
+    unsigned int   n_pairs;
+    unsigned int   min_len;
+    unsigned int   max_len;
+    unsigned int   mutation;
+    unsigned int   penalty;
+    unsigned int   batch;
+    unsigned int   n_threads;
+    unsigned int   n_warmup;
+    unsigned int   n_reps;
+} Params;
+
+static void usage() {
+    fprintf(stderr,
+            "\nUsage:  ./program [options]"
+            "\n"
+            "\nGeneral options:"
+            "\n    -h        help"
+            "\n    -w <W>    # of untimed warmup iterations (default=1)"
+            "\n    -e <E>    # of timed repetition iterations (default=3)"
+            "\n    -t <T>    # of threads (CPU baseline only, default=8)"
+            "\n"
+            "\nBenchmark-specific options:"
+            "\n    -n <N>    number of sequence pairs (default=16384)"
+            "\n    -l <L>    minimum sequence length (default=100)"
+            "\n    -L <L>    maximum sequence length, at most MAX_LEN (default=1000)"
+            "\n    -m <M>    mutation rate of b with respect to a, in percent (default=10)"
+            "\n    -p <P>    gap penalty: a positive integer (default=1)"
+            "\n    -b <B>    pairs per DPU in each batch (default=256)"
+            "\n");
+}
+
+struct Params input_params(int argc, char **argv) {
+    struct Params p;
+    p.n_warmup      = 1;
+    p.n_reps        = 3;
+    p.n_threads     = 8;
+    p.n_pairs       = 16384;
+    p.min_len       = 100;
+    p.max_len       = 1000;
+    p.mutation      = 10;
+    p.penalty       = 1;
+    p.batch         = 256;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hw:e:t:n:l:L:m:p:b:")) >= 0) {
+        switch(opt) {
+            case 'h':
+                usage();
+                exit(0);
+                break;
+            case 'w': p.n_warmup      = atoi(optarg); break;
+            case 'e': p.n_reps        = atoi(optarg); break;
+            case 't': p.n_threads     = atoi(optarg); break;
+            case 'n': p.n_pairs       = atoi(optarg); break;
+            case 'l': p.min_len       = atoi(optarg); break;
+            case 'L': p.max_len       = atoi(optarg); break;
+            case 'm': p.mutation      = atoi(optarg); break;
+            case 'p': p.penalty       = atoi(optarg); break;
+            case 'b': p.batch         = atoi(optarg); break;
+            default:
+                      fprintf(stderr, "\nUnrecognized option!\n");
+                      usage();
+                      exit(0);
+        }
+    }
+    assert(p.min_len > 0 && p.min_len <= p.max_len && "Invalid sequence lengths!");
+    assert(p.max_len <= MAX_LEN && "Sequences longer than MAX_LEN!");
+    // Scores are 16-bit on the DPU: |score| <= 2 * MAX_LEN * penalty
+    assert(p.penalty > 0 && 2 * MAX_LEN * p.penalty < 32768 && "Invalid penalty!");
+    assert(p.batch > 0 && p.n_threads > 0 && "Invalid batch or thread count!");
+
+    return p;
+}
+#endif
@@ -6,6 +6,7 @@
 #include <math.h>
 #include <sys/time.h>
 #include <omp.h>
+#include "../../support/rapl.h"
 #define OPENMP
 //#define NUM_THREAD 4
 
@@ -302,14 +303,20 @@ runTest( int argc, char** argv)
     printf("Num of threads: %d\n", omp_num_threads);
     printf("Processing top-left matrix\n");
 
+    Energy energy;
+    energy_start(&energy, 0, 0);
     long long start_time = get_time();
 
     nw_optimized( input_itemsets, output_itemsets, referrence,
             max_rows, max_cols, penalty );
 
     long long end_time = get_time();
+    energy_stop(&energy, 0);
 
     printf("Total time: %.3f seconds\n", ((float) (end_time - start_time)) / (1000*1000));
+    printf("Energy ");
+    energy_print(&energy, 0, 1, (uint64_t)(max_rows - 1) * (max_cols - 1));
+    printf("\n");
 
 #define TRACEBACK
 #ifdef TRACEBACK
@@ -17,6 +17,7 @@
 #include "../support/timer.h"
 #include "../support/params.h"
 #include "../support/prim_results.h"
+#include "../support/trace.h"
 
 #if ENERGY
 #include <dpu_probe.h>
@@ -272,6 +273,7 @@ int main(int argc, char **argv) {
             input_itemsets[j] = -j * penalty;
         }
 
+        TRACE_BEGIN("host", "CPU NW", rep, -1);
         if (rep >= p.n_warmup)
             start(&timer, 0, rep - p.n_warmup);
         // Computation on host CPU
@@ -286,6 +288,7 @@ int main(int argc, char **argv) {
 #endif
         if (rep >= p.n_warmup)
             stop(&timer, 0);
+        TRACE_END();
 
         // Top-left computation on DPUs
         for (unsigned int blk = 1; blk <= (max_cols-1)/BL; blk++) {
@@ -329,7 +332,9 @@ int main(int argc, char **argv) {
                 input_args[i].penalty = penalty;
                 DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
             } 
+            TRACE_BEGIN("xfer", "Arguments (top-left)", blk, (int64_t)sizeof(dpu_arguments_t) * nr_of_dpus);
             DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+            TRACE_END();
 
             // Copy itemsets to DPUs
             blocks_per_dpu = blk / nr_of_dpus;
@@ -358,6 +363,7 @@ int main(int argc, char **argv) {
             total_dpu_memory = (uint64_t) blocks_per_dpu * (BL+1) * (BL+2) * sizeof(int32_t) + (uint64_t) blocks_per_dpu * BL * BL * sizeof(int32_t);
             printf("Total memory allocated in each DPU %u bytes\n", total_dpu_memory);
 #endif
+            TRACE_BEGIN("xfer", "Itemsets CPU-DPU (top-left)", blk, (int64_t)blocks_per_dpu * (BL+2 + BL*2) * sizeof(int32_t) * nr_of_dpus);
             for (unsigned int bl_indx = 0; bl_indx < blocks_per_dpu; bl_indx++) {
                 for (unsigned int bl = 0; bl < BL + 1; bl++) {
 
@@ -399,6 +405,7 @@ int main(int argc, char **argv) {
 
                 }
             }
+            TRACE_END();
             if (rep >= p.n_warmup) {
                 if ((max_cols-1)/BL == 1) 
                     stop(&timer, 2);
@@ -423,6 +430,7 @@ int main(int argc, char **argv) {
             }
             // Copy reference to DPUs
             mram_offset = blocks_per_dpu * (BL+1) * (BL+2) * sizeof(int32_t); 
+            TRACE_BEGIN("xfer", "Reference CPU-DPU (top-left)", blk, (int64_t)blocks_per_dpu * BL * BL * sizeof(int32_t) * nr_of_dpus);
             for (unsigned int bl_indx = 0; bl_indx < blocks_per_dpu; bl_indx++) {
                 for (unsigned int bl = 0; bl < BL; bl++) {
 
@@ -460,6 +468,7 @@ int main(int argc, char **argv) {
 
                 }
             }
+            TRACE_END();
             if (rep >= p.n_warmup) {
                 stop(&timer, 2);
                 if (blk == ((max_cols-1)/BL)) {
@@ -480,7 +489,9 @@ int main(int argc, char **argv) {
                 }
             }
             // Launch kernel on DPUs
+            TRACE_BEGIN("launch", "Diagonal (top-left)", blk, -1);
             DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            TRACE_END();
             if (rep >= p.n_warmup) {
                 stop(&timer, 3);
                 // Timer for longest diagonal
@@ -520,6 +531,7 @@ int main(int argc, char **argv) {
             // Retrieve results
             // Copy output result to Host CPU
             mram_offset = 0;
+            TRACE_BEGIN("xfer", "DPU-CPU (top-left)", blk, (int64_t)blocks_per_dpu * BL * (BL+2) * sizeof(int32_t) * nr_of_dpus);
             for (unsigned int bl_indx = 0; bl_indx < blocks_per_dpu; bl_indx++) {
                 for (unsigned int bl = 0; bl < BL + 1; bl++) {
 
@@ -564,6 +576,7 @@ int main(int argc, char **argv) {
 
                 }
             }
+            TRACE_END();
             if (rep >= p.n_warmup) {
                 stop(&timer, 4);
                 // Timer for longest diagonal
@@ -616,7 +629,9 @@ int main(int argc, char **argv) {
                 input_args[i].penalty = penalty;
                 DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
             } 
+            TRACE_BEGIN("xfer", "Arguments (bottom-right)", blk, (int64_t)sizeof(dpu_arguments_t) * nr_of_dpus);
             DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+            TRACE_END();
 
             if (rep >= p.n_warmup)
                 start(&timer, 1, rep - p.n_warmup + blk - 1);
@@ -630,6 +645,7 @@ int main(int argc, char **argv) {
             printf("Total memory allocated in each DPU %u bytes\n", total_dpu_memory);
 #endif
             unsigned int mram_offset = 0;
+            TRACE_BEGIN("xfer", "Itemsets CPU-DPU (bottom-right)", blk, (int64_t)blocks_per_dpu * (BL+2 + BL*2) * sizeof(int32_t) * nr_of_dpus);
             for (unsigned int bl_indx = 0; bl_indx < blocks_per_dpu; bl_indx++) {
                 for (unsigned int bl = 0; bl < BL + 1; bl++) {
 
@@ -671,6 +687,7 @@ int main(int argc, char **argv) {
 
                 }
             }
+            TRACE_END();
             if (rep >= p.n_warmup)
                 stop(&timer, 1);
 
@@ -679,6 +696,7 @@ int main(int argc, char **argv) {
                 start(&timer, 2, rep - p.n_warmup + blk - 1);
             // Copy reference to DPUs
             mram_offset = blocks_per_dpu * (BL+1) * (BL+2) * sizeof(int32_t); 
+            TRACE_BEGIN("xfer", "Reference CPU-DPU (bottom-right)", blk, (int64_t)blocks_per_dpu * BL * BL * sizeof(int32_t) * nr_of_dpus);
             for (unsigned int bl_indx = 0; bl_indx < blocks_per_dpu; bl_indx++) {
                 for (unsigned int bl = 0; bl < BL; bl++) {
 
@@ -717,6 +735,7 @@ int main(int argc, char **argv) {
 
                 }
             }
+            TRACE_END();
             if (rep >= p.n_warmup)
                 stop(&timer, 2);
 
@@ -728,7 +747,9 @@ int main(int argc, char **argv) {
             if (rep >= p.n_warmup)
                 start(&timer, 3, rep - p.n_warmup + blk - 1); // Do not re-initialize the counter
             // Launch kernel on DPUs
+            TRACE_BEGIN("launch", "Diagonal (bottom-right)", blk, -1);
             DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            TRACE_END();
             if (rep >= p.n_warmup)
                 stop(&timer, 3);
 #if ENERGY
@@ -759,6 +780,7 @@ int main(int argc, char **argv) {
             // Retrieve results
             // Copy output result to Host CPU
             mram_offset = 0;
+            TRACE_BEGIN("xfer", "DPU-CPU (bottom-right)", blk, (int64_t)blocks_per_dpu * BL * (BL+2) * sizeof(int32_t) * nr_of_dpus);
             for (unsigned int bl_indx = 0; bl_indx < blocks_per_dpu; bl_indx++) {
                 for (unsigned int bl = 0; bl < BL + 1; bl++) {
 
@@ -804,6 +826,7 @@ int main(int argc, char **argv) {
 
                 }
             }
+            TRACE_END();
             if (rep >= p.n_warmup)
                 stop(&timer, 4);
 
@@ -811,6 +834,7 @@ int main(int argc, char **argv) {
         }
 
         // Traceback step
+        TRACE_BEGIN("host", "Traceback", rep, -1);
         if (rep >= p.n_warmup)
             start(&timer, 1, 1);
 #if PRINT_FILE
@@ -821,6 +845,7 @@ int main(int argc, char **argv) {
 #endif
         if (rep >= p.n_warmup)
             stop(&timer, 1);
+        TRACE_END();
 
     }
 
@@ -853,6 +878,7 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "U_C2D");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 4, p.n_reps, "U_D2C");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)(max_cols - 1) * (max_cols - 1), (double)max_dpus);
     
 #if ENERGY
     printf("DPU Energy (J): %f \t ", tavg_energy / p.n_reps);
@@ -0,0 +1,121 @@
+#ifndef PRIM_TRACE_H
+#define PRIM_TRACE_H
+
+// Header-only timeline trace in Chrome/Perfetto JSON format (build with TRACE=1).
+// - TRACE_BEGIN(cat, name, iter, bytes) / TRACE_END() bracket a transfer, launch or host step
+//   (iter: loop index such as the BFS level or NW diagonal, bytes: transferred bytes; -1 if none)
+// - Events are buffered in memory with their thread ID and written at exit to
+//   $PRIM_TRACE_FILE (default: trace.json); open it at https://ui.perfetto.dev
+// - Asynchronous launches and transfers only cover the host call; the wait shows up where
+//   dpu_sync is traced
+// - Without TRACE=1 the macros expand to nothing and their arguments are not evaluated
+//
+// Usage:
+//   TRACE_BEGIN("xfer", "A to DPUs", round, bytes);
+//   DPU_ASSERT(dpu_push_xfer(...));
+//   TRACE_END();
+
+#if TRACE
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef PRIM_TRACE_DEFAULT_FILE
+#define PRIM_TRACE_DEFAULT_FILE "trace.json"
+#endif
+
+typedef struct {
+    const char *cat;  // String literal
+    const char *name; // String literal
+    char ph;          // 'B' or 'E'
+    int tid;
+    double ts;        // Microseconds
+    int64_t iter;
+    int64_t bytes;
+} prim_trace_event_t;
+
+static prim_trace_event_t *prim_trace_events;
+static size_t prim_trace_nr_events;
+static size_t prim_trace_cap_events;
+static pthread_mutex_t prim_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static double prim_trace_t0 = -1.0;
+static _Thread_local int prim_trace_tid;
+
+static inline double prim_trace_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static inline void prim_trace_write(void) {
+    const char *path = getenv("PRIM_TRACE_FILE");
+    if (!path || !*path) path = PRIM_TRACE_DEFAULT_FILE;
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "[WARNING] Cannot write trace file %s\n", path);
+        return;
+    }
+    int pid = (int)getpid();
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t e = 0; e < prim_trace_nr_events; e++) {
+        const prim_trace_event_t *ev = &prim_trace_events[e];
+        fprintf(f, "%s{\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f", e ? ",\n" : "", ev->ph, pid, ev->tid, ev->ts);
+        if (ev->ph == 'B') {
+            fprintf(f, ",\"cat\":\"%s\",\"name\":\"%s\",\"args\":{", ev->cat, ev->name);
+            if (ev->iter >= 0) fprintf(f, "\"iter\":%lld", (long long)ev->iter);
+            if (ev->bytes >= 0) fprintf(f, "%s\"bytes\":%lld", ev->iter >= 0 ? "," : "", (long long)ev->bytes);
+            fputc('}', f);
+        }
+        fputc('}', f);
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    fprintf(stderr, "Trace with %zu events written to %s\n", prim_trace_nr_events, path);
+    free(prim_trace_events);
+}
+
+static inline void prim_trace_event(char ph, const char *cat, const char *name, int64_t iter, int64_t bytes) {
+    double ts = prim_trace_now_us();
+    if (!prim_trace_tid) prim_trace_tid = (int)syscall(SYS_gettid);
+    pthread_mutex_lock(&prim_trace_mutex);
+    if (prim_trace_t0 < 0.0) {
+        prim_trace_t0 = ts;
+        atexit(prim_trace_write);
+    }
+    if (prim_trace_nr_events == prim_trace_cap_events) {
+        size_t cap = prim_trace_cap_events ? 2 * prim_trace_cap_events : 4096;
+        prim_trace_event_t *events = (prim_trace_event_t *)realloc(prim_trace_events, cap * sizeof(prim_trace_event_t));
+        if (!events) {
+            pthread_mutex_unlock(&prim_trace_mutex);
+            return;
+        }
+        prim_trace_events = events;
+        prim_trace_cap_events = cap;
+    }
+    prim_trace_event_t *ev = &prim_trace_events[prim_trace_nr_events++];
+    ev->cat = cat;
+    ev->name = name;
+    ev->ph = ph;
+    ev->tid = prim_trace_tid;
+    ev->ts = ts - prim_trace_t0;
+    ev->iter = iter;
+    ev->bytes = bytes;
+    pthread_mutex_unlock(&prim_trace_mutex);
+}
+
+#define TRACE_BEGIN(cat, name, iter, bytes) prim_trace_event('B', (cat), (name), (int64_t)(iter), (int64_t)(bytes))
+#define TRACE_END() prim_trace_event('E', "", "", -1, -1)
+
+#else
+
+#define TRACE_BEGIN(cat, name, iter, bytes) ((void)0)
+#define TRACE_END() ((void)0)
+
+#endif
+
+#endif // PRIM_TRACE_H
@@ -13,9 +13,13 @@
 
 #include "../support/common.h"
 #include "../support/cyclecount.h"
+#include "../support/codec.h"
 
 __host dpu_arguments_t DPU_INPUT_ARGUMENTS;
 __host dpu_results_t DPU_RESULTS[NR_TASKLETS];
+#if COMPRESS
+__host codec_stats_t DPU_CODEC_STATS[NR_TASKLETS];
+#endif
 
 // Array for communication between adjacent tasklets
 T message[NR_TASKLETS];
@@ -49,7 +53,7 @@ int main_kernel1() {
 #endif
     if (tasklet_id == 0){ // Initialize once the cycle counter
         mem_reset(); // Reset the heap
-#if PERF
+#if PERF || COMPRESS
         perfcounter_config(COUNT_CYCLES, true);
 #endif
     }
@@ -71,6 +75,11 @@ int main_kernel1() {
 
     // Initialize a local cache to store the MRAM block
     T *cache_A = (T *) mem_alloc(BLOCK_SIZE);
+#if COMPRESS
+    uint8_t *cache_C = (uint8_t *) mem_alloc(BLOCK_SIZE);
+    codec_entry_t *entry = (codec_entry_t *) mem_alloc(sizeof(codec_entry_t));
+    uint64_t decode_cycles = 0;
+#endif
 	
     // Local count
     T l_count = 0;
@@ -82,13 +91,30 @@ int main_kernel1() {
         uint32_t l_size_bytes = (byte_index + BLOCK_SIZE >= input_size_dpu_bytes) ? (input_size_dpu_bytes - byte_index) : BLOCK_SIZE;
 
         // Load cache with current MRAM block
+#if COMPRESS
+        // Compressed column: look the block up in the directory, read it and expand it in WRAM
+        mram_read((__mram_ptr void const*)(mram_base_addr_A + (byte_index >> BLOCK_SIZE_LOG2) * sizeof(codec_entry_t)), entry, sizeof(codec_entry_t));
+        if (entry->scheme == CODEC_RAW)
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + entry->offset), cache_A, entry->bytes);
+        else {
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + entry->offset), cache_C, entry->bytes);
+            perfcounter_t decode_start = perfcounter_get();
+            codec_decode(cache_A, cache_C);
+            decode_cycles += perfcounter_get() - decode_start;
+        }
+#else
         mram_read((__mram_ptr void const*)(mram_base_addr_A + byte_index), cache_A, l_size_bytes);
+#endif
 		
         // Reduction in each tasklet
         l_count += reduction(cache_A, l_size_bytes >> DIV);
 
     }
 #endif
+#if COMPRESS
+    DPU_CODEC_STATS[tasklet_id].decode_cycles = decode_cycles;
+    DPU_CODEC_STATS[tasklet_id].cycles = perfcounter_get();
+#endif
 
     // Reduce local counts
     message[tasklet_id] = l_count;
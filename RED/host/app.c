@@ -16,6 +16,7 @@
 #include "../support/common.h"
 #include "../support/timer.h"
 #include "../support/params.h"
+#include "../support/codec.h"
 #include "../support/prim_results.h"
 
 // Define the DPU Binary path as DPU_BINARY here
@@ -29,13 +30,16 @@
 
 // Pointer declaration
 static T* A;
+#if COMPRESS
+static uint8_t* A_compressed;
+#endif
 
 // Create input arrays
-static void read_input(T* A, unsigned int nr_elements) {
+static void read_input(T* A, unsigned int nr_elements, unsigned int dist) {
     srand(0);
     printf("nr_elements\t%u\t", nr_elements);
     for (unsigned int i = 0; i < nr_elements; i++) {
-        A[i] = (T)(rand());
+        A[i] = dist == DIST_DEFAULT ? (T)(rand()) : codec_input(dist, i);
     }
 }
 
@@ -82,12 +86,21 @@ int main(int argc, char **argv) {
 
     // Input/output allocation
     A = malloc(input_size_dpu_8bytes * nr_of_dpus * sizeof(T));
+#if COMPRESS
+    const unsigned int bound_dpu = codec_bound(input_size_dpu_8bytes * sizeof(T)); // Compressed input per DPU (max.)
+    A_compressed = malloc(bound_dpu * nr_of_dpus);
+    uint8_t *bufferA = A_compressed;
+    uint32_t compressed_bytes = 0;
+    uint32_t blocks[nr_codec_schemes];
+#else
     T *bufferA = A;
+#endif
+    unsigned int transfer_size_dpu = input_size_dpu_8bytes * sizeof(T);
     T count = 0;
     T count_host = 0;
 
     // Create an input file with arbitrary data
-    read_input(A, input_size);
+    read_input(A, input_size, p.dist);
 
     // Timer declaration
     Timer timer;
@@ -117,6 +130,18 @@ int main(int argc, char **argv) {
         }
         input_arguments[nr_of_dpus-1].size=(input_size_8bytes - input_size_dpu_8bytes * (NR_DPUS-1)) * sizeof(T); 
         input_arguments[nr_of_dpus-1].kernel=kernel;		
+#if COMPRESS
+        // Encoding is part of the CPU-DPU transfer; all DPUs receive the largest column
+        transfer_size_dpu = 0;
+        compressed_bytes = 0;
+        memset(blocks, 0, sizeof(blocks));
+        for(i = 0; i < nr_of_dpus; i++) {
+            uint32_t bytes = codec_encode(A_compressed + bound_dpu * i, A + input_size_dpu_8bytes * i, input_arguments[i].size >> DIV, p.codec, blocks);
+            compressed_bytes += bytes;
+            if(bytes > transfer_size_dpu)
+                transfer_size_dpu = bytes;
+        }
+#endif
         // Copy input arrays
         i = 0;
         DPU_FOREACH(dpu_set, dpu, i) {
@@ -124,9 +149,13 @@ int main(int argc, char **argv) {
         }
         DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(input_arguments[0]), DPU_XFER_DEFAULT));
         DPU_FOREACH(dpu_set, dpu, i) {
+#if COMPRESS
+            DPU_ASSERT(dpu_prepare_xfer(dpu, bufferA + bound_dpu * i));
+#else
             DPU_ASSERT(dpu_prepare_xfer(dpu, bufferA + input_size_dpu_8bytes * i));
+#endif
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, input_size_dpu_8bytes * sizeof(T), DPU_XFER_DEFAULT));
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, transfer_size_dpu, DPU_XFER_DEFAULT));
         if(rep >= p.n_warmup)
             stop(&timer, 1);
 
@@ -238,6 +267,21 @@ int main(int argc, char **argv) {
     print(&timer, 2, p.n_reps);
     printf("Inter-DPU ");
     print(&timer, 3, p.n_reps);
+    printf("\nCPU-DPU bytes per DPU\t%u\n", transfer_size_dpu);
+#if COMPRESS
+    // Decode statistics of the last launch
+    codec_stats_t *codec_stats = malloc(nr_of_dpus * NR_TASKLETS * sizeof(codec_stats_t));
+    DPU_FOREACH(dpu_set, dpu, i) {
+        DPU_ASSERT(dpu_prepare_xfer(dpu, codec_stats + NR_TASKLETS * i));
+    }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "DPU_CODEC_STATS", 0, NR_TASKLETS * sizeof(codec_stats_t), DPU_XFER_DEFAULT));
+    double compression_ratio = (double)input_size_8bytes * sizeof(T) / compressed_bytes;
+    double decode_cycles, decode_share;
+    codec_summary(codec_stats, nr_of_dpus, &decode_cycles, &decode_share);
+    free(codec_stats);
+    printf("Compression ratio\t%.2f\tBlocks RAW/FOR/DELTA/RLE\t%u/%u/%u/%u\n", compression_ratio, blocks[CODEC_RAW], blocks[CODEC_FOR], blocks[CODEC_DELTA], blocks[CODEC_RLE]);
+    printf("Decode cycles\t%.0f\tDecode share\t%.1f%%\n", decode_cycles, 100 * decode_share);
+#endif
 
     // update CSV
 #define TEST_NAME "RED"
@@ -245,6 +289,12 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 0, p.n_reps, "CPU");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");    
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)input_size, (double)nr_of_dpus);
+#if COMPRESS
+    update_csv(RESULTS_FILE, TEST_NAME, "Compression_ratio", compression_ratio);
+    update_csv(RESULTS_FILE, TEST_NAME, "Decode_cycles", decode_cycles);
+    update_csv(RESULTS_FILE, TEST_NAME, "Decode_share", decode_share);
+#endif
 
     #if ENERGY
     double energy;
@@ -263,6 +313,9 @@ int main(int argc, char **argv) {
 
     // Deallocation
     free(A);
+#if COMPRESS
+    free(A_compressed);
+#endif
     DPU_ASSERT(dpu_free(dpu_set));
 	
     return status ? 0 : -1;
@@ -38,6 +38,14 @@
 #define DIV 1 // Shift right to divide by sizeof(T)
 #endif
 
+// Input transfer format: 0 sends the raw column, 1 compresses it (see codec.h)
+#ifndef COMPRESS
+#define COMPRESS 0
+#endif
+#if COMPRESS && (defined(FLOAT) || defined(DOUBLE) || defined(CHAR) || defined(SHORT))
+#error "COMPRESS needs a 32- or 64-bit integer TYPE"
+#endif
+
 // Structures used by both the host and the dpu to communicate information
 typedef struct {
     uint32_t size;
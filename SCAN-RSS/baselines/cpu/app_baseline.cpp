@@ -34,6 +34,7 @@
 
 #include "../../support/common.h"
 #include "../../support/timer.h"
+#include "../../support/rapl.h"
 
 #define ANSI_COLOR_RED     "\x1b[31m"
 #define ANSI_COLOR_GREEN   "\x1b[32m"
@@ -146,6 +147,7 @@ int main(int argc, char **argv) {
 
     // Timer declaration
     Timer timer;
+    Energy energy;
     float time_gpu = 0;
 
     thrust::omp::vector<T> h_output(input_size);
@@ -154,21 +156,29 @@ int main(int argc, char **argv) {
     for(int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
 
         // Compute output on CPU (performance comparison and verification purposes)
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
+            energy_start(&energy, 0, rep - p.n_warmup);
             start(&timer, 0, rep - p.n_warmup);
+        }
         scan_host(C, A, input_size);
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
             stop(&timer, 0);
+            energy_stop(&energy, 0);
+        }
 
         memcpy(thrust::raw_pointer_cast(&h_output[0]), A, input_size * sizeof(T));
 
         omp_set_num_threads(p.n_threads);
 
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
+            energy_start(&energy, 1, rep - p.n_warmup);
             start(&timer, 1, rep - p.n_warmup);
+        }
         thrust::exclusive_scan(thrust::omp::par, h_output.begin(),h_output.end(),h_output.begin());
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
             stop(&timer, 1);
+            energy_stop(&energy, 1);
+        }
     }
 
     // Print timing results
@@ -176,6 +186,11 @@ int main(int argc, char **argv) {
     print(&timer, 0, p.n_reps);
     printf("Kernel ");
     print(&timer, 1, p.n_reps);
+    printf("\nCPU energy ");
+    energy_print(&energy, 0, p.n_reps, input_size);
+    printf("\nKernel energy ");
+    energy_print(&energy, 1, p.n_reps, input_size);
+    printf("\n");
 
     // Check output
     bool status = true;
@@ -266,6 +266,7 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 5, p.n_reps, "U_D2C");
     double dpu_ms = prim_timer_ms_avg(&timer, 2, p.n_reps) + prim_timer_ms_avg(&timer, 4, p.n_reps);
     update_csv(RESULTS_FILE, TEST_NAME, "UPMEM", dpu_ms);
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)input_size, (double)nr_of_dpus);
 
     #if ENERGY
     double energy;
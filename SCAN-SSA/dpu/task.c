@@ -12,9 +12,13 @@
 #include <barrier.h>
 
 #include "../support/common.h"
+#include "../support/codec.h"
 
 __host dpu_arguments_t DPU_INPUT_ARGUMENTS;
 __host dpu_results_t DPU_RESULTS[NR_TASKLETS];
+#if COMPRESS
+__host codec_stats_t DPU_CODEC_STATS[NR_TASKLETS];
+#endif
 
 // Array for communication between adjacent tasklets
 T message[NR_TASKLETS];
@@ -30,6 +34,33 @@ static T scan(T *output, T *input){
     return output[REGS - 1];
 }
 
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+#ifdef KOGGE
+// Double buffer for the scan across tasklets
+T scan_buffer[2][NR_TASKLETS];
+
+// Log-depth (Kogge-Stone) exclusive scan across tasklets
+// The DPU count is read between the first and the last barrier: the last tasklet updates it
+// after the scan, and before the next scan
+static T kogge_stone_sync(T l_count, unsigned int tasklet_id, T *partial_count){
+    unsigned int in = 0;
+    scan_buffer[in][tasklet_id] = l_count;
+    barrier_wait(&my_barrier);
+    *partial_count = message_partial_count;
+    #pragma unroll
+    for(unsigned int offset = 1; offset < NR_TASKLETS; offset <<= 1){
+        T value = scan_buffer[in][tasklet_id];
+        if(tasklet_id >= offset)
+            value += scan_buffer[in][tasklet_id - offset];
+        scan_buffer[1 - in][tasklet_id] = value;
+        in = 1 - in;
+        barrier_wait(&my_barrier);
+    }
+    return scan_buffer[in][tasklet_id] - l_count;
+}
+#else
 // Handshake with adjacent tasklets
 static T handshake_sync(T l_count, unsigned int tasklet_id){
     T p_count;
@@ -47,9 +78,7 @@ static T handshake_sync(T l_count, unsigned int tasklet_id){
     }
     return p_count;
 }
-
-// Barrier
-BARRIER_INIT(my_barrier, NR_TASKLETS);
+#endif
 
 // Add in each tasklet
 static void add(T *output, T p_count){
@@ -78,6 +107,9 @@ int main_kernel1() {
 #endif
     if (tasklet_id == 0){ // Initialize once the cycle counter
         mem_reset(); // Reset the heap
+#if COMPRESS
+        perfcounter_config(COUNT_CYCLES, true);
+#endif
     }
     // Barrier
     barrier_wait(&my_barrier);
@@ -89,11 +121,21 @@ int main_kernel1() {
     // Address of the current processing block in MRAM
     uint32_t base_tasklet = tasklet_id << BLOCK_SIZE_LOG2;
     uint32_t mram_base_addr_A = (uint32_t)DPU_MRAM_HEAP_POINTER;
+#if COMPRESS
+    uint32_t mram_base_addr_B = (uint32_t)(DPU_MRAM_HEAP_POINTER + codec_bound(input_size_dpu_bytes));
+#else
     uint32_t mram_base_addr_B = (uint32_t)(DPU_MRAM_HEAP_POINTER + input_size_dpu_bytes);
+#endif
 
     // Initialize a local cache to store the MRAM block
     T *cache_A = (T *) mem_alloc(BLOCK_SIZE);
     T *cache_B = (T *) mem_alloc(BLOCK_SIZE);
+#if COMPRESS
+    // Compressed blocks go through cache_B, which is free until the scan
+    uint8_t *cache_C = (uint8_t *) cache_B;
+    codec_entry_t *entry = (codec_entry_t *) mem_alloc(sizeof(codec_entry_t));
+    uint64_t decode_cycles = 0;
+#endif
 	
     // Initialize shared variable
     if(tasklet_id == NR_TASKLETS - 1)
@@ -104,29 +146,53 @@ int main_kernel1() {
     for(unsigned int byte_index = base_tasklet; byte_index < input_size_dpu_bytes; byte_index += BLOCK_SIZE * NR_TASKLETS){
 
         // Load cache with current MRAM block
+#if COMPRESS
+        // Compressed column: look the block up in the directory, read it and expand it in WRAM
+        mram_read((__mram_ptr void const*)(mram_base_addr_A + (byte_index >> BLOCK_SIZE_LOG2) * sizeof(codec_entry_t)), entry, sizeof(codec_entry_t));
+        if (entry->scheme == CODEC_RAW)
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + entry->offset), cache_A, entry->bytes);
+        else {
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + entry->offset), cache_C, entry->bytes);
+            perfcounter_t decode_start = perfcounter_get();
+            codec_decode(cache_A, cache_C);
+            decode_cycles += perfcounter_get() - decode_start;
+        }
+#else
         mram_read((const __mram_ptr void*)(mram_base_addr_A + byte_index), cache_A, BLOCK_SIZE);
+#endif
 
         // Scan in each tasklet
         T l_count = scan(cache_B, cache_A); 
 
+#ifdef KOGGE
+        // Scan across tasklets (ends with a barrier)
+        T partial_count;
+        T p_count = kogge_stone_sync(l_count, tasklet_id, &partial_count);
+#else
         // Sync with adjacent tasklets
         T p_count = handshake_sync(l_count, tasklet_id);
 
         // Barrier
         barrier_wait(&my_barrier);
+        T partial_count = message_partial_count;
+#endif
 
         // Add in each tasklet
-        add(cache_B, message_partial_count + p_count);
+        add(cache_B, partial_count + p_count);
 
         // Write cache to current MRAM block
         mram_write(cache_B, (__mram_ptr void*)(mram_base_addr_B + byte_index), BLOCK_SIZE);
 
         // Total count in this DPU
         if(tasklet_id == NR_TASKLETS - 1){
-            result->t_count = message_partial_count + p_count + l_count;
+            result->t_count = partial_count + p_count + l_count;
             message_partial_count = result->t_count;
         }
 	}
+#if COMPRESS
+    DPU_CODEC_STATS[tasklet_id].decode_cycles = decode_cycles;
+    DPU_CODEC_STATS[tasklet_id].cycles = perfcounter_get();
+#endif
 
 #endif
     return 0;
@@ -148,7 +214,11 @@ int main_kernel2() {
 
     // Address of the current processing block in MRAM
     uint32_t base_tasklet = tasklet_id << BLOCK_SIZE_LOG2;
+#if COMPRESS
+    uint32_t mram_base_addr_B = (uint32_t)(DPU_MRAM_HEAP_POINTER + codec_bound(input_size_dpu_bytes));
+#else
     uint32_t mram_base_addr_B = (uint32_t)(DPU_MRAM_HEAP_POINTER + input_size_dpu_bytes);
+#endif
 
     // Initialize a local cache to store the MRAM block
     T *cache_A = (T *) mem_alloc(BLOCK_SIZE);
@@ -16,6 +16,7 @@
 #include "../support/common.h"
 #include "../support/timer.h"
 #include "../support/params.h"
+#include "../support/codec.h"
 #include "../support/prim_results.h"
 
 // Define the DPU Binary path as DPU_BINARY here
@@ -31,13 +32,16 @@
 static T* A;
 static T* C;
 static T* C2;
+#if COMPRESS
+static uint8_t* A_compressed;
+#endif
 
 // Create input arrays
-static void read_input(T* A, unsigned int nr_elements, unsigned int nr_elements_round) {
+static void read_input(T* A, unsigned int nr_elements, unsigned int nr_elements_round, unsigned int dist) {
     srand(0);
     printf("nr_elements\t%u\t", nr_elements);
     for (unsigned int i = 0; i < nr_elements; i++) {
-        A[i] = (T) (rand());
+        A[i] = dist == DIST_DEFAULT ? (T) (rand()) : codec_input(dist, i);
     }
     for (unsigned int i = nr_elements; i < nr_elements_round; i++) {
         A[i] = 0;
@@ -83,11 +87,22 @@ int main(int argc, char **argv) {
     A = malloc(input_size_dpu_round * nr_of_dpus * sizeof(T));
     C = malloc(input_size_dpu_round * nr_of_dpus * sizeof(T));
     C2 = malloc(input_size_dpu_round * nr_of_dpus * sizeof(T));
+#if COMPRESS
+    const unsigned int bound_dpu = codec_bound(input_size_dpu_round * sizeof(T)); // Compressed input per DPU (max.)
+    const unsigned int output_offset = bound_dpu;
+    A_compressed = malloc(bound_dpu * nr_of_dpus);
+    uint8_t *bufferA = A_compressed;
+    uint32_t compressed_bytes = 0;
+    uint32_t blocks[nr_codec_schemes];
+#else
+    const unsigned int output_offset = input_size_dpu_round * sizeof(T);
     T *bufferA = A;
+#endif
+    unsigned int transfer_size_dpu = input_size_dpu_round * sizeof(T);
     T *bufferC = C2;
 
     // Create an input file with arbitrary data
-    read_input(A, input_size, input_size_dpu_round * nr_of_dpus);
+    read_input(A, input_size, input_size_dpu_round * nr_of_dpus, p.dist);
 
     // Timer declaration
     Timer timer;
@@ -111,6 +126,18 @@ int main(int argc, char **argv) {
         const unsigned int input_size_dpu = input_size_dpu_round;
         unsigned int kernel = 0;
         dpu_arguments_t input_arguments = {input_size_dpu * sizeof(T), kernel, 0};
+#if COMPRESS
+        // Encoding is part of the CPU-DPU transfer; all DPUs receive the largest column
+        transfer_size_dpu = 0;
+        compressed_bytes = 0;
+        memset(blocks, 0, sizeof(blocks));
+        for(i = 0; i < nr_of_dpus; i++) {
+            uint32_t bytes = codec_encode(A_compressed + bound_dpu * i, A + input_size_dpu * i, input_size_dpu, p.codec, blocks);
+            compressed_bytes += bytes;
+            if(bytes > transfer_size_dpu)
+                transfer_size_dpu = bytes;
+        }
+#endif
         // Copy input arrays
         i = 0;
         DPU_FOREACH(dpu_set, dpu, i) {
@@ -118,9 +145,13 @@ int main(int argc, char **argv) {
         }
         DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(input_arguments), DPU_XFER_DEFAULT));
         DPU_FOREACH(dpu_set, dpu, i) {
+#if COMPRESS
+            DPU_ASSERT(dpu_prepare_xfer(dpu, bufferA + bound_dpu * i));
+#else
             DPU_ASSERT(dpu_prepare_xfer(dpu, bufferA + input_size_dpu * i));
+#endif
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, input_size_dpu * sizeof(T), DPU_XFER_DEFAULT));
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, transfer_size_dpu, DPU_XFER_DEFAULT));
         if(rep >= p.n_warmup)
             stop(&timer, 1);
 
@@ -240,7 +271,7 @@ int main(int argc, char **argv) {
         DPU_FOREACH(dpu_set, dpu, i) {
             DPU_ASSERT(dpu_prepare_xfer(dpu, bufferC + input_size_dpu * i));
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, input_size_dpu * sizeof(T), input_size_dpu * sizeof(T), DPU_XFER_DEFAULT));
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, output_offset, input_size_dpu * sizeof(T), DPU_XFER_DEFAULT));
 	printf("%d\n",input_size_dpu * sizeof(T)/8);
         if(rep >= p.n_warmup)
             stop(&timer, 5);
@@ -262,6 +293,21 @@ int main(int argc, char **argv) {
     print(&timer, 4, p.n_reps);
     printf("DPU-CPU ");
     print(&timer, 5, p.n_reps);
+    printf("\nCPU-DPU bytes per DPU\t%u\n", transfer_size_dpu);
+#if COMPRESS
+    // Decode statistics of the last scan kernel
+    codec_stats_t *codec_stats = malloc(nr_of_dpus * NR_TASKLETS * sizeof(codec_stats_t));
+    DPU_FOREACH(dpu_set, dpu, i) {
+        DPU_ASSERT(dpu_prepare_xfer(dpu, codec_stats + NR_TASKLETS * i));
+    }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, "DPU_CODEC_STATS", 0, NR_TASKLETS * sizeof(codec_stats_t), DPU_XFER_DEFAULT));
+    double compression_ratio = (double)input_size_dpu_round * nr_of_dpus * sizeof(T) / compressed_bytes;
+    double decode_cycles, decode_share;
+    codec_summary(codec_stats, nr_of_dpus, &decode_cycles, &decode_share);
+    free(codec_stats);
+    printf("Compression ratio\t%.2f\tBlocks RAW/FOR/DELTA/RLE\t%u/%u/%u/%u\n", compression_ratio, blocks[CODEC_RAW], blocks[CODEC_FOR], blocks[CODEC_DELTA], blocks[CODEC_RLE]);
+    printf("Decode cycles\t%.0f\tDecode share\t%.1f%%\n", decode_cycles, 100 * decode_share);
+#endif
 
 #define TEST_NAME "SCAN-SSA"
 #define RESULTS_FILE "../prim_results.csv"
@@ -270,6 +316,12 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 5, p.n_reps, "U_D2C");
     double dpu_ms = prim_timer_ms_avg(&timer, 2, p.n_reps) + prim_timer_ms_avg(&timer, 4, p.n_reps);
     update_csv(RESULTS_FILE, TEST_NAME, "UPMEM", dpu_ms);
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)input_size, (double)nr_of_dpus);
+#if COMPRESS
+    update_csv(RESULTS_FILE, TEST_NAME, "Compression_ratio", compression_ratio);
+    update_csv(RESULTS_FILE, TEST_NAME, "Decode_cycles", decode_cycles);
+    update_csv(RESULTS_FILE, TEST_NAME, "Decode_share", decode_share);
+#endif
 
 
     #if ENERGY
@@ -299,6 +351,9 @@ int main(int argc, char **argv) {
     free(A);
     free(C);
     free(C2);
+#if COMPRESS
+    free(A_compressed);
+#endif
     DPU_ASSERT(dpu_free(dpu_set));
 	
     return status ? 0 : -1;
@@ -9,3 +9,17 @@ do
 			make clean
 			wait
 done
+
+# Handshake chain (HAND) vs. log-depth scan (KOGGE) across tasklets
+for s in HAND KOGGE
+do
+	for k in 8 16 24
+	do
+		NR_DPUS=1 NR_TASKLETS=$k BL=10 SYNC=$s make all
+		wait
+		./bin/host_code -w 10 -e 100 -i 3932160 > profile/out_${s}_tl${k}_bl10_dpu1
+		wait
+		make clean
+		wait
+	done
+done
@@ -0,0 +1,280 @@
+#ifndef _CODEC_H_
+#define _CODEC_H_
+
+// Lightweight compression of integer columns (COMPRESS=1 builds).
+// The column of a DPU is cut in blocks of BLOCK_SIZE raw bytes, the unit of the DPU loop, and
+// is stored as a directory of one codec_entry_t per block followed by the blocks, each of them
+// 8-byte aligned so that the DPU fetches it with a single mram_read:
+//   - FOR: frame of reference, the minimum of the block and bit-packed offsets from it
+//   - DELTA: the first value and bit-packed differences between neighbors, minus the smallest
+//     (signed) difference, for sorted or slowly varying columns
+//   - RLE: the value of every run, then the 16-bit run lengths
+// Packed values take up to 32 bits, LSB first in 32-bit words. A block that no scheme makes
+// smaller is stored raw, so a compressed block never exceeds BLOCK_SIZE and a column never
+// exceeds codec_bound(). Arithmetic is modulo the width of T, a 32- or 64-bit integer.
+// The host encodes with codec_encode() before the CPU-DPU transfer; the DPU reads the entry and
+// the block of its current byte index and expands the block in WRAM with codec_decode().
+
+#include <stdint.h>
+
+#include "common.h"
+
+enum codec_schemes { CODEC_RAW, CODEC_FOR, CODEC_DELTA, CODEC_RLE, nr_codec_schemes };
+#define CODEC_AUTO CODEC_RAW // Requested scheme: smallest of all per block
+
+// Input distributions (-d), so that raw and compressed builds run on the same data
+enum codec_dists { DIST_DEFAULT, DIST_NARROW, DIST_SORTED, DIST_RUNS, nr_codec_dists };
+
+// Directory entry of a block
+typedef struct {
+    uint32_t offset; // From the start of the directory
+    uint16_t bytes;  // Stored bytes, 8-byte aligned
+    uint16_t scheme;
+} codec_entry_t;
+
+// Header of a compressed block
+typedef struct {
+    uint64_t base;   // FOR: minimum; DELTA: first value
+    uint64_t step;   // DELTA: smallest difference, two's complement
+    uint16_t n;      // Values in the block
+    uint16_t runs;   // RLE: number of runs
+    uint8_t scheme;
+    uint8_t bits;    // FOR, DELTA: bits per packed value
+    uint8_t pad[2];
+} codec_header_t;
+
+// Decode statistics of a tasklet, for one launch
+typedef struct {
+    uint64_t decode_cycles; // In codec_decode()
+    uint64_t cycles;        // Whole kernel
+} codec_stats_t;
+
+#define codec_align8(b) (((b) + 7) & ~7u)
+#define codec_wrap(v) (sizeof(T) == 8 ? (uint64_t)(v) : (uint64_t)(v) & 0xFFFFFFFF)
+#define codec_signed(v) (sizeof(T) == 8 ? (int64_t)(v) : (int64_t)(int32_t)(v))
+// Raw blocks are padded to 8 bytes, which adds 4 bytes to the last one for an odd number of 32-bit values
+#define codec_bound(bytes) (codec_align8(bytes) + (((bytes) + BLOCK_SIZE - 1) / BLOCK_SIZE) * sizeof(codec_entry_t))
+
+// Expands a compressed block into dst; returns the number of values
+static inline unsigned int codec_decode(T *dst, const uint8_t *src) {
+    const codec_header_t *h = (const codec_header_t *) src;
+    const uint32_t *w = (const uint32_t *) (src + sizeof(codec_header_t));
+    unsigned int n = h->n;
+    unsigned int bits = h->bits;
+    uint32_t mask = bits == 32 ? 0xFFFFFFFF : (1u << bits) - 1;
+    uint64_t acc = 0; // Packed bits not consumed yet
+    unsigned int avail = 0;
+    uint64_t x = h->base;
+
+    if (h->scheme == CODEC_FOR) {
+        for (unsigned int i = 0; i < n; i++) {
+            if (avail < bits) {
+                acc |= (uint64_t)(*w++) << avail;
+                avail += 32;
+            }
+            dst[i] = (T)(x + (acc & mask));
+            acc >>= bits;
+            avail -= bits;
+        }
+    } else if (h->scheme == CODEC_DELTA) {
+        uint64_t step = h->step;
+        dst[0] = (T)x;
+        for (unsigned int i = 1; i < n; i++) {
+            if (avail < bits) {
+                acc |= (uint64_t)(*w++) << avail;
+                avail += 32;
+            }
+            x += step + (acc & mask);
+            dst[i] = (T)x;
+            acc >>= bits;
+            avail -= bits;
+        }
+    } else { // CODEC_RLE
+        const T *values = (const T *) (src + sizeof(codec_header_t));
+        const uint16_t *lengths = (const uint16_t *) (values + h->runs);
+        unsigned int i = 0;
+        for (unsigned int r = 0; r < h->runs; r++) {
+            T v = values[r];
+            for (unsigned int l = 0; l < lengths[r]; l++)
+                dst[i++] = v;
+        }
+    }
+    return n;
+}
+
+// Smallest width that holds range
+static inline unsigned int codec_bits(uint64_t range) {
+    unsigned int bits = 0;
+    while (bits < 64 && (range >> bits) != 0)
+        bits++;
+    return bits;
+}
+
+// Bytes of a compressed block with payload bytes after the header
+static inline uint32_t codec_block_bytes(uint32_t payload) {
+    return sizeof(codec_header_t) + codec_align8(payload);
+}
+
+// Packs v[0..n) of bits bits after the header of dst and pads the block with zeros
+static inline void codec_pack(uint8_t *dst, const uint64_t *v, unsigned int n, unsigned int bits) {
+    uint32_t *w = (uint32_t *) (dst + sizeof(codec_header_t));
+    uint32_t words = (n * bits + 31) / 32;
+    uint64_t acc = 0;
+    unsigned int used = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        acc |= v[i] << used;
+        used += bits;
+        if (used >= 32) {
+            *w++ = (uint32_t)acc;
+            acc >>= 32;
+            used -= 32;
+        }
+    }
+    if (used > 0)
+        *w++ = (uint32_t)acc;
+    for (uint32_t b = words * 4; b < codec_align8(words * 4); b++)
+        ((uint8_t *) w)[b - words * 4] = 0;
+}
+
+// Encodes the n values of src (at most BLOCK_SIZE bytes) into dst with the requested scheme, or
+// the smallest one for CODEC_AUTO, and raw if that is not smaller; returns the stored bytes
+static inline uint32_t codec_encode_block(uint8_t *dst, const T *src, unsigned int n, unsigned int scheme, uint16_t *stored) {
+    uint64_t v[BLOCK_SIZE / sizeof(T)];
+    uint32_t raw_bytes = codec_align8(n * sizeof(T));
+
+    // Frame of reference
+    T lo = src[0], hi = src[0];
+    for (unsigned int i = 1; i < n; i++) {
+        if (src[i] < lo) lo = src[i];
+        if (src[i] > hi) hi = src[i];
+    }
+    unsigned int for_bits = codec_bits(codec_wrap((uint64_t)hi - (uint64_t)lo));
+    uint32_t for_bytes = for_bits <= 32 ? codec_block_bytes((n * for_bits + 31) / 32 * 4) : UINT32_MAX;
+
+    // Differences between neighbors, as signed values
+    int64_t d_lo = INT64_MAX, d_hi = INT64_MIN;
+    for (unsigned int i = 1; i < n; i++) {
+        int64_t d = codec_signed((uint64_t)src[i] - (uint64_t)src[i - 1]);
+        if (d < d_lo) d_lo = d;
+        if (d > d_hi) d_hi = d;
+    }
+    if (n == 1)
+        d_lo = d_hi = 0;
+    unsigned int delta_bits = codec_bits((uint64_t)d_hi - (uint64_t)d_lo);
+    uint32_t delta_bytes = delta_bits <= 32 ? codec_block_bytes(((n - 1) * delta_bits + 31) / 32 * 4) : UINT32_MAX;
+
+    // Runs
+    unsigned int runs = 1;
+    for (unsigned int i = 1; i < n; i++)
+        runs += src[i] != src[i - 1];
+    uint32_t rle_bytes = codec_block_bytes(runs * (sizeof(T) + sizeof(uint16_t)));
+
+    uint32_t bytes[nr_codec_schemes] = {raw_bytes, for_bytes, delta_bytes, rle_bytes};
+    if (scheme == CODEC_AUTO) {
+        for (unsigned int s = CODEC_FOR; s < nr_codec_schemes; s++)
+            if (bytes[s] < bytes[scheme])
+                scheme = s;
+    } else if (bytes[scheme] >= raw_bytes) {
+        scheme = CODEC_RAW;
+    }
+    *stored = scheme;
+
+    if (scheme == CODEC_RAW) {
+        for (uint32_t b = 0; b < raw_bytes; b++)
+            dst[b] = b < n * sizeof(T) ? ((const uint8_t *) src)[b] : 0;
+        return raw_bytes;
+    }
+
+    codec_header_t *h = (codec_header_t *) dst;
+    h->n = n;
+    h->runs = 0;
+    h->scheme = scheme;
+    h->bits = 0;
+    h->pad[0] = h->pad[1] = 0;
+    h->base = codec_wrap(src[0]);
+    h->step = 0;
+    if (scheme == CODEC_FOR) {
+        h->base = codec_wrap(lo);
+        h->bits = for_bits;
+        for (unsigned int i = 0; i < n; i++)
+            v[i] = codec_wrap((uint64_t)src[i] - (uint64_t)lo);
+        codec_pack(dst, v, n, for_bits);
+    } else if (scheme == CODEC_DELTA) {
+        h->step = (uint64_t)d_lo;
+        h->bits = delta_bits;
+        for (unsigned int i = 1; i < n; i++)
+            v[i - 1] = (uint64_t)codec_signed((uint64_t)src[i] - (uint64_t)src[i - 1]) - (uint64_t)d_lo;
+        codec_pack(dst, v, n - 1, delta_bits);
+    } else { // CODEC_RLE
+        T *values = (T *) (dst + sizeof(codec_header_t));
+        uint16_t *lengths = (uint16_t *) (values + runs);
+        unsigned int r = 0;
+        values[0] = src[0];
+        lengths[0] = 1;
+        for (unsigned int i = 1; i < n; i++) {
+            if (src[i] == src[i - 1]) {
+                lengths[r]++;
+            } else {
+                values[++r] = src[i];
+                lengths[r] = 1;
+            }
+        }
+        h->runs = runs;
+        for (uint32_t b = sizeof(codec_header_t) + runs * (sizeof(T) + sizeof(uint16_t)); b < rle_bytes; b++)
+            dst[b] = 0;
+    }
+    return bytes[scheme];
+}
+
+// Encodes the n values of src as a directory and blocks of BLOCK_SIZE raw bytes; returns the bytes
+// written to dst, at most codec_bound(n * sizeof(T)), and adds the blocks per scheme to blocks
+static inline uint32_t codec_encode(uint8_t *dst, const T *src, uint32_t n, unsigned int scheme, uint32_t *blocks) {
+    const uint32_t block_values = BLOCK_SIZE / sizeof(T);
+    const uint32_t n_blocks = (n + block_values - 1) / block_values;
+    codec_entry_t *directory = (codec_entry_t *) dst;
+    uint32_t offset = n_blocks * sizeof(codec_entry_t);
+    for (uint32_t b = 0; b < n_blocks; b++) {
+        uint32_t first = b * block_values;
+        unsigned int l_size = n - first < block_values ? n - first : block_values;
+        directory[b].offset = offset;
+        directory[b].bytes = codec_encode_block(dst + offset, src + first, l_size, scheme, &directory[b].scheme);
+        offset += directory[b].bytes;
+        blocks[directory[b].scheme]++;
+    }
+    return offset;
+}
+
+// Value i of an input distribution other than DIST_DEFAULT
+static inline T codec_input(unsigned int dist, uint32_t i) {
+    uint32_t x = i;
+    if (dist == DIST_RUNS)
+        x = i >> 6; // Runs of 64 values
+    x ^= x >> 16; x *= 0x7FEB352D;
+    x ^= x >> 15; x *= 0x846CA68B;
+    x ^= x >> 16;
+    if (dist == DIST_NARROW)
+        return (T)(x & 4095); // 12 bits
+    else if (dist == DIST_SORTED)
+        return (T)((uint64_t)i * 4 + (x & 3)); // Differences from 1 to 7
+    else
+        return (T)(x & 0xFFFF);
+}
+
+// Decode cycles of the slowest DPU, as a mean over its tasklets, and share of the kernel cycles
+// spent decoding over all DPUs
+static inline void codec_summary(const codec_stats_t *stats, unsigned int nr_dpus, double *decode_cycles, double *decode_share) {
+    uint64_t decode = 0, total = 0, slowest = 0;
+    for (unsigned int d = 0; d < nr_dpus; d++) {
+        uint64_t dpu_decode = 0;
+        for (unsigned int t = 0; t < NR_TASKLETS; t++) {
+            dpu_decode += stats[d * NR_TASKLETS + t].decode_cycles;
+            total += stats[d * NR_TASKLETS + t].cycles;
+        }
+        decode += dpu_decode;
+        if (dpu_decode > slowest)
+            slowest = dpu_decode;
+    }
+    *decode_cycles = (double)slowest / NR_TASKLETS;
+    *decode_share = total ? (double)decode / total : 0;
+}
+#endif
@@ -40,6 +40,14 @@
 
 #define REGS (BLOCK_SIZE >> DIV)
 
+// Input transfer format: 0 sends the raw column, 1 compresses it (see codec.h)
+#ifndef COMPRESS
+#define COMPRESS 0
+#endif
+#if COMPRESS && (defined(FLOAT) || defined(DOUBLE) || defined(CHAR) || defined(SHORT))
+#error "COMPRESS needs a 32- or 64-bit integer TYPE"
+#endif
+
 // Structures used by both the host and the dpu to communicate information
 typedef struct {
     uint32_t size;
@@ -12,9 +12,13 @@
 #include <barrier.h>
 
 #include "../support/common.h"
+#include "../support/codec.h"
 
 __host dpu_arguments_t DPU_INPUT_ARGUMENTS;
 __host dpu_results_t DPU_RESULTS[NR_TASKLETS];
+#if COMPRESS
+__host codec_stats_t DPU_CODEC_STATS[NR_TASKLETS];
+#endif
 
 // Array for communication between adjacent tasklets
 uint32_t message[NR_TASKLETS];
@@ -33,6 +37,33 @@ static unsigned int select(T *output, T *input){
     return pos;
 }
 
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+#ifdef KOGGE
+// Double buffer for the scan across tasklets
+uint32_t scan_buffer[2][NR_TASKLETS];
+
+// Log-depth (Kogge-Stone) exclusive scan across tasklets
+// The DPU count is read between the first and the last barrier: the last tasklet updates it
+// after the scan, and before the next scan
+static unsigned int kogge_stone_sync(unsigned int l_count, unsigned int tasklet_id, uint32_t *partial_count){
+    unsigned int in = 0;
+    scan_buffer[in][tasklet_id] = l_count;
+    barrier_wait(&my_barrier);
+    *partial_count = message_partial_count;
+    #pragma unroll
+    for(unsigned int offset = 1; offset < NR_TASKLETS; offset <<= 1){
+        uint32_t value = scan_buffer[in][tasklet_id];
+        if(tasklet_id >= offset)
+            value += scan_buffer[in][tasklet_id - offset];
+        scan_buffer[1 - in][tasklet_id] = value;
+        in = 1 - in;
+        barrier_wait(&my_barrier);
+    }
+    return scan_buffer[in][tasklet_id] - l_count;
+}
+#else
 // Handshake with adjacent tasklets
 static unsigned int handshake_sync(unsigned int l_count, unsigned int tasklet_id){
     unsigned int p_count;
@@ -50,9 +81,7 @@ static unsigned int handshake_sync(unsigned int l_count, unsigned int tasklet_id
     }
     return p_count;
 }
-
-// Barrier
-BARRIER_INIT(my_barrier, NR_TASKLETS);
+#endif
 
 extern int main_kernel1(void);
 
@@ -71,6 +100,9 @@ int main_kernel1() {
 #endif
     if (tasklet_id == 0){ // Initialize once the cycle counter
         mem_reset(); // Reset the heap
+#if COMPRESS
+        perfcounter_config(COUNT_CYCLES, true);
+#endif
     }
     // Barrier
     barrier_wait(&my_barrier);
@@ -82,11 +114,21 @@ int main_kernel1() {
     // Address of the current processing block in MRAM
     uint32_t base_tasklet = tasklet_id << BLOCK_SIZE_LOG2;
     uint32_t mram_base_addr_A = (uint32_t)DPU_MRAM_HEAP_POINTER;
+#if COMPRESS
+    uint32_t mram_base_addr_B = (uint32_t)(DPU_MRAM_HEAP_POINTER + codec_bound(input_size_dpu_bytes));
+#else
     uint32_t mram_base_addr_B = (uint32_t)(DPU_MRAM_HEAP_POINTER + input_size_dpu_bytes);
+#endif
 
     // Initialize a local cache to store the MRAM block
     T *cache_A = (T *) mem_alloc(BLOCK_SIZE);
     T *cache_B = (T *) mem_alloc(BLOCK_SIZE);
+#if COMPRESS
+    // Compressed blocks go through cache_B, which is free until the selection
+    uint8_t *cache_C = (uint8_t *) cache_B;
+    codec_entry_t *entry = (codec_entry_t *) mem_alloc(sizeof(codec_entry_t));
+    uint64_t decode_cycles = 0;
+#endif
 
     // Initialize shared variable
     if(tasklet_id == NR_TASKLETS - 1)
@@ -97,27 +139,51 @@ int main_kernel1() {
     for(unsigned int byte_index = base_tasklet; byte_index < input_size_dpu_bytes; byte_index += BLOCK_SIZE * NR_TASKLETS){
 
         // Load cache with current MRAM block
+#if COMPRESS
+        // Compressed column: look the block up in the directory, read it and expand it in WRAM
+        mram_read((__mram_ptr void const*)(mram_base_addr_A + (byte_index >> BLOCK_SIZE_LOG2) * sizeof(codec_entry_t)), entry, sizeof(codec_entry_t));
+        if (entry->scheme == CODEC_RAW)
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + entry->offset), cache_A, entry->bytes);
+        else {
+            mram_read((__mram_ptr void const*)(mram_base_addr_A + entry->offset), cache_C, entry->bytes);
+            perfcounter_t decode_start = perfcounter_get();
+            codec_decode(cache_A, cache_C);
+            decode_cycles += perfcounter_get() - decode_start;
+        }
+#else
         mram_read((__mram_ptr void const*)(mram_base_addr_A + byte_index), cache_A, BLOCK_SIZE);
+#endif
 
         // SELECT in each tasklet
         uint32_t l_count = select(cache_B, cache_A); // In-place or out-of-place?
 
+#ifdef KOGGE
+        // Scan across tasklets (ends with a barrier)
+        uint32_t partial_count;
+        uint32_t p_count = kogge_stone_sync(l_count, tasklet_id, &partial_count);
+#else
         // Sync with adjacent tasklets
         uint32_t p_count = handshake_sync(l_count, tasklet_id);
 
         // Barrier
         barrier_wait(&my_barrier);
+        uint32_t partial_count = message_partial_count;
+#endif
 
         // Write cache to current MRAM block
-        mram_write(cache_B, (__mram_ptr void*)(mram_base_addr_B + (message_partial_count + p_count) * sizeof(T)), l_count * sizeof(T));
+        mram_write(cache_B, (__mram_ptr void*)(mram_base_addr_B + (partial_count + p_count) * sizeof(T)), l_count * sizeof(T));
 
         // Total count in this DPU
         if(tasklet_id == NR_TASKLETS - 1){
-            result->t_count = message_partial_count + p_count + l_count;
+            result->t_count = partial_count + p_count + l_count;
             message_partial_count = result->t_count;
         }
 
     }
+#if COMPRESS
+    DPU_CODEC_STATS[tasklet_id].decode_cycles = decode_cycles;
+    DPU_CODEC_STATS[tasklet_id].cycles = perfcounter_get();
+#endif
 
     return 0;
 }
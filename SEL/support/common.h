@@ -28,6 +28,11 @@ typedef struct {
 #define T uint64_t
 #define REGS (BLOCK_SIZE >> 3) // 64 bits
 
+// Input transfer format: 0 sends the raw column, 1 compresses it (see codec.h)
+#ifndef COMPRESS
+#define COMPRESS 0
+#endif
+
 // Sample predicate
 bool pred(const T x){
   return (x % 2) == 0;
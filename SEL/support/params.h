@@ -2,12 +2,15 @@
 #define _PARAMS_H_
 
 #include "common.h"
+#include "codec.h"
 
 typedef struct Params {
     unsigned int   input_size;
     int   n_warmup;
     int   n_reps;
     int  exp;
+    unsigned int  dist;
+    unsigned int  codec;
 }Params;
 
 static void usage() {
@@ -22,6 +25,8 @@ static void usage() {
         "\n"
         "\nBenchmark-specific options:"
         "\n    -i <I>    input size (default=3932160 elements)"
+        "\n    -d <D>    input distribution: 0 = 1, 2, 3..., 1 = 12-bit values, 2 = sorted, 3 = runs of 64 (default=0)"
+        "\n    -c <C>    compression scheme of COMPRESS=1 builds: 0 = smallest per block, 1 = FOR, 2 = DELTA, 3 = RLE (default=0)"
         "\n");
 }
 
@@ -31,9 +36,11 @@ struct Params input_params(int argc, char **argv) {
     p.n_warmup      = 0;
     p.n_reps        = 1;
     p.exp           = 0;
+    p.dist          = DIST_DEFAULT;
+    p.codec         = CODEC_AUTO;
 
     int opt;
-    while((opt = getopt(argc, argv, "hi:w:e:x:")) >= 0) {
+    while((opt = getopt(argc, argv, "hi:w:e:x:d:c:")) >= 0) {
         switch(opt) {
         case 'h':
         usage();
@@ -43,6 +50,8 @@ struct Params input_params(int argc, char **argv) {
         case 'w': p.n_warmup      = atoi(optarg); break;
         case 'e': p.n_reps        = atoi(optarg); break;
         case 'x': p.exp           = atoi(optarg); break;
+        case 'd': p.dist          = atoi(optarg); break;
+        case 'c': p.codec         = atoi(optarg); break;
         default:
             fprintf(stderr, "\nUnrecognized option!\n");
             usage();
@@ -50,6 +59,7 @@ struct Params input_params(int argc, char **argv) {
         }
     }
     assert(NR_DPUS > 0 && "Invalid # of dpus!");
+    assert(p.dist < nr_codec_dists && p.codec < nr_codec_schemes && "Invalid distribution or compression scheme!");
 
     return p;
 }
@@ -0,0 +1,81 @@
+/**
+* @file sls.c
+* @brief Embedding bags on the CPU: the table and bags of the DPU version, OpenMP over bags
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include <omp.h>
+#include "../../support/timer.h"
+#include "../../support/rapl.h"
+#include "../../support/params.h"
+#include "../../support/bags.h"
+
+/**
+* @brief sums the rows of every bag, one bag per iteration
+*/
+static void sls(ACC *out, const T *table, uint32_t dim, const uint32_t *indices, uint64_t n_bags, uint32_t lookups, int t) {
+    omp_set_num_threads(t);
+    #pragma omp parallel for schedule(static)
+    for (uint64_t b = 0; b < n_bags; b++)
+        sls_bag(out + b * dim, table, dim, indices + b * lookups, lookups);
+}
+
+/**
+* @brief Main of the CPU baseline.
+*/
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    const uint64_t n_lookups = (uint64_t) p.n_bags * p.lookups;
+    T *table = (T *) malloc((uint64_t) p.n_rows * p.dim * sizeof(T));
+    uint32_t *indices = (uint32_t *) malloc(n_lookups * sizeof(uint32_t));
+    ACC *sums = (ACC *) malloc((uint64_t) p.n_bags * p.dim * sizeof(ACC));
+    zipf_t zipf;
+    generate_table(table, p.n_rows, p.dim);
+    zipf_init(&zipf, p.n_rows, p.zipf);
+    generate_bags(indices, p.n_bags, p.lookups, &zipf, 7);
+    zipf_free(&zipf);
+    printf("Rows %u x %u %s (%lu MB), bags %u x %u lookups, Zipf %.2f\n", p.n_rows, p.dim, sizeof(T) == 1 ? "int8" : "fp32",
+            (unsigned long) (((uint64_t) p.n_rows * p.dim * sizeof(T)) >> 20), p.n_bags, p.lookups, p.zipf);
+
+    Timer timer;
+    Energy energy;
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+        if (rep >= p.n_warmup) {
+            energy_start(&energy, 0, rep - p.n_warmup);
+            start(&timer, 0, rep - p.n_warmup);
+        }
+        sls(sums, table, p.dim, indices, p.n_bags, p.lookups, p.n_threads);
+        if (rep >= p.n_warmup) {
+            stop(&timer, 0);
+            energy_stop(&energy, 0);
+        }
+    }
+
+    double checksum = 0.0;
+    for (uint64_t e = 0; e < (uint64_t) p.n_bags * p.dim; e++)
+        checksum += (double) sums[e];
+
+    printf("Kernel ");
+    print(&timer, 0, p.n_reps);
+    printf("\n");
+    printf("Mlookups/s: %f\tChecksum: %f\n", n_lookups / (timer.time[0] / p.n_reps), checksum);
+    printf("Energy ");
+    energy_print(&energy, 0, p.n_reps, n_lookups);
+    printf("\n");
+
+    free(table);
+    free(indices);
+    free(sums);
+
+    return 0;
+}
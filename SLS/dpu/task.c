@@ -0,0 +1,81 @@
+/*
+* Embedding-bag partial sums with multiple tasklets
+* Every tasklet takes segments (the lookups of one bag on this DPU), gathers their
+* rows one mram_read each, sums them in WRAM and writes one partial sum per segment
+*
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <barrier.h>
+
+#include "../support/common.h"
+
+__host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+// main
+int main() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){
+        mem_reset(); // Reset the heap
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    uint32_t n_segments = DPU_INPUT_ARGUMENTS.n_segments;
+    uint32_t dim = DPU_INPUT_ARGUMENTS.dim;
+    uint32_t row_bytes = dim * sizeof(T);
+    uint32_t sum_bytes = dim * sizeof(ACC);
+
+    // Addresses of the rows, indices, segments and partial sums in MRAM
+    uint32_t mram_base_addr_E = (uint32_t)DPU_MRAM_HEAP_POINTER;
+    uint32_t mram_base_addr_I = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.index_offset);
+    uint32_t mram_base_addr_S = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.segment_offset);
+    uint32_t mram_base_addr_O = (uint32_t)(DPU_MRAM_HEAP_POINTER + DPU_INPUT_ARGUMENTS.output_offset);
+
+    // Initialize a local cache to store the indices, a row and the partial sum
+    uint32_t *cache_I = (uint32_t *) mem_alloc(BLOCK_SIZE);
+    segment_t *cache_S = (segment_t *) mem_alloc(2 * sizeof(segment_t));
+    T *cache_E = (T *) mem_alloc(MAX_DIM * sizeof(T));
+    ACC *cache_O = (ACC *) mem_alloc(MAX_DIM * sizeof(ACC));
+
+    // Segments are interleaved: their lengths vary with the popularity of the rows
+    for(unsigned int s = tasklet_id; s < n_segments; s += NR_TASKLETS){
+
+        // This segment and the next one, which gives the end of the lookups
+        mram_read((__mram_ptr void const*)(mram_base_addr_S + s * sizeof(segment_t)), cache_S, 2 * sizeof(segment_t));
+        uint32_t first = cache_S[0].first;
+        uint32_t last = cache_S[1].first;
+
+        for (unsigned int d = 0; d < dim; d++)
+            cache_O[d] = 0;
+
+        // Index blocks start at an even lookup, for 8-byte aligned reads
+        for (uint32_t k = first; k < last; ) {
+            uint32_t start = k & ~1u;
+            uint32_t n = last - start < BLOCK_SIZE / sizeof(uint32_t) ? last - start : BLOCK_SIZE / sizeof(uint32_t);
+            mram_read((__mram_ptr void const*)(mram_base_addr_I + start * sizeof(uint32_t)), cache_I, (n * sizeof(uint32_t) + 7) & ~7u);
+
+            for (unsigned int j = k - start; j < n; j++) {
+                mram_read((__mram_ptr void const*)(mram_base_addr_E + cache_I[j] * row_bytes), cache_E, row_bytes);
+                for (unsigned int d = 0; d < dim; d++)
+                    cache_O[d] += (ACC) cache_E[d];
+            }
+            k = start + n;
+        }
+
+        // Write the partial sum of the segment
+        mram_write(cache_O, (__mram_ptr void*)(mram_base_addr_O + s * sum_bytes), sum_bytes);
+
+    }
+
+    return 0;
+}
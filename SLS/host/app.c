@@ -0,0 +1,400 @@
+/**
+* app.c
+* SLS Host Application Source File
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <omp.h>
+
+#include "../support/common.h"
+#include "../support/timer.h"
+#include "../support/params.h"
+#include "../support/bags.h"
+#include "../support/prim_results.h"
+
+#if ENERGY
+#include <dpu_probe.h>
+#endif
+
+// Define the DPU Binary path as DPU_BINARY here
+#ifndef DPU_BINARY
+#define DPU_BINARY "./bin/sls_dpu"
+#endif
+
+// Lookups of a batch, grouped by owner DPU: DPU i has count[i] lookups, and n_segments[i]
+// segments followed by a sentinel, from i * cap
+typedef struct {
+    uint32_t *indices;     // Row of every routed lookup, local to its DPU
+    uint32_t *bags;        // Bag of every routed lookup
+    segment_t *segments;
+    ACC *sums;             // Partial sums of the DPUs, max_segments per DPU
+    uint32_t *owner;       // Owner DPU of every lookup of the batch
+    uint32_t *hist;        // Per-thread histograms, then scatter positions
+    uint32_t *count;
+    uint32_t *n_segments;
+    uint32_t cap;          // Even, so index lists stay 8-byte aligned
+    uint32_t max_segments;
+    uint64_t capacity;     // Slots allocated in indices and bags
+    uint64_t sum_capacity; // ACC allocated in sums
+} router_t;
+
+// Bag sums on the host CPU
+static void sls_host(ACC *out, const T *table, uint32_t dim, const uint32_t *indices, uint64_t n_bags, uint32_t lookups) {
+    for (uint64_t b = 0; b < n_bags; b++)
+        sls_bag(out + b * dim, table, dim, indices + b * lookups, lookups);
+}
+
+// Routes the lookups of n_bags bags to the DPUs owning their rows in one parallel partition
+// pass (per-thread histograms, prefix sum DPU major and thread minor, scatter), then cuts the
+// lookups of every DPU into segments. Threads take whole bags and scatter them in order, so
+// the lookups of a bag are contiguous on a DPU and segments come sorted by bag.
+static void route_lookups(router_t *r, const uint32_t *indices, uint32_t n_bags, uint32_t lookups, uint32_t rows_per_dpu,
+        uint32_t nr_of_dpus, unsigned int n_threads) {
+    #pragma omp parallel num_threads(n_threads)
+    {
+        unsigned int t = omp_get_thread_num();
+        unsigned int n_team = omp_get_num_threads(); // Can be fewer than n_threads
+        uint32_t *hist = r->hist + (uint64_t) t * nr_of_dpus;
+        uint64_t first = (uint64_t) n_bags * t / n_team * lookups, last = (uint64_t) n_bags * (t + 1) / n_team * lookups;
+        memset(hist, 0, nr_of_dpus * sizeof(uint32_t));
+        for (uint64_t l = first; l < last; l++) {
+            r->owner[l] = indices[l] / rows_per_dpu;
+            hist[r->owner[l]]++;
+        }
+        #pragma omp barrier
+        #pragma omp single
+        {
+            r->cap = 0;
+            for (uint32_t i = 0; i < nr_of_dpus; i++) {
+                uint32_t count = 0;
+                for (unsigned int u = 0; u < n_team; u++)
+                    count += r->hist[(uint64_t) u * nr_of_dpus + i];
+                r->count[i] = count;
+                if (count > r->cap)
+                    r->cap = count;
+            }
+            r->cap = (r->cap + 2) & ~1u; // At least one free slot for the sentinel segment
+            if ((uint64_t) r->cap * nr_of_dpus > r->capacity) {
+                r->capacity = (uint64_t) r->cap * nr_of_dpus;
+                r->indices = (uint32_t *) realloc(r->indices, r->capacity * sizeof(uint32_t));
+                r->bags = (uint32_t *) realloc(r->bags, r->capacity * sizeof(uint32_t));
+                r->segments = (segment_t *) realloc(r->segments, r->capacity * sizeof(segment_t));
+            }
+            for (uint32_t i = 0; i < nr_of_dpus; i++) {
+                uint32_t pos = i * r->cap;
+                for (unsigned int u = 0; u < n_team; u++) {
+                    uint32_t count = r->hist[(uint64_t) u * nr_of_dpus + i];
+                    r->hist[(uint64_t) u * nr_of_dpus + i] = pos;
+                    pos += count;
+                }
+            }
+        }
+        for (uint64_t l = first; l < last; l++) {
+            uint32_t pos = hist[r->owner[l]]++;
+            r->indices[pos] = indices[l] - r->owner[l] * rows_per_dpu;
+            r->bags[pos] = l / lookups;
+        }
+        #pragma omp barrier
+        #pragma omp for schedule(static)
+        for (uint32_t i = 0; i < nr_of_dpus; i++) {
+            const uint32_t *bags = r->bags + (uint64_t) i * r->cap;
+            segment_t *segments = r->segments + (uint64_t) i * r->cap;
+            uint32_t n = 0;
+            for (uint32_t j = 0; j < r->count[i]; j++) {
+                if (j == 0 || bags[j] != bags[j - 1]) {
+                    segments[n].bag = bags[j];
+                    segments[n].first = j;
+                    n++;
+                }
+            }
+            segments[n].bag = n_bags;
+            segments[n].first = r->count[i];
+            r->n_segments[i] = n;
+        }
+    }
+    r->max_segments = 0;
+    for (uint32_t i = 0; i < nr_of_dpus; i++)
+        if (r->n_segments[i] > r->max_segments)
+            r->max_segments = r->n_segments[i];
+}
+
+// Adds up the partial sums of every bag; every thread owns a range of bags and finds
+// its first segment on each DPU by binary search
+static void reduce_sums(const router_t *r, ACC *out, uint32_t n_bags, uint32_t dim, uint32_t nr_of_dpus, unsigned int n_threads) {
+    #pragma omp parallel num_threads(n_threads)
+    {
+        unsigned int t = omp_get_thread_num();
+        unsigned int n_team = omp_get_num_threads();
+        uint32_t first = (uint64_t) n_bags * t / n_team, last = (uint64_t) n_bags * (t + 1) / n_team;
+        memset(out + (uint64_t) first * dim, 0, (uint64_t) (last - first) * dim * sizeof(ACC));
+        for (uint32_t i = 0; i < nr_of_dpus; i++) {
+            const segment_t *segments = r->segments + (uint64_t) i * r->cap;
+            uint32_t lo = 0, hi = r->n_segments[i];
+            while (lo < hi) {
+                uint32_t mid = (lo + hi) / 2;
+                if (segments[mid].bag < first)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            for (uint32_t s = lo; s < r->n_segments[i] && segments[s].bag < last; s++) {
+                const ACC *sum = r->sums + ((uint64_t) i * r->max_segments + s) * dim;
+                ACC *bag = out + (uint64_t) segments[s].bag * dim;
+                for (uint32_t d = 0; d < dim; d++)
+                    bag[d] += sum[d];
+            }
+        }
+    }
+}
+
+// Main of the Host Application
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+    struct dpu_set_t dpu_set, dpu;
+    uint32_t nr_of_dpus;
+
+#if ENERGY
+    struct dpu_probe_t probe;
+    DPU_ASSERT(dpu_probe_init("energy_probe", &probe));
+#endif
+
+    // Allocate DPUs and load binary
+    DPU_ASSERT(dpu_alloc(NR_DPUS, NULL, &dpu_set));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
+    printf("Allocated %d DPU(s)\n", nr_of_dpus);
+    printf("NR_TASKLETS\t%d\tBL\t%d\n", NR_TASKLETS, BL);
+
+    // Every DPU owns rows_per_dpu consecutive rows; the table is padded to whole DPUs
+    const uint32_t dim = p.dim;
+    const uint32_t rows_per_dpu = divceil(p.n_rows, nr_of_dpus);
+    const uint32_t row_bytes = dim * sizeof(T);
+    const uint32_t sum_bytes = dim * sizeof(ACC);
+    const uint64_t n_lookups = (uint64_t) p.n_bags * p.lookups;
+    T *table = (T *) calloc((uint64_t) rows_per_dpu * nr_of_dpus * dim, sizeof(T));
+    uint32_t *indices = (uint32_t *) malloc(n_lookups * sizeof(uint32_t));
+    ACC *sums_host = (ACC *) malloc((uint64_t) p.n_bags * sum_bytes);
+    ACC *sums = (ACC *) malloc((uint64_t) p.n_bags * sum_bytes);
+    zipf_t zipf;
+    generate_table(table, p.n_rows, dim);
+    zipf_init(&zipf, p.n_rows, p.zipf);
+    generate_bags(indices, p.n_bags, p.lookups, &zipf, 7);
+    zipf_free(&zipf);
+    printf("Rows %u x %u %s (%lu MB), bags %u x %u lookups, Zipf %.2f, %u bags per batch\n", p.n_rows, dim,
+            sizeof(T) == 1 ? "int8" : "fp32", (unsigned long) (((uint64_t) p.n_rows * row_bytes) >> 20),
+            p.n_bags, p.lookups, p.zipf, p.batch);
+
+    // Load balance of the row partitioning under the popularity skew
+    uint32_t *dpu_lookups = (uint32_t *) calloc(nr_of_dpus, sizeof(uint32_t));
+    uint32_t max_lookups = 0;
+    for (uint64_t l = 0; l < n_lookups; l++)
+        dpu_lookups[indices[l] / rows_per_dpu]++;
+    for (uint32_t i = 0; i < nr_of_dpus; i++)
+        if (dpu_lookups[i] > max_lookups)
+            max_lookups = dpu_lookups[i];
+    printf("Rows per DPU %u (%u KB), lookups per DPU max %u, imbalance %.2f\n", rows_per_dpu,
+            (unsigned int) (((uint64_t) rows_per_dpu * row_bytes) >> 10), max_lookups,
+            (double) max_lookups * nr_of_dpus / n_lookups);
+
+    // Timer
+    Timer timer;
+
+    // Load the rows once
+    start(&timer, 4, 0);
+    const uint32_t table_bytes = rows_per_dpu * row_bytes;
+    assert((uint64_t) rows_per_dpu * row_bytes <= DPU_CAPACITY && "Table does not fit in MRAM, use more DPUs!");
+    unsigned int i = 0;
+    DPU_FOREACH(dpu_set, dpu, i) {
+        DPU_ASSERT(dpu_prepare_xfer(dpu, table + (uint64_t) rows_per_dpu * dim * i));
+    }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, table_bytes, DPU_XFER_DEFAULT));
+    stop(&timer, 4);
+
+    router_t router;
+    memset(&router, 0, sizeof(router));
+    router.owner = (uint32_t *) malloc((uint64_t) p.batch * p.lookups * sizeof(uint32_t));
+    router.hist = (uint32_t *) malloc((uint64_t) p.n_threads * nr_of_dpus * sizeof(uint32_t));
+    router.count = (uint32_t *) malloc(nr_of_dpus * sizeof(uint32_t));
+    router.n_segments = (uint32_t *) malloc(nr_of_dpus * sizeof(uint32_t));
+    dpu_arguments_t *input_args = (dpu_arguments_t *) malloc(nr_of_dpus * sizeof(dpu_arguments_t));
+    uint64_t segments = 0;
+#if ENERGY
+    double tavg_energy=0;
+#endif
+
+    for (unsigned int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+
+        if (rep >= p.n_warmup)
+            start(&timer, 0, rep - p.n_warmup);
+        // Computation on host CPU
+        sls_host(sums_host, table, dim, indices, p.n_bags, p.lookups);
+        if (rep >= p.n_warmup)
+            stop(&timer, 0);
+
+        for (unsigned int first = 0, b = 0; first < p.n_bags; first += p.batch, b++) {
+            unsigned int n = first + p.batch < p.n_bags ? p.batch : p.n_bags - first;
+
+            if (rep >= p.n_warmup)
+                start(&timer, 1, rep - p.n_warmup + b);
+            route_lookups(&router, indices + (uint64_t) first * p.lookups, n, p.lookups, rows_per_dpu, nr_of_dpus, p.n_threads);
+            uint32_t index_offset = table_bytes;
+            uint32_t segment_offset = index_offset + router.cap * sizeof(uint32_t);
+            uint32_t output_offset = segment_offset + (router.max_segments + 1) * sizeof(segment_t);
+            assert((uint64_t) output_offset + (uint64_t) router.max_segments * sum_bytes <= DPU_CAPACITY && "Batch does not fit in MRAM, use a smaller -b");
+            for (i = 0; i < nr_of_dpus; i++) {
+                input_args[i].n_segments = router.n_segments[i];
+                input_args[i].n_lookups = router.count[i];
+                input_args[i].dim = dim;
+                input_args[i].index_offset = index_offset;
+                input_args[i].segment_offset = segment_offset;
+                input_args[i].output_offset = output_offset;
+            }
+
+            // Copy input arguments, row indices and segments to DPUs
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, input_args + i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(dpu_arguments_t), DPU_XFER_DEFAULT));
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, router.indices + (uint64_t) router.cap * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, index_offset, router.cap * sizeof(uint32_t), DPU_XFER_DEFAULT));
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, router.segments + (uint64_t) router.cap * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, segment_offset, (router.max_segments + 1) * sizeof(segment_t), DPU_XFER_DEFAULT));
+            if (rep >= p.n_warmup)
+                stop(&timer, 1);
+
+#if ENERGY
+            if (rep >= p.n_warmup) {
+                DPU_ASSERT(dpu_probe_start(&probe));
+            }
+#endif
+            if (rep >= p.n_warmup)
+                start(&timer, 2, rep - p.n_warmup + b); // Do not re-initialize the counter
+            // Launch kernel on DPUs
+            DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            if (rep >= p.n_warmup)
+                stop(&timer, 2);
+#if ENERGY
+            if (rep >= p.n_warmup) {
+                DPU_ASSERT(dpu_probe_stop(&probe));
+                double avg_energy;
+                DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &avg_energy));
+                tavg_energy += avg_energy;
+            }
+#endif
+
+#if PRINT
+            // Display DPU Logs
+            DPU_FOREACH(dpu_set, dpu) {
+                DPU_ASSERT(dpulog_read_for_dpu(dpu.dpu, stdout));
+            }
+#endif
+
+            if (rep >= p.n_warmup)
+                start(&timer, 3, rep - p.n_warmup + b);
+            // Retrieve the partial sums and add them up per bag
+            if ((uint64_t) router.max_segments * nr_of_dpus * dim > router.sum_capacity) {
+                router.sum_capacity = (uint64_t) router.max_segments * nr_of_dpus * dim;
+                router.sums = (ACC *) realloc(router.sums, router.sum_capacity * sizeof(ACC));
+            }
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, router.sums + (uint64_t) router.max_segments * dim * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, output_offset, router.max_segments * sum_bytes, DPU_XFER_DEFAULT));
+            reduce_sums(&router, sums + (uint64_t) first * dim, n, dim, nr_of_dpus, p.n_threads);
+            if (rep >= p.n_warmup)
+                stop(&timer, 3);
+
+            // Partial sums per lookup, from the last repetition
+            if (rep == p.n_warmup + p.n_reps - 1) {
+                for (i = 0; i < nr_of_dpus; i++)
+                    segments += router.n_segments[i];
+            }
+        }
+
+    }
+
+    // Print timing results
+    printf("CPU version ");
+    print(&timer, 0, p.n_reps);
+    printf("CPU-DPU ");
+    print(&timer, 1, p.n_reps);
+    printf("DPU Kernel ");
+    print(&timer, 2, p.n_reps);
+    printf("DPU-CPU ");
+    print(&timer, 3, p.n_reps);
+    printf("Table load ");
+    print(&timer, 4, 1);
+    printf("\n");
+
+    // Million lookups per second; end-to-end covers routing, transfers, kernel and bag sums
+    double ms_e2e = prim_timer_ms_avg(&timer, 1, p.n_reps) + prim_timer_ms_avg(&timer, 2, p.n_reps) + prim_timer_ms_avg(&timer, 3, p.n_reps);
+    double mlookups_cpu = n_lookups / (prim_timer_ms_avg(&timer, 0, p.n_reps) * 1e3);
+    double mlookups_dpu = n_lookups / (prim_timer_ms_avg(&timer, 2, p.n_reps) * 1e3);
+    double mlookups_e2e = n_lookups / (ms_e2e * 1e3);
+    printf("Mlookups/s CPU: %f\tDPU Kernel: %f\tEnd-to-end: %f\n", mlookups_cpu, mlookups_dpu, mlookups_e2e);
+    printf("Partial sums per bag: %f\n", (double) segments / p.n_bags);
+
+    // update CSV
+#define TEST_NAME "SLS"
+#define RESULTS_FILE "../prim_results.csv"
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 0, p.n_reps, "CPU");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)n_lookups, (double)nr_of_dpus);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mlookups_CPU", mlookups_cpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mlookups_DPU", mlookups_dpu);
+    update_csv(RESULTS_FILE, TEST_NAME, "Mlookups_E2E", mlookups_e2e);
+
+#if ENERGY
+    printf("DPU Energy (J): %f \t ", tavg_energy / p.n_reps);
+#endif
+
+    // Check output: the sums are exact (bags.h), so they must match bit for bit
+    bool status = true;
+    for (uint64_t e = 0; e < (uint64_t) p.n_bags * dim; e++) {
+        if (sums_host[e] != sums[e]) {
+            status = false;
+#if PRINT
+            printf("Bag %lu [%lu]: %f -- %f\n", e / dim, e % dim, (double) sums_host[e], (double) sums[e]);
+#endif
+        }
+    }
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    free(table);
+    free(indices);
+    free(sums_host);
+    free(sums);
+    free(dpu_lookups);
+    free(router.indices);
+    free(router.bags);
+    free(router.segments);
+    free(router.sums);
+    free(router.owner);
+    free(router.hist);
+    free(router.count);
+    free(router.n_segments);
+    free(input_args);
+    DPU_ASSERT(dpu_free(dpu_set));
+
+    return status ? 0 : -1;
+}
@@ -0,0 +1,99 @@
+#ifndef _BAGS_H_
+#define _BAGS_H_
+
+// Host-side embedding table, bag generator and reference bag sums, shared by the host
+// application and the CPU baseline.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "common.h"
+
+// xorshift64*: the same table and bags for every run, host and baseline alike
+static inline uint64_t sls_rand(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+// Float rows hold multiples of 1/64 in [-2, 2): their sums are exact in any order, so the
+// partial sums of the DPUs add up to the bits of the host sum
+static void generate_table(T *table, uint64_t n_rows, uint32_t dim) {
+    uint64_t s = 0x853C49E6748FEA9BULL;
+    for (uint64_t i = 0; i < n_rows * dim; i++) {
+#ifdef INT8
+        table[i] = (T) (int) (sls_rand(&s) % 256 - 128);
+#else
+        table[i] = (T) ((int) (sls_rand(&s) % 256) - 128) / 64.0f;
+#endif
+    }
+}
+
+// Row popularity: rank r is drawn with probability ~ 1 / (r + 1)^exponent, and ranks are
+// shuffled over the rows so the hot rows do not all live on the first DPU
+typedef struct {
+    double *cdf;
+    uint32_t *rows;
+    uint64_t n;
+} zipf_t;
+
+static void zipf_init(zipf_t *z, uint64_t n, double exponent) {
+    z->n = n;
+    z->cdf = (double *) malloc(n * sizeof(double));
+    z->rows = (uint32_t *) malloc(n * sizeof(uint32_t));
+    double sum = 0.0;
+    for (uint64_t r = 0; r < n; r++) {
+        sum += exponent == 0.0 ? 1.0 : pow((double) (r + 1), -exponent);
+        z->cdf[r] = sum;
+    }
+    for (uint64_t r = 0; r < n; r++) {
+        z->cdf[r] /= sum;
+        z->rows[r] = (uint32_t) r;
+    }
+    uint64_t s = 0x2545F4914F6CDD1DULL;
+    for (uint64_t r = n - 1; r > 0; r--) {
+        uint64_t j = sls_rand(&s) % (r + 1);
+        uint32_t tmp = z->rows[r];
+        z->rows[r] = z->rows[j];
+        z->rows[j] = tmp;
+    }
+}
+
+static inline uint32_t zipf_next(const zipf_t *z, uint64_t *s) {
+    double u = (sls_rand(s) >> 11) * (1.0 / 9007199254740992.0);
+    uint64_t lo = 0, hi = z->n - 1;
+    while (lo < hi) {
+        uint64_t mid = (lo + hi) / 2;
+        if (z->cdf[mid] <= u)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return z->rows[lo];
+}
+
+static void zipf_free(zipf_t *z) {
+    free(z->cdf);
+    free(z->rows);
+}
+
+// Row indices of n_bags bags of lookups rows each, bag after bag
+static void generate_bags(uint32_t *indices, uint64_t n_bags, uint32_t lookups, const zipf_t *z, uint64_t seed) {
+    uint64_t s = seed * 0x9E3779B97F4A7C15ULL + 1;
+    for (uint64_t i = 0; i < n_bags * lookups; i++)
+        indices[i] = zipf_next(z, &s);
+}
+
+// Sum of the rows of one bag
+static inline void sls_bag(ACC *out, const T *table, uint32_t dim, const uint32_t *indices, uint32_t lookups) {
+    memset(out, 0, dim * sizeof(ACC));
+    for (uint32_t l = 0; l < lookups; l++) {
+        const T *row = table + (uint64_t) indices[l] * dim;
+        for (uint32_t d = 0; d < dim; d++)
+            out[d] += (ACC) row[d];
+    }
+}
+#endif
@@ -0,0 +1,58 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+// Embedding bags (sparse lengths sum): the rows of an embedding table are range-partitioned
+// across the DPUs and a bag is the sum of the rows it looks up. Every DPU sums the lookups
+// of a bag that fall in its rows (a segment) and the host adds up the partial sums of a bag.
+
+// Transfer size between MRAM and WRAM (index blocks)
+#ifdef BL
+#define BLOCK_SIZE_LOG2 BL
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#else
+#define BLOCK_SIZE_LOG2 8
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#define BL BLOCK_SIZE_LOG2
+#endif
+
+// Row type and sum type: int8 rows (quantized tables) are summed exactly in int32
+#ifdef INT8
+#define T int8_t
+#define ACC int32_t
+#else
+#define T float
+#define ACC float
+#endif
+
+// Largest embedding dimension: every tasklet holds a row and a partial sum in WRAM
+#define MAX_DIM 256
+
+// Lookups of one bag on one DPU: from first to the first of the next segment
+typedef struct {
+    uint32_t bag;   // Bag in the batch
+    uint32_t first; // First lookup in the DPU's index list
+} segment_t;
+
+// Structures used by both the host and the dpu to communicate information
+typedef struct {
+    uint32_t n_segments;     // Segments of this DPU, followed by a sentinel
+    uint32_t n_lookups;
+    uint32_t dim;
+    uint32_t index_offset;   // Offsets in the MRAM heap; the rows start at 0
+    uint32_t segment_offset;
+    uint32_t output_offset;  // One partial sum (dim ACC) per segment
+} dpu_arguments_t;
+
+#define DPU_CAPACITY (64 << 20) // A DPU's capacity is 64 MiB
+
+#ifndef ENERGY
+#define ENERGY 0
+#endif
+#define PRINT 0
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+#define divceil(n, m) (((n)-1) / (m) + 1)
+#endif
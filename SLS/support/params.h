@@ -0,0 +1,80 @@
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "common.h"
+
+typedef struct Params {
+    unsigned int   n_rows;
+    unsigned int   dim;
+    unsigned int   n_bags;
+    unsigned int   lookups;
+    double         zipf;
+    unsigned int   batch;
+    unsigned int   n_threads;
+    unsigned int   n_warmup;
+    unsigned int   n_reps;
+} Params;
+
+static void usage() {
+    fprintf(stderr,
+            "\nUsage:  ./program [options]"
+            "\n"
+            "\nGeneral options:"
+            "\n    -h        help"
+            "\n    -w <W>    # of untimed warmup iterations (default=1)"
+            "\n    -e <E>    # of timed repetition iterations (default=3)"
+            "\n    -t <T>    # of host threads for lookup routing and bag sums, or of the CPU baseline (default=8)"
+            "\n"
+            "\nBenchmark-specific options:"
+            "\n    -r <R>    rows of the embedding table (default=1048576)"
+            "\n    -d <D>    embedding dimension, a multiple of 8 up to 256 (default=64)"
+            "\n    -q <Q>    number of bags (default=16384)"
+            "\n    -l <L>    lookups per bag (default=32)"
+            "\n    -z <Z>    Zipf exponent of the row popularity, 0 for uniform (default=0.99)"
+            "\n    -b <B>    bags per batch, 0 for a single batch (default=0)"
+            "\n");
+}
+
+struct Params input_params(int argc, char **argv) {
+    struct Params p;
+    p.n_warmup      = 1;
+    p.n_reps        = 3;
+    p.n_threads     = 8;
+    p.n_rows        = 1048576;
+    p.dim           = 64;
+    p.n_bags        = 16384;
+    p.lookups       = 32;
+    p.zipf          = 0.99;
+    p.batch         = 0;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hw:e:t:r:d:q:l:z:b:")) >= 0) {
+        switch(opt) {
+            case 'h':
+                usage();
+                exit(0);
+                break;
+            case 'w': p.n_warmup      = atoi(optarg); break;
+            case 'e': p.n_reps        = atoi(optarg); break;
+            case 't': p.n_threads     = atoi(optarg); break;
+            case 'r': p.n_rows        = atoi(optarg); break;
+            case 'd': p.dim           = atoi(optarg); break;
+            case 'q': p.n_bags        = atoi(optarg); break;
+            case 'l': p.lookups       = atoi(optarg); break;
+            case 'z': p.zipf          = atof(optarg); break;
+            case 'b': p.batch         = atoi(optarg); break;
+            default:
+                      fprintf(stderr, "\nUnrecognized option!\n");
+                      usage();
+                      exit(0);
+        }
+    }
+    if (p.batch == 0 || p.batch > p.n_bags)
+        p.batch = p.n_bags;
+    assert(p.n_rows > 0 && p.n_bags > 0 && p.lookups > 0 && "Invalid # of rows, bags or lookups!");
+    assert(p.dim > 0 && p.dim <= MAX_DIM && p.dim % 8 == 0 && "Invalid embedding dimension!");
+    assert(p.zipf >= 0.0 && p.n_threads > 0 && "Invalid Zipf exponent or thread count!");
+
+    return p;
+}
+#endif
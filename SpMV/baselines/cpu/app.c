@@ -10,6 +10,7 @@
 
 #include "../../support/matrix.h"
 #include "../../support/params.h"
+#include "../../support/rapl.h"
 #include "../../support/timer.h"
 #include "../../support/utils.h"
 
@@ -20,17 +21,18 @@ int main(int argc, char** argv) {
 
     // Initialize SpMV data structures
     PRINT_INFO(p.verbosity >= 1, "Reading matrix %s", p.fileName);
-    struct COOMatrix cooMatrix = readCOOMatrix(p.fileName);
-    PRINT_INFO(p.verbosity >= 1, "    %u rows, %u columns, %u nonzeros", cooMatrix.numRows, cooMatrix.numCols, cooMatrix.numNonzeros);
-    struct CSRMatrix csrMatrix = coo2csr(cooMatrix);
+    struct CSRMatrix csrMatrix = readMatrix(p.fileName);
+    PRINT_INFO(p.verbosity >= 1, "    %u rows, %u columns, %u nonzeros", csrMatrix.numRows, csrMatrix.numCols, csrMatrix.numNonzeros);
     float* inVector = malloc(csrMatrix.numCols*sizeof(float));
     float* outVector = malloc(csrMatrix.numRows*sizeof(float));
     initVector(inVector, csrMatrix.numCols);
 
     // Calculating result on CPU
     PRINT_INFO(p.verbosity >= 1, "Calculating result on CPU");
-    omp_set_num_threads(4);
+    if(getenv("OMP_NUM_THREADS") == NULL) omp_set_num_threads(4); // Default unless set by the caller
     Timer timer;
+    Energy energy;
+    energy_start(&energy, 0, 0);
     startTimer(&timer);
     #pragma omp parallel for
     for(uint32_t rowIdx = 0; rowIdx < csrMatrix.numRows; ++rowIdx) {
@@ -43,11 +45,16 @@ int main(int argc, char** argv) {
         outVector[rowIdx] = sum;
     }
     stopTimer(&timer);
+    energy_stop(&energy, 0);
     if(p.verbosity == 0) PRINT("%f", getElapsedTime(timer)*1e3);
     PRINT_INFO(p.verbosity >= 1, "    Elapsed time: %f ms", getElapsedTime(timer)*1e3);
+    if(p.verbosity >= 1) {
+        printf("\033[0;32mINFO:\033[0m        Energy ");
+        energy_print(&energy, 0, 1, csrMatrix.numNonzeros);
+        printf("\n");
+    }
 
     // Deallocate data structures
-    freeCOOMatrix(cooMatrix);
     freeCSRMatrix(csrMatrix);
     free(inVector);
     free(outVector);
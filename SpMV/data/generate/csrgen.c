@@ -0,0 +1,389 @@
+
+// Synthetic graph / sparse matrix generator writing binary CSR (see support/matrix.h and
+// BFS/support/graph.h for the reader).
+//
+// Generators:
+//   kron     Graph500 Kronecker graph: R-MAT with A=0.57, B=C=0.19, vertex IDs scrambled by a
+//            bijective hash, 2^scale nodes, edgefactor * 2^scale edges
+//   rmat     R-MAT with tunable skew (-a -b -c) and no scrambling, so high-degree nodes stay
+//            clustered at low IDs (worst case for contiguous row/edge partitioning)
+//   banded   n x n matrix with all columns in [row - w, row + w]
+//   uniform  n x n matrix with k uniformly random columns per row
+//
+// Every random number is a function of (seed, edge or row index) only, so the output is
+// identical for any number of OpenMP threads.
+
+#include <assert.h>
+#include <errno.h>
+#include <getopt.h>
+#include <omp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Binary CSR layout (little endian)
+#define CSR_FILE_MAGIC "PRIMCSR1"
+#define CSR_FILE_HAS_VALUES 0x1
+
+struct Params {
+    const char* type;
+    unsigned int scale;
+    uint64_t n;
+    unsigned int edgeFactor;
+    unsigned int width;
+    double a, b, c;
+    uint64_t seed;
+    int undirected;
+    int dedup;
+    int values;
+    const char* outFile;
+};
+
+struct CSR {
+    uint32_t numRows;
+    uint32_t numCols;
+    uint64_t numNonzeros;
+    uint32_t* rowPtrs;
+    uint32_t* colIdxs;
+};
+
+// Counter-based random numbers
+static inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static inline double uniform01(uint64_t* state) {
+    *state = splitmix64(*state);
+    return (*state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Bijection on [0, 2^scale): odd multiplier and xor-shift, both invertible modulo 2^scale
+static inline uint32_t scramble(uint32_t v, unsigned int scale, uint64_t seed) {
+    uint64_t mask = (1ULL << scale) - 1;
+    uint64_t x = v;
+    uint64_t m1 = (splitmix64(seed ^ 0xA5A5A5A5ULL) | 1) & mask;
+    uint64_t m2 = (splitmix64(seed ^ 0x5A5A5A5AULL) | 1) & mask;
+    x = (x * m1) & mask;
+    x ^= x >> (scale / 2 + 1);
+    x = (x * m2) & mask;
+    x ^= x >> (scale / 2 + 1);
+    return (uint32_t)x;
+}
+
+static void usage() {
+    fprintf(stderr,
+        "\nUsage:  ./csrgen [options]"
+        "\n"
+        "\nOptions:"
+        "\n    -h        help"
+        "\n    -g <G>    generator: kron, rmat, banded, uniform (default=kron)"
+        "\n    -s <S>    scale, 2^S nodes (kron, rmat) (default=16)"
+        "\n    -n <N>    number of rows (banded, uniform) (default=65536)"
+        "\n    -e <E>    edges per node (kron, rmat) or nonzeros per row (uniform) (default=16)"
+        "\n    -w <W>    half bandwidth (banded) (default=8)"
+        "\n    -a/-b/-c  R-MAT quadrant probabilities (rmat) (default=0.57/0.19/0.19)"
+        "\n    -r <R>    random seed (default=1)"
+        "\n    -u        undirected: add every edge in both directions (kron, rmat)"
+        "\n    -d        remove duplicate nonzeros (and self loops for kron, rmat)"
+        "\n    -v        store random float values in [0, 1) (default: pattern only)"
+        "\n    -o <F>    output file (default=out.csr)"
+        "\n");
+}
+
+// Scale of -s, rejected unless it is a whole number in [1, 31] (2^scale nodes fit in 32 bits)
+static unsigned int parse_scale(const char* arg) {
+    char* end;
+    errno = 0;
+    long scale = strtol(arg, &end, 10);
+    if(errno != 0 || end == arg || *end != '\0' || scale < 1 || scale > 31) {
+        fprintf(stderr, "Scale must be in [1, 31], got %s\n", arg);
+        exit(1);
+    }
+    return (unsigned int)scale;
+}
+
+static struct Params input_params(int argc, char** argv) {
+    struct Params p;
+    p.type = "kron";
+    p.scale = 16;
+    p.n = 65536;
+    p.edgeFactor = 16;
+    p.width = 8;
+    p.a = 0.57;
+    p.b = 0.19;
+    p.c = 0.19;
+    p.seed = 1;
+    p.undirected = 0;
+    p.dedup = 0;
+    p.values = 0;
+    p.outFile = "out.csr";
+    int opt;
+    while((opt = getopt(argc, argv, "hg:s:n:e:w:a:b:c:r:udvo:")) >= 0) {
+        switch(opt) {
+            case 'h': usage(); exit(0);
+            case 'g': p.type = optarg; break;
+            case 's': p.scale = parse_scale(optarg); break;
+            case 'n': p.n = strtoull(optarg, NULL, 10); break;
+            case 'e': p.edgeFactor = atoi(optarg); break;
+            case 'w': p.width = atoi(optarg); break;
+            case 'a': p.a = atof(optarg); break;
+            case 'b': p.b = atof(optarg); break;
+            case 'c': p.c = atof(optarg); break;
+            case 'r': p.seed = strtoull(optarg, NULL, 10); break;
+            case 'u': p.undirected = 1; break;
+            case 'd': p.dedup = 1; break;
+            case 'v': p.values = 1; break;
+            case 'o': p.outFile = optarg; break;
+            default: usage(); exit(1);
+        }
+    }
+    if(p.a < 0 || p.b < 0 || p.c < 0 || p.a + p.b + p.c > 1.0) {
+        fprintf(stderr, "R-MAT probabilities must be non-negative with a + b + c <= 1\n");
+        exit(1);
+    }
+    return p;
+}
+
+static int compareUint32(const void* x, const void* y) {
+    uint32_t a = *(const uint32_t*)x, b = *(const uint32_t*)y;
+    return (a > b) - (a < b);
+}
+
+// Sort every row (makes the output independent of the scatter order) and optionally
+// drop duplicates and self loops, compacting the rows in place
+static void finalizeRows(struct CSR* csr, int dedup, int dropSelfLoops) {
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for(int64_t row = 0; row < (int64_t)csr->numRows; ++row) {
+        qsort(&csr->colIdxs[csr->rowPtrs[row]], csr->rowPtrs[row + 1] - csr->rowPtrs[row], sizeof(uint32_t), compareUint32);
+    }
+    if(!dedup) return;
+    uint64_t out = 0;
+    uint32_t begin = csr->rowPtrs[0];
+    for(uint32_t row = 0; row < csr->numRows; ++row) {
+        uint32_t end = csr->rowPtrs[row + 1];
+        csr->rowPtrs[row] = (uint32_t)out;
+        for(uint32_t i = begin; i < end; ++i) {
+            uint32_t col = csr->colIdxs[i];
+            if(dropSelfLoops && col == row) continue;
+            if(out > csr->rowPtrs[row] && csr->colIdxs[out - 1] == col) continue;
+            csr->colIdxs[out++] = col;
+        }
+        begin = end;
+    }
+    csr->rowPtrs[csr->numRows] = (uint32_t)out;
+    csr->numNonzeros = out;
+}
+
+// Edge list to CSR: row histogram, prefix sum, scatter (rows are sorted afterwards)
+static struct CSR edgesToCSR(const uint32_t* src, const uint32_t* dst, uint64_t numEdges, uint32_t numNodes) {
+    struct CSR csr;
+    csr.numRows = numNodes;
+    csr.numCols = numNodes;
+    csr.numNonzeros = numEdges;
+    csr.rowPtrs = (uint32_t*) calloc((uint64_t)numNodes + 1, sizeof(uint32_t));
+    csr.colIdxs = (uint32_t*) malloc(numEdges * sizeof(uint32_t));
+    assert(csr.rowPtrs && csr.colIdxs);
+
+    #pragma omp parallel for
+    for(uint64_t e = 0; e < numEdges; ++e) {
+        #pragma omp atomic
+        csr.rowPtrs[src[e]]++;
+    }
+    uint32_t sum = 0;
+    for(uint32_t row = 0; row < numNodes; ++row) {
+        uint32_t count = csr.rowPtrs[row];
+        csr.rowPtrs[row] = sum;
+        sum += count;
+    }
+    csr.rowPtrs[numNodes] = sum;
+
+    uint32_t* next = (uint32_t*) malloc((uint64_t)numNodes * sizeof(uint32_t));
+    memcpy(next, csr.rowPtrs, (uint64_t)numNodes * sizeof(uint32_t));
+    #pragma omp parallel for
+    for(uint64_t e = 0; e < numEdges; ++e) {
+        uint32_t pos;
+        #pragma omp atomic capture
+        pos = next[src[e]]++;
+        csr.colIdxs[pos] = dst[e];
+    }
+    free(next);
+    return csr;
+}
+
+static struct CSR generateRMAT(const struct Params* p, int graph500) {
+    uint32_t numNodes = 1u << p->scale;
+    uint64_t numGenerated = (uint64_t)p->edgeFactor << p->scale;
+    uint64_t numEdges = p->undirected ? 2 * numGenerated : numGenerated;
+    if(numEdges > UINT32_MAX) {
+        fprintf(stderr, "Too many edges (%lu) for 32-bit CSR offsets\n", (unsigned long)numEdges);
+        exit(1);
+    }
+    double a = graph500 ? 0.57 : p->a;
+    double b = graph500 ? 0.19 : p->b;
+    double c = graph500 ? 0.19 : p->c;
+    uint32_t* src = (uint32_t*) malloc(numEdges * sizeof(uint32_t));
+    uint32_t* dst = (uint32_t*) malloc(numEdges * sizeof(uint32_t));
+    assert(src && dst);
+
+    #pragma omp parallel for schedule(static)
+    for(uint64_t e = 0; e < numGenerated; ++e) {
+        uint64_t state = splitmix64(p->seed ^ (e * 0xD1B54A32D192ED03ULL));
+        uint32_t u = 0, v = 0;
+        for(unsigned int level = 0; level < p->scale; ++level) {
+            double r = uniform01(&state);
+            uint32_t bit = 1u << (p->scale - 1 - level);
+            if(r < a) {
+            } else if(r < a + b) {
+                v |= bit;
+            } else if(r < a + b + c) {
+                u |= bit;
+            } else {
+                u |= bit;
+                v |= bit;
+            }
+        }
+        if(graph500) {
+            u = scramble(u, p->scale, p->seed);
+            v = scramble(v, p->scale, p->seed);
+        }
+        src[e] = u;
+        dst[e] = v;
+        if(p->undirected) {
+            src[numGenerated + e] = v;
+            dst[numGenerated + e] = u;
+        }
+    }
+
+    struct CSR csr = edgesToCSR(src, dst, numEdges, numNodes);
+    free(src);
+    free(dst);
+    finalizeRows(&csr, p->dedup, 1);
+    return csr;
+}
+
+static struct CSR generateBanded(const struct Params* p) {
+    struct CSR csr;
+    uint32_t n = (uint32_t)p->n;
+    csr.numRows = csr.numCols = n;
+    csr.rowPtrs = (uint32_t*) malloc(((uint64_t)n + 1) * sizeof(uint32_t));
+    uint64_t sum = 0;
+    for(uint32_t row = 0; row < n; ++row) {
+        uint64_t first = (row > p->width) ? row - p->width : 0;
+        uint64_t last = ((uint64_t)row + p->width < n) ? row + p->width : n - 1;
+        csr.rowPtrs[row] = (uint32_t)sum;
+        sum += last - first + 1;
+    }
+    if(sum > UINT32_MAX) {
+        fprintf(stderr, "Too many nonzeros (%lu) for 32-bit CSR offsets\n", (unsigned long)sum);
+        exit(1);
+    }
+    csr.rowPtrs[n] = (uint32_t)sum;
+    csr.numNonzeros = sum;
+    csr.colIdxs = (uint32_t*) malloc(sum * sizeof(uint32_t));
+    assert(csr.colIdxs);
+    #pragma omp parallel for schedule(static)
+    for(int64_t row = 0; row < (int64_t)n; ++row) {
+        uint32_t first = (row > p->width) ? (uint32_t)(row - p->width) : 0;
+        for(uint32_t i = csr.rowPtrs[row]; i < csr.rowPtrs[row + 1]; ++i) {
+            csr.colIdxs[i] = first + (i - csr.rowPtrs[row]);
+        }
+    }
+    return csr;
+}
+
+static struct CSR generateUniform(const struct Params* p) {
+    struct CSR csr;
+    uint32_t n = (uint32_t)p->n;
+    uint64_t numNonzeros = (uint64_t)n * p->edgeFactor;
+    if(numNonzeros > UINT32_MAX) {
+        fprintf(stderr, "Too many nonzeros (%lu) for 32-bit CSR offsets\n", (unsigned long)numNonzeros);
+        exit(1);
+    }
+    csr.numRows = csr.numCols = n;
+    csr.numNonzeros = numNonzeros;
+    csr.rowPtrs = (uint32_t*) malloc(((uint64_t)n + 1) * sizeof(uint32_t));
+    csr.colIdxs = (uint32_t*) malloc(numNonzeros * sizeof(uint32_t));
+    assert(csr.rowPtrs && csr.colIdxs);
+    #pragma omp parallel for schedule(static)
+    for(int64_t row = 0; row <= (int64_t)n; ++row) {
+        csr.rowPtrs[row] = (uint32_t)(row * p->edgeFactor);
+    }
+    #pragma omp parallel for schedule(static)
+    for(int64_t row = 0; row < (int64_t)n; ++row) {
+        uint64_t state = splitmix64(p->seed ^ ((uint64_t)row * 0xD1B54A32D192ED03ULL));
+        for(uint32_t i = csr.rowPtrs[row]; i < csr.rowPtrs[row + 1]; ++i) {
+            csr.colIdxs[i] = (uint32_t)(uniform01(&state) * n);
+        }
+    }
+    finalizeRows(&csr, p->dedup, 0);
+    return csr;
+}
+
+static void writeCSR(const struct CSR* csr, const struct Params* p) {
+    FILE* fp = fopen(p->outFile, "wb");
+    if(!fp) {
+        fprintf(stderr, "Cannot open %s\n", p->outFile);
+        exit(1);
+    }
+    uint32_t header[4] = { csr->numRows, csr->numCols, (uint32_t)csr->numNonzeros, p->values ? CSR_FILE_HAS_VALUES : 0 };
+    int ok = fwrite(CSR_FILE_MAGIC, 1, 8, fp) == 8;
+    ok = ok && fwrite(header, sizeof(uint32_t), 4, fp) == 4;
+    ok = ok && fwrite(csr->rowPtrs, sizeof(uint32_t), (uint64_t)csr->numRows + 1, fp) == (uint64_t)csr->numRows + 1;
+    ok = ok && fwrite(csr->colIdxs, sizeof(uint32_t), csr->numNonzeros, fp) == csr->numNonzeros;
+    if(ok && p->values) {
+        float* values = (float*) malloc(csr->numNonzeros * sizeof(float));
+        #pragma omp parallel for schedule(static)
+        for(uint64_t i = 0; i < csr->numNonzeros; ++i) {
+            uint64_t state = splitmix64(p->seed ^ 0xF00DULL ^ (i * 0x9E3779B97F4A7C15ULL));
+            values[i] = (float)uniform01(&state);
+        }
+        ok = fwrite(values, sizeof(float), csr->numNonzeros, fp) == csr->numNonzeros;
+        free(values);
+    }
+    if(fclose(fp) != 0 || !ok) {
+        fprintf(stderr, "Error writing %s\n", p->outFile);
+        exit(1);
+    }
+}
+
+int main(int argc, char** argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    struct CSR csr;
+    double start = omp_get_wtime();
+    if(strcmp(p.type, "kron") == 0) {
+        csr = generateRMAT(&p, 1);
+    } else if(strcmp(p.type, "rmat") == 0) {
+        csr = generateRMAT(&p, 0);
+    } else if(strcmp(p.type, "banded") == 0) {
+        csr = generateBanded(&p);
+    } else if(strcmp(p.type, "uniform") == 0) {
+        csr = generateUniform(&p);
+    } else {
+        fprintf(stderr, "Unknown generator %s\n", p.type);
+        usage();
+        return 1;
+    }
+    double generated = omp_get_wtime();
+    writeCSR(&csr, &p);
+
+    uint32_t maxDegree = 0;
+    for(uint32_t row = 0; row < csr.numRows; ++row) {
+        uint32_t degree = csr.rowPtrs[row + 1] - csr.rowPtrs[row];
+        if(degree > maxDegree) maxDegree = degree;
+    }
+    printf("%s: %u x %u, %lu nonzeros (avg %.2f, max %u per row), %d threads, generated in %.3f s, written in %.3f s\n",
+        p.outFile, csr.numRows, csr.numCols, (unsigned long)csr.numNonzeros, (double)csr.numNonzeros / csr.numRows, maxDegree,
+        omp_get_max_threads(), generated - start, omp_get_wtime() - generated);
+
+    free(csr.rowPtrs);
+    free(csr.colIdxs);
+
+    return 0;
+
+}
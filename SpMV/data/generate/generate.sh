@@ -7,3 +7,12 @@ for r in $R; do
     ./replicate ../bcsstk30.mtx $r ../bcsstk30.mtx.$r.mtx
 done
 
+# Synthetic binary CSR inputs (SpMV and BFS read them with -f like the text files)
+S="16 18 20"
+
+for s in $S; do
+    ./csrgen -g kron -s $s -u -d -o ../kron.$s.csr
+    ./csrgen -g rmat -s $s -a 0.7 -b 0.1 -c 0.1 -v -o ../rmat.$s.csr
+    ./csrgen -g uniform -n $((1 << s)) -e 16 -v -o ../uniform.$s.csr
+    ./csrgen -g banded -n $((1 << s)) -w 16 -v -o ../banded.$s.csr
+done
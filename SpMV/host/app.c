@@ -54,9 +54,8 @@ int main(int argc, char** argv) {
 
     // Initialize SpMV data structures
     PRINT_INFO(p.verbosity >= 1, "Reading matrix %s", p.fileName);
-    struct COOMatrix cooMatrix = readCOOMatrix(p.fileName);
-    PRINT_INFO(p.verbosity >= 1, "    %u rows, %u columns, %u nonzeros", cooMatrix.numRows, cooMatrix.numCols, cooMatrix.numNonzeros);
-    struct CSRMatrix csrMatrix = coo2csr(cooMatrix);
+    struct CSRMatrix csrMatrix = readMatrix(p.fileName);
+    PRINT_INFO(p.verbosity >= 1, "    %u rows, %u columns, %u nonzeros", csrMatrix.numRows, csrMatrix.numCols, csrMatrix.numNonzeros);
     uint32_t numRows = csrMatrix.numRows;
     uint32_t numCols = csrMatrix.numCols;
     uint32_t* rowPtrs = csrMatrix.rowPtrs;
@@ -118,20 +117,20 @@ int main(int argc, char** argv) {
 
             // Send data to DPU
             PRINT_INFO(p.verbosity >= 2, "        Copying data to DPU");
-            startTimer(&timer);
+            startPhase(&timer, PHASE_C2D);
             copyToDPU(dpu, (uint8_t*)dpuRowPtrs_h, dpuRowPtrs_m, (dpuNumRows + 1)*sizeof(uint32_t));
             copyToDPU(dpu, (uint8_t*)dpuNonzeros_h, dpuNonzeros_m, dpuNumNonzeros*sizeof(struct Nonzero));
             copyToDPU(dpu, (uint8_t*)inVector, dpuInVector_m, numCols*sizeof(float));
-            stopTimer(&timer);
+            stopPhase(&timer, PHASE_C2D);
             loadTime += getElapsedTime(timer);
 
         }
 
         // Send parameters to DPU
         PRINT_INFO(p.verbosity >= 2, "        Copying parameters to DPU");
-        startTimer(&timer);
+        startPhase(&timer, PHASE_C2D);
         copyToDPU(dpu, (uint8_t*)&dpuParams[dpuIdx], dpuParams_m, sizeof(struct DPUParams));
-        stopTimer(&timer);
+        stopPhase(&timer, PHASE_C2D);
         loadTime += getElapsedTime(timer);
 
         ++dpuIdx;
@@ -141,7 +140,7 @@ int main(int argc, char** argv) {
 
     // Run all DPUs
     PRINT_INFO(p.verbosity >= 1, "Booting DPUs");
-    startTimer(&timer);
+    startPhase(&timer, PHASE_DPU);
     #if ENERGY
     DPU_ASSERT(dpu_probe_start(&probe));
     #endif
@@ -152,13 +151,13 @@ int main(int argc, char** argv) {
     DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &energy));
     PRINT_INFO(p.verbosity >= 1, "    DPU Energy: %f J", energy);
     #endif
-    stopTimer(&timer);
+    stopPhase(&timer, PHASE_DPU);
     dpuTime += getElapsedTime(timer);
     PRINT_INFO(p.verbosity >= 1, "    DPU Time: %f ms", dpuTime*1e3);
 
     // Copy back result
     PRINT_INFO(p.verbosity >= 1, "Copying back the result");
-    startTimer(&timer);
+    startPhase(&timer, PHASE_D2C);
     dpuIdx = 0;
     DPU_FOREACH (dpu_set, dpu) {
         unsigned int dpuNumRows = dpuParams[dpuIdx].dpuNumRows;
@@ -168,14 +167,14 @@ int main(int argc, char** argv) {
         }
         ++dpuIdx;
     }
-    stopTimer(&timer);
+    stopPhase(&timer, PHASE_D2C);
     retrieveTime += getElapsedTime(timer);
     PRINT_INFO(p.verbosity >= 1, "    DPU-CPU Time: %f ms", retrieveTime*1e3);
     if(p.verbosity == 0) PRINT("CPU-DPU Time(ms): %f    DPU Kernel Time (ms): %f    DPU-CPU Time (ms): %f", loadTime*1e3, dpuTime*1e3, retrieveTime*1e3);
 
     // Calculating result on CPU
     PRINT_INFO(p.verbosity >= 1, "Calculating result on CPU");
-    startTimer(&timer);
+    startPhase(&timer, PHASE_CPU);
     float* outVectorReference = malloc(numRows*sizeof(float));
     for(uint32_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
         float sum = 0.0f;
@@ -186,7 +185,7 @@ int main(int argc, char** argv) {
         }
         outVectorReference[rowIdx] = sum;
     }
-    stopTimer(&timer);
+    stopPhase(&timer, PHASE_CPU);
     float cpuTime = getElapsedTime(timer);
     if (p.verbosity >= 0) {
         PRINT("CPU Time(ms): %f, CPU-DPU Time(ms): %f    DPU Kernel Time (ms): %f    DPU-CPU Time (ms): %f",
@@ -200,6 +199,19 @@ int main(int argc, char** argv) {
         update_csv(RESULTS_FILE, TEST_NAME, "U_C2D", loadTime*1e3);
         update_csv(RESULTS_FILE, TEST_NAME, "U_D2C", retrieveTime*1e3);
         update_csv(RESULTS_FILE, TEST_NAME, "UPMEM", dpuTime*1e3);
+        update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)csrMatrix.numNonzeros, (double)numDPUs);
+#if PERF_EVENTS
+    {
+        // Host counters of each phase, named after the matching CSV column
+        const char* phaseNames[NUM_PHASES] = {"CPU", "U_C2D", "UPMEM", "U_D2C"};
+        for(int phase = 0; phase < NUM_PHASES; ++phase) {
+            printf("%s ", phaseNames[phase]);
+            prim_perf_print(phase, 1);
+            printf("\n");
+            update_csv_perf_events(RESULTS_FILE, TEST_NAME, phase, 1, phaseNames[phase]);
+        }
+    }
+#endif
 
     // Verify the result
     PRINT_INFO(p.verbosity >= 1, "Verifying the result");
@@ -231,7 +243,6 @@ int main(int argc, char** argv) {
     }
 
     // Deallocate data structures
-    freeCOOMatrix(cooMatrix);
     freeCSRMatrix(csrMatrix);
     free(inVector);
     free(outVector);
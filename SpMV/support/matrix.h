@@ -4,6 +4,8 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "common.h"
 #include "utils.h"
@@ -109,6 +111,87 @@ static void freeCSRMatrix(struct CSRMatrix csrMatrix) {
     free(csrMatrix.nonzeros);
 }
 
+// Binary CSR written by data/generate/csrgen (little endian):
+//   char magic[8] = "PRIMCSR1"; uint32_t numRows, numCols, numNonzeros, flags;
+//   uint32_t rowPtrs[numRows + 1]; uint32_t colIdxs[numNonzeros]; float values[numNonzeros] (if flags & 1)
+#define CSR_FILE_MAGIC "PRIMCSR1"
+#define CSR_FILE_HAS_VALUES 0x1
+
+static int isBinaryCSRFile(const char* fileName) {
+    char magic[8];
+    FILE* fp = fopen(fileName, "rb");
+    if(fp == NULL) return 0;
+    int isCSR = (fread(magic, 1, 8, fp) == 8) && (memcmp(magic, CSR_FILE_MAGIC, 8) == 0);
+    fclose(fp);
+    return isCSR;
+}
+
+static void freadOrExit(void* ptr, size_t size, size_t count, FILE* fp, const char* fileName) {
+    if(fread(ptr, size, count, fp) != count) {
+        PRINT_ERROR("Reading matrix %s: file is truncated", fileName);
+        exit(1);
+    }
+}
+
+// Pattern-only files get all values set to 1.0f, like readCOOMatrix
+static struct CSRMatrix readCSRMatrix(const char* fileName) {
+
+    struct CSRMatrix csrMatrix;
+
+    FILE* fp = fopen(fileName, "rb");
+    if(fp == NULL) {
+        PRINT_ERROR("Cannot open matrix %s", fileName);
+        exit(1);
+    }
+    char magic[8];
+    uint32_t header[4];
+    freadOrExit(magic, 1, 8, fp, fileName);
+    freadOrExit(header, sizeof(uint32_t), 4, fp, fileName);
+    uint32_t numRows = header[0];
+    csrMatrix.numRows = numRows;
+    if(csrMatrix.numRows%2 == 1) {
+        PRINT_WARNING("Reading matrix %s: number of rows must be even. Padding with an extra row.", fileName);
+        csrMatrix.numRows++;
+    }
+    csrMatrix.numCols = header[1];
+    csrMatrix.numNonzeros = header[2];
+    csrMatrix.rowPtrs = (uint32_t*) malloc(ROUND_UP_TO_MULTIPLE_OF_8((csrMatrix.numRows + 1)*sizeof(uint32_t)));
+    csrMatrix.nonzeros = (struct Nonzero*) malloc(ROUND_UP_TO_MULTIPLE_OF_8(csrMatrix.numNonzeros*sizeof(struct Nonzero)));
+    freadOrExit(csrMatrix.rowPtrs, sizeof(uint32_t), numRows + 1, fp, fileName);
+    csrMatrix.rowPtrs[csrMatrix.numRows] = csrMatrix.numNonzeros;
+
+    // Columns and values are stored as separate arrays
+    uint32_t* buffer = (uint32_t*) malloc(ROUND_UP_TO_MULTIPLE_OF_8(csrMatrix.numNonzeros*sizeof(uint32_t)));
+    freadOrExit(buffer, sizeof(uint32_t), csrMatrix.numNonzeros, fp, fileName);
+    for(uint32_t i = 0; i < csrMatrix.numNonzeros; ++i) {
+        csrMatrix.nonzeros[i].col = buffer[i];
+        csrMatrix.nonzeros[i].value = 1.0f;
+    }
+    if(header[3] & CSR_FILE_HAS_VALUES) {
+        float* values = (float*) buffer;
+        freadOrExit(values, sizeof(float), csrMatrix.numNonzeros, fp, fileName);
+        for(uint32_t i = 0; i < csrMatrix.numNonzeros; ++i) {
+            csrMatrix.nonzeros[i].value = values[i];
+        }
+    }
+    free(buffer);
+    fclose(fp);
+
+    return csrMatrix;
+
+}
+
+// Binary CSR or text COO, chosen by the file contents
+static struct CSRMatrix readMatrix(const char* fileName) {
+    if(isBinaryCSRFile(fileName)) {
+        return readCSRMatrix(fileName);
+    }
+    struct COOMatrix cooMatrix = readCOOMatrix(fileName);
+    struct CSRMatrix csrMatrix = coo2csr(cooMatrix);
+    freeCOOMatrix(cooMatrix);
+    return csrMatrix;
+}
+
 static void initVector(float* vec, uint32_t size) {
     for(uint32_t i = 0; i < size; ++i) {
         vec[i] = 1.0f;
@@ -31,6 +31,10 @@
 #include <sys/file.h>
 #endif
 
+#if PERF_EVENTS
+#include "perf_events.h"
+#endif
+
 // Forward declare Timer if you don't want to include your timer header here.
 // But easiest is: include this AFTER support/timer.h in your host file.
 //typedef struct Timer Timer;
@@ -417,6 +421,38 @@ static inline int update_csv(
     return 0;
 }
 
+// Elements and DPUs of a run, which roofline.py reads next to the times of the same row.
+static inline int update_csv_run_size(
+    const char *csv_path,
+    const char *test_name,
+    double elements,
+    double dpus
+) {
+    int ret = update_csv(csv_path, test_name, "Elements", elements);
+    if (update_csv(csv_path, test_name, "DPUs", dpus) != 0) ret = -1;
+    return ret;
+}
+
+#if PERF_EVENTS
+// Write the host counters of a phase as <metric>_<event> columns (see perf_events.h).
+static inline int update_csv_perf_events(
+    const char *csv_path,
+    const char *test_name,
+    int phase,
+    int reps,
+    const char *metric_name
+) {
+    int ret = 0;
+    for (int e = 0; e < PRIM_PERF_NR_EVENTS; e++) {
+        if (!prim_perf_available(e)) continue;
+        char col[128];
+        snprintf(col, sizeof(col), "%s_%s", metric_name, PRIM_PERF_EVENT_NAMES[e]);
+        if (update_csv(csv_path, test_name, col, prim_perf_avg(phase, e, reps)) != 0) ret = -1;
+    }
+    return ret;
+}
+#endif
+
 #if 0
 // compute avg ms from Timer slot and write to CSV.
 static inline int update_csv_from_timer(
@@ -5,6 +5,10 @@
 #include <stdio.h>
 #include <sys/time.h>
 
+#if PERF_EVENTS
+#include "perf_events.h"
+#endif
+
 typedef struct Timer {
     struct timeval startTime;
     struct timeval endTime;
@@ -23,5 +27,25 @@ static float getElapsedTime(Timer timer) {
                    + (timer.endTime.tv_usec - timer.startTime.tv_usec)/1.0e6));
 }
 
+// Host phases, which accumulate the optional hardware counters (PERF_EVENTS=1) across DPUs
+enum HostPhase { PHASE_CPU, PHASE_C2D, PHASE_DPU, PHASE_D2C, NUM_PHASES };
+
+static void startPhase(Timer* timer, enum HostPhase phase) {
+#if PERF_EVENTS
+    prim_perf_start(phase, 1);
+#else
+    (void) phase;
+#endif
+    startTimer(timer);
+}
+
+static void stopPhase(Timer* timer, enum HostPhase phase) {
+    stopTimer(timer);
+#if PERF_EVENTS
+    prim_perf_stop(phase);
+#else
+    (void) phase;
 #endif
+}
 
+#endif
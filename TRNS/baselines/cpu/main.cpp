@@ -38,6 +38,7 @@
 #include "support/common.h"
 #include "support/timer.h"
 #include "support/verify.h"
+#include "../../support/rapl.h"
 
 #include <unistd.h>
 #include <thread>
@@ -121,6 +122,7 @@ int main(int argc, char **argv) {
 
     const Params p(argc, argv);
     Timer        timer;
+    Energy       energy;
 
     // Allocate
     timer.start("Allocation");
@@ -160,47 +162,64 @@ int main(int argc, char **argv) {
 	        h_head[i].store(0);
 
         // start timer
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
+            energy_start(&energy, 0, rep - p.n_warmup);
             timer.start("Step 1");
+        }
         // Launch CPU threads
         std::thread main_thread_1(run_cpu_threads_100, h_in_out, h_finished, h_head, M_ * m, N_, n, p.n_threads); //M_ * m * N_);
         main_thread_1.join();
         // end timer
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
             timer.stop("Step 1");
+            energy_stop(&energy, 0);
+        }
 
         for(int i = 0; i < N_; i++)
             h_head[i].store(0);
 
         // start timer
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
+            energy_start(&energy, 1, rep - p.n_warmup);
             timer.start("Step 2");
+        }
         // Launch CPU threads
         std::thread main_thread_2(run_cpu_threads_010, h_in_out, h_head, m, n, M_ * N_, p.n_threads);
         main_thread_2.join();
         // end timer
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
             timer.stop("Step 2");
+            energy_stop(&energy, 1);
+        }
 
         memset((void *)h_finished, 0, sizeof(std::atomic_int) * finished_size);
         for(int i = 0; i < N_; i++)
             h_head[i].store(0);
 
         // start timer
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
+            energy_start(&energy, 2, rep - p.n_warmup);
             timer.start("Step 3");
+        }
         // Launch CPU threads
         for(int i = 0; i < N_; i++){
             std::thread main_thread_3(run_cpu_threads_100, h_in_out + i * M_ * n * m, h_finished + i * M_ * n, h_head + i, M_, n, m, p.n_threads); //M_ * n);
             main_thread_3.join();
 		}
         // end timer
-        if(rep >= p.n_warmup)
+        if(rep >= p.n_warmup) {
             timer.stop("Step 3");
+            energy_stop(&energy, 2);
+        }
     }
     timer.print("Step 1", p.n_reps);
     timer.print("Step 2", p.n_reps);
     timer.print("Step 3", p.n_reps);
+    for(int i = 0; i < 3; i++) {
+        printf("Step %d energy ", i + 1);
+        energy_print(&energy, i, p.n_reps, in_size);
+        printf("\n");
+    }
 
     // Verify answer
     //verify(h_in_out, h_in_backup, M_ * m, N_ * n, 1);
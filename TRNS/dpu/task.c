@@ -15,9 +15,12 @@
 #include "../support/common.h"
 
 __host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+__host uint64_t kernel_cycles;
 
 uint32_t curr_tile = 0; // protected by MUTEX
+uint32_t curr_leader; // protected by MUTEX
 uint32_t get_tile();
+uint32_t get_leaders();
 void read_tile_step2(uint32_t A, uint32_t offset, T* variable, uint32_t m, uint32_t n);
 void write_tile_step2(uint32_t A, uint32_t offset, T* variable, uint32_t m, uint32_t n);
 void read_tile_step3(uint32_t A, uint32_t offset, T* variable, uint32_t m);
@@ -34,8 +37,9 @@ MUTEX_INIT(done_mutex);
 
 extern int main_kernel1(void);
 extern int main_kernel2(void);
+extern int main_kernel3(void);
 
-int (*kernels[nr_kernels])(void) = {main_kernel1, main_kernel2};
+int (*kernels[nr_kernels])(void) = {main_kernel1, main_kernel2, main_kernel3};
 
 int main(void) { 
     // Kernel
@@ -50,6 +54,7 @@ int main_kernel1() {
 #endif
     if (tasklet_id == 0){ // Initialize once the cycle counter
         mem_reset(); // Reset the heap
+        perfcounter_config(COUNT_CYCLES, true);
     }
     // Barrier
     barrier_wait(&my_barrier);
@@ -70,6 +75,11 @@ int main_kernel1() {
         write_tile_step2(A, tile * m * n, backup, m, n);
     }
 
+    // Barrier
+    barrier_wait(&my_barrier);
+    if (tasklet_id == 0)
+        kernel_cycles = perfcounter_get();
+
     return 0;
 }
 
@@ -81,6 +91,7 @@ int main_kernel2() {
 #endif
     if (tasklet_id == 0){ // Initialize once the cycle counter
         mem_reset(); // Reset the heap
+        perfcounter_config(COUNT_CYCLES, true);
     }
     // Barrier
     barrier_wait(&my_barrier);
@@ -125,7 +136,88 @@ int main_kernel2() {
         }
         tile = get_tile();
     }
-		
+
+    // Barrier
+    barrier_wait(&my_barrier);
+    if (tasklet_id == 0)
+        kernel_cycles = perfcounter_get();
+
+    return 0;
+}
+
+// Step 3 with host-precomputed cycle leaders: 1000
+// Each cycle of the permutation is followed by exactly one tasklet, starting from its leader,
+// so no done array is needed. Up to STAGE_TILES tiles of the cycle are read into WRAM before
+// they are written back one position further along the cycle.
+int main_kernel3() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){ // Initialize once the cycle counter
+        mem_reset(); // Reset the heap
+        perfcounter_config(COUNT_CYCLES, true);
+        curr_leader = 0;
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    uint32_t A = (uint32_t)DPU_MRAM_HEAP_POINTER;
+    uint32_t m = DPU_INPUT_ARGUMENTS.m;
+    uint32_t n = DPU_INPUT_ARGUMENTS.n;
+    uint32_t M_ = DPU_INPUT_ARGUMENTS.M_;
+    uint32_t n_leaders = DPU_INPUT_ARGUMENTS.n_leaders;
+    uint32_t leaders = (uint32_t)(DPU_MRAM_HEAP_POINTER + M_ * m * n * sizeof(T));
+
+    const uint32_t tile_max = M_ * n - 1; // Tile id upper bound
+
+    // buf[0] holds the tile carried to the next position of the cycle, buf[1..STAGE_TILES] the staged tiles
+    T* buf[STAGE_TILES + 1];
+    for(unsigned int s = 0; s <= STAGE_TILES; s++){
+        buf[s] = (T*)mem_alloc(sizeof(T) * m);
+    }
+    uint32_t* leader_pair = (uint32_t*)mem_alloc(2 * sizeof(uint32_t));
+    uint32_t pos[STAGE_TILES];
+
+    for(uint32_t l = get_leaders(); l < n_leaders; l = get_leaders()){
+        mram_read((__mram_ptr void*)(leaders + l * sizeof(uint32_t)), leader_pair, 2 * sizeof(uint32_t));
+        for(uint32_t j = 0; j < 2 && l + j < n_leaders; j++){
+            uint32_t leader = leader_pair[j];
+            read_tile_step3(A, leader * m, buf[0], m);
+
+            uint32_t next_in_cycle = ((leader * M_) - tile_max * (leader / n));
+            _Bool closed = 0;
+            while(!closed){
+                // Stage the next tiles of the cycle (the leader itself has already been read)
+                uint32_t k = 0;
+                do {
+                    pos[k] = next_in_cycle;
+                    closed = (next_in_cycle == leader);
+                    if(!closed) {
+                        read_tile_step3(A, next_in_cycle * m, buf[k + 1], m);
+                    }
+                    next_in_cycle = ((next_in_cycle * M_) - tile_max * (next_in_cycle / n));
+                    k++;
+                } while(k < STAGE_TILES && !closed);
+
+                // Every tile moves one position forward
+                for(uint32_t s = 0; s < k; s++){
+                    write_tile_step3(A, pos[s] * m, buf[s], m);
+                }
+
+                // The last staged tile is carried into the next batch
+                T* carry = buf[0];
+                buf[0] = buf[k];
+                buf[k] = carry;
+            }
+        }
+    }
+
+    // Barrier
+    barrier_wait(&my_barrier);
+    if (tasklet_id == 0)
+        kernel_cycles = perfcounter_get();
+
     return 0;
 }
 
@@ -138,6 +230,15 @@ uint32_t get_tile(){
     return value;
 }
 
+// Cycle leaders are handed out in pairs, so each one costs a single aligned 8-byte MRAM read
+uint32_t get_leaders(){
+    mutex_lock(tile_mutex);
+    uint32_t value = curr_leader;
+    curr_leader += 2;
+    mutex_unlock(tile_mutex);
+    return value;
+}
+
 void read_tile_step2(uint32_t A, uint32_t offset, T* variable, uint32_t m, uint32_t n){
     int rest = m * n;
     int transfer;
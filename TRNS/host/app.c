@@ -18,6 +18,7 @@
 #include "../support/timer.h"
 #include "../support/params.h"
 #include "../support/prim_results.h"
+#include "../support/trace.h"
 
 // Define the DPU Binary path as DPU_BINARY here
 #ifndef DPU_BINARY
@@ -58,6 +59,38 @@ static void trns_host(T* input, unsigned int A, unsigned int B, unsigned int b){
    free(output);
 }
 
+// Compute the smallest tile id of every non-trivial cycle of the step 3 permutation
+static unsigned int cycle_leaders(uint32_t* leaders, unsigned int M_, unsigned int n){
+   const uint64_t tile_max = (uint64_t)M_ * n - 1;
+   bool* visited = calloc(tile_max + 1, sizeof(bool));
+   unsigned int n_leaders = 0;
+   for (uint64_t tile = 1; tile < tile_max; tile++){
+      if (visited[tile])
+         continue;
+      uint64_t next = (tile * M_) - tile_max * (tile / n);
+      if (next == tile)
+         continue;
+      leaders[n_leaders++] = (uint32_t)tile;
+      for (; next != tile; next = (next * M_) - tile_max * (next / n))
+         visited[next] = true;
+   }
+   free(visited);
+   return n_leaders;
+}
+
+// Kernel cycles of the slowest DPU in the set
+static uint64_t max_kernel_cycles(struct dpu_set_t dpu_set){
+   struct dpu_set_t dpu;
+   uint64_t max_cycles = 0;
+   DPU_FOREACH(dpu_set, dpu) {
+      uint64_t cycles;
+      DPU_ASSERT(dpu_copy_from(dpu, "kernel_cycles", 0, &cycles, sizeof(uint64_t)));
+      if (cycles > max_cycles)
+         max_cycles = cycles;
+   }
+   return max_cycles;
+}
+
 // Main of the Host Application
 int main(int argc, char **argv) {
 
@@ -84,6 +117,7 @@ int main(int argc, char **argv) {
     A_result = malloc(M_ * m * N_ * n * sizeof(T));
     T* done_host = malloc(M_ * n); // Host array to reset done array of step 3
     memset(done_host, 0, M_ * n);
+    uint32_t* leaders_host = malloc(((M_ * n) / 2 + 2) * sizeof(uint32_t)); // Cycle leaders of step 3 (-k 1)
 
     // Create an input file with arbitrary data
     read_input(A_host, M_ * m * N_ * n);
@@ -91,21 +125,37 @@ int main(int argc, char **argv) {
 
     // Timer declaration
     Timer timer;
+    uint64_t cycles_step2 = 0;
+    uint64_t cycles_step3 = 0;
 
     printf("NR_TASKLETS\t%d\n", NR_TASKLETS);
     printf("M_\t%u, m\t%u, N_\t%u, n\t%u\n", M_, m, N_, n);
 
+    // The permutation only depends on M_ and n, so the cycle leaders are computed once
+    unsigned int n_leaders = 0;
+    if(p.step3){
+        TRACE_BEGIN("host", "Cycle leaders", -1, -1);
+        start(&timer, 5, 0);
+        n_leaders = cycle_leaders(leaders_host, M_, n);
+        stop(&timer, 5);
+        TRACE_END();
+        leaders_host[n_leaders] = 0; // Padding for 8-byte transfers
+        printf("Cycle leaders\t%u\n", n_leaders);
+    }
+
     // Loop over main kernel
     for(int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
 
         int timer_fix = 0;
         // Compute output on CPU (performance comparison and verification purposes)
         memcpy(A_host, A_backup, M_ * m * N_ * n * sizeof(T));
+        TRACE_BEGIN("host", "CPU transposition", rep, -1);
         if(rep >= p.n_warmup)
             start(&timer, 0, rep - p.n_warmup + timer_fix);
         trns_host(A_host, M_ * m, N_ * n, 1);
         if(rep >= p.n_warmup)
             stop(&timer, 0);
+        TRACE_END();
 
         unsigned int curr_dpu = 0;
         unsigned int active_dpus;
@@ -113,6 +163,7 @@ int main(int argc, char **argv) {
         unsigned int first_round = 1;
 
         while(curr_dpu < N_){
+            bool loaded = false;
             // Allocate DPUs and load binary
             if((N_ - curr_dpu) > NR_DPUS){
                 active_dpus = NR_DPUS;
@@ -125,14 +176,17 @@ int main(int argc, char **argv) {
                 DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
                 DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
                 printf("Allocated %d DPU(s)\n", nr_of_dpus);
+                loaded = true;
             } else if (first_round){
                 DPU_ASSERT(dpu_alloc(active_dpus, NULL, &dpu_set));
                 DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
                 DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
                 printf("Allocated %d DPU(s)\n", nr_of_dpus);
+                loaded = true;
             }
 
             printf("Load input data (step 1)\n");
+            TRACE_BEGIN("xfer", "CPU-DPU (step 1)", timer_fix, (int64_t)M_ * m * n * nr_of_dpus * sizeof(T));
             if(rep >= p.n_warmup)
                 start(&timer, 1, rep - p.n_warmup + timer_fix);
             // Load input matrix (step 1)
@@ -146,18 +200,30 @@ int main(int argc, char **argv) {
             }
             if(rep >= p.n_warmup)
                 stop(&timer, 1);
-            // Reset done array (for step 3)
-            DPU_FOREACH(dpu_set, dpu) {
-                DPU_ASSERT(dpu_prepare_xfer(dpu, done_host));
+            TRACE_END();
+            if(p.step3 == 0){
+                // Reset done array (for step 3)
+                TRACE_BEGIN("xfer", "Done array reset", timer_fix, (int64_t)((M_ * n) / 8 == 0 ? 8 : M_ * n) * nr_of_dpus);
+                DPU_FOREACH(dpu_set, dpu) {
+                    DPU_ASSERT(dpu_prepare_xfer(dpu, done_host));
+                }
+                DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, M_ * m * n * sizeof(T), (M_ * n) / 8 == 0 ? 8 : M_ * n, DPU_XFER_DEFAULT));
+                TRACE_END();
+            } else if(loaded && n_leaders > 0){
+                // Cycle leaders (for step 3) are read-only, so they are only sent when the DPUs are loaded
+                TRACE_BEGIN("xfer", "Cycle leaders broadcast", timer_fix, (int64_t)divceil(n_leaders, 2) * 2 * sizeof(uint32_t) * nr_of_dpus);
+                DPU_ASSERT(dpu_broadcast_to(dpu_set, DPU_MRAM_HEAP_POINTER_NAME, M_ * m * n * sizeof(T), leaders_host, divceil(n_leaders, 2) * 2 * sizeof(uint32_t), DPU_XFER_DEFAULT));
+                TRACE_END();
             }
-            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, M_ * m * n * sizeof(T), (M_ * n) / 8 == 0 ? 8 : M_ * n, DPU_XFER_DEFAULT));
 
             unsigned int kernel = 0;
-            dpu_arguments_t input_arguments = {m, n, M_, kernel};
+            dpu_arguments_t input_arguments = {m, n, M_, kernel, n_leaders};
+            TRACE_BEGIN("xfer", "Arguments (step 2)", timer_fix, (int64_t)sizeof(input_arguments) * nr_of_dpus);
 	        DPU_FOREACH(dpu_set, dpu, i) {
 	            DPU_ASSERT(dpu_prepare_xfer(dpu, &input_arguments));
 	        }
 	        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(input_arguments), DPU_XFER_DEFAULT));
+            TRACE_END();
             printf("Run step 2 on DPU(s) \n");
             // Run DPU kernel
             if(rep >= p.n_warmup){
@@ -166,12 +232,15 @@ int main(int argc, char **argv) {
                 DPU_ASSERT(dpu_probe_start(&probe));
 #endif
             }
+            TRACE_BEGIN("launch", "Step 2", timer_fix, -1);
             DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            TRACE_END();
             if(rep >= p.n_warmup){
                 stop(&timer, 2);
 #if ENERGY
                 DPU_ASSERT(dpu_probe_stop(&probe));
 #endif
+                cycles_step2 += max_kernel_cycles(dpu_set);
             }
 #if PRINT
         {
@@ -185,12 +254,14 @@ int main(int argc, char **argv) {
         }
 #endif
 
-            kernel = 1;
-            dpu_arguments_t input_arguments2 = {m, n, M_, kernel};
+            kernel = p.step3 ? 2 : 1;
+            dpu_arguments_t input_arguments2 = {m, n, M_, kernel, n_leaders};
+            TRACE_BEGIN("xfer", "Arguments (step 3)", timer_fix, (int64_t)sizeof(input_arguments2) * nr_of_dpus);
 	        DPU_FOREACH(dpu_set, dpu, i) {
 	            DPU_ASSERT(dpu_prepare_xfer(dpu, &input_arguments2));
 	        }
 	        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(input_arguments2), DPU_XFER_DEFAULT));
+            TRACE_END();
             printf("Run step 3 on DPU(s) \n");
             // Run DPU kernel
             if(rep >= p.n_warmup){
@@ -199,12 +270,15 @@ int main(int argc, char **argv) {
                 DPU_ASSERT(dpu_probe_start(&probe));
 #endif
             }
+            TRACE_BEGIN("launch", "Step 3", timer_fix, -1);
             DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+            TRACE_END();
             if(rep >= p.n_warmup){
                 stop(&timer, 3);
 #if ENERGY
                 DPU_ASSERT(dpu_probe_stop(&probe));
 #endif
+                cycles_step3 += max_kernel_cycles(dpu_set);
             }
 #if PRINT
         {
@@ -219,6 +293,7 @@ int main(int argc, char **argv) {
 #endif
 
             printf("Retrieve results\n");
+            TRACE_BEGIN("xfer", "DPU-CPU", timer_fix, (int64_t)M_ * m * n * nr_of_dpus * sizeof(T));
             if(rep >= p.n_warmup)
                 start(&timer, 4, rep - p.n_warmup + timer_fix);
             DPU_FOREACH(dpu_set, dpu) {
@@ -228,6 +303,7 @@ int main(int argc, char **argv) {
             DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, sizeof(T) * m * n * M_, DPU_XFER_DEFAULT));
             if(rep >= p.n_warmup)
                 stop(&timer, 4);
+            TRACE_END();
 
             if(first_round){
                 first_round = 0;
@@ -249,6 +325,11 @@ int main(int argc, char **argv) {
     print(&timer, 3, p.n_reps);
     printf("DPU-CPU ");
     print(&timer, 4, p.n_reps);
+    if(p.step3){
+        printf("Cycle leaders (host) ");
+        print(&timer, 5, 1);
+    }
+    printf("\nStep 2 DPU cycles\t%lu\tStep 3 DPU cycles\t%lu\n", (unsigned long)(cycles_step2 / p.n_reps), (unsigned long)(cycles_step3 / p.n_reps));
     // update CSV
 #define TEST_NAME "TRNS"
 #define RESULTS_FILE "../prim_results.csv"
@@ -257,6 +338,7 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 4, p.n_reps, "U_D2C");
     double dpu_ms = prim_timer_ms_avg(&timer, 2, p.n_reps) + prim_timer_ms_avg(&timer, 3, p.n_reps);
     update_csv(RESULTS_FILE, TEST_NAME, "UPMEM", dpu_ms);
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)M_ * m * N_ * n, (double)nr_of_dpus);
 
     #if ENERGY
     double energy;
@@ -285,6 +367,7 @@ int main(int argc, char **argv) {
     free(A_backup);
     free(A_result);
     free(done_host);
+    free(leaders_host);
 	
     return status ? 0 : -1;
 }
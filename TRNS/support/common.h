@@ -22,10 +22,17 @@ typedef struct {
 	enum kernels {
 	    kernel1 = 0,
 	    kernel2 = 1,
-	    nr_kernels = 2,
+	    kernel3 = 2,
+	    nr_kernels = 3,
 	} kernel;
+    uint32_t n_leaders; // Number of cycle leaders (step 3 with kernel3)
 } dpu_arguments_t;
 
+// Tiles of a cycle staged in WRAM per tasklet (step 3 with kernel3)
+#ifndef STAGE_TILES
+#define STAGE_TILES 4
+#endif
+
 #ifndef ENERGY
 #define ENERGY 0
 #endif
@@ -11,6 +11,7 @@ typedef struct Params {
     int   n_warmup;
     int   n_reps;
     int  exp;
+    int  step3;
 }Params;
 
 static void usage() {
@@ -28,6 +29,7 @@ static void usage() {
         "\n    -n <I>    n (default=8 elements)"
         "\n    -o <I>    M_ (default=12288 elements)"
         "\n    -p <I>    N_ (default=1 elements)"
+        "\n    -k <K>    step 3 kernel: MRAM done array (0) or host-precomputed cycle leaders (1) (default=0)"
         "\n");
 }
 
@@ -40,9 +42,10 @@ struct Params input_params(int argc, char **argv) {
     p.n_warmup      = 0;
     p.n_reps        = 1;
     p.exp           = 0;
+    p.step3         = 0;
 
     int opt;
-    while((opt = getopt(argc, argv, "hw:e:x:m:n:o:p:")) >= 0) {
+    while((opt = getopt(argc, argv, "hw:e:x:m:n:o:p:k:")) >= 0) {
         switch(opt) {
         case 'h':
         usage();
@@ -55,6 +58,7 @@ struct Params input_params(int argc, char **argv) {
         case 'n': p.n             = atoi(optarg); break;
         case 'o': p.M_            = atoi(optarg); break;
         case 'p': p.N_            = atoi(optarg); break;
+        case 'k': p.step3         = atoi(optarg); break;
         default:
             fprintf(stderr, "\nUnrecognized option!\n");
             usage();
@@ -62,6 +66,7 @@ struct Params input_params(int argc, char **argv) {
         }
     }
     assert(NR_DPUS > 0 && "Invalid # of dpus!");
+    assert((p.step3 == 0 || p.step3 == 1) && "Invalid step 3 kernel!");
 
     return p;
 }
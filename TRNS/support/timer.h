@@ -35,6 +35,10 @@
 
 #include <sys/time.h>
 
+#if PERF_EVENTS
+#include "perf_events.h"
+#endif
+
 typedef struct Timer{
 
     struct timeval startTime[7];
@@ -47,13 +51,24 @@ void start(Timer *timer, int i, int rep) {
     if(rep == 0) {
         timer->time[i] = 0.0;
     }
+#if PERF_EVENTS
+    prim_perf_start(i, rep);
+#endif
     gettimeofday(&timer->startTime[i], NULL);
 }
 
 void stop(Timer *timer, int i) {
     gettimeofday(&timer->stopTime[i], NULL);
+#if PERF_EVENTS
+    prim_perf_stop(i);
+#endif
     timer->time[i] += (timer->stopTime[i].tv_sec - timer->startTime[i].tv_sec) * 1000000.0 +
                       (timer->stopTime[i].tv_usec - timer->startTime[i].tv_usec);
 }
 
-void print(Timer *timer, int i, int REP) { printf("Time (ms): %f\t", timer->time[i] / (1000 * REP)); }
+void print(Timer *timer, int i, int REP) {
+    printf("Time (ms): %f\t", timer->time[i] / (1000 * REP));
+#if PERF_EVENTS
+    prim_perf_print(i, REP);
+#endif
+}
@@ -40,6 +40,7 @@ The second column of the output file is the matrix profile index.
 #include <omp.h>
 
 #include "mprofile.h"
+#include "../../support/rapl.h"
 
 bool interrupt = false;
 int numThreads, exclusionZone;
@@ -259,6 +260,7 @@ int main(int argc, char* argv[])
   // Creation of time meassure structures
   std::chrono::high_resolution_clock::time_point tprogstart, tstart, tend;
   std::chrono::duration<double> time_elapsed;
+  Energy energy;
 
   // Creation of interrupt handler
   struct sigaction act;
@@ -362,13 +364,18 @@ int main(int argc, char* argv[])
 
   /******************** SCRIMP ********************/
   std::cout << "[>>] Performing STREAMP..." << std::endl;
+  energy_start(&energy, 0, 0);
   tstart = std::chrono::high_resolution_clock::now();
 
   streamp();
 
   tend = std::chrono::high_resolution_clock::now();
+  energy_stop(&energy, 0);
   time_elapsed = tend - tstart;
   std::cout << "[OK] STREAMP Time:            " << std::setprecision(std::numeric_limits<DTYPE>::digits10 + 2) << time_elapsed.count() << " seconds." << std::endl;
+  std::cout << "[OK] STREAMP Energy:          " << std::flush;
+  energy_print(&energy, 0, 1, ProfileLength);
+  printf("\n");
 
   // Save profile to file
   //std::cout << "[>>] Saving Profile..." << std::endl;
@@ -22,6 +22,7 @@
 #include "params.h"
 #include "timer.h"
 #include "prim_results.h"
+#include "xfer_queue.h"
 
 // Define the DPU Binary path as DPU_BINARY here
 #define DPU_BINARY "./bin/ts_dpu"
@@ -133,6 +134,8 @@ int main(int argc, char **argv) {
 	DPU_ASSERT(dpu_alloc(NR_DPUS, NULL, &dpu_set));
 	DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
 	DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
+	xfer_queue_t queue;
+	xfer_queue_init(&queue, dpu_set);
 
 #if ENERGY
 	struct dpu_probe_t probe;
@@ -189,50 +192,25 @@ int main(int argc, char **argv) {
 		if (rep >= p.n_warmup)
 			start(&timer, 1, rep - p.n_warmup);
 		uint32_t i = 0;
+		input_arguments.exclusion_zone = 0;
 
-		DPU_FOREACH(dpu_set, dpu) {
-			input_arguments.exclusion_zone = 0;
-
-			DPU_ASSERT(dpu_copy_to(dpu, "DPU_INPUT_ARGUMENTS", 0, (const void *) &input_arguments, sizeof(input_arguments)));
-			i++;
-		}
+		// Same arguments and query for every DPU, then the slices of the series, means and sigmas,
+		// back to back in MRAM (the queue folds the argument copies into one push and merges the slices)
+		for (i = 0; i < nr_of_dpus; i++)
+			xfer_queue_copy(&queue, DPU_XFER_TO_DPU, i, "DPU_INPUT_ARGUMENTS", 0, &input_arguments, sizeof(input_arguments));
 
-		i = 0;
 		mem_offset = 0;
-		DPU_FOREACH(dpu_set, dpu, i)
-		{
-			DPU_ASSERT(dpu_prepare_xfer(dpu, bufferQ));
-		}
-
-		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, query_length * sizeof(DTYPE), DPU_XFER_DEFAULT));
-
-		i = 0;
+		xfer_queue_push(&queue, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, mem_offset, bufferQ, 0, query_length * sizeof(DTYPE));
 
 		mem_offset += query_length * sizeof(DTYPE);
-		DPU_FOREACH(dpu_set, dpu, i) {
-			DPU_ASSERT(dpu_prepare_xfer(dpu, bufferTS + slice_per_dpu * i));
-		}
-
-		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, mem_offset,(slice_per_dpu + query_length)*sizeof(DTYPE), DPU_XFER_DEFAULT));
+		xfer_queue_push(&queue, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, mem_offset, bufferTS, slice_per_dpu * sizeof(DTYPE), (slice_per_dpu + query_length) * sizeof(DTYPE));
 
 		mem_offset += ((slice_per_dpu + query_length) * sizeof(DTYPE));
-
-		i = 0;
-		DPU_FOREACH(dpu_set, dpu, i) {
-			DPU_ASSERT(dpu_prepare_xfer(dpu, bufferAMean + slice_per_dpu * i));
-		}
-
-		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, mem_offset, (slice_per_dpu + query_length)*sizeof(DTYPE), DPU_XFER_DEFAULT));
-
-		i = 0;
+		xfer_queue_push(&queue, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, mem_offset, bufferAMean, slice_per_dpu * sizeof(DTYPE), (slice_per_dpu + query_length) * sizeof(DTYPE));
 
 		mem_offset += ((slice_per_dpu + query_length) * sizeof(DTYPE));
-
-		DPU_FOREACH(dpu_set, dpu, i) {
-			DPU_ASSERT(dpu_prepare_xfer(dpu, bufferASigma + slice_per_dpu * i));
-		}
-
-		DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, mem_offset, (slice_per_dpu + query_length)*sizeof(DTYPE), DPU_XFER_DEFAULT));
+		xfer_queue_push(&queue, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, mem_offset, bufferASigma, slice_per_dpu * sizeof(DTYPE), (slice_per_dpu + query_length) * sizeof(DTYPE));
+		xfer_queue_flush(&queue);
 
 		if (rep >= p.n_warmup)
 			stop(&timer, 1);
@@ -330,6 +308,13 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)ts_size, (double)nr_of_dpus);
+
+    // Transfers per repetition
+    unsigned int runs = p.n_warmup + p.n_reps;
+    printf("\nTransfers requested\t%lu\tissued\t%lu\tstaged bytes\t%lu\n", (unsigned long)(queue.stats.requested / runs), (unsigned long)(queue.stats.issued / runs), (unsigned long)(queue.stats.staged_bytes / runs));
+    update_csv(RESULTS_FILE, TEST_NAME, "Xfer_requested", (double)queue.stats.requested / runs);
+    update_csv(RESULTS_FILE, TEST_NAME, "Xfer_issued", (double)queue.stats.issued / runs);
 
 #if ENERGY
 	printf("Energy (J): %f J\t", avg_energy);
@@ -342,6 +327,7 @@ int main(int argc, char **argv) {
 		printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] results differ!\n");
 	}
 
+	xfer_queue_free(&queue);
 	DPU_ASSERT(dpu_free(dpu_set));
 
 #if ENERGY
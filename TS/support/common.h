@@ -34,6 +34,11 @@ typedef struct  {
     uint32_t maxIndex;
 }dpu_result_t;
 
+// Host transfer queue merges adjacent transfers (see support/xfer_queue.h)
+#ifndef COALESCE
+#define COALESCE 1
+#endif
+
 #ifndef ENERGY
 #define ENERGY 0
 #endif
@@ -9,6 +9,7 @@
 
 #include <omp.h>
 #include "../../support/timer.h"
+#include "../../support/rapl.h"
 
 #define T int64_t
 
@@ -124,17 +125,23 @@ int main(int argc, char **argv) {
     create_test_file(file_size);
 
     Timer timer;
+    Energy energy;
+    energy_start(&energy, 0, 0);
     start(&timer, 0, 0);
 
     total_count = unique_host(file_size, p.n_threads);
 
     stop(&timer, 0);
+    energy_stop(&energy, 0);
 
     printf("Total count = %d\t", total_count);
 
     printf("Kernel ");
     print(&timer, 0, 1);
     printf("\n");
+    printf("Energy ");
+    energy_print(&energy, 0, 1, file_size);
+    printf("\n");
 
     free(A);
     free(B);
@@ -38,6 +38,42 @@ static unsigned int unique(T *output, T *input){
     return pos;
 }
 
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+#ifdef KOGGE
+// Double buffer for the scan across tasklets
+uint32_t scan_buffer[2][NR_TASKLETS];
+
+// Log-depth (Kogge-Stone) exclusive scan across tasklets
+// The counts are scanned without the duplicated first element, so the offset count of the result is always 0
+// The DPU count is read between the first and the last barrier: the last tasklet updates it
+// after the scan, and before the next scan
+static uint3 kogge_stone_sync(T *output, unsigned int l_count, unsigned int tasklet_id, unsigned int *partial_count){
+    // Pass the last element to the next tasklet
+    if(tasklet_id < NR_TASKLETS - 1)
+        message_value[tasklet_id + 1] = output[l_count - 1];
+    barrier_wait(&my_barrier);
+    *partial_count = message_partial_count;
+    T prev_last = (tasklet_id != 0) ? message_value[tasklet_id] : message_last_from_last;
+    unsigned int offset = (prev_last == output[0])?1:0;
+
+    unsigned int in = 0;
+    scan_buffer[in][tasklet_id] = l_count - offset;
+    barrier_wait(&my_barrier);
+    #pragma unroll
+    for(unsigned int o = 1; o < NR_TASKLETS; o <<= 1){
+        uint32_t value = scan_buffer[in][tasklet_id];
+        if(tasklet_id >= o)
+            value += scan_buffer[in][tasklet_id - o];
+        scan_buffer[1 - in][tasklet_id] = value;
+        in = 1 - in;
+        barrier_wait(&my_barrier);
+    }
+    uint3 result = {scan_buffer[in][tasklet_id] - (l_count - offset), 0, offset};
+    return result;
+}
+#else
 // Handshake with adjacent tasklets
 static uint3 handshake_sync(T *output, unsigned int l_count, unsigned int tasklet_id){
     unsigned int p_count, o_count, offset;
@@ -63,9 +99,7 @@ static uint3 handshake_sync(T *output, unsigned int l_count, unsigned int taskle
     uint3 result = {p_count, o_count, offset}; 
     return result;
 }
-
-// Barrier
-BARRIER_INIT(my_barrier, NR_TASKLETS);
+#endif
 
 extern int main_kernel1(void);
 
@@ -118,11 +152,18 @@ int main_kernel1() {
         // UNI in each tasklet
         unsigned int l_count = unique(cache_B, cache_A); // In-place or out-of-place?
 
+#ifdef KOGGE
+        // Scan across tasklets
+        unsigned int partial_count;
+        uint3 po_count = kogge_stone_sync(cache_B, l_count, tasklet_id, &partial_count);
+#else
         // Sync with adjacent tasklets
         uint3 po_count = handshake_sync(cache_B, l_count, tasklet_id);
+        unsigned int partial_count = message_partial_count;
+#endif
 
         // Write cache to current MRAM block
-        mram_write(&cache_B[po_count.z], (__mram_ptr void*)(mram_base_addr_B + (message_partial_count + po_count.x - po_count.y) * sizeof(T)), l_count * sizeof(T));
+        mram_write(&cache_B[po_count.z], (__mram_ptr void*)(mram_base_addr_B + (partial_count + po_count.x - po_count.y) * sizeof(T)), l_count * sizeof(T));
 
         // First
         if(tasklet_id == 0 && i == 0){
@@ -133,7 +174,7 @@ int main_kernel1() {
         if(tasklet_id == NR_TASKLETS - 1){
             message_last_from_last = cache_B[l_count - 1];
             result->last = cache_B[l_count - 1];
-            result->t_count = message_partial_count + po_count.x + l_count - po_count.y - po_count.z;
+            result->t_count = partial_count + po_count.x + l_count - po_count.y - po_count.z;
             message_partial_count = result->t_count;
         }
 
@@ -0,0 +1,87 @@
+/**
+* @file app_baseline.c
+* @brief Fused element-wise expression on the CPU, same parser and evaluator as the host application
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include <omp.h>
+#include "../../support/timer.h"
+#include "../../support/rapl.h"
+#include "../../support/params.h"
+#include "../../support/expr.h"
+
+/**
+* @brief evaluates the expression; each thread takes a contiguous chunk
+*/
+static void expression_host(expr_t *expr, T **vectors, T *out, unsigned int nr_elements, int t) {
+    omp_set_num_threads(t);
+    #pragma omp parallel
+    {
+        uint64_t chunk = divceil(nr_elements, omp_get_num_threads());
+        uint64_t first = chunk * omp_get_thread_num();
+        if (first < nr_elements)
+            expr_eval(expr, vectors, out, first, first + chunk <= nr_elements ? chunk : nr_elements - first);
+    }
+}
+
+/**
+* @brief Main of the CPU baseline.
+*/
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    static expr_t expr;
+    for (int s = 0; s < p.n_scalars; s++)
+        expr_bind(&expr, p.scalars[s]);
+    expr_parse(&expr, p.expression);
+    printf("Expression: %s\n", expr.src);
+
+    const unsigned int file_size = p.input_size;
+    T *vectors[EXPR_VECTORS];
+    srand(0);
+    for (int v = 0; v < expr.n_inputs; v++) {
+        vectors[v] = (T *) malloc(file_size * sizeof(T));
+        for (unsigned int i = 0; i < file_size; i++)
+            vectors[v][i] = (T) (rand() % 1000);
+    }
+    T *out = (T *) malloc(file_size * sizeof(T));
+
+    Timer timer;
+    Energy energy;
+    for (int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+        if (rep >= p.n_warmup) {
+            energy_start(&energy, 0, rep - p.n_warmup);
+            start(&timer, 0, rep - p.n_warmup);
+        }
+        expression_host(&expr, vectors, out, file_size, p.n_threads);
+        if (rep >= p.n_warmup) {
+            stop(&timer, 0);
+            energy_stop(&energy, 0);
+        }
+    }
+
+    // Every input read once, the output written once
+    double bytes = (double) (expr.n_inputs + 1) * file_size * sizeof(T);
+    printf("Kernel ");
+    print(&timer, 0, p.n_reps);
+    printf("\n");
+    printf("Expression bandwidth (MB/s): %f\n", bytes / (timer.time[0] / p.n_reps));
+    printf("Energy ");
+    energy_print(&energy, 0, p.n_reps, file_size);
+    printf("\n");
+
+    for (int v = 0; v < expr.n_inputs; v++)
+        free(vectors[v]);
+    free(out);
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+* Fused element-wise expressions with multiple tasklets
+* The host sends a small program; every tasklet runs it on each of its MRAM blocks,
+* so each operand is read once and the result written once per block
+*
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <barrier.h>
+
+#include "../support/common.h"
+
+__host dpu_arguments_t DPU_INPUT_ARGUMENTS;
+__host expr_program_t DPU_EXPR_PROGRAM;
+
+// Block-wide operations: the opcode is decoded once per block, not once per element
+static void expr_binary(uint8_t op, T *dst, T *a, T *b, unsigned int l_size) {
+    switch (op) {
+        case OP_ADD: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] + b[i]; break;
+        case OP_SUB: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] - b[i]; break;
+        case OP_MUL: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] * b[i]; break;
+        case OP_MIN: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] < b[i] ? a[i] : b[i]; break;
+        case OP_MAX: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] > b[i] ? a[i] : b[i]; break;
+        default: break;
+    }
+}
+
+static void expr_scalar(uint8_t op, T *dst, T *a, T *b, T s, unsigned int l_size) {
+    switch (op) {
+        case OP_ADDS: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] + s; break;
+        case OP_RSUBS: for (unsigned int i = 0; i < l_size; i++) dst[i] = s - a[i]; break;
+        case OP_MULS: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] * s; break;
+        case OP_MINS: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] < s ? a[i] : s; break;
+        case OP_MAXS: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] > s ? a[i] : s; break;
+        case OP_FMAS: for (unsigned int i = 0; i < l_size; i++) dst[i] = a[i] * s + b[i]; break;
+        default: break;
+    }
+}
+
+// Barrier
+BARRIER_INIT(my_barrier, NR_TASKLETS);
+
+// main
+int main() {
+    unsigned int tasklet_id = me();
+#if PRINT
+    printf("tasklet_id = %u\n", tasklet_id);
+#endif
+    if (tasklet_id == 0){
+        mem_reset(); // Reset the heap
+    }
+    // Barrier
+    barrier_wait(&my_barrier);
+
+    uint32_t input_size_dpu_bytes = DPU_INPUT_ARGUMENTS.size; // Input size per DPU in bytes
+    uint32_t input_size_dpu_bytes_transfer = DPU_INPUT_ARGUMENTS.transfer_size; // Transfer input size per DPU in bytes
+    uint32_t n_ops = DPU_EXPR_PROGRAM.n_ops;
+
+    // Address of the current processing block in MRAM; vector v starts at v * transfer_size
+    uint32_t base_tasklet = tasklet_id << BLOCK_SIZE_LOG2;
+    uint32_t mram_base_addr = (uint32_t)DPU_MRAM_HEAP_POINTER;
+
+    // Initialize the WRAM registers of the program
+    T *regs[EXPR_REGS];
+    for (unsigned int r = 0; r < DPU_EXPR_PROGRAM.n_regs; r++)
+        regs[r] = (T *) mem_alloc(BLOCK_SIZE);
+
+    for(unsigned int byte_index = base_tasklet; byte_index < input_size_dpu_bytes; byte_index += BLOCK_SIZE * NR_TASKLETS){
+
+        // Bound checking
+        uint32_t l_size_bytes = (byte_index + BLOCK_SIZE >= input_size_dpu_bytes) ? (input_size_dpu_bytes - byte_index) : BLOCK_SIZE;
+
+        for (unsigned int k = 0; k < n_ops; k++) {
+            expr_op_t *op = &DPU_EXPR_PROGRAM.ops[k];
+            if (op->op == OP_LOAD)
+                mram_read((__mram_ptr void const*)(mram_base_addr + op->a * input_size_dpu_bytes_transfer + byte_index), regs[op->dst], l_size_bytes);
+            else if (op->op == OP_STORE)
+                mram_write(regs[op->a], (__mram_ptr void*)(mram_base_addr + op->dst * input_size_dpu_bytes_transfer + byte_index), l_size_bytes);
+            else if (op->op < OP_ADDS)
+                expr_binary(op->op, regs[op->dst], regs[op->a], regs[op->b], l_size_bytes >> DIV);
+            else
+                expr_scalar(op->op, regs[op->dst], regs[op->a], regs[op->b], DPU_EXPR_PROGRAM.scalars[op->s], l_size_bytes >> DIV);
+        }
+
+    }
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+/**
+* app.c
+* VA-EXPR Host Application Source File
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <assert.h>
+
+#include "../support/common.h"
+#include "../support/timer.h"
+#include "../support/params.h"
+#include "../support/expr.h"
+#include "../support/prim_results.h"
+
+// Define the DPU Binary path as DPU_BINARY here
+#ifndef DPU_BINARY
+#define DPU_BINARY "./bin/dpu_code"
+#endif
+
+#if ENERGY
+#include <dpu_probe.h>
+#endif
+
+// Create input arrays
+static void read_input(T **vectors, int n_inputs, unsigned int nr_elements) {
+    srand(0);
+    printf("nr_elements\t%u\t", nr_elements);
+    for (int v = 0; v < n_inputs; v++)
+        for (unsigned int i = 0; i < nr_elements; i++)
+            vectors[v][i] = (T) (rand() % 1000);
+}
+
+// Main of the Host Application
+int main(int argc, char **argv) {
+
+    struct Params p = input_params(argc, argv);
+
+    struct dpu_set_t dpu_set, dpu;
+    uint32_t nr_of_dpus;
+
+#if ENERGY
+    struct dpu_probe_t probe;
+    DPU_ASSERT(dpu_probe_init("energy_probe", &probe));
+#endif
+
+    // Expression and its DPU program
+    static expr_t expr;
+    static expr_program_t program;
+    for (int s = 0; s < p.n_scalars; s++)
+        expr_bind(&expr, p.scalars[s]);
+    expr_parse(&expr, p.expression);
+    expr_compile(&expr, &program);
+    printf("Expression: %s\n", expr.src);
+    expr_print_program(&expr, &program);
+
+    // Allocate DPUs and load binary
+    DPU_ASSERT(dpu_alloc(NR_DPUS, NULL, &dpu_set));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY, NULL));
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
+    printf("Allocated %d DPU(s)\n", nr_of_dpus);
+    unsigned int i = 0;
+
+    const unsigned int input_size = p.exp == 0 ? p.input_size * nr_of_dpus : p.input_size; // Total input size (weak or strong scaling)
+    const unsigned int input_size_8bytes =
+        ((input_size * sizeof(T)) % 8) != 0 ? roundup(input_size, 8) : input_size; // Input size per DPU (max.), 8-byte aligned
+    const unsigned int input_size_dpu = divceil(input_size, nr_of_dpus); // Input size per DPU (max.)
+    const unsigned int input_size_dpu_8bytes =
+        ((input_size_dpu * sizeof(T)) % 8) != 0 ? roundup(input_size_dpu, 8) : input_size_dpu; // Input size per DPU (max.), 8-byte aligned
+    assert((uint64_t) expr.n_vectors * input_size_dpu_8bytes * sizeof(T) <= (64 << 20) && "Vectors do not fit in MRAM!");
+
+    // Input/output allocation: one buffer per input vector (a separate output vector stays in MRAM), plus the CPU result
+    T *vectors[EXPR_VECTORS];
+    for (int v = 0; v < expr.n_inputs; v++)
+        vectors[v] = malloc(input_size_dpu_8bytes * nr_of_dpus * sizeof(T));
+    T *C = malloc(input_size_dpu_8bytes * nr_of_dpus * sizeof(T));
+    T *bufferC = malloc(input_size_dpu_8bytes * nr_of_dpus * sizeof(T));
+
+    // Create an input file with arbitrary data
+    read_input(vectors, expr.n_inputs, input_size);
+
+    // Timer declaration
+    Timer timer;
+
+    printf("NR_TASKLETS\t%d\tBL\t%d\n", NR_TASKLETS, BL);
+    assert(program.n_regs <= EXPR_REGS);
+
+    // Loop over main kernel
+    for(int rep = 0; rep < p.n_warmup + p.n_reps; rep++) {
+
+        // Compute output on CPU (performance comparison and verification purposes)
+        if(rep >= p.n_warmup)
+            start(&timer, 0, rep - p.n_warmup);
+        expr_eval(&expr, vectors, C, 0, input_size);
+        if(rep >= p.n_warmup)
+            stop(&timer, 0);
+
+        printf("Load input data\n");
+        if(rep >= p.n_warmup)
+            start(&timer, 1, rep - p.n_warmup);
+        // Input arguments
+        dpu_arguments_t input_arguments[NR_DPUS];
+        for(i=0; i<nr_of_dpus-1; i++) {
+            input_arguments[i].size=input_size_dpu_8bytes * sizeof(T);
+            input_arguments[i].transfer_size=input_size_dpu_8bytes * sizeof(T);
+        }
+        input_arguments[nr_of_dpus-1].size=(input_size_8bytes - input_size_dpu_8bytes * (NR_DPUS-1)) * sizeof(T);
+        input_arguments[nr_of_dpus-1].transfer_size=input_size_dpu_8bytes * sizeof(T);
+
+        // Copy input arguments and the program
+        i = 0;
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, &input_arguments[i]));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(input_arguments[0]), DPU_XFER_DEFAULT));
+        DPU_ASSERT(dpu_broadcast_to(dpu_set, "DPU_EXPR_PROGRAM", 0, &program, sizeof(program), DPU_XFER_DEFAULT));
+
+        // Copy input arrays: input v goes to MRAM vector v
+        for (int v = 0; v < expr.n_inputs; v++) {
+            DPU_FOREACH(dpu_set, dpu, i) {
+                DPU_ASSERT(dpu_prepare_xfer(dpu, vectors[v] + input_size_dpu_8bytes * i));
+            }
+            DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, v * input_size_dpu_8bytes * sizeof(T), input_size_dpu_8bytes * sizeof(T), DPU_XFER_DEFAULT));
+        }
+        if(rep >= p.n_warmup)
+            stop(&timer, 1);
+
+        printf("Run program on DPU(s) \n");
+        // Run DPU kernel
+        if(rep >= p.n_warmup) {
+            start(&timer, 2, rep - p.n_warmup);
+            #if ENERGY
+            DPU_ASSERT(dpu_probe_start(&probe));
+            #endif
+        }
+        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+        if(rep >= p.n_warmup) {
+            stop(&timer, 2);
+            #if ENERGY
+            DPU_ASSERT(dpu_probe_stop(&probe));
+            #endif
+        }
+
+#if PRINT
+        {
+            unsigned int each_dpu = 0;
+            printf("Display DPU Logs\n");
+            DPU_FOREACH (dpu_set, dpu) {
+                printf("DPU#%d:\n", each_dpu);
+                DPU_ASSERT(dpulog_read_for_dpu(dpu.dpu, stdout));
+                each_dpu++;
+            }
+        }
+#endif
+
+        printf("Retrieve results\n");
+        if(rep >= p.n_warmup)
+            start(&timer, 3, rep - p.n_warmup);
+        i = 0;
+        // PARALLEL RETRIEVE TRANSFER
+        DPU_FOREACH(dpu_set, dpu, i) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, bufferC + input_size_dpu_8bytes * i));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, expr.out_vec * input_size_dpu_8bytes * sizeof(T), input_size_dpu_8bytes * sizeof(T), DPU_XFER_DEFAULT));
+        if(rep >= p.n_warmup)
+            stop(&timer, 3);
+
+    }
+
+    // Print timing results
+    printf("CPU ");
+    print(&timer, 0, p.n_reps);
+    printf("CPU-DPU ");
+    print(&timer, 1, p.n_reps);
+    printf("DPU Kernel ");
+    print(&timer, 2, p.n_reps);
+    printf("DPU-CPU ");
+    print(&timer, 3, p.n_reps);
+    printf("\n");
+
+    // Bandwidth of the expression: every input read once, the output written once
+    double mram_bytes = (double) (expr.n_inputs + 1) * input_size * sizeof(T);
+    double mram_mbs = mram_bytes / (prim_timer_ms_avg(&timer, 2, p.n_reps) * 1e3);
+    double cpu_mbs = mram_bytes / (prim_timer_ms_avg(&timer, 0, p.n_reps) * 1e3);
+    printf("Expression bandwidth (MB/s): DPU %f\tCPU %f\t(%d input(s), %u op(s) per block)\n",
+            mram_mbs, cpu_mbs, expr.n_inputs, program.n_ops);
+
+    // update CSV
+#define TEST_NAME "VA-EXPR"
+#define RESULTS_FILE "../prim_results.csv"
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 0, p.n_reps, "CPU");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
+    update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)input_size, (double)nr_of_dpus);
+    update_csv(RESULTS_FILE, TEST_NAME, "Expr_MBs", mram_mbs);
+
+#if ENERGY
+    double energy;
+    DPU_ASSERT(dpu_probe_get(&probe, DPU_ENERGY, DPU_AVERAGE, &energy));
+    printf("DPU Energy (J): %f\t", energy);
+#endif
+
+    // Check output
+    bool status = true;
+    for (i = 0; i < input_size; i++) {
+        if(C[i] != bufferC[i]){
+            status = false;
+#if PRINT
+            printf("%d: %f -- %f\n", i, (double)C[i], (double)bufferC[i]);
+#endif
+        }
+    }
+    if (status) {
+        printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Outputs are equal\n");
+    } else {
+        printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Outputs differ!\n");
+    }
+
+    // Deallocation
+    for (int v = 0; v < expr.n_inputs; v++)
+        free(vectors[v]);
+    free(C);
+    free(bufferC);
+    DPU_ASSERT(dpu_free(dpu_set));
+
+    return status ? 0 : -1;
+}
@@ -0,0 +1,101 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+// Structures used by both the host and the dpu to communicate information
+typedef struct {
+    uint32_t size;
+    uint32_t transfer_size;
+} dpu_arguments_t;
+
+// Transfer size between MRAM and WRAM
+#ifdef BL
+#define BLOCK_SIZE_LOG2 BL
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#else
+#define BLOCK_SIZE_LOG2 8
+#define BLOCK_SIZE (1 << BLOCK_SIZE_LOG2)
+#define BL BLOCK_SIZE_LOG2
+#endif
+
+// Data type
+#ifdef UINT32
+#define T uint32_t
+#define DIV 2 // Shift right to divide by sizeof(T)
+#elif UINT64
+#define T uint64_t
+#define DIV 3 // Shift right to divide by sizeof(T)
+#elif INT32
+#define T int32_t
+#define DIV 2 // Shift right to divide by sizeof(T)
+#elif INT64
+#define T int64_t
+#define DIV 3 // Shift right to divide by sizeof(T)
+#elif FLOAT
+#define T float
+#define DIV 2 // Shift right to divide by sizeof(T)
+#elif DOUBLE
+#define T double
+#define DIV 3 // Shift right to divide by sizeof(T)
+#elif CHAR
+#define T char
+#define DIV 0 // Shift right to divide by sizeof(T)
+#elif SHORT
+#define T short
+#define DIV 1 // Shift right to divide by sizeof(T)
+#endif
+
+// Expression program: a list of block-wide operations on WRAM registers.
+// Every register is one WRAM block per tasklet, so EXPR_REGS * BLOCK_SIZE * NR_TASKLETS
+// bytes of WRAM are needed (32 KB with the defaults).
+#ifndef EXPR_REGS
+#define EXPR_REGS 8
+#endif
+#define EXPR_OPS 32
+#define EXPR_SCALARS 8
+#define EXPR_VECTORS 8 // Vectors resident in MRAM, inputs and output
+
+enum expr_opcodes {
+    OP_LOAD = 0,  // dst <- block of MRAM vector a
+    OP_STORE,     // block of MRAM vector dst <- a
+    OP_ADD,       // dst <- a + b
+    OP_SUB,       // dst <- a - b
+    OP_MUL,       // dst <- a * b
+    OP_MIN,       // dst <- min(a, b)
+    OP_MAX,       // dst <- max(a, b)
+    OP_ADDS,      // dst <- a + s
+    OP_RSUBS,     // dst <- s - a
+    OP_MULS,      // dst <- a * s
+    OP_MINS,      // dst <- min(a, s)
+    OP_MAXS,      // dst <- max(a, s)
+    OP_FMAS,      // dst <- a * s + b
+    nr_expr_opcodes,
+};
+
+typedef struct {
+    uint8_t op;
+    uint8_t dst;
+    uint8_t a;
+    uint8_t b;
+    uint8_t s;    // Index in scalars
+    uint8_t pad[3];
+} expr_op_t;
+
+typedef struct {
+    uint32_t n_ops;
+    uint32_t n_regs;
+    T scalars[EXPR_SCALARS];
+    expr_op_t ops[EXPR_OPS];
+} expr_program_t;
+
+#ifndef ENERGY
+#define ENERGY 0
+#endif
+#define PRINT 0
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+#define divceil(n, m) (((n)-1) / (m) + 1)
+#define roundup(n, m) ((n / m) * m + m)
+#endif
@@ -0,0 +1,383 @@
+#ifndef _EXPR_H_
+#define _EXPR_H_
+
+// Host side of the expression engine, shared by the host application and the CPU baseline:
+//   - expr_parse():   "d = a*x + b*y - c" into a small tree (x and y bound with -s)
+//   - expr_compile(): tree into an expr_program_t for the DPUs
+//   - expr_eval():    tree evaluated directly on the CPU, for reference and verification
+// Grammar: out = expr, with +, -, *, unary -, parentheses, min(e, e) and max(e, e).
+// Names are vectors unless bound as scalars; numbers are scalars of type T.
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define EXPR_NODES 64
+#define EXPR_NAME 16
+#define EXPR_EVAL_BLOCK 256 // Elements per step of expr_eval()
+
+// Named expressions, e.g. the STREAM kernels (-f triad)
+static const char *const EXPR_PRESETS[][2] = {
+    {"add",   "c = a + b"},
+    {"copy",  "c = a"},
+    {"scale", "b = 3 * a"},
+    {"triad", "a = b + 3 * c"},
+    {"axpby", "d = a*x + b*y - c"},
+    {"relu",  "b = max(a, 0)"},
+};
+
+enum expr_node_types { NODE_NUM, NODE_VEC, NODE_ADD, NODE_SUB, NODE_MUL, NODE_MIN, NODE_MAX };
+
+typedef struct {
+    int type;
+    int l, r;      // Children
+    int vec;       // NODE_VEC: input vector
+    T value;       // NODE_NUM
+} expr_node_t;
+
+typedef struct {
+    expr_node_t nodes[EXPR_NODES];
+    int n_nodes;
+    int root;
+    char inputs[EXPR_VECTORS][EXPR_NAME]; // Input vectors, in order of appearance
+    int n_inputs;
+    char output[EXPR_NAME];
+    int out_vec;   // MRAM vector of the result: an input (in place) or n_inputs
+    int n_vectors; // Vectors resident in MRAM
+    const char *src;
+    const char *pos;
+    char names[EXPR_SCALARS][EXPR_NAME]; // Scalars bound with -s
+    T values[EXPR_SCALARS];
+    int n_names;
+} expr_t;
+
+static inline void expr_error(expr_t *e, const char *msg) {
+    fprintf(stderr, "Expression error: %s\n  %s\n  %*s^\n", msg, e->src, (int)(e->pos - e->src), "");
+    exit(1);
+}
+
+// Binds a scalar "name=value" given on the command line
+static inline void expr_bind(expr_t *e, const char *arg) {
+    const char *eq = strchr(arg, '=');
+    if (!eq || eq == arg || eq - arg >= EXPR_NAME || e->n_names == EXPR_SCALARS) {
+        fprintf(stderr, "Invalid scalar binding %s, expected name=value\n", arg);
+        exit(1);
+    }
+    memcpy(e->names[e->n_names], arg, eq - arg);
+    e->names[e->n_names][eq - arg] = '\0';
+    e->values[e->n_names++] = (T) strtod(eq + 1, NULL);
+}
+
+static inline int expr_node(expr_t *e, int type, int l, int r) {
+    if (e->n_nodes == EXPR_NODES)
+        expr_error(e, "too many nodes");
+    expr_node_t *n = &e->nodes[e->n_nodes];
+    n->type = type; n->l = l; n->r = r; n->vec = -1; n->value = 0;
+    return e->n_nodes++;
+}
+
+static inline void expr_skip(expr_t *e) {
+    while (isspace((unsigned char)*e->pos)) e->pos++;
+}
+
+static inline int expr_name(expr_t *e, char *name) {
+    expr_skip(e);
+    int len = 0;
+    while (isalnum((unsigned char)e->pos[len]) || e->pos[len] == '_') len++;
+    if (len == 0 || !isalpha((unsigned char)*e->pos))
+        return 0;
+    if (len >= EXPR_NAME)
+        expr_error(e, "name too long");
+    memcpy(name, e->pos, len);
+    name[len] = '\0';
+    e->pos += len;
+    return 1;
+}
+
+static inline void expr_expect(expr_t *e, char c) {
+    expr_skip(e);
+    if (*e->pos != c) {
+        char msg[32];
+        snprintf(msg, sizeof(msg), "expected '%c'", c);
+        expr_error(e, msg);
+    }
+    e->pos++;
+}
+
+// Constants are folded while parsing, so at most one child of an operation is a number
+static inline T expr_fold(int type, T a, T b) {
+    switch (type) {
+        case NODE_ADD: return a + b;
+        case NODE_SUB: return a - b;
+        case NODE_MUL: return a * b;
+        case NODE_MIN: return a < b ? a : b;
+        default:       return a > b ? a : b;
+    }
+}
+
+static inline int expr_binary_node(expr_t *e, int type, int l, int r) {
+    if (e->nodes[l].type == NODE_NUM && e->nodes[r].type == NODE_NUM) {
+        e->nodes[l].value = expr_fold(type, e->nodes[l].value, e->nodes[r].value);
+        return l;
+    }
+    return expr_node(e, type, l, r);
+}
+
+static inline int expr_sum(expr_t *e);
+
+static inline int expr_primary(expr_t *e) {
+    char name[EXPR_NAME];
+    expr_skip(e);
+    if (*e->pos == '(') {
+        e->pos++;
+        int n = expr_sum(e);
+        expr_expect(e, ')');
+        return n;
+    }
+    if (*e->pos == '-') {
+        e->pos++;
+        int n = expr_primary(e);
+        int m = expr_node(e, NODE_NUM, -1, -1);
+        e->nodes[m].value = (T) -1;
+        return expr_binary_node(e, NODE_MUL, m, n);
+    }
+    if (isdigit((unsigned char)*e->pos) || *e->pos == '.') {
+        char *end;
+        double v = strtod(e->pos, &end);
+        e->pos = end;
+        int n = expr_node(e, NODE_NUM, -1, -1);
+        e->nodes[n].value = (T) v;
+        return n;
+    }
+    if (!expr_name(e, name))
+        expr_error(e, "expected a vector, scalar or number");
+    if (!strcmp(name, "min") || !strcmp(name, "max")) {
+        expr_expect(e, '(');
+        int l = expr_sum(e);
+        expr_expect(e, ',');
+        int r = expr_sum(e);
+        expr_expect(e, ')');
+        return expr_binary_node(e, name[1] == 'i' ? NODE_MIN : NODE_MAX, l, r);
+    }
+    for (int s = 0; s < e->n_names; s++) {
+        if (!strcmp(name, e->names[s])) {
+            int n = expr_node(e, NODE_NUM, -1, -1);
+            e->nodes[n].value = e->values[s];
+            return n;
+        }
+    }
+    int v = 0;
+    while (v < e->n_inputs && strcmp(name, e->inputs[v])) v++;
+    if (v == e->n_inputs) {
+        if (e->n_inputs == EXPR_VECTORS - 1)
+            expr_error(e, "too many input vectors");
+        strcpy(e->inputs[e->n_inputs++], name);
+    }
+    int n = expr_node(e, NODE_VEC, -1, -1);
+    e->nodes[n].vec = v;
+    return n;
+}
+
+static inline int expr_product(expr_t *e) {
+    int n = expr_primary(e);
+    for (expr_skip(e); *e->pos == '*'; expr_skip(e)) {
+        e->pos++;
+        n = expr_binary_node(e, NODE_MUL, n, expr_primary(e));
+    }
+    return n;
+}
+
+static inline int expr_sum(expr_t *e) {
+    int n = expr_product(e);
+    for (expr_skip(e); *e->pos == '+' || *e->pos == '-'; expr_skip(e)) {
+        int type = *e->pos++ == '+' ? NODE_ADD : NODE_SUB;
+        n = expr_binary_node(e, type, n, expr_product(e));
+    }
+    return n;
+}
+
+// Parses "out = expr" (or the name of a preset); scalars must be bound before
+static inline void expr_parse(expr_t *e, const char *src) {
+    for (unsigned int k = 0; k < sizeof(EXPR_PRESETS) / sizeof(EXPR_PRESETS[0]); k++)
+        if (!strcmp(src, EXPR_PRESETS[k][0]))
+            src = EXPR_PRESETS[k][1];
+    e->src = e->pos = src;
+    e->n_nodes = 0;
+    e->n_inputs = 0;
+    if (!expr_name(e, e->output))
+        expr_error(e, "expected the name of the output vector");
+    expr_expect(e, '=');
+    e->root = expr_sum(e);
+    expr_skip(e);
+    if (*e->pos != '\0')
+        expr_error(e, "unexpected character");
+    if (e->nodes[e->root].type == NODE_NUM)
+        expr_error(e, "the expression needs at least one vector");
+
+    e->out_vec = 0;
+    while (e->out_vec < e->n_inputs && strcmp(e->output, e->inputs[e->out_vec])) e->out_vec++;
+    e->n_vectors = e->out_vec == e->n_inputs ? e->n_inputs + 1 : e->n_inputs;
+}
+
+// ---------------------------------------------------------------------------
+// Compilation: inputs are loaded once into registers 0..n_inputs-1,
+// intermediate results use the remaining registers
+
+typedef struct {
+    expr_t *e;
+    expr_program_t *prog;
+    unsigned int busy; // Bitmask of registers in use
+    unsigned int n_scalars;
+} expr_compiler_t;
+
+static inline void expr_emit(expr_compiler_t *c, uint8_t op, int dst, int a, int b, int s) {
+    if (c->prog->n_ops == EXPR_OPS)
+        expr_error(c->e, "the program needs too many operations");
+    expr_op_t *o = &c->prog->ops[c->prog->n_ops++];
+    memset(o, 0, sizeof(*o));
+    o->op = op; o->dst = dst; o->a = a; o->b = b < 0 ? 0 : b; o->s = s < 0 ? 0 : s;
+}
+
+// Releases a temporary register and returns the destination of an operation on a and b
+static inline int expr_dest(expr_compiler_t *c, int a, int b) {
+    int n_in = c->e->n_inputs;
+    if (a >= n_in) c->busy &= ~(1u << a);
+    if (b >= n_in) c->busy &= ~(1u << b);
+    for (int r = n_in; r < EXPR_REGS; r++) {
+        if (!(c->busy & (1u << r))) {
+            c->busy |= 1u << r;
+            if ((unsigned int)r + 1 > c->prog->n_regs) c->prog->n_regs = r + 1;
+            return r;
+        }
+    }
+    expr_error(c->e, "not enough WRAM registers (EXPR_REGS)");
+    return -1;
+}
+
+// Scalar slots are shared by equal values
+static inline int expr_scalar_slot(expr_compiler_t *c, T value) {
+    for (unsigned int s = 0; s < c->n_scalars; s++)
+        if (c->prog->scalars[s] == value)
+            return s;
+    if (c->n_scalars == EXPR_SCALARS)
+        expr_error(c->e, "too many distinct scalars");
+    c->prog->scalars[c->n_scalars] = value;
+    return c->n_scalars++;
+}
+
+static inline int expr_gen(expr_compiler_t *c, int node) {
+    expr_node_t *n = &c->e->nodes[node];
+    if (n->type == NODE_VEC)
+        return n->vec;
+
+    expr_node_t *l = &c->e->nodes[n->l];
+    expr_node_t *r = &c->e->nodes[n->r];
+    // One operand is a number: scalar form of the operation
+    if (l->type == NODE_NUM || r->type == NODE_NUM) {
+        int num_left = l->type == NODE_NUM;
+        T s = num_left ? l->value : r->value;
+        int a = expr_gen(c, num_left ? n->r : n->l);
+        uint8_t op;
+        switch (n->type) {
+            case NODE_ADD: op = OP_ADDS; break;
+            case NODE_SUB: op = num_left ? OP_RSUBS : OP_ADDS; if (!num_left) s = 0 - s; break;
+            case NODE_MUL: op = OP_MULS; break;
+            case NODE_MIN: op = OP_MINS; break;
+            default:       op = OP_MAXS; break;
+        }
+        int slot = expr_scalar_slot(c, s);
+        int dst = expr_dest(c, a, -1);
+        expr_emit(c, op, dst, a, -1, slot);
+        return dst;
+    }
+    // x * s + y, y + x * s and y - x * s are fused
+    if (n->type == NODE_ADD || n->type == NODE_SUB) {
+        for (int side = (n->type == NODE_ADD ? 0 : 1); side < 2; side++) {
+            expr_node_t *m = side == 0 ? l : r;
+            if (m->type != NODE_MUL)
+                continue;
+            expr_node_t *ml = &c->e->nodes[m->l];
+            expr_node_t *mr = &c->e->nodes[m->r];
+            if (ml->type != NODE_NUM && mr->type != NODE_NUM)
+                continue;
+            T s = ml->type == NODE_NUM ? ml->value : mr->value;
+            if (n->type == NODE_SUB) s = 0 - s;
+            int x = expr_gen(c, ml->type == NODE_NUM ? m->r : m->l);
+            int y = expr_gen(c, side == 0 ? n->r : n->l);
+            int slot = expr_scalar_slot(c, s);
+            int dst = expr_dest(c, x, y);
+            expr_emit(c, OP_FMAS, dst, x, y, slot);
+            return dst;
+        }
+    }
+    int a = expr_gen(c, n->l);
+    int b = expr_gen(c, n->r);
+    static const uint8_t ops[] = {0, 0, OP_ADD, OP_SUB, OP_MUL, OP_MIN, OP_MAX};
+    int dst = expr_dest(c, a, b);
+    expr_emit(c, ops[n->type], dst, a, b, -1);
+    return dst;
+}
+
+static inline void expr_compile(expr_t *e, expr_program_t *prog) {
+    expr_compiler_t c = {e, prog, 0, 0};
+    memset(prog, 0, sizeof(*prog));
+    prog->n_regs = e->n_inputs;
+    for (int v = 0; v < e->n_inputs; v++)
+        expr_emit(&c, OP_LOAD, v, v, -1, -1);
+    if (e->n_inputs > EXPR_REGS)
+        expr_error(e, "not enough WRAM registers (EXPR_REGS)");
+    int result = expr_gen(&c, e->root);
+    expr_emit(&c, OP_STORE, e->out_vec, result, -1, -1);
+}
+
+static inline void expr_print_program(expr_t *e, expr_program_t *prog) {
+    static const char *names[] = {"load", "store", "add", "sub", "mul", "min", "max",
+        "adds", "rsubs", "muls", "mins", "maxs", "fmas"};
+    printf("Program (%u ops, %u registers):\n", prog->n_ops, prog->n_regs);
+    for (unsigned int k = 0; k < prog->n_ops; k++) {
+        expr_op_t *o = &prog->ops[k];
+        if (o->op == OP_LOAD)
+            printf("  %-5s r%u <- %s\n", names[o->op], o->dst, e->inputs[o->a]);
+        else if (o->op == OP_STORE)
+            printf("  %-5s %s <- r%u\n", names[o->op], e->output, o->a);
+        else if (o->op < OP_ADDS)
+            printf("  %-5s r%u <- r%u, r%u\n", names[o->op], o->dst, o->a, o->b);
+        else if (o->op == OP_FMAS)
+            printf("  %-5s r%u <- r%u * %g + r%u\n", names[o->op], o->dst, o->a, (double)prog->scalars[o->s], o->b);
+        else
+            printf("  %-5s r%u <- r%u, %g\n", names[o->op], o->dst, o->a, (double)prog->scalars[o->s]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Reference evaluation of the tree, EXPR_EVAL_BLOCK elements at a time
+
+static inline void expr_eval_node(expr_t *e, int node, T **vectors, uint64_t first, unsigned int len, T *out) {
+    expr_node_t *n = &e->nodes[node];
+    if (n->type == NODE_VEC) {
+        memcpy(out, vectors[n->vec] + first, len * sizeof(T));
+        return;
+    }
+    if (n->type == NODE_NUM) {
+        for (unsigned int i = 0; i < len; i++) out[i] = n->value;
+        return;
+    }
+    T rhs[EXPR_EVAL_BLOCK];
+    expr_eval_node(e, n->l, vectors, first, len, out);
+    expr_eval_node(e, n->r, vectors, first, len, rhs);
+    for (unsigned int i = 0; i < len; i++)
+        out[i] = expr_fold(n->type, out[i], rhs[i]);
+}
+
+// Computes out[first .. first + count) from the input vectors
+static inline void expr_eval(expr_t *e, T **vectors, T *out, uint64_t first, uint64_t count) {
+    for (uint64_t i = first; i < first + count; i += EXPR_EVAL_BLOCK) {
+        unsigned int len = first + count - i < EXPR_EVAL_BLOCK ? first + count - i : EXPR_EVAL_BLOCK;
+        expr_eval_node(e, e->root, vectors, i, len, out + i);
+    }
+}
+#endif
@@ -0,0 +1,79 @@
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "common.h"
+
+typedef struct Params {
+    unsigned int   input_size;
+    int   n_warmup;
+    int   n_reps;
+    int   exp;
+    int   n_threads;
+    const char *expression;
+    const char *scalars[EXPR_SCALARS];
+    int   n_scalars;
+}Params;
+
+static void usage() {
+    fprintf(stderr,
+        "\nUsage:  ./program [options]"
+        "\n"
+        "\nGeneral options:"
+        "\n    -h        help"
+        "\n    -w <W>    # of untimed warmup iterations (default=1)"
+        "\n    -e <E>    # of timed repetition iterations (default=3)"
+        "\n    -x <X>    Weak (0) or strong (1) scaling (default=0)"
+        "\n    -t <T>    # of threads (CPU baseline only, default=8)"
+        "\n"
+        "\nBenchmark-specific options:"
+        "\n    -i <I>    input size (default=2621440 elements)"
+        "\n    -f <F>    expression, e.g. \"d = a*x + b*y - c\", or one of the presets"
+        "\n              add, copy, scale, triad, axpby, relu (default=axpby)"
+        "\n    -s <S>    scalar binding name=value, repeatable (axpby default: x=3 and y=2)"
+        "\n");
+}
+
+struct Params input_params(int argc, char **argv) {
+    struct Params p;
+    p.input_size    = 2621440;
+    p.n_warmup      = 1;
+    p.n_reps        = 3;
+    p.exp           = 0;
+    p.n_threads     = 8;
+    p.expression    = "axpby";
+    p.n_scalars     = 0;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hi:w:e:x:t:f:s:")) >= 0) {
+        switch(opt) {
+        case 'h':
+        usage();
+        exit(0);
+        break;
+        case 'i': p.input_size    = atoi(optarg); break;
+        case 'w': p.n_warmup      = atoi(optarg); break;
+        case 'e': p.n_reps        = atoi(optarg); break;
+        case 'x': p.exp           = atoi(optarg); break;
+        case 't': p.n_threads     = atoi(optarg); break;
+        case 'f': p.expression    = optarg; break;
+        case 's':
+            assert(p.n_scalars < EXPR_SCALARS - 2 && "Too many scalars!");
+            p.scalars[p.n_scalars++] = optarg;
+            break;
+        default:
+            fprintf(stderr, "\nUnrecognized option!\n");
+            usage();
+            exit(0);
+        }
+    }
+    // Defaults of the axpby preset, which would otherwise shadow vectors named x and y;
+    // bindings given with -s take precedence
+    if (strcmp(p.expression, "axpby") == 0) {
+        p.scalars[p.n_scalars++] = "x=3";
+        p.scalars[p.n_scalars++] = "y=2";
+    }
+    assert(p.n_threads > 0 && "Invalid # of threads!");
+
+    return p;
+}
+#endif
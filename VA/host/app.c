@@ -17,6 +17,7 @@
 #include "../support/timer.h"
 #include "../support/params.h"
 #include "../support/prim_results.h"
+#include "../support/xfer_queue.h"
 
 // Define the DPU Binary path as DPU_BINARY here
 #ifndef DPU_BINARY
@@ -72,6 +73,8 @@ int main(int argc, char **argv) {
     DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
     printf("Allocated %d DPU(s) %d\n", nr_of_dpus, p.input_size);
     unsigned int i = 0;
+    xfer_queue_t queue;
+    xfer_queue_init(&queue, dpu_set);
 
     const unsigned int input_size = p.exp == 0 ? p.input_size * nr_of_dpus : p.input_size; // Total input size (weak or strong scaling)
     const unsigned int input_size_8bytes = 
@@ -122,22 +125,11 @@ int main(int argc, char **argv) {
         input_arguments[nr_of_dpus-1].transfer_size=input_size_dpu_8bytes * sizeof(T); 
         input_arguments[nr_of_dpus-1].kernel=kernel;
 
-        // Copy input arrays
-        i = 0;
-        DPU_FOREACH(dpu_set, dpu, i) {
-            DPU_ASSERT(dpu_prepare_xfer(dpu, &input_arguments[i]));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, sizeof(input_arguments[0]), DPU_XFER_DEFAULT));
-
-        DPU_FOREACH(dpu_set, dpu, i) {
-            DPU_ASSERT(dpu_prepare_xfer(dpu, bufferA + input_size_dpu_8bytes * i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, input_size_dpu_8bytes * sizeof(T), DPU_XFER_DEFAULT));
- 
-        DPU_FOREACH(dpu_set, dpu, i) {
-            DPU_ASSERT(dpu_prepare_xfer(dpu, bufferB + input_size_dpu_8bytes * i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, input_size_dpu_8bytes * sizeof(T), input_size_dpu_8bytes * sizeof(T), DPU_XFER_DEFAULT));
+        // Copy input arrays (the queue stages A and B of a DPU into one push when they fit in XFER_STAGE_BYTES)
+        xfer_queue_push(&queue, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS", 0, input_arguments, sizeof(input_arguments[0]), sizeof(input_arguments[0]));
+        xfer_queue_push(&queue, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, bufferA, input_size_dpu_8bytes * sizeof(T), input_size_dpu_8bytes * sizeof(T));
+        xfer_queue_push(&queue, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, input_size_dpu_8bytes * sizeof(T), bufferB, input_size_dpu_8bytes * sizeof(T), input_size_dpu_8bytes * sizeof(T));
+        xfer_queue_flush(&queue);
         if(rep >= p.n_warmup)
             stop(&timer, 1);
 
@@ -226,6 +218,13 @@ int main(int argc, char **argv) {
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 1, p.n_reps, "U_C2D");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 3, p.n_reps, "U_D2C");
     update_csv_from_timer(RESULTS_FILE, TEST_NAME, &timer, 2, p.n_reps, "UPMEM");
+    update_csv_run_size(RESULTS_FILE, TEST_NAME, (double)input_size, (double)nr_of_dpus);
+
+    // Transfers per repetition
+    unsigned int runs = p.n_warmup + p.n_reps;
+    printf("\nTransfers requested\t%lu\tissued\t%lu\tstaged bytes\t%lu\n", (unsigned long)(queue.stats.requested / runs), (unsigned long)(queue.stats.issued / runs), (unsigned long)(queue.stats.staged_bytes / runs));
+    update_csv(RESULTS_FILE, TEST_NAME, "Xfer_requested", (double)queue.stats.requested / runs);
+    update_csv(RESULTS_FILE, TEST_NAME, "Xfer_issued", (double)queue.stats.issued / runs);
 
 #if ENERGY
     double energy;
@@ -254,6 +253,7 @@ int main(int argc, char **argv) {
     free(B);
     free(C);
     free(C2);
+    xfer_queue_free(&queue);
     DPU_ASSERT(dpu_free(dpu_set));
 	
     return status ? 0 : -1;
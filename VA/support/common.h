@@ -48,6 +48,11 @@ typedef struct {
 #define DIV 1 // Shift right to divide by sizeof(T)
 #endif
 
+// Host transfer queue merges adjacent transfers (see support/xfer_queue.h)
+#ifndef COALESCE
+#define COALESCE 1
+#endif
+
 #ifndef ENERGY
 #define ENERGY 0
 #endif
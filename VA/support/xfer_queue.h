@@ -0,0 +1,316 @@
+#ifndef _XFER_QUEUE_H_
+#define _XFER_QUEUE_H_
+
+// Host transfer queue: CPU-DPU and DPU-CPU transfers are queued per DPU and issued by
+// xfer_queue_flush(), right before the launch that needs them.
+// With COALESCE=1 the consecutive transfers of a DPU to adjacent offsets of the same symbol are
+// merged into one: directly when their host buffers are contiguous too, through a staging
+// buffer otherwise. The merged transfers of all DPUs with the same symbol, offset and size then
+// go out as a single dpu_push_xfer, and a transfer that no other DPU shares as
+// dpu_copy_to/dpu_copy_from. Broadcasts (the same host buffer for several DPUs) are never staged,
+// that would copy the buffer once per DPU. The other transfers are staged if all of them fit in
+// XFER_STAGE_BYTES, so that every DPU merges the same way and keeps sharing one push; otherwise
+// only the transfers that no other DPU shares are staged, up to XFER_STAGE_BYTES per flush.
+// With COALESCE=0 every queued transfer is issued as it was requested, for comparison.
+// Host buffers are read (or written) at the flush, not when the transfer is queued. The order
+// of the transfers of a DPU is kept; there is no order between DPUs.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dpu.h>
+
+#include "common.h"
+
+// Bytes copied through staging buffers per flush, over all DPUs. A staging copy of 256 KB
+// (malloc and memcpy, cache resident) takes about 10 us on one core, in the order of the fixed
+// cost of the dpu_copy_to calls it saves; larger copies fall out of the cache and cost more
+#ifndef XFER_STAGE_BYTES
+#define XFER_STAGE_BYTES (256 << 10)
+#endif
+
+// Transfer of one DPU
+typedef struct {
+    const char *symbol;
+    uint8_t *host;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t dpu;     // Index in the set, in DPU_FOREACH order
+    uint32_t request; // Queue call that added it
+    dpu_xfer_t dir;
+} xfer_entry_t;
+
+// Merged transfers of one DPU
+typedef struct {
+    const char *symbol;
+    uint8_t *host;    // First host buffer, or the staging buffer
+    uint32_t offset;
+    uint32_t size;
+    uint32_t first;   // Merged entries, in the order of xfer_queue_flush()
+    uint32_t count;
+    uint32_t request;
+    dpu_xfer_t dir;
+    uint8_t staged;
+    uint8_t shared;   // Whether a merged entry is shared with another DPU
+    uint8_t bcast;    // Whether a merged entry is a broadcast
+} xfer_run_t;
+
+typedef struct {
+    uint64_t requested;    // Transfers requested by the application
+    uint64_t issued;       // dpu_push_xfer, dpu_copy_to and dpu_copy_from calls
+    uint64_t bytes;
+    uint64_t staged_bytes; // Copied through staging buffers
+} xfer_stats_t;
+
+typedef struct {
+    struct dpu_set_t set;
+    struct dpu_set_t *dpus;
+    uint32_t nr_dpus;
+    xfer_entry_t *entries;
+    uint32_t n;
+    uint32_t capacity;
+    uint32_t requests;
+    xfer_stats_t stats;
+} xfer_queue_t;
+
+static inline void xfer_queue_init(xfer_queue_t *q, struct dpu_set_t set) {
+    struct dpu_set_t dpu;
+    uint32_t i;
+    memset(q, 0, sizeof(*q));
+    q->set = set;
+    DPU_ASSERT(dpu_get_nr_dpus(set, &q->nr_dpus));
+    q->dpus = malloc(q->nr_dpus * sizeof(struct dpu_set_t));
+    DPU_FOREACH(set, dpu, i) {
+        q->dpus[i] = dpu;
+    }
+}
+
+static inline void xfer_queue_free(xfer_queue_t *q) {
+    free(q->dpus);
+    free(q->entries);
+}
+
+static inline void xfer_queue_add(xfer_queue_t *q, dpu_xfer_t dir, uint32_t dpu, const char *symbol, uint32_t offset, void *host, uint32_t size) {
+    if (size == 0)
+        return;
+    if (q->n == q->capacity) {
+        q->capacity = q->capacity ? 2 * q->capacity : 64;
+        q->entries = realloc(q->entries, q->capacity * sizeof(xfer_entry_t));
+    }
+    xfer_entry_t e = {symbol, (uint8_t *) host, offset, size, dpu, q->requests, dir};
+    q->entries[q->n++] = e;
+}
+
+// Queues a transfer of size bytes between host and symbol + offset of DPU dpu
+static inline void xfer_queue_copy(xfer_queue_t *q, dpu_xfer_t dir, uint32_t dpu, const char *symbol, uint32_t offset, void *host, uint32_t size) {
+    xfer_queue_add(q, dir, dpu, symbol, offset, host, size);
+    q->requests++;
+    q->stats.requested++;
+}
+
+// Queues a transfer of size bytes for every DPU, DPU i from or to host + i * stride (0 broadcasts)
+static inline void xfer_queue_push(xfer_queue_t *q, dpu_xfer_t dir, const char *symbol, uint32_t offset, void *host, size_t stride, uint32_t size) {
+    for (uint32_t i = 0; i < q->nr_dpus; i++)
+        xfer_queue_add(q, dir, i, symbol, offset, (uint8_t *) host + i * stride, size);
+    q->requests++;
+    q->stats.requested++;
+}
+
+// Entry key, sorted to find the entries of different DPUs with the same transfer
+typedef struct {
+    const char *symbol;
+    const uint8_t *host;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t entry;
+    dpu_xfer_t dir;
+} xfer_key_t;
+
+static int xfer_key_cmp(const void *a, const void *b) {
+    const xfer_key_t *x = (const xfer_key_t *) a, *y = (const xfer_key_t *) b;
+    if (x->dir != y->dir)
+        return x->dir < y->dir ? -1 : 1;
+    if (x->offset != y->offset)
+        return x->offset < y->offset ? -1 : 1;
+    if (x->size != y->size)
+        return x->size < y->size ? -1 : 1;
+    return strcmp(x->symbol, y->symbol);
+}
+
+// Same key, then same host buffer
+static int xfer_key_host_cmp(const void *a, const void *b) {
+    const xfer_key_t *x = (const xfer_key_t *) a, *y = (const xfer_key_t *) b;
+    int c = xfer_key_cmp(a, b);
+    if (c != 0 || x->host == y->host)
+        return c;
+    return x->host < y->host ? -1 : 1;
+}
+
+// Marks the entries that another entry transfers with the same symbol, offset and size (shared),
+// and among them those that also have the same host buffer (bcast)
+static inline void xfer_queue_shared(const xfer_queue_t *q, uint8_t *shared, uint8_t *bcast) {
+    xfer_key_t *keys = malloc(q->n * sizeof(xfer_key_t));
+    for (uint32_t e = 0; e < q->n; e++) {
+        xfer_key_t k = {q->entries[e].symbol, q->entries[e].host, q->entries[e].offset, q->entries[e].size, e, q->entries[e].dir};
+        keys[e] = k;
+    }
+    qsort(keys, q->n, sizeof(xfer_key_t), xfer_key_host_cmp);
+    for (uint32_t e = 0; e < q->n; e++) {
+        shared[keys[e].entry] = (e > 0 && xfer_key_cmp(&keys[e - 1], &keys[e]) == 0) ||
+            (e + 1 < q->n && xfer_key_cmp(&keys[e], &keys[e + 1]) == 0);
+        bcast[keys[e].entry] = (e > 0 && xfer_key_host_cmp(&keys[e - 1], &keys[e]) == 0) ||
+            (e + 1 < q->n && xfer_key_host_cmp(&keys[e], &keys[e + 1]) == 0);
+    }
+    free(keys);
+}
+
+// Merges the consecutive entries of every DPU into runs, runs of DPU d are
+// runs[run_start[d]..run_start[d + 1]). Non-contiguous entries are staged if they are no
+// broadcast, and shared ones only with stage_shared, while the staged bytes stay within budget.
+// Returns the staged bytes.
+static inline uint64_t xfer_queue_merge(const xfer_queue_t *q, const uint32_t *start, const uint32_t *order, const uint8_t *shared,
+        const uint8_t *bcast, int stage_shared, uint64_t budget, xfer_run_t *runs, uint32_t *run_start) {
+    uint32_t nr_runs = 0;
+    uint64_t staged_bytes = 0;
+    for (uint32_t d = 0; d < q->nr_dpus; d++) {
+        run_start[d] = nr_runs;
+        uint8_t contiguous = 0;
+        for (uint32_t k = start[d]; k < start[d + 1]; k++) {
+            const xfer_entry_t *e = &q->entries[order[k]];
+            xfer_run_t *r = nr_runs > run_start[d] ? &runs[nr_runs - 1] : NULL;
+            if (COALESCE && r != NULL && r->dir == e->dir && e->offset == r->offset + r->size && strcmp(r->symbol, e->symbol) == 0) {
+                const xfer_entry_t *last = &q->entries[order[k - 1]];
+                contiguous = contiguous && e->host == last->host + last->size;
+                uint64_t stage = (r->staged ? 0 : r->size) + e->size;
+                int stageable = !r->bcast && !bcast[order[k]] && (stage_shared || (!r->shared && !shared[order[k]]));
+                if (contiguous || (stageable && staged_bytes + stage <= budget)) {
+                    if (!contiguous)
+                        staged_bytes += stage;
+                    r->size += e->size;
+                    r->count++;
+                    r->staged = !contiguous;
+                    r->shared |= shared[order[k]];
+                    r->bcast |= bcast[order[k]];
+                    continue;
+                }
+            }
+            xfer_run_t s = {e->symbol, e->host, e->offset, e->size, k, 1, e->request, e->dir, 0, shared[order[k]], bcast[order[k]]};
+            runs[nr_runs++] = s;
+            contiguous = 1;
+        }
+    }
+    run_start[q->nr_dpus] = nr_runs;
+    return staged_bytes;
+}
+
+// Whether run r of a DPU and run s of another one can share a dpu_push_xfer
+static inline int xfer_run_match(const xfer_run_t *r, const xfer_run_t *s) {
+    return r->dir == s->dir && r->offset == s->offset && r->size == s->size &&
+        (COALESCE || r->request == s->request) && strcmp(r->symbol, s->symbol) == 0;
+}
+
+// Issues and empties the queue
+static inline void xfer_queue_flush(xfer_queue_t *q) {
+    if (q->n == 0)
+        return;
+
+    // Entries of every DPU, in queue order
+    uint32_t *start = calloc(q->nr_dpus + 1, sizeof(uint32_t));
+    uint32_t *order = malloc(q->n * sizeof(uint32_t));
+    for (uint32_t e = 0; e < q->n; e++)
+        start[q->entries[e].dpu + 1]++;
+    for (uint32_t d = 0; d < q->nr_dpus; d++)
+        start[d + 1] += start[d];
+    uint32_t *next = malloc(q->nr_dpus * sizeof(uint32_t));
+    memcpy(next, start, q->nr_dpus * sizeof(uint32_t));
+    for (uint32_t e = 0; e < q->n; e++)
+        order[next[q->entries[e].dpu]++] = e;
+
+    uint8_t *shared = malloc(q->n);
+    uint8_t *bcast = malloc(q->n);
+    xfer_queue_shared(q, shared, bcast);
+
+    // Merge the consecutive entries of every DPU, staging the shared ones only if all of them fit
+    xfer_run_t *runs = malloc(q->n * sizeof(xfer_run_t));
+    uint32_t *run_start = malloc((q->nr_dpus + 1) * sizeof(uint32_t));
+    if (xfer_queue_merge(q, start, order, shared, bcast, 1, UINT64_MAX, runs, run_start) > XFER_STAGE_BYTES)
+        xfer_queue_merge(q, start, order, shared, bcast, 0, XFER_STAGE_BYTES, runs, run_start);
+    uint32_t nr_runs = run_start[q->nr_dpus];
+
+    // Gather the staged CPU-DPU runs
+    for (uint32_t r = 0; r < nr_runs; r++) {
+        if (!runs[r].staged)
+            continue;
+        uint8_t *buffer = malloc(runs[r].size);
+        if (runs[r].dir == DPU_XFER_TO_DPU) {
+            for (uint32_t k = runs[r].first, pos = 0; k < runs[r].first + runs[r].count; k++) {
+                const xfer_entry_t *e = &q->entries[order[k]];
+                memcpy(buffer + pos, e->host, e->size);
+                pos += e->size;
+            }
+        }
+        runs[r].host = buffer;
+        q->stats.staged_bytes += runs[r].size;
+    }
+
+    // Issue the pending run that was requested first, in one dpu_push_xfer with the next runs of
+    // all the DPUs that match it (with COALESCE=0, the other DPUs of the same request)
+    for (uint32_t d = 0; d < q->nr_dpus; d++)
+        next[d] = run_start[d];
+    for (;;) {
+        uint32_t d = q->nr_dpus;
+        for (uint32_t o = 0; o < q->nr_dpus; o++)
+            if (next[o] < run_start[o + 1] && (d == q->nr_dpus || runs[next[o]].request < runs[next[d]].request))
+                d = o;
+        if (d == q->nr_dpus)
+            break;
+        const xfer_run_t *r = &runs[next[d]];
+        uint32_t sharing = 0;
+        for (uint32_t o = 0; o < q->nr_dpus; o++)
+            sharing += next[o] < run_start[o + 1] && xfer_run_match(r, &runs[next[o]]);
+        if (sharing == 1) {
+            if (r->dir == DPU_XFER_TO_DPU)
+                DPU_ASSERT(dpu_copy_to(q->dpus[d], r->symbol, r->offset, r->host, r->size));
+            else
+                DPU_ASSERT(dpu_copy_from(q->dpus[d], r->symbol, r->offset, r->host, r->size));
+            next[d]++;
+        } else {
+            for (uint32_t o = 0; o < q->nr_dpus; o++) {
+                if (o != d && next[o] < run_start[o + 1] && xfer_run_match(r, &runs[next[o]])) {
+                    DPU_ASSERT(dpu_prepare_xfer(q->dpus[o], runs[next[o]].host));
+                    next[o]++;
+                }
+            }
+            DPU_ASSERT(dpu_prepare_xfer(q->dpus[d], r->host));
+            next[d]++;
+            DPU_ASSERT(dpu_push_xfer(q->set, r->dir, r->symbol, r->offset, r->size, DPU_XFER_DEFAULT));
+        }
+        q->stats.issued++;
+        q->stats.bytes += (uint64_t) sharing * r->size;
+    }
+
+    // Scatter the staged DPU-CPU runs
+    for (uint32_t r = 0; r < nr_runs; r++) {
+        if (!runs[r].staged)
+            continue;
+        if (runs[r].dir == DPU_XFER_FROM_DPU) {
+            for (uint32_t k = runs[r].first, pos = 0; k < runs[r].first + runs[r].count; k++) {
+                const xfer_entry_t *e = &q->entries[order[k]];
+                memcpy(e->host, runs[r].host + pos, e->size);
+                pos += e->size;
+            }
+        }
+        free(runs[r].host);
+    }
+
+    free(shared);
+    free(bcast);
+    free(start);
+    free(order);
+    free(next);
+    free(runs);
+    free(run_start);
+    q->n = 0;
+}
+
+#endif
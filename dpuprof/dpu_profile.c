@@ -0,0 +1,118 @@
+/*
+* DPU runtime of the profiling mode (run_profile.py)
+* The benchmark is compiled with -fsanitize-coverage=bb,no-prune,trace-pc, so every basic
+* block starts with a call to __sanitizer_cov_trace_pc. The hook counts the executions of
+* the block and charges the cycles since the tasklet's previous hook to the previous block.
+* Every tasklet has its own counters in MRAM, which the host merges, so the hook only takes
+* a mutex to insert a new block address or once per launch.
+* This file is compiled without the instrumentation.
+*
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <defs.h>
+#include <mram.h>
+#include <mutex.h>
+#include <perfcounter.h>
+
+#include "prof_common.h"
+
+// Distinct basic blocks, a power of two (4 bytes of WRAM and PROF_TASKLETS * 16 bytes of MRAM per block)
+#ifndef PROF_SLOTS
+#define PROF_SLOTS 256
+#endif
+_Static_assert(PROF_SLOTS <= PROF_MAX_SLOTS && (PROF_SLOTS & (PROF_SLOTS - 1)) == 0, "PROF_SLOTS: power of two up to PROF_MAX_SLOTS");
+
+__host uint32_t prof_pcs[PROF_SLOTS]; // Return address of the hook, i.e., start of the block
+__mram_noinit prof_count_t prof_counts[PROF_TASKLETS][PROF_SLOTS]; // Cleared by the host after every load
+__host prof_dma_t prof_dma[PROF_TASKLETS];
+__host uint64_t prof_launch;                 // Bumped by the host before every launch
+__host uint64_t prof_dropped[PROF_TASKLETS]; // Block executions lost to a full table
+
+static uint64_t seen_launch[PROF_TASKLETS];
+static uint64_t config_launch;
+static int last_slot[PROF_TASKLETS];
+static perfcounter_t last_time[PROF_TASKLETS];
+static prof_count_t count_buffer[PROF_TASKLETS];
+
+MUTEX_INIT(prof_mutex);
+
+// Open addressing on the block address, -1 if the table is full. Addresses are never
+// removed, so a slot that holds pc can be found without the mutex.
+static int prof_find(uint32_t pc) {
+    uint32_t h = (pc * 0x9E3779B1u) >> 16;
+    for (unsigned int probe = 0; probe < PROF_SLOTS; probe++) {
+        unsigned int s = (h + probe) & (PROF_SLOTS - 1);
+        uint32_t p = prof_pcs[s];
+        if (p == 0) {
+            mutex_lock(prof_mutex);
+            if (prof_pcs[s] == 0)
+                prof_pcs[s] = pc;
+            p = prof_pcs[s];
+            mutex_unlock(prof_mutex);
+        }
+        if (p == pc)
+            return s;
+    }
+    return -1;
+}
+
+void __sanitizer_cov_trace_pc(void) {
+    uint32_t pc = (uint32_t) __builtin_return_address(0);
+    unsigned int t = me();
+    perfcounter_t now = perfcounter_get();
+    prof_count_t *c = &count_buffer[t];
+
+    if (seen_launch[t] != prof_launch) { // First block of the tasklet in a launch
+        seen_launch[t] = prof_launch;
+        last_slot[t] = -1;
+        // Kernels that configure the counter themselves reset it, which only loses one interval per tasklet
+        mutex_lock(prof_mutex);
+        if (config_launch != prof_launch) {
+            config_launch = prof_launch;
+            perfcounter_config(COUNT_CYCLES, false);
+        }
+        mutex_unlock(prof_mutex);
+        now = perfcounter_get();
+    }
+    if (last_slot[t] >= 0 && now >= last_time[t]) {
+        mram_read(&prof_counts[t][last_slot[t]], c, sizeof(prof_count_t));
+        c->cycles += now - last_time[t];
+        mram_write(c, &prof_counts[t][last_slot[t]], sizeof(prof_count_t));
+    }
+    int s = prof_find(pc);
+    if (s >= 0) {
+        mram_read(&prof_counts[t][s], c, sizeof(prof_count_t));
+        c->execs++;
+        mram_write(c, &prof_counts[t][s], sizeof(prof_count_t));
+    } else {
+        prof_dropped[t]++;
+    }
+    last_slot[t] = s;
+
+    // The hook itself is not charged to the block
+    last_time[t] = perfcounter_get();
+}
+
+void prof_mram_read(const __mram_ptr void *from, void *to, unsigned int nb_of_bytes) {
+    prof_dma_t *d = &prof_dma[me()];
+    perfcounter_t start = perfcounter_get();
+    mram_read(from, to, nb_of_bytes);
+    perfcounter_t end = perfcounter_get();
+    d->reads++;
+    d->read_bytes += nb_of_bytes;
+    if (end >= start)
+        d->cycles += end - start;
+}
+
+void prof_mram_write(const void *from, __mram_ptr void *to, unsigned int nb_of_bytes) {
+    prof_dma_t *d = &prof_dma[me()];
+    perfcounter_t start = perfcounter_get();
+    mram_write(from, to, nb_of_bytes);
+    perfcounter_t end = perfcounter_get();
+    d->writes++;
+    d->write_bytes += nb_of_bytes;
+    if (end >= start)
+        d->cycles += end - start;
+}
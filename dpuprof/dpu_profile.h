@@ -0,0 +1,15 @@
+#ifndef _DPU_PROFILE_H_
+#define _DPU_PROFILE_H_
+
+// Force-included (-include) into every DPU source of a benchmark built by run_profile.py:
+// mram_read and mram_write go through the counting wrappers of dpu_profile.c.
+// Transfers issued by seqread or by direct __mram_ptr accesses are not counted.
+
+#include <mram.h>
+
+void prof_mram_read(const __mram_ptr void *from, void *to, unsigned int nb_of_bytes);
+void prof_mram_write(const void *from, __mram_ptr void *to, unsigned int nb_of_bytes);
+
+#define mram_read(from, to, nb_of_bytes) prof_mram_read((from), (to), (nb_of_bytes))
+#define mram_write(from, to, nb_of_bytes) prof_mram_write((from), (to), (nb_of_bytes))
+#endif
@@ -0,0 +1,255 @@
+/**
+* host_profile.c
+* LD_PRELOAD shim of the DPU profiling mode (run_profile.py)
+*
+* Allocations go to the simulator backend (DPUPROF_BACKEND, default "simulator"; "hw"
+* keeps the caller's profile). Every launch bumps prof_launch on the DPUs, and the
+* block and transfer counters of dpu_profile.c are read back, and the tasklets merged,
+* before a set is reloaded or freed. The totals are written to DPUPROF_OUT (default
+* dpuprof.tsv) at exit.
+*
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <dlfcn.h>
+#include <dpu.h>
+
+#include "prof_common.h"
+
+// Executions and cycles of one block over all tasklets
+typedef struct {
+    uint32_t pc;
+    uint64_t execs;
+    uint64_t cycles;
+} prof_block_t;
+
+// Totals of one DPU binary over all its DPUs and launches
+typedef struct {
+    char path[PATH_MAX];
+    uint32_t n_blocks;
+    prof_block_t blocks[PROF_MAX_SLOTS];
+    uint64_t dma[PROF_TASKLETS][5];
+    uint64_t dropped;
+    uint32_t nr_dpus;
+} prof_binary_t;
+
+#define MAX_BINARIES 8
+#define MAX_SETS 32
+
+static prof_binary_t *binaries[MAX_BINARIES];
+static unsigned int n_binaries;
+
+// Live DPU sets and the binary they run
+static struct {
+    struct dpu_set_t set;
+    struct dpu_program_t *program;
+    int binary;
+} sets[MAX_SETS];
+static unsigned int n_sets;
+
+static uint64_t launches;
+
+static dpu_error_t (*real_alloc)(uint32_t, const char *, struct dpu_set_t *);
+static dpu_error_t (*real_alloc_ranks)(uint32_t, const char *, struct dpu_set_t *);
+static dpu_error_t (*real_load)(struct dpu_set_t, const char *, struct dpu_program_t **);
+static dpu_error_t (*real_launch)(struct dpu_set_t, dpu_launch_policy_t);
+static dpu_error_t (*real_free)(struct dpu_set_t);
+
+static void *next(const char *name) {
+    void *f = dlsym(RTLD_NEXT, name);
+    if (f == NULL) {
+        fprintf(stderr, "dpuprof: %s not found\n", name);
+        abort();
+    }
+    return f;
+}
+
+// Profile string of the allocation: the backend first, then the caller's properties
+static const char *profile_of(const char *profile, char *buffer, size_t size) {
+    const char *backend = getenv("DPUPROF_BACKEND");
+    if (backend == NULL)
+        backend = "simulator";
+    if (strcmp(backend, "hw") == 0)
+        return profile;
+    snprintf(buffer, size, "backend=%s%s%s", backend, profile && *profile ? "," : "", profile ? profile : "");
+    return buffer;
+}
+
+static int find_set(struct dpu_set_t set) {
+    for (unsigned int s = 0; s < n_sets; s++)
+        if (memcmp(&sets[s].set, &set, sizeof(set)) == 0)
+            return s;
+    return -1;
+}
+
+static int find_binary(const char *binary) {
+    char path[PATH_MAX];
+    if (realpath(binary, path) == NULL)
+        snprintf(path, sizeof(path), "%s", binary);
+    for (unsigned int b = 0; b < n_binaries; b++)
+        if (strcmp(binaries[b]->path, path) == 0)
+            return b;
+    if (n_binaries == MAX_BINARIES)
+        return -1;
+    prof_binary_t *p = calloc(1, sizeof(prof_binary_t));
+    snprintf(p->path, sizeof(p->path), "%s", path);
+    binaries[n_binaries] = p;
+    return n_binaries++;
+}
+
+static void add_block(prof_binary_t *p, uint32_t pc, uint64_t execs, uint64_t cycles) {
+    for (uint32_t i = 0; i < p->n_blocks; i++) {
+        if (p->blocks[i].pc == pc) {
+            p->blocks[i].execs += execs;
+            p->blocks[i].cycles += cycles;
+            return;
+        }
+    }
+    if (p->n_blocks < PROF_MAX_SLOTS)
+        p->blocks[p->n_blocks++] = (prof_block_t) {pc, execs, cycles};
+    else
+        p->dropped += execs;
+}
+
+// Reads the counters of every DPU of a set and merges the tasklets. Binaries built without
+// the profiling runtime have no prof_pcs symbol and are skipped.
+static void collect(int s) {
+    if (s < 0 || sets[s].binary < 0 || sets[s].program == NULL)
+        return;
+    prof_binary_t *p = binaries[sets[s].binary];
+    // The table size is the one the runtime was built with (DPUPROF_SLOTS)
+    struct dpu_symbol_t symbol;
+    if (dpu_get_symbol(sets[s].program, "prof_pcs", &symbol) != DPU_OK)
+        return;
+    uint32_t n = symbol.size / sizeof(uint32_t);
+    if (n > PROF_MAX_SLOTS) {
+        fprintf(stderr, "dpuprof: %u block slots, more than PROF_MAX_SLOTS\n", n);
+        return;
+    }
+
+    struct dpu_set_t dpu;
+    static uint32_t pcs[PROF_MAX_SLOTS];
+    static prof_count_t counts[PROF_TASKLETS * PROF_MAX_SLOTS];
+    prof_dma_t dma[PROF_TASKLETS];
+    uint64_t dropped[PROF_TASKLETS];
+    DPU_FOREACH(sets[s].set, dpu) {
+        if (dpu_copy_from(dpu, "prof_pcs", 0, pcs, n * sizeof(uint32_t)) != DPU_OK ||
+            dpu_copy_from(dpu, "prof_counts", 0, counts, PROF_TASKLETS * n * sizeof(prof_count_t)) != DPU_OK ||
+            dpu_copy_from(dpu, "prof_dma", 0, dma, sizeof(dma)) != DPU_OK ||
+            dpu_copy_from(dpu, "prof_dropped", 0, dropped, sizeof(dropped)) != DPU_OK)
+            return;
+        for (uint32_t i = 0; i < n; i++) {
+            if (pcs[i] == 0)
+                continue;
+            uint64_t execs = 0, cycles = 0;
+            for (unsigned int t = 0; t < PROF_TASKLETS; t++) {
+                execs += counts[(uint64_t) t * n + i].execs;
+                cycles += counts[(uint64_t) t * n + i].cycles;
+            }
+            add_block(p, pcs[i], execs, cycles);
+        }
+        for (unsigned int t = 0; t < PROF_TASKLETS; t++) {
+            p->dma[t][0] += dma[t].reads;
+            p->dma[t][1] += dma[t].writes;
+            p->dma[t][2] += dma[t].read_bytes;
+            p->dma[t][3] += dma[t].write_bytes;
+            p->dma[t][4] += dma[t].cycles;
+            p->dropped += dropped[t];
+        }
+        p->nr_dpus++;
+    }
+}
+
+// The block counters are in __mram_noinit and start as zeros only after this
+static void clear_counts(int s) {
+    struct dpu_symbol_t symbol;
+    if (s < 0 || sets[s].program == NULL || dpu_get_symbol(sets[s].program, "prof_counts", &symbol) != DPU_OK)
+        return;
+    void *zeros = calloc(1, symbol.size);
+    dpu_broadcast_to(sets[s].set, "prof_counts", 0, zeros, symbol.size, DPU_XFER_DEFAULT);
+    free(zeros);
+}
+
+dpu_error_t dpu_alloc(uint32_t nr_dpus, const char *profile, struct dpu_set_t *dpu_set) {
+    char buffer[1024];
+    if (real_alloc == NULL)
+        real_alloc = next("dpu_alloc");
+    return real_alloc(nr_dpus, profile_of(profile, buffer, sizeof(buffer)), dpu_set);
+}
+
+dpu_error_t dpu_alloc_ranks(uint32_t nr_ranks, const char *profile, struct dpu_set_t *dpu_set) {
+    char buffer[1024];
+    if (real_alloc_ranks == NULL)
+        real_alloc_ranks = next("dpu_alloc_ranks");
+    return real_alloc_ranks(nr_ranks, profile_of(profile, buffer, sizeof(buffer)), dpu_set);
+}
+
+dpu_error_t dpu_load(struct dpu_set_t dpu_set, const char *binary_path, struct dpu_program_t **program) {
+    if (real_load == NULL)
+        real_load = next("dpu_load");
+    int s = find_set(dpu_set);
+    collect(s); // Loading resets the counters
+    if (s < 0 && n_sets < MAX_SETS) {
+        s = n_sets++;
+        sets[s].set = dpu_set;
+    }
+    // The program is needed to size prof_blocks, also when the caller does not want it
+    struct dpu_program_t *loaded = NULL;
+    dpu_error_t status = real_load(dpu_set, binary_path, &loaded);
+    if (program != NULL)
+        *program = loaded;
+    if (s >= 0) {
+        sets[s].program = status == DPU_OK ? loaded : NULL;
+        sets[s].binary = find_binary(binary_path);
+        clear_counts(s);
+    }
+    return status;
+}
+
+dpu_error_t dpu_launch(struct dpu_set_t dpu_set, dpu_launch_policy_t policy) {
+    if (real_launch == NULL)
+        real_launch = next("dpu_launch");
+    uint64_t launch = ++launches;
+    dpu_broadcast_to(dpu_set, "prof_launch", 0, &launch, sizeof(launch), DPU_XFER_DEFAULT);
+    return real_launch(dpu_set, policy);
+}
+
+dpu_error_t dpu_free(struct dpu_set_t dpu_set) {
+    if (real_free == NULL)
+        real_free = next("dpu_free");
+    int s = find_set(dpu_set);
+    if (s >= 0) {
+        collect(s);
+        sets[s] = sets[--n_sets];
+    }
+    return real_free(dpu_set);
+}
+
+__attribute__((destructor)) static void dpuprof_write(void) {
+    // Sets that were never freed
+    while (n_sets > 0) {
+        collect(n_sets - 1);
+        n_sets--;
+    }
+    const char *out = getenv("DPUPROF_OUT");
+    FILE *f = fopen(out ? out : "dpuprof.tsv", "w");
+    if (f == NULL)
+        return;
+    fprintf(f, "launches\t%lu\n", (unsigned long) launches);
+    for (unsigned int b = 0; b < n_binaries; b++) {
+        prof_binary_t *p = binaries[b];
+        fprintf(f, "binary\t%s\t%u\t%lu\n", p->path, p->nr_dpus, (unsigned long) p->dropped);
+        for (uint32_t i = 0; i < p->n_blocks; i++)
+            fprintf(f, "block\t%s\t%u\t%lu\t%lu\n", p->path, p->blocks[i].pc, (unsigned long) p->blocks[i].execs, (unsigned long) p->blocks[i].cycles);
+        for (unsigned int t = 0; t < PROF_TASKLETS; t++)
+            if (p->dma[t][0] + p->dma[t][1] > 0)
+                fprintf(f, "dma\t%s\t%u\t%lu\t%lu\t%lu\t%lu\t%lu\n", p->path, t, (unsigned long) p->dma[t][0], (unsigned long) p->dma[t][1],
+                    (unsigned long) p->dma[t][2], (unsigned long) p->dma[t][3], (unsigned long) p->dma[t][4]);
+        free(p);
+    }
+    fclose(f);
+}
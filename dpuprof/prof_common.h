@@ -0,0 +1,26 @@
+#ifndef _PROF_COMMON_H_
+#define _PROF_COMMON_H_
+
+// Counter layout shared by the DPU runtime (dpu_profile.c), the host shim (host_profile.c)
+// and run_profile.py, which reads PROF_MAX_SLOTS from here
+
+#include <stdint.h>
+
+// Largest table of distinct basic blocks (PROF_SLOTS of the runtime, --slots of run_profile.py)
+#define PROF_MAX_SLOTS 4096
+#define PROF_TASKLETS 24 // Hardware threads of a DPU
+
+// Executions and cycles of one block and one tasklet, in MRAM
+typedef struct {
+    uint64_t execs;
+    uint64_t cycles;
+} prof_count_t;
+
+typedef struct {
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t read_bytes;
+    uint32_t write_bytes;
+    uint64_t cycles; // Cycles spent in mram_read/mram_write
+} prof_dma_t;
+#endif
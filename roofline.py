@@ -0,0 +1,341 @@
+#!/usr/bin/env python3
+"""
+Roofline report for the PrIM workloads.
+
+The roofs are the per-DPU ceilings measured by the microbenchmarks:
+  - MRAM bandwidth: Microbenchmarks/STREAM (run.sh -> profile/{op}_{dpus}_tl{k}_MRAM.txt)
+  - Arithmetic throughput: Microbenchmarks/Arithmetic-Throughput (profile/{OP}_{TYPE}_tl{k}.txt)
+  - Host link (optional): Microbenchmarks/CPU-DPU (profile/{dpus}_tl1_TR{k}_i{n}.txt)
+The best configuration of every profile (usually 11+ tasklets) is taken as the peak.
+
+Each workload declares in WORKLOADS how many MRAM bytes, host-DPU bytes and operations
+it needs per element. The measured time, element count and number of DPUs are read from
+prim_results.csv (columns UPMEM, U_C2D, U_D2C, Elements, DPUs written by the host apps).
+
+Usage:
+  python3 roofline.py [--csv prim_results.csv] [--out roofline.csv] [--plot roofline.png]
+"""
+from __future__ import annotations
+
+import argparse
+import csv
+import re
+import sys
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+
+# ---------------------------
+# Workload declarations
+# ---------------------------
+# Per element, with the default data types of each Makefile:
+#   mram:  bytes read and written in MRAM by the kernel(s)
+#   host:  bytes transferred CPU-DPU plus DPU-CPU
+#   ops:   arithmetic operations, bounded by the Arithmetic-Throughput result of `roof`
+# The values are estimates from the DPU code (WRAM reuse, partial writes and the
+# fixed cost of launches are ignored); adjust them when a kernel changes.
+TS_QUERY_LENGTH = 256  # Default -m of TS
+
+WORKLOADS: Dict[str, dict] = {
+    # Element: one vector entry; A and B read, C written (INT32)
+    "VA": dict(mram=12, host=12, ops=1, roof=("ADD", "INT32")),
+    # Default expression d = a*x + b*y - c: three inputs read, one output written, MUL + FMA + SUB
+    "VA-EXPR": dict(mram=16, host=16, ops=4, roof=("MUL", "INT32")),
+    # Element: one matrix entry; row and vector chunks read, MUL + ADD (UINT32)
+    "GEMV": dict(mram=8, host=4, ops=2, roof=("MUL", "UINT32")),
+    # Element: one weight of one layer, as GEMV
+    "MLP": dict(mram=8, host=4, ops=2, roof=("MUL", "UINT32")),
+    # Element: one pixel; bin index is a multiplication and a shift, then an increment
+    "HST-S": dict(mram=4, host=4, ops=2, roof=("MUL", "UINT32")),
+    "HST-L": dict(mram=4, host=4, ops=2, roof=("MUL", "UINT32")),
+    # Element: one INT64 value
+    "RED": dict(mram=8, host=8, ops=1, roof=("ADD", "INT64")),
+    # Reduce (A read) + scan (A read, C written)
+    "SCAN-RSS": dict(mram=24, host=16, ops=2, roof=("ADD", "INT64")),
+    # Scan (A read, C written) + add (C read and written)
+    "SCAN-SSA": dict(mram=32, host=16, ops=2, roof=("ADD", "INT64")),
+    # Element: one INT64 value, about half of them are written back
+    "SEL": dict(mram=12, host=12, ops=1, roof=("SUB", "INT64")),
+    "UNI": dict(mram=12, host=12, ops=1, roof=("SUB", "INT64")),
+    # Element: one INT64 value; step 2 and step 3 read and write every tile
+    "TRNS": dict(mram=32, host=16, ops=0, roof=None),
+    # Element: one query; ~21 probes of 8 bytes into the 2M-entry sorted array
+    "BS": dict(mram=176, host=16, ops=21, roof=("SUB", "INT64")),
+    # Element: one query; query read, one 64-byte bucket (a second one for ~13% of the
+    # queries and for misses), value written; two 32-bit hashes and the slot compares
+    "HT": dict(mram=90, host=16, ops=16, roof=("MUL", "UINT32")),
+    # Element: one k-mer of the reads; its packed base is read by the 4 DPUs of a group and
+    # the cache misses almost always, so one 64-byte bucket is read and one entry written;
+    # the 4 DPUs hash it with 3 MULs each. Most k-mers of a group are distinct at the
+    # default coverage, so about one 16-byte entry comes back per k-mer
+    "KMER": dict(mram=82, host=17, ops=12, roof=("MUL", "UINT32")),
+    # Element: one query-vector pair; the 128 int8 entries of a vector are read once per
+    # batch of 8 queries, MUL + ADD per entry; the queries and top-k lists moved per pair
+    # are negligible (16384 vectors per DPU over 64 DPUs)
+    "KNN": dict(mram=16, host=0.013, ops=256, roof=("MUL", "INT32")),
+    # Element: one lookup; index and 64 FLOAT row entries read, the partial sum of its bag
+    # (~0.8 per lookup with 32 lookups per bag over 64 DPUs) written and sent back
+    "SLS": dict(mram=270, host=215, ops=64, roof=("ADD", "FLOAT")),
+    # Element: one operand word of a query; 8 bytes read and one 64-bit AND/OR/ANDNOT, with
+    # popcounts (the default output) only the queries and the counts move per launch
+    "BITMAP": dict(mram=8, host=0, ops=1, roof=("ADD", "INT64")),
+    # Element: one nonzero; value, column index and gathered x entry, MUL + ADD (FLOAT)
+    "SpMV": dict(mram=12, host=8, ops=2, roof=("MUL", "FLOAT")),
+    # Element: one edge; neighbor index and visited bitmap word
+    "BFS": dict(mram=8, host=4, ops=2, roof=("ADD", "UINT32")),
+    # Element: one score cell; reference read, score written, 3-way max of 2 sums
+    "NW": dict(mram=12, host=12, ops=5, roof=("ADD", "INT32")),
+    # Element: one score cell; the row stays in WRAM, 2 bits of traceback direction are
+    # written, sequences and CIGARs cross the host link once per pair (~1000x1000 pairs)
+    "NW-BATCH": dict(mram=0.25, host=0.01, ops=5, roof=("ADD", "INT32")),
+    # Element: one position of the series; dot product with the query (INT32)
+    "TS": dict(mram=56, host=4, ops=2 * TS_QUERY_LENGTH, roof=("MUL", "INT32")),
+}
+
+# Bytes per element of each STREAM kernel (T = uint64_t)
+STREAM_BYTES = {"copy": 16, "copyw": 16, "scale": 16, "add": 24, "triad": 24}
+
+RE_NR_ELEMENTS = re.compile(r"nr_elements\s+(\d+)")
+RE_CYCLES = re.compile(r"DPU cycles\s*=\s*([0-9.eE+-]+)\s*cc")
+RE_KERNEL_MS = re.compile(r"DPU Kernel Time \(ms\):\s*([0-9.eE+-]+)")
+RE_C2D_BW = re.compile(r"CPU-DPU Bandwidth \(GB/s\):\s*([0-9.eE+-]+)")
+RE_D2C_BW = re.compile(r"DPU-CPU Bandwidth \(GB/s\):\s*([0-9.eE+-]+)")
+
+
+# ---------------------------
+# Microbenchmark profiles
+# ---------------------------
+def profile_seconds(text: str, freq_mhz: float) -> Optional[float]:
+    """Kernel time from the DPU cycles (preferred) or the host-side kernel time."""
+    m = RE_CYCLES.search(text)
+    if m and float(m.group(1)) > 0:
+        return float(m.group(1)) / (freq_mhz * 1e6)
+    m = RE_KERNEL_MS.search(text)
+    if m and float(m.group(1)) > 0:
+        return float(m.group(1)) / 1e3
+    return None
+
+
+def stream_peak(profile_dir: Path, freq_mhz: float) -> Tuple[Optional[float], str]:
+    """Best MRAM bandwidth per DPU in MB/s over all STREAM kernels and tasklet counts."""
+    best, where = None, ""
+    for p in sorted(profile_dir.glob("*_MRAM.txt")):
+        m = re.fullmatch(r"(\w+?)_(\d+)_tl(\d+)_MRAM\.txt", p.name)
+        if not m or m.group(1) not in STREAM_BYTES:
+            continue
+        text = p.read_text(errors="replace")
+        n = RE_NR_ELEMENTS.search(text)
+        secs = profile_seconds(text, freq_mhz)
+        if not n or not secs:
+            continue
+        dpus = int(m.group(2))
+        mbs = STREAM_BYTES[m.group(1)] * int(n.group(1)) / dpus / secs / 1e6
+        if best is None or mbs > best:
+            best, where = mbs, p.name
+    return best, where
+
+
+def arithmetic_peaks(profile_dir: Path, freq_mhz: float) -> Dict[Tuple[str, str], float]:
+    """Best MOPS per DPU for every (OP, TYPE) over all tasklet counts."""
+    peaks: Dict[Tuple[str, str], float] = {}
+    for p in sorted(profile_dir.glob("*_tl*.txt")):
+        m = re.fullmatch(r"([A-Z]+)_([A-Z0-9]+)_tl(\d+)\.txt", p.name)
+        if not m:
+            continue
+        text = p.read_text(errors="replace")
+        n = RE_NR_ELEMENTS.search(text)
+        secs = profile_seconds(text, freq_mhz)
+        if not n or not secs:
+            continue
+        key = (m.group(1), m.group(2))
+        mops = int(n.group(1)) / secs / 1e6  # One operation per element, 1 DPU
+        peaks[key] = max(peaks.get(key, 0.0), mops)
+    return peaks
+
+
+def host_peak(profile_dir: Path) -> Optional[float]:
+    """Best parallel (PUSH) CPU-DPU + DPU-CPU bandwidth in GB/s, as the mean of both directions."""
+    best = None
+    for p in sorted(profile_dir.glob("*_TRPUSH_*.txt")):
+        text = p.read_text(errors="replace")
+        c2d, d2c = RE_C2D_BW.search(text), RE_D2C_BW.search(text)
+        if not c2d or not d2c:
+            continue
+        gbs = (float(c2d.group(1)) + float(d2c.group(1))) / 2
+        if best is None or gbs > best:
+            best = gbs
+    return best
+
+
+# ---------------------------
+# Report
+# ---------------------------
+def read_results(path: Path) -> Dict[str, Dict[str, str]]:
+    with path.open(newline="") as f:
+        return {row["Test"]: row for row in csv.DictReader(f) if row.get("Test")}
+
+
+def as_float(row: Dict[str, str], col: str) -> Optional[float]:
+    try:
+        v = float(row.get(col) or "")
+    except ValueError:
+        return None
+    return v if v > 0 else None
+
+
+def roofline_rows(results: Dict[str, Dict[str, str]], peak_bw: Optional[float],
+                  peak_ops: Dict[Tuple[str, str], float], peak_host: Optional[float]) -> List[dict]:
+    rows = []
+    for test, w in WORKLOADS.items():
+        row = results.get(test)
+        if row is None:
+            continue
+        ms, elements, dpus = as_float(row, "UPMEM"), as_float(row, "Elements"), as_float(row, "DPUs")
+        if ms is None or elements is None or dpus is None:
+            print(f"[SKIP] {test}: needs UPMEM, Elements and DPUs in the results (rerun the benchmark)")
+            continue
+        secs = ms / 1e3
+        per_dpu = elements / dpus
+        r = dict(Test=test, Elements=int(elements), DPUs=int(dpus))
+        r["AI"] = w["ops"] / w["mram"]
+        r["MRAM_MBs"] = w["mram"] * per_dpu / secs / 1e6
+        r["MOPS"] = w["ops"] * per_dpu / secs / 1e6
+        r["BW_frac"] = r["MRAM_MBs"] / peak_bw if peak_bw else None
+
+        # Attainable throughput: min(compute roof, AI * bandwidth roof)
+        ops_roof = peak_ops.get(w["roof"]) if w["roof"] else None
+        if w["ops"] == 0:
+            r["Roof_MOPS"], r["Bound"] = None, "memory"
+            r["Roof_frac"] = r["BW_frac"]
+        elif ops_roof is not None and peak_bw:
+            mem_roof = r["AI"] * peak_bw
+            r["Roof_MOPS"] = min(ops_roof, mem_roof)
+            r["Bound"] = "memory" if mem_roof < ops_roof else "compute"
+            r["Roof_frac"] = r["MOPS"] / r["Roof_MOPS"]
+        else:
+            r["Roof_MOPS"] = r["Roof_frac"] = r["Bound"] = None
+
+        xfer_ms = (as_float(row, "U_C2D") or 0.0) + (as_float(row, "U_D2C") or 0.0)
+        r["Host_GBs"] = w["host"] * elements / (xfer_ms / 1e3) / 1e9 if xfer_ms > 0 else None
+        r["Host_frac"] = r["Host_GBs"] / peak_host if r["Host_GBs"] and peak_host else None
+        rows.append(r)
+    return rows
+
+
+COLUMNS = ["Test", "Elements", "DPUs", "AI", "MOPS", "Roof_MOPS", "Roof_frac", "Bound",
+           "MRAM_MBs", "BW_frac", "Host_GBs", "Host_frac"]
+
+
+def fmt(v) -> str:
+    if v is None:
+        return "n/a"
+    if isinstance(v, float):
+        return f"{v:.3f}"
+    return str(v)
+
+
+def print_table(rows: List[dict]) -> None:
+    widths = [max(len(c), *(len(fmt(r.get(c))) for r in rows)) for c in COLUMNS]
+    print("  ".join(c.rjust(w) for c, w in zip(COLUMNS, widths)))
+    for r in rows:
+        print("  ".join(fmt(r.get(c)).rjust(w) for c, w in zip(COLUMNS, widths)))
+
+
+def write_csv(path: Path, rows: List[dict]) -> None:
+    with path.open("w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(COLUMNS)
+        for r in rows:
+            writer.writerow(["" if r.get(c) is None else fmt(r.get(c)) for c in COLUMNS])
+
+
+def plot(path: Path, rows: List[dict], peak_bw: float, peak_ops: Dict[Tuple[str, str], float]) -> None:
+    try:
+        import matplotlib
+        matplotlib.use("Agg")
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print("[WARN] matplotlib is not installed, no plot written")
+        return
+    points = [r for r in rows if r["AI"] > 0]
+    if not points:
+        return
+    lo = min(r["AI"] for r in points) / 4
+    hi = max(r["AI"] for r in points) * 4
+    fig, ax = plt.subplots(figsize=(8, 6))
+    ax.plot([lo, hi], [lo * peak_bw, hi * peak_bw], "k-", label=f"MRAM {peak_bw:.0f} MB/s")
+    for (op, ty), mops in sorted(peak_ops.items()):
+        if any(WORKLOADS[r["Test"]]["roof"] == (op, ty) for r in points):
+            ax.axhline(mops, linestyle="--", linewidth=0.8, label=f"{op} {ty} {mops:.1f} MOPS")
+    for r in points:
+        ax.plot(r["AI"], r["MOPS"], "o")
+        ax.annotate(r["Test"], (r["AI"], r["MOPS"]), textcoords="offset points", xytext=(4, 4), fontsize=8)
+    ax.set_xscale("log")
+    ax.set_yscale("log")
+    ax.set_xlabel("Operational intensity (operations / MRAM byte)")
+    ax.set_ylabel("Throughput per DPU (MOPS)")
+    ax.legend(fontsize=7)
+    ax.grid(True, which="both", linewidth=0.3)
+    fig.tight_layout()
+    fig.savefig(path, dpi=150)
+    print(f"Plot written to {path}")
+
+
+# ---------------------------
+# Main
+# ---------------------------
+def main() -> None:
+    root = Path(__file__).resolve().parent
+    micro = root / "Microbenchmarks"
+    ap = argparse.ArgumentParser(description="Roofline report of the PrIM workloads")
+    ap.add_argument("--csv", default=str(root / "prim_results.csv"), help="results written by the host apps")
+    ap.add_argument("--stream", default=str(micro / "STREAM" / "profile"), help="STREAM profile directory")
+    ap.add_argument("--arith", default=str(micro / "Arithmetic-Throughput" / "profile"),
+                    help="Arithmetic-Throughput profile directory")
+    ap.add_argument("--cpu-dpu", default=str(micro / "CPU-DPU" / "profile"), help="CPU-DPU profile directory")
+    ap.add_argument("--freq-mhz", type=float, default=350.0, help="DPU clock to convert cycles to time")
+    ap.add_argument("--peak-bw", type=float, help="override the MRAM roof (MB/s per DPU)")
+    ap.add_argument("--peak-ops", action="append", default=[], metavar="OP_TYPE=MOPS",
+                    help="override a compute roof, e.g. ADD_INT32=58 (repeatable)")
+    ap.add_argument("--host-bw", type=float, help="override the host-DPU roof (GB/s)")
+    ap.add_argument("--out", default="roofline.csv", help="output table")
+    ap.add_argument("--plot", help="write a roofline chart (PNG, needs matplotlib)")
+    args = ap.parse_args()
+
+    peak_bw, bw_src = stream_peak(Path(args.stream), args.freq_mhz)
+    if args.peak_bw:
+        peak_bw, bw_src = args.peak_bw, "--peak-bw"
+    peak_ops = arithmetic_peaks(Path(args.arith), args.freq_mhz)
+    for spec in args.peak_ops:
+        key, _, value = spec.partition("=")
+        op, _, ty = key.partition("_")
+        if not value or not ty:
+            raise SystemExit(f"Bad --peak-ops value: {spec}")
+        peak_ops[(op.upper(), ty.upper())] = float(value)
+    peak_host = args.host_bw if args.host_bw else host_peak(Path(args.cpu_dpu))
+
+    print(f"MRAM roof: {fmt(peak_bw)} MB/s per DPU ({bw_src or 'no STREAM profile found'})")
+    needed = sorted({w["roof"] for w in WORKLOADS.values() if w["roof"]})
+    for key in needed:
+        print(f"{key[0]} {key[1]} roof: {fmt(peak_ops.get(key))} MOPS per DPU")
+    print(f"Host roof: {fmt(peak_host)} GB/s")
+    print()
+
+    csv_path = Path(args.csv)
+    if not csv_path.exists():
+        raise SystemExit(f"Results file not found: {csv_path}")
+    rows = roofline_rows(read_results(csv_path), peak_bw, peak_ops, peak_host)
+    if not rows:
+        raise SystemExit("No workload with complete results")
+    print_table(rows)
+    write_csv(Path(args.out), rows)
+    print(f"\nTable written to {args.out}")
+    if args.plot:
+        if peak_bw:
+            plot(Path(args.plot), rows, peak_bw, peak_ops)
+        else:
+            print("[WARN] No MRAM roof, no plot written")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+"""
+Compressed-column inputs: raw versus COMPRESS=1 builds of RED, SEL, SCAN-SSA and HST-S.
+
+Every benchmark is built twice (COMPRESS=0 and COMPRESS=1, support/codec.h) and both
+binaries run on the same input for every data distribution (-d, HST-S uses its image).
+The host encodes the input column per WRAM block with frame-of-reference, delta or run
+length plus bit-packing, inside the CPU-DPU timer; the DPU kernels decode every block
+before computing. Reported per benchmark and distribution:
+  - ratio: raw bytes over encoded bytes, summed over the DPUs (the push pads every DPU to the
+    largest encoding, so the bytes actually transferred can be higher)
+  - decode cycles: slowest DPU, mean over its tasklets, and their share of kernel cycles
+  - speedup: end-to-end time (every timer except CPU) of the raw build over the compressed one
+
+Outputs (logs/codec_<timestamp>/):
+  - <bench>.<compress>.make.log, <bench>.<compress>.d<dist>.run.log
+  - codec.csv: one row per benchmark and distribution
+
+Usage:
+  python3 run_codec.py [--dpus 64] [--tasklets N] [--codec 0] [--dists 0 1 2 3] [RED SEL ...]
+"""
+from __future__ import annotations
+
+import argparse
+import csv
+import re
+import subprocess
+import sys
+from datetime import datetime
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from run_prim import pick_host_binary
+
+
+# ---------------------------
+# Codec config
+# ---------------------------
+# make_vars: extra Makefile variables (NR_DPUS and NR_TASKLETS come from the command line)
+# args:      host arguments of both builds
+# dists:     whether the benchmark takes the -d distributions of codec_input()
+CODEC_RUNS: Dict[str, dict] = {
+    "RED": dict(args=[], dists=True),
+    "SEL": dict(args=[], dists=True),
+    "SCAN-SSA": dict(args=[], dists=True),
+    "HST-S": dict(args=[], dists=False),
+}
+
+DIST_NAMES = ["default", "narrow", "sorted", "runs"]
+CODEC_CSV = "codec.csv"
+CSV_HEADER = ["Test", "Distribution", "Ratio", "Blocks", "Decode_cycles", "Decode_share",
+              "Raw_ms", "Compressed_ms", "Speedup"]
+
+TIME_RE = re.compile(r"^\s*(.*?)\s*Time \(ms\):\s*([-+0-9.eE]+)")
+RATIO_RE = re.compile(r"^Compression ratio\t([0-9.]+)\tBlocks RAW/FOR/DELTA/RLE\t(\S+)", re.M)
+DECODE_RE = re.compile(r"^Decode cycles\t([0-9.]+)\tDecode share\t([0-9.]+)%", re.M)
+
+
+# ---------------------------
+# Build and run
+# ---------------------------
+def build(bench_dir: Path, make_vars: Dict[str, str]) -> Tuple[bool, str]:
+    # -B: COMPRESS is not part of the object file names
+    cmd = ["make", "-B"] + [f"{k}={v}" for k, v in make_vars.items()]
+    proc = subprocess.run(cmd, cwd=str(bench_dir), stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    return proc.returncode == 0, proc.stdout or ""
+
+
+def run(bench_dir: Path, cmd: List[str], timeout: int) -> Tuple[Optional[int], str]:
+    try:
+        proc = subprocess.run(cmd, cwd=str(bench_dir), stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                              text=True, timeout=timeout)
+        return proc.returncode, proc.stdout or ""
+    except subprocess.TimeoutExpired as e:
+        out = e.stdout.decode(errors="replace") if isinstance(e.stdout, bytes) else (e.stdout or "")
+        return None, out
+
+
+def end_to_end_ms(output: str) -> Optional[float]:
+    """Sum of the timers of the last report, without the CPU baseline."""
+    total = None
+    for line in output.splitlines():
+        if "Time (ms):" not in line:
+            continue
+        times = [TIME_RE.match(field) for field in line.split("\t")]
+        times = [(m.group(1), float(m.group(2))) for m in times if m]
+        if any(label == "CPU-DPU" for label, _ in times):
+            total = sum(t for label, t in times if label != "CPU")
+    return total
+
+
+def fmt(x: Optional[float], digits: int = 2) -> str:
+    return "" if x is None else f"{x:.{digits}f}"
+
+
+# ---------------------------
+# Main
+# ---------------------------
+def main() -> None:
+    root = Path(__file__).resolve().parent
+    ap = argparse.ArgumentParser(description="Compression ratio, decode cycles and end-to-end speedup of COMPRESS=1")
+    ap.add_argument("benchmarks", nargs="*", help=f"subset of: {' '.join(CODEC_RUNS)}")
+    ap.add_argument("--dpus", type=int, default=64, help="NR_DPUS of both builds (default: 64)")
+    ap.add_argument("--tasklets", type=int, help="NR_TASKLETS of both builds (default: the Makefile's)")
+    ap.add_argument("--codec", type=int, default=0, help="-c of the compressed runs (0 = smallest per block)")
+    ap.add_argument("--dists", type=int, nargs="+", default=[0, 1, 2, 3],
+                    help="-d distributions: 0 = default, 1 = narrow, 2 = sorted, 3 = runs")
+    ap.add_argument("--timeout", type=int, default=3600, help="seconds per run")
+    args = ap.parse_args()
+
+    selected = args.benchmarks or list(CODEC_RUNS)
+    unknown = [b for b in selected if b not in CODEC_RUNS]
+    if unknown:
+        raise SystemExit(f"Unknown benchmark(s): {' '.join(unknown)}")
+    if any(not 0 <= d < len(DIST_NAMES) for d in args.dists):
+        raise SystemExit(f"--dists must be in 0..{len(DIST_NAMES) - 1}")
+
+    logdir = root / "logs" / datetime.now().strftime("codec_%Y%m%d_%H%M%S")
+    logdir.mkdir(parents=True, exist_ok=True)
+    make_vars = {"NR_DPUS": str(args.dpus)}
+    if args.tasklets:
+        make_vars["NR_TASKLETS"] = str(args.tasklets)
+
+    print(f"Root     : {root}")
+    print(f"Logs     : {logdir}")
+    print(f"DPUs     : {args.dpus}, codec {args.codec}")
+    print()
+
+    rows: List[dict] = []
+    failed: List[Tuple[str, str]] = []
+    for bench in selected:
+        spec = CODEC_RUNS[bench]
+        bench_dir = root / bench
+        dists = args.dists if spec["dists"] else [0]
+        # outputs[compress][dist]
+        outputs: Dict[int, Dict[int, str]] = {0: {}, 1: {}}
+        try:
+            for compress in (0, 1):
+                ok, out = build(bench_dir, dict(make_vars, COMPRESS=str(compress)))
+                (logdir / f"{bench}.{compress}.make.log").write_text(out, encoding="utf-8", errors="replace")
+                if not ok:
+                    failed.append((bench, f"make COMPRESS={compress} failed"))
+                    print(f"[FAIL] {bench}: make COMPRESS={compress} failed")
+                    break
+                host_bin = pick_host_binary(bench_dir)
+                if host_bin is None:
+                    failed.append((bench, "no host binary found"))
+                    print(f"[FAIL] {bench}: no runnable host binary found under {bench}/bin/")
+                    break
+                for d in dists:
+                    cmd = [str(host_bin)] + spec["args"]
+                    if spec["dists"]:
+                        cmd += ["-d", str(d)]
+                    if compress:
+                        cmd += ["-c", str(args.codec)]
+                    print(f"==> Running {bench} COMPRESS={compress}: {' '.join(cmd[1:])}")
+                    rc, out = run(bench_dir, cmd, args.timeout)
+                    run_log = logdir / f"{bench}.{compress}.d{d}.run.log"
+                    run_log.write_text(out, encoding="utf-8", errors="replace")
+                    if rc != 0 or "Outputs are equal" not in out:
+                        reason = "timeout" if rc is None else (f"rc={rc}" if rc else "wrong output")
+                        failed.append((f"{bench} -d {d}", reason))
+                        print(f"[FAIL] {bench}: {reason} (see {run_log})")
+                        continue
+                    outputs[compress][d] = out
+        finally:
+            # A later normal run must not pick up the COMPRESS=1 binaries
+            subprocess.run(["make", "clean"], cwd=str(bench_dir),
+                           stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+        for d in dists:
+            if d not in outputs[0] or d not in outputs[1]:
+                continue
+            ratio = RATIO_RE.search(outputs[1][d])
+            decode = DECODE_RE.search(outputs[1][d])
+            raw_ms = end_to_end_ms(outputs[0][d])
+            compressed_ms = end_to_end_ms(outputs[1][d])
+            speedup = raw_ms / compressed_ms if raw_ms and compressed_ms else None
+            rows.append({
+                "Test": bench,
+                "Distribution": DIST_NAMES[d] if spec["dists"] else "image",
+                "Ratio": ratio.group(1) if ratio else "",
+                "Blocks": ratio.group(2) if ratio else "",
+                "Decode_cycles": decode.group(1) if decode else "",
+                "Decode_share": decode.group(2) if decode else "",
+                "Raw_ms": fmt(raw_ms, 4),
+                "Compressed_ms": fmt(compressed_ms, 4),
+                "Speedup": fmt(speedup),
+            })
+
+    if rows:
+        csv_path = logdir / CODEC_CSV
+        with csv_path.open("w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=CSV_HEADER)
+            writer.writeheader()
+            writer.writerows(rows)
+        print(f"\n{'Test':<10}{'Distribution':<14}{'Ratio':>8}{'Decode cycles':>16}{'Share %':>9}"
+              f"{'Raw ms':>12}{'Comp. ms':>12}{'Speedup':>9}")
+        for r in rows:
+            print(f"{r['Test']:<10}{r['Distribution']:<14}{r['Ratio']:>8}{r['Decode_cycles']:>16}"
+                  f"{r['Decode_share']:>9}{r['Raw_ms']:>12}{r['Compressed_ms']:>12}{r['Speedup']:>9}")
+        print(f"\nResults written to {csv_path}")
+
+    if failed:
+        print("Failed or skipped:")
+        for b, why in failed:
+            print(f"  - {b}: {why}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
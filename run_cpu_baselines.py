@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""
+Thread-scaling sweep of the CPU baselines (*/baselines/cpu).
+
+Every baseline is built with its own Makefile and run once per thread count (and
+--runs times per count, keeping the fastest run). Threads are pinned to the first
+N cores with taskset and OMP_PROC_BIND=close (--pin spread only sets OMP_PROC_BIND,
+--pin none leaves placement to the OS).
+
+Outputs:
+  - cpu_baselines.csv: one row per run (Test, Threads, Run, Time_ms, Pinning)
+  - prim_results.csv: columns CPU_<threads> (fastest run of each thread count),
+    CPU_best and CPU_best_threads for every baseline; the CPU column (single-threaded
+    host reference of each PrIM app) is left untouched
+
+Usage:
+  python3 run_cpu_baselines.py [--threads 1,2,4,8] [--runs 3] [--no-make] [VA SEL ...]
+"""
+from __future__ import annotations
+
+import argparse
+import csv
+import os
+import re
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+from typing import Dict, List, Optional
+
+
+# ---------------------------
+# Baseline config
+# ---------------------------
+# threads: "flag" passes -t N, "arg" appends N to the arguments, "env" relies on OMP_NUM_THREADS
+# time:    regexes whose first matches are summed (ms unless scale says otherwise)
+# needs:   input files (relative to the baseline directory) without which the run is skipped
+RE_KERNEL_MS = r"Kernel Time \(ms\):\s*([0-9.eE+-]+)"
+RE_KERNEL_BARE_MS = r"(?m)^Kernel\s+([0-9.eE+-]+)"  # print() of the GEMV/MLP timers has no label
+
+BASELINES: Dict[str, dict] = {
+    "BFS": dict(bin="bfs", args=["-v", "1", "-f", "../../data/loc-gowalla"], threads="env",
+                time=[r"Elapsed time:\s*([0-9.eE+-]+) ms"], needs=["../../data/loc-gowalla"]),
+    "BITMAP": dict(bin="bitmap", args=["-w", "0", "-e", "1"], threads="flag", time=[RE_KERNEL_MS]),
+    "BS": dict(bin="bs_omp", args=["2048576", "16777216"], threads="env",
+               time=[r"Execution time:\s*([0-9.eE+-]+)\s*ms"]),
+    "GEMV": dict(bin="gemv", args=[], threads="env", time=[RE_KERNEL_BARE_MS]),
+    "HST-S": dict(bin="hist", args=[], threads="flag", time=[RE_KERNEL_MS],
+                  needs=["../../input/image_VanHateren.iml"]),
+    "HT": dict(bin="ht", args=["-w", "0", "-e", "1"], threads="flag", time=[RE_KERNEL_MS]),
+    "KMER": dict(bin="kmer", args=["-w", "0", "-e", "1"], threads="flag", time=[RE_KERNEL_MS]),
+    "KNN": dict(bin="knn", args=["-w", "0", "-e", "1"], threads="flag", time=[RE_KERNEL_MS]),
+    "MLP": dict(bin="mlp_openmp", args=[], threads="env", time=[RE_KERNEL_BARE_MS]),
+    "NW": dict(bin="needle", args=["2048", "10"], threads="arg",
+               time=[r"Total time:\s*([0-9.eE+-]+) seconds"], scale=1e3, make_target="needle"),
+    "NW-BATCH": dict(bin="nw_batch", args=["-w", "0", "-e", "1"], threads="flag", time=[RE_KERNEL_MS]),
+    "RED": dict(bin="red", args=[], threads="flag", time=[RE_KERNEL_MS], make_env={"TYPE": "UINT64"}),
+    "SCAN-RSS": dict(bin="scan", args=[], threads="flag", time=[RE_KERNEL_MS], make_env={"TYPE": "UINT64"}),
+    "SEL": dict(bin="sel", args=[], threads="flag", time=[RE_KERNEL_MS]),
+    "SLS": dict(bin="sls", args=["-w", "0", "-e", "1"], threads="flag", time=[RE_KERNEL_MS]),
+    "SpMV": dict(bin="spmv", args=["-v", "1", "-f", "../../data/bcsstk30.mtx"], threads="env",
+                 time=[r"Elapsed time:\s*([0-9.eE+-]+) ms"], needs=["../../data/bcsstk30.mtx"]),
+    "TRNS": dict(bin="trns", args=["-w", "0", "-r", "1", "-m", "16", "-n", "8", "-o", "4096", "-p", "64"],
+                 threads="flag", time=[rf"Step {s} Time \(ms\):\s*([0-9.eE+-]+)" for s in (1, 2, 3)]),
+    "TS": dict(bin="streamp_openmp", args=["inputs/randomlist33M.txt", "256"], threads="env",
+               time=[r"STREAMP Time:\s*([0-9.eE+-]+) seconds"], scale=1e3, needs=["inputs/randomlist33M.txt"]),
+    "UNI": dict(bin="uni", args=[], threads="flag", time=[RE_KERNEL_MS]),
+    "VA": dict(bin="va", args=[], threads="flag", time=[RE_KERNEL_MS]),
+    "VA-EXPR": dict(bin="va_expr", args=[], threads="flag", time=[RE_KERNEL_MS]),
+}
+
+RUNS_CSV = "cpu_baselines.csv"
+RESULTS_CSV = "prim_results.csv"
+
+
+# ---------------------------
+# Helpers
+# ---------------------------
+def default_threads() -> List[int]:
+    n = os.cpu_count() or 1
+    counts, t = [], 1
+    while t < n:
+        counts.append(t)
+        t *= 2
+    counts.append(n)
+    return counts
+
+
+def usable_cpus() -> List[int]:
+    try:
+        return sorted(os.sched_getaffinity(0))
+    except AttributeError:
+        return list(range(os.cpu_count() or 1))
+
+
+def run_env(threads: int, pin: str) -> Dict[str, str]:
+    env = dict(os.environ)
+    env["OMP_NUM_THREADS"] = str(threads)
+    if pin != "none":
+        env["OMP_PROC_BIND"] = pin
+        env["OMP_PLACES"] = "cores"
+    return env
+
+
+def command(spec: dict, threads: int, pin: str, cpus: List[int]) -> List[str]:
+    cmd = [f"./{spec['bin']}"] + list(spec["args"])
+    if spec["threads"] == "flag":
+        cmd += ["-t", str(threads)]
+    elif spec["threads"] == "arg":
+        cmd += [str(threads)]
+    # taskset also pins the std::thread workers of TRNS, which ignore the OpenMP variables
+    if pin == "close" and shutil.which("taskset") and threads <= len(cpus):
+        cmd = ["taskset", "-c", ",".join(str(c) for c in cpus[:threads])] + cmd
+    return cmd
+
+
+def parse_time_ms(spec: dict, out: str) -> Optional[float]:
+    total = 0.0
+    for pattern in spec["time"]:
+        m = re.search(pattern, out)
+        if not m:
+            return None
+        total += float(m.group(1))
+    return total * spec.get("scale", 1.0)
+
+
+def build(bench_dir: Path, spec: dict) -> tuple[bool, str]:
+    env = dict(os.environ)
+    env.update(spec.get("make_env", {}))
+    cmd = ["make"] + ([spec["make_target"]] if "make_target" in spec else [])
+    proc = subprocess.run(cmd, cwd=str(bench_dir), env=env,
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    return proc.returncode == 0, proc.stdout or ""
+
+
+def update_results(path: Path, updates: Dict[str, Dict[str, str]]) -> None:
+    """Upsert columns of prim_results.csv, keeping existing rows and column order."""
+    header: List[str] = ["Test", "CPU", "DPU", "M_C2D", "M_D2C", "UPMEM", "U_C2D", "U_D2C"]
+    rows: Dict[str, Dict[str, str]] = {}
+    if path.exists():
+        with path.open(newline="") as f:
+            reader = csv.DictReader(f)
+            if reader.fieldnames:
+                header = list(reader.fieldnames)
+            for row in reader:
+                rows[row["Test"]] = row
+    for test, cols in updates.items():
+        for col in cols:
+            if col not in header:
+                header.append(col)
+        rows.setdefault(test, {"Test": test}).update(cols)
+    with path.open("w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=header, restval="")
+        writer.writeheader()
+        for row in rows.values():
+            writer.writerow(row)
+
+
+# ---------------------------
+# Main
+# ---------------------------
+def main() -> None:
+    root = Path(__file__).resolve().parent
+    ap = argparse.ArgumentParser(description="Thread-scaling sweep of the CPU baselines")
+    ap.add_argument("benchmarks", nargs="*", help=f"subset of: {' '.join(BASELINES)}")
+    ap.add_argument("--threads", help="comma-separated thread counts (default: powers of two up to all cores)")
+    ap.add_argument("--runs", type=int, default=1, help="runs per thread count, the fastest is kept")
+    ap.add_argument("--pin", choices=["close", "spread", "none"], default="close",
+                    help="OMP_PROC_BIND policy; close also restricts the run to the first N cores")
+    ap.add_argument("--no-make", action="store_true", help="do not build the baselines")
+    ap.add_argument("--runs-csv", default=str(root / RUNS_CSV))
+    ap.add_argument("--results", default=str(root / RESULTS_CSV))
+    args = ap.parse_args()
+
+    selected = args.benchmarks or list(BASELINES)
+    unknown = [b for b in selected if b not in BASELINES]
+    if unknown:
+        raise SystemExit(f"Unknown baseline(s): {' '.join(unknown)}")
+    threads = [int(t) for t in args.threads.split(",")] if args.threads else default_threads()
+    cpus = usable_cpus()
+
+    runs_path = Path(args.runs_csv)
+    runs_file = runs_path.open("w", newline="")
+    runs = csv.writer(runs_file)
+    runs.writerow(["Test", "Threads", "Run", "Time_ms", "Pinning"])
+
+    updates: Dict[str, Dict[str, str]] = {}
+    failed: List[tuple[str, str]] = []
+    for bench in selected:
+        spec = BASELINES[bench]
+        bench_dir = root / bench / "baselines" / "cpu"
+        missing = [n for n in spec.get("needs", []) if not (bench_dir / n).exists()]
+        if missing:
+            failed.append((bench, f"missing input {missing[0]}"))
+            print(f"[SKIP] {bench}: missing input {missing[0]}")
+            continue
+        if not args.no_make:
+            ok, out = build(bench_dir, spec)
+            (bench_dir / "make.log").write_text(out, encoding="utf-8", errors="replace")
+            if not ok:
+                failed.append((bench, "make failed"))
+                print(f"[FAIL] {bench}: make failed (see {bench_dir / 'make.log'})")
+                continue
+
+        best_per_threads: Dict[int, float] = {}
+        for t in threads:
+            for r in range(args.runs):
+                cmd = command(spec, t, args.pin, cpus)
+                proc = subprocess.run(cmd, cwd=str(bench_dir), env=run_env(t, args.pin),
+                                      stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+                out = proc.stdout or ""
+                ms = parse_time_ms(spec, out) if proc.returncode == 0 else None
+                if ms is None:
+                    log = bench_dir / f"run_t{t}.log"
+                    log.write_text(out, encoding="utf-8", errors="replace")
+                    print(f"[FAIL] {bench} t={t}: rc={proc.returncode}, no time found (see {log})")
+                    continue
+                runs.writerow([bench, t, r, f"{ms:.3f}", args.pin])
+                runs_file.flush()
+                best_per_threads[t] = min(ms, best_per_threads.get(t, ms))
+                print(f"[OK]   {bench} t={t} run={r}: {ms:.3f} ms")
+
+        if not best_per_threads:
+            failed.append((bench, "no successful run"))
+            continue
+        cols = {f"CPU_{t}": f"{ms:.3f}" for t, ms in sorted(best_per_threads.items())}
+        best_t = min(best_per_threads, key=best_per_threads.get)
+        cols["CPU_best"] = f"{best_per_threads[best_t]:.3f}"
+        cols["CPU_best_threads"] = str(best_t)
+        updates[bench] = cols
+        scaling = best_per_threads.get(threads[0], 0.0) / best_per_threads[best_t]
+        print(f"==> {bench}: best {best_per_threads[best_t]:.3f} ms with {best_t} threads "
+              f"({scaling:.2f}x over {threads[0]} thread(s))")
+        print()
+
+    runs_file.close()
+    if updates:
+        update_results(Path(args.results), updates)
+        print(f"Results written to {args.results}, runs to {runs_path}")
+
+    if failed:
+        print("Failed or skipped:")
+        for b, why in failed:
+            print(f"  - {b}: {why}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
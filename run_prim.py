@@ -18,8 +18,8 @@ from typing import List, Tuple
 # Bench config
 # ---------------------------
 DEFAULT_BENCH_DIRS = [
-    "BFS", "BS", "GEMV", "HST-L", "HST-S", "MLP", "NW", "RED",
-    "SCAN-RSS", "SCAN-SSA", "SEL", "SpMV", "TRNS", "TS", "UNI", "VA",
+    "BFS", "BITMAP", "BS", "GEMV", "HST-L", "HST-S", "HT", "KMER", "KNN", "MLP", "NW", "NW-BATCH", "RED",
+    "SCAN-RSS", "SCAN-SSA", "SEL", "SLS", "SpMV", "TRNS", "TS", "UNI", "VA", "VA-EXPR",
 ]
 
 EXCLUDE_BIN_NAMES = {
@@ -0,0 +1,458 @@
+#!/usr/bin/env python3
+"""
+Cycle-attributed profile of the DPU kernels on the UPMEM simulator backend.
+
+Every benchmark is rebuilt with the stand-in compiler of dpuprof/bin, which adds a
+coverage hook at the start of every basic block and counts the explicit mram_read and
+mram_write transfers per tasklet (dpuprof/dpu_profile.c). The host binary runs with
+small inputs and with dpuprof/host_profile.c preloaded, which allocates the DPUs on
+the simulator and reads the counters back. Block counts are then mapped to functions
+and source lines with llvm-objdump and llvm-symbolizer of the DPU toolchain:
+  - cycles: measured between consecutive hooks of a tasklet, hook excluded, so they
+    are wall cycles of the (interleaved) pipeline, not issue slots of the tasklet
+  - instructions: static size of the block times its executions
+  - MRAM: transfers, bytes and cycles per tasklet, over all DPUs and launches
+No PIM DIMMs are needed. With --backend hw the same counters are taken on hardware.
+
+Outputs (logs/profile_<timestamp>/):
+  - <bench>.profile.txt: hotspot report (functions, lines, MRAM transfers per tasklet)
+  - dpu_profile.csv: one row per source line and per tasklet, comparable across
+    commits with --compare (instructions and transfers are deterministic for the
+    fixed inputs below, cycles are reported but not compared)
+
+Usage:
+  python3 run_profile.py [--dpus 1] [--tasklets N] [--top 15] [--compare old.csv] [VA SEL ...]
+"""
+from __future__ import annotations
+
+import argparse
+import csv
+import os
+import re
+import shutil
+import subprocess
+import sys
+from collections import defaultdict
+from datetime import datetime
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from run_prim import pick_host_binary
+
+
+# ---------------------------
+# Profile config
+# ---------------------------
+# make_vars: extra Makefile variables (NR_DPUS and NR_TASKLETS come from the command line)
+# args:      host arguments, small enough for the simulator (one warmup-free repetition)
+# needs:     input files (relative to the benchmark directory) without which the run is skipped
+ONE_REP = ["-w", "0", "-e", "1"]
+
+PROFILES: Dict[str, dict] = {
+    "BFS": dict(args=["-f", "data/loc-gowalla"], needs=["data/loc-gowalla"]),
+    "BITMAP": dict(args=["-r", "1048576", "-q", "2", "-t", "1"] + ONE_REP),
+    "BS": dict(make_vars={"PROBLEM_SIZE": "16384"}, args=["-i", "1024"] + ONE_REP),
+    "GEMV": dict(args=["-m", "256", "-n", "256"] + ONE_REP),
+    "HST-L": dict(args=["-i", "16384"] + ONE_REP),
+    "HST-S": dict(args=["-i", "16384"] + ONE_REP),
+    "HT": dict(args=["-n", "8192", "-q", "4096", "-t", "1"] + ONE_REP),
+    "KMER": dict(args=["-r", "1024", "-g", "65536", "-t", "1"] + ONE_REP),
+    "KNN": dict(args=["-n", "4096", "-q", "16", "-t", "1"] + ONE_REP),
+    "MLP": dict(args=["-m", "256", "-n", "256"] + ONE_REP),
+    "NW": dict(args=["-n", "256", "-p", "10"] + ONE_REP),
+    "NW-BATCH": dict(args=["-n", "32", "-l", "50", "-L", "100", "-b", "32"] + ONE_REP),
+    "RED": dict(args=["-i", "65536"] + ONE_REP),
+    "SCAN-RSS": dict(args=["-i", "65536"] + ONE_REP),
+    "SCAN-SSA": dict(args=["-i", "65536"] + ONE_REP),
+    "SEL": dict(args=["-i", "65536"] + ONE_REP),
+    "SLS": dict(args=["-r", "16384", "-q", "256", "-l", "16", "-t", "1"] + ONE_REP),
+    "SpMV": dict(args=["-f", "data/bcsstk30.mtx"], needs=["data/bcsstk30.mtx"]),
+    "TRNS": dict(args=["-m", "16", "-n", "8", "-o", "256", "-p", "1"] + ONE_REP),
+    "TS": dict(args=["-n", "8192", "-m", "64"] + ONE_REP),
+    "UNI": dict(args=["-i", "65536"] + ONE_REP),
+    "VA": dict(args=["-i", "65536"] + ONE_REP),
+    "VA-EXPR": dict(args=["-i", "65536"] + ONE_REP),
+}
+
+DPU_CLANG = "dpu-upmem-dpurte-clang"
+HOOK = "__sanitizer_cov_trace_pc"
+INSN_BYTES = 8  # DPU instructions are 48 bits, stored in 64-bit words in the ELF
+IRAM_BASE = 0x80000000
+# Largest --slots, the table size the host shim can read back (dpuprof/prof_common.h)
+PROF_MAX_SLOTS = int(re.search(r"#define PROF_MAX_SLOTS (\d+)",
+                               (Path(__file__).resolve().parent / "dpuprof" / "prof_common.h").read_text()).group(1))
+PROFILE_CSV = "dpu_profile.csv"
+CSV_HEADER = ["Test", "Binary", "Scope", "Function", "Location", "Cycles", "Instructions", "Execs",
+              "Reads", "Writes", "Bytes"]
+
+
+# ---------------------------
+# Toolchain
+# ---------------------------
+def find_tool(names: List[str], near: Path) -> Optional[str]:
+    """First of names next to the real DPU compiler, then on PATH."""
+    for n in names:
+        p = near.parent / n
+        if p.is_file() and os.access(str(p), os.X_OK):
+            return str(p)
+    for n in names:
+        p = shutil.which(n)
+        if p:
+            return p
+    return None
+
+
+def build_shim(root: Path, out: Path) -> Tuple[bool, str]:
+    cflags = subprocess.run(["dpu-pkg-config", "--cflags", "--libs", "dpu"],
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    if cflags.returncode != 0:
+        return False, cflags.stdout or "dpu-pkg-config failed"
+    cmd = ["cc", "-shared", "-fPIC", "-O2", "-o", str(out), str(root / "dpuprof" / "host_profile.c")]
+    cmd += cflags.stdout.split() + ["-ldl"]
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    return proc.returncode == 0, proc.stdout or ""
+
+
+def build(bench_dir: Path, spec: dict, make_vars: Dict[str, str], env: Dict[str, str]) -> Tuple[bool, str]:
+    # -B: objects and binaries of a normal build must not be reused
+    variables = dict(spec.get("make_vars", {}))
+    variables.update(make_vars)
+    cmd = ["make", "-B"] + [f"{k}={v}" for k, v in variables.items()]
+    proc = subprocess.run(cmd, cwd=str(bench_dir), env=env,
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    return proc.returncode == 0, proc.stdout or ""
+
+
+# ---------------------------
+# Raw counters (DPUPROF_OUT of host_profile.c)
+# ---------------------------
+def read_counters(path: Path) -> Tuple[int, Dict[str, dict]]:
+    launches = 0
+    binaries: Dict[str, dict] = {}
+    for line in path.read_text().splitlines():
+        f = line.split("\t")
+        if f[0] == "launches":
+            launches = int(f[1])
+        elif f[0] == "binary":
+            binaries[f[1]] = dict(dpus=int(f[2]), dropped=int(f[3]), blocks={}, dma={})
+        elif f[0] == "block":
+            binaries[f[1]]["blocks"][int(f[2])] = (int(f[3]), int(f[4]))
+        elif f[0] == "dma":
+            binaries[f[1]]["dma"][int(f[2])] = tuple(int(x) for x in f[3:8])
+    return launches, binaries
+
+
+# ---------------------------
+# Disassembly and symbols
+# ---------------------------
+RE_FUNC = re.compile(r"^([0-9a-fA-F]+) <(.+)>:$")
+RE_INSN = re.compile(r"^\s*([0-9a-fA-F]+):\s+(.*)$")
+
+
+def disassemble(objdump: str, binary: str) -> List[Tuple[int, str, bool]]:
+    """(address, function, is_hook_call) of every IRAM instruction."""
+    out = subprocess.run([objdump, "-d", "--no-show-raw-insn", binary],
+                         stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True).stdout or ""
+    insns, func = [], "?"
+    for line in out.splitlines():
+        m = RE_FUNC.match(line)
+        if m:
+            func = m.group(2)
+            continue
+        m = RE_INSN.match(line)
+        if m:
+            insns.append((int(m.group(1), 16), func, "call" in m.group(2) and HOOK in m.group(2)))
+    return insns
+
+
+def pc_to_addr(pc: int) -> int:
+    """The hook sees return addresses as IRAM instruction indices; ELF addresses are bytes from IRAM_BASE."""
+    return IRAM_BASE + pc * INSN_BYTES
+
+
+def block_sizes(insns: List[Tuple[int, str, bool]]) -> Dict[int, int]:
+    """Instructions from every return site to the next hook call of the same function."""
+    sizes: Dict[int, int] = {}
+    index = {a: i for i, (a, _, _) in enumerate(insns)}
+    for a, func, hook in insns:
+        if not hook or a + INSN_BYTES not in index:
+            continue
+        n = 0
+        for b, f, h in insns[index[a + INSN_BYTES]:]:
+            if h or f != func:
+                break
+            n += 1
+        sizes[a + INSN_BYTES] = n
+    return sizes
+
+
+def symbolize(symbolizer: Optional[str], binary: str, addrs: List[int]) -> Dict[int, Tuple[str, str]]:
+    """(function, file:line) of every address; llvm-symbolizer and llvm-addr2line print the same pairs."""
+    if symbolizer is None or not addrs:
+        return {}
+    if "addr2line" in Path(symbolizer).name:
+        cmd = [symbolizer, "-f", "-e", binary]
+    else:
+        cmd = [symbolizer, "--obj=" + binary, "--no-inlines"]
+    out = subprocess.run(cmd, input="".join(f"0x{a:x}\n" for a in addrs),
+                         stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True).stdout or ""
+    lines = [l for l in out.splitlines() if l.strip()]
+    result = {}
+    for a, i in zip(addrs, range(0, len(lines) - 1, 2)):
+        loc = lines[i + 1]
+        # Drop the column
+        parts = loc.rsplit(":", 2)
+        if len(parts) == 3 and parts[2].isdigit():
+            loc = f"{parts[0]}:{parts[1]}"
+        result[a] = (lines[i], loc)
+    return result
+
+
+# ---------------------------
+# Report
+# ---------------------------
+def attribute(counters: dict, insns, symbolizer: Optional[str], binary: str, bench_dir: Path) -> List[dict]:
+    """One row per source line: cycles, instructions, executions."""
+    pcs = list(counters["blocks"])
+    sizes = block_sizes(insns)
+    funcs = {a: f for a, f, _ in insns}
+    addrs = [pc_to_addr(pc) for pc in pcs]
+    # Every return address must follow a hook call, otherwise the mapping is wrong for this toolchain
+    stray = [a for a in addrs if a not in sizes]
+    if stray:
+        raise ValueError(f"{len(stray)} of {len(addrs)} block address(es) do not follow a {HOOK} call "
+                         f"(first 0x{stray[0]:x}); the IRAM address mapping does not match {binary}")
+    symbols = symbolize(symbolizer, binary, addrs)
+
+    rows: Dict[Tuple[str, str], dict] = {}
+    for pc, addr in zip(pcs, addrs):
+        execs, cycles = counters["blocks"][pc]
+        func, loc = symbols.get(addr, (funcs.get(addr, "?"), f"0x{addr:x}"))
+        if loc.startswith(str(bench_dir) + "/"):
+            loc = loc[len(str(bench_dir)) + 1:]
+        r = rows.setdefault((func, loc), dict(Function=func, Location=loc, Cycles=0, Instructions=0, Execs=0))
+        r["Cycles"] += cycles
+        r["Instructions"] += sizes.get(addr, 0) * execs
+        r["Execs"] += execs
+    return sorted(rows.values(), key=lambda r: -r["Cycles"])
+
+
+def write_report(path: Path, bench: str, launches: int, backend: str, top: int,
+                 results: List[Tuple[str, dict, List[dict]]]) -> None:
+    with path.open("w") as f:
+        f.write(f"DPU profile of {bench} ({launches} launch(es), {backend} backend)\n")
+        f.write("Cycles are counted between the coverage hooks of a tasklet and include the\n"
+                "instrumentation's effect on scheduling; compare them within a profile, not with\n"
+                "uninstrumented runs. Only mram_read/mram_write transfers are counted.\n")
+        for name, counters, lines in results:
+            total = sum(r["Cycles"] for r in lines) or 1
+            f.write(f"\n=== {name} ({counters['dpus']} DPU(s))\n")
+            if counters["dropped"]:
+                f.write(f"WARNING: {counters['dropped']} block executions dropped, rerun with a larger --slots\n")
+
+            per_func: Dict[str, dict] = defaultdict(lambda: dict(Cycles=0, Instructions=0, Execs=0))
+            for r in lines:
+                for k in ("Cycles", "Instructions", "Execs"):
+                    per_func[r["Function"]][k] += r[k]
+            f.write("\nFunctions\n")
+            f.write(f"{'cycles':>14} {'%':>6} {'instructions':>14} {'block execs':>12}  function\n")
+            for func, r in sorted(per_func.items(), key=lambda kv: -kv[1]["Cycles"])[:top]:
+                f.write(f"{r['Cycles']:>14} {100.0 * r['Cycles'] / total:>6.2f} {r['Instructions']:>14} "
+                        f"{r['Execs']:>12}  {func}\n")
+
+            f.write("\nLines\n")
+            f.write(f"{'cycles':>14} {'%':>6} {'instructions':>14} {'block execs':>12}  location (function)\n")
+            for r in lines[:top]:
+                f.write(f"{r['Cycles']:>14} {100.0 * r['Cycles'] / total:>6.2f} {r['Instructions']:>14} "
+                        f"{r['Execs']:>12}  {r['Location']} ({r['Function']})\n")
+
+            f.write("\nMRAM transfers per tasklet\n")
+            f.write(f"{'tasklet':>7} {'reads':>10} {'writes':>10} {'read bytes':>12} {'write bytes':>12} "
+                    f"{'cycles':>14}\n")
+            for t, (rd, wr, rb, wb, cc) in sorted(counters["dma"].items()):
+                f.write(f"{t:>7} {rd:>10} {wr:>10} {rb:>12} {wb:>12} {cc:>14}\n")
+
+
+def compare(old_path: Path, rows: List[dict], tolerance: float) -> List[str]:
+    """Instruction counts per function and transfers per binary that grew by more than tolerance."""
+    def totals(rs):
+        t: Dict[Tuple[str, str, str], float] = defaultdict(float)
+        for r in rs:
+            if r["Scope"] == "line":
+                t[(r["Test"], r["Binary"], r["Function"])] += float(r["Instructions"])
+            else:
+                t[(r["Test"], r["Binary"], "MRAM transfers")] += float(r["Reads"]) + float(r["Writes"])
+                t[(r["Test"], r["Binary"], "MRAM bytes")] += float(r["Bytes"])
+        return t
+    with old_path.open(newline="") as f:
+        old = totals(list(csv.DictReader(f)))
+    regressions = []
+    for key, value in sorted(totals(rows).items()):
+        before = old.get(key)
+        if before is None or before == 0:
+            continue
+        if value > before * (1.0 + tolerance):
+            regressions.append(f"{key[0]} {key[1]} {key[2]}: {before:.0f} -> {value:.0f} "
+                               f"(+{100.0 * (value / before - 1.0):.1f}%)")
+    return regressions
+
+
+# ---------------------------
+# Main
+# ---------------------------
+def main() -> None:
+    root = Path(__file__).resolve().parent
+    ap = argparse.ArgumentParser(description="Cycle-attributed DPU profile on the simulator backend")
+    ap.add_argument("benchmarks", nargs="*", help=f"subset of: {' '.join(PROFILES)}")
+    ap.add_argument("--dpus", type=int, default=1, help="NR_DPUS of the build (default: 1)")
+    ap.add_argument("--tasklets", type=int, help="NR_TASKLETS of the build (default: the Makefile's)")
+    ap.add_argument("--backend", default="simulator", help="DPU backend, hw to keep the default allocation")
+    ap.add_argument("--slots", type=int, default=256, help="distinct basic blocks per DPU (power of two)")
+    ap.add_argument("--top", type=int, default=15, help="functions and lines in the report")
+    ap.add_argument("--timeout", type=int, default=3600, help="seconds per run")
+    ap.add_argument("--compare", help="previous dpu_profile.csv: report instruction and transfer regressions")
+    ap.add_argument("--tolerance", type=float, default=0.02, help="relative growth reported by --compare")
+    args = ap.parse_args()
+
+    selected = args.benchmarks or list(PROFILES)
+    unknown = [b for b in selected if b not in PROFILES]
+    if unknown:
+        raise SystemExit(f"Unknown benchmark(s): {' '.join(unknown)}")
+    if args.slots & (args.slots - 1) or not 0 < args.slots <= PROF_MAX_SLOTS:
+        raise SystemExit(f"--slots must be a power of two, at most {PROF_MAX_SLOTS} (PROF_MAX_SLOTS of dpuprof/prof_common.h)")
+
+    real_clang = shutil.which(DPU_CLANG)
+    if real_clang is None:
+        raise SystemExit(f"{DPU_CLANG} not found: source the UPMEM SDK environment first")
+    real_clang_path = Path(real_clang).resolve()
+    objdump = find_tool(["llvm-objdump"], real_clang_path)
+    symbolizer = find_tool(["llvm-symbolizer", "llvm-addr2line"], real_clang_path)
+    if objdump is None:
+        raise SystemExit("llvm-objdump not found next to the DPU compiler or on PATH")
+
+    logdir = root / "logs" / datetime.now().strftime("profile_%Y%m%d_%H%M%S")
+    logdir.mkdir(parents=True, exist_ok=True)
+    shim = logdir / "libdpuprof.so"
+    ok, out = build_shim(root, shim)
+    if not ok:
+        (logdir / "shim.log").write_text(out, encoding="utf-8", errors="replace")
+        raise SystemExit(f"Could not build the host shim (see {logdir / 'shim.log'})")
+
+    build_env = dict(os.environ)
+    build_env["PATH"] = f"{root / 'dpuprof' / 'bin'}{os.pathsep}{build_env.get('PATH', '')}"
+    build_env["DPUPROF_CLANG"] = str(real_clang_path)
+    build_env["DPUPROF_SLOTS"] = str(args.slots)
+    make_vars = {"NR_DPUS": str(args.dpus)}
+    if args.tasklets:
+        make_vars["NR_TASKLETS"] = str(args.tasklets)
+
+    print(f"Root     : {root}")
+    print(f"Logs     : {logdir}")
+    print(f"Backend  : {args.backend}, {args.dpus} DPU(s)")
+    print(f"Symbols  : {symbolizer or 'none (addresses only)'}")
+    print()
+
+    rows: List[dict] = []
+    failed: List[Tuple[str, str]] = []
+    for bench in selected:
+        spec = PROFILES[bench]
+        bench_dir = root / bench
+        missing = [n for n in spec.get("needs", []) if not (bench_dir / n).exists()]
+        if missing:
+            failed.append((bench, f"missing input {missing[0]}"))
+            print(f"[SKIP] {bench}: missing input {missing[0]}")
+            continue
+
+        ok, out = build(bench_dir, spec, make_vars, build_env)
+        (logdir / f"{bench}.make.log").write_text(out, encoding="utf-8", errors="replace")
+        if not ok:
+            failed.append((bench, "make failed"))
+            print(f"[FAIL] {bench}: make failed (see {logdir / f'{bench}.make.log'})")
+            continue
+
+        try:
+            host_bin = pick_host_binary(bench_dir)
+            if host_bin is None:
+                failed.append((bench, "no host binary found"))
+                print(f"[FAIL] {bench}: no runnable host binary found under {bench}/bin/")
+                continue
+            counters_path = logdir / f"{bench}.counters.tsv"
+            env = dict(os.environ)
+            env["LD_PRELOAD"] = str(shim)
+            env["DPUPROF_OUT"] = str(counters_path)
+            env["DPUPROF_BACKEND"] = args.backend
+            print(f"==> Running {bench}: {host_bin.relative_to(bench_dir)} {' '.join(spec['args'])}")
+            try:
+                proc = subprocess.run([str(host_bin)] + spec["args"], cwd=str(bench_dir), env=env,
+                                      stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True,
+                                      timeout=args.timeout)
+                out, rc = proc.stdout or "", proc.returncode
+            except subprocess.TimeoutExpired as e:
+                out = e.stdout.decode(errors="replace") if isinstance(e.stdout, bytes) else (e.stdout or "")
+                rc = None
+            run_log = logdir / f"{bench}.run.log"
+            run_log.write_text(out, encoding="utf-8", errors="replace")
+            if rc != 0:
+                failed.append((bench, "timeout" if rc is None else f"rc={rc}"))
+                print(f"[FAIL] {bench}: {'timeout' if rc is None else f'rc={rc}'} (see {run_log})")
+                continue
+
+            launches, binaries = read_counters(counters_path)
+            if not binaries:
+                failed.append((bench, "no counters"))
+                print(f"[FAIL] {bench}: no DPU counters collected (see {run_log})")
+                continue
+
+            results, bench_rows = [], []
+            for binary, counters in binaries.items():
+                name = os.path.relpath(binary, str(bench_dir))
+                try:
+                    lines = attribute(counters, disassemble(objdump, binary), symbolizer, binary, bench_dir)
+                except ValueError as e:
+                    failed.append((bench, "address mapping"))
+                    print(f"[FAIL] {bench}: {e}")
+                    results = None
+                    break
+                results.append((name, counters, lines))
+                for r in lines:
+                    bench_rows.append(dict(Test=bench, Binary=name, Scope="line", Reads=0, Writes=0, Bytes=0, **r))
+                for t, (rd, wr, rb, wb, cc) in sorted(counters["dma"].items()):
+                    bench_rows.append(dict(Test=bench, Binary=name, Scope="tasklet", Function="", Location=str(t),
+                                     Cycles=cc, Instructions=0, Execs=0, Reads=rd, Writes=wr, Bytes=rb + wb))
+            if results is None:
+                continue
+            rows.extend(bench_rows)
+            report = logdir / f"{bench}.profile.txt"
+            write_report(report, bench, launches, args.backend, args.top, results)
+            print(f"[OK]   {bench}: {report}")
+        finally:
+            # The instrumented binaries must not be picked up by a later normal run
+            subprocess.run(["make", "clean"], cwd=str(bench_dir),
+                           stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+    if rows:
+        csv_path = logdir / PROFILE_CSV
+        with csv_path.open("w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=CSV_HEADER)
+            writer.writeheader()
+            writer.writerows(rows)
+        print(f"\nProfile written to {csv_path}")
+        if args.compare:
+            regressions = compare(Path(args.compare), rows, args.tolerance)
+            if regressions:
+                print(f"Regressions against {args.compare}:")
+                for r in regressions:
+                    print(f"  - {r}")
+                failed.append(("compare", f"{len(regressions)} regression(s)"))
+            else:
+                print(f"No regression against {args.compare}")
+
+    if failed:
+        print("Failed or skipped:")
+        for b, why in failed:
+            print(f"  - {b}: {why}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()